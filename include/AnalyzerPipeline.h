@@ -0,0 +1,51 @@
+#ifndef ANALYZER_PIPELINE_H
+#define ANALYZER_PIPELINE_H
+
+#include <tuple>
+#include <utility>
+#include "FrameParser.h"
+
+#if defined(__GNUC__)
+#define PIPELINE_INLINE inline __attribute__((always_inline))
+#define PIPELINE_LAMBDA_INLINE __attribute__((always_inline))
+#else
+#define PIPELINE_INLINE inline
+#define PIPELINE_LAMBDA_INLINE
+#endif
+
+// Pipeline de analisadores montado em tempo de compilação.
+//
+// Todo estágio segue o mesmo "conceito" (sem herança nem métodos virtuais):
+//   void onFrame(const ParsedFrame& frame);  // chamado para cada quadro decodificado
+//   void onWindowEnd();                      // chamado ao fim de cada janela de estatísticas
+//
+// Os estágios são chamados na ordem em que aparecem nos parâmetros do template,
+// e a cadeia por quadro é uma sequência de chamadas diretas que o compilador
+// expande em linha: um estágio a mais custa apenas o trabalho dele.
+template <typename... Stages>
+class Pipeline {
+public:
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) {
+    _forEach([&frame](auto& stage) PIPELINE_LAMBDA_INLINE { stage.onFrame(frame); },
+             std::index_sequence_for<Stages...>{});
+  }
+
+  void onWindowEnd() {
+    _forEach([](auto& stage) { stage.onWindowEnd(); }, std::index_sequence_for<Stages...>{});
+  }
+
+  template <typename Stage>
+  Stage& get() { return std::get<Stage>(_stages); }
+
+  static constexpr size_t stageCount() { return sizeof...(Stages); }
+
+private:
+  std::tuple<Stages...> _stages;
+
+  template <typename Fn, size_t... I>
+  PIPELINE_INLINE void _forEach(Fn&& fn, std::index_sequence<I...>) {
+    (fn(std::get<I>(_stages)), ...);
+  }
+};
+
+#endif
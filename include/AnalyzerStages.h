@@ -0,0 +1,208 @@
+#ifndef ANALYZER_STAGES_H
+#define ANALYZER_STAGES_H
+
+#include <cstdint>
+#include <cstddef>
+#include "AnalyzerPipeline.h"
+#include "AppClassifier.h"
+#include "DeviceProfile.h"
+#include "DeviceFingerprint.h"
+#include "FeatureVector.h"
+#include "FlowTable.h"
+#include "TcpRttTracker.h"
+
+// Estágios do pipeline do sniffer. Cada um implementa onFrame()/onWindowEnd()
+// em linha e delega o trabalho pesado para o módulo correspondente.
+
+// Totais da janela e pacotes/bytes/destinos de cada estação, que no fim da
+// janela atualizam o perfil dela (ver DeviceProfile)
+#define STATS_MAX_STATIONS 64              // Estações por janela (24 B cada)
+#define STATS_MIN_PROFILE_WINDOW_MS 10000  // Janela mais curta não atualiza os perfis
+
+class StatsStage {
+public:
+  StatsStage() { reset(); }
+
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) {
+    if (_pendingPackets == 0) _windowStartMs = frame.uptimeMs;
+    _lastMs = frame.uptimeMs;
+    _pendingPackets++;
+    _pendingBytes += frame.length;
+    Counters* counters = _station(frame);
+    if (counters != nullptr) {
+      counters->packets++;
+      counters->bytes += frame.length;
+      if (frame.hasIpv4) counters->peers |= 1u << peerBit(frame.isUplink() ? frame.dstIp : frame.srcIp);
+    }
+  }
+  void onWindowEnd();
+  void reset();
+
+  // Totais da última janela fechada
+  uint32_t windowPackets() const { return _windowPackets; }
+  uint64_t windowBytes() const { return _windowBytes; }
+  DeviceProfileStore& profiles() { return _profiles; }
+
+  static uint64_t macToKey(const uint8_t* mac);
+  // Bit do IP remoto no bitmap de destinos do perfil
+  static uint8_t peerBit(uint32_t ip) { return (uint8_t)((ip * 2654435761u) >> 27); }
+
+private:
+  struct Counters {
+    uint64_t key;     // MAC em 48 bits; 0 = livre
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t peers;
+  };
+  Counters _stations[STATS_MAX_STATIONS];
+  uint32_t _pendingPackets;
+  uint64_t _pendingBytes;
+  uint32_t _windowStartMs;
+  uint32_t _lastMs;
+  uint32_t _windowPackets;
+  uint64_t _windowBytes;
+  DeviceProfileStore _profiles;
+
+  Counters* _station(const ParsedFrame& frame);
+};
+
+// Registra as consultas DNS (UDP/53) legíveis
+class DnsStage {
+public:
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) {
+    if (frame.hasIpv4 && frame.ipProto == IP_PROTO_UDP && frame.dstPort == 53 && frame.l4Payload != nullptr) {
+      _handleQuery(frame);
+    }
+  }
+  void onWindowEnd() { _queriesInWindow = 0; }
+  uint32_t queriesInWindow() const { return _queriesInWindow; }
+
+private:
+  uint32_t _queriesInWindow = 0;
+  void _handleQuery(const ParsedFrame& frame);
+};
+
+// Medidor de fluxos 5-tupla (ver FlowTable / NetFlowExporter)
+class FlowStage {
+public:
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) {
+    _table.onFrame(frame, frame.uptimeMs);
+    if (frame.uptimeMs - _lastExpireMs >= 1000) {
+      _lastExpireMs = frame.uptimeMs;
+      _table.expire(frame.uptimeMs);
+    }
+  }
+  void onWindowEnd() { _table.expire(_lastExpireMs); }
+  FlowTable& table() { return _table; }
+
+private:
+  FlowTable _table;
+  uint32_t _lastExpireMs = 0;
+};
+
+// RTT passivo do handshake TCP e retransmissões
+class RttStage {
+public:
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) {
+    _lastFrameUs = frame.timestampUs;
+    _tracker.onFrame(frame);
+  }
+  void onWindowEnd() { _tracker.expire(_lastFrameUs); }
+  TcpRttTracker& tracker() { return _tracker; }
+
+private:
+  TcpRttTracker _tracker;
+  uint32_t _lastFrameUs = 0;
+};
+
+// Vetor de características do detector de anomalias (AnomalyFeatures.def).
+// Acumula o ciclo sniffer inteiro: onWindowEnd() não zera, reset() sim.
+#define FEATURE_PEER_BITMAP_BITS 1024  // Contagem linear de peers distintos (128 bytes)
+#define FEATURE_DEVICE_PEER_BITS 128   // O mesmo, por dispositivo (16 bytes)
+
+class FeatureStage {
+public:
+  FeatureStage() { reset(); }
+
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) {
+    if (_packets == 0) _firstMs = frame.uptimeMs;
+    _lastMs = frame.uptimeMs;
+    _packets++;
+    _bytes += frame.length;
+    if (frame.isRetry()) _retries++;
+    Station* station = _station(frame.transmitter);
+    if (station != nullptr) {
+      station->packets++;
+      station->bytes += frame.length;
+      if (frame.isRetry()) station->retries++;
+    }
+    if (frame.hasIpv4) {
+      bool dns = frame.ipProto == IP_PROTO_UDP && frame.dstPort == 53;
+      if (dns) _dnsQueries++;
+      if (dns && station != nullptr) station->dnsQueries++;
+      _notePeer(frame.srcIp, station);
+      _notePeer(frame.dstIp, station);
+    }
+  }
+  void onWindowEnd() {}
+  void reset();
+  // Soma o que outro acumulador viu no mesmo intervalo (uptimeMs na mesma base):
+  // janelas partidas entre dois arquivos de captura no tools/pcap_features
+  void merge(const FeatureStage& other);
+
+  // Vetor agregado do ciclo
+  FeatureVector features() const;
+  // Um vetor por transmissor visto (no máximo FEATURE_MAX_STATIONS); retorna quantos
+  size_t deviceFeatures(DeviceFeatures* out, size_t maxOut) const;
+
+private:
+  struct Station {
+    uint64_t key;   // MAC em 48 bits; 0 = posição livre
+    uint64_t bytes;
+    uint32_t packets;
+    uint32_t retries;
+    uint32_t dnsQueries;
+    uint32_t peerBitmap[FEATURE_DEVICE_PEER_BITS / 32];
+  };
+  Station _stations[FEATURE_MAX_STATIONS];
+  uint32_t _stationCount;   // Satura em FEATURE_MAX_STATIONS
+  uint32_t _peerBitmap[FEATURE_PEER_BITMAP_BITS / 32];
+  uint32_t _packets;
+  uint64_t _bytes;
+  uint32_t _retries;
+  uint32_t _dnsQueries;
+  uint32_t _firstMs;
+  uint32_t _lastMs;
+
+  Station* _station(const uint8_t* mac);
+  Station* _stationByKey(uint64_t key);
+  void _notePeer(uint32_t ip, Station* station);
+  uint32_t _durationMs() const;
+};
+
+// Impressão digital dos dispositivos ainda não classificados (ver DeviceFingerprint)
+class FingerprintStage {
+public:
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) { _fingerprinter.onFrame(frame); }
+  void onWindowEnd() {}
+  DeviceFingerprinter& fingerprinter() { return _fingerprinter; }
+
+private:
+  DeviceFingerprinter _fingerprinter;
+};
+
+// Atividade de cada estação por janela (ver AppClassifier)
+class AppClassStage {
+public:
+  PIPELINE_INLINE void onFrame(const ParsedFrame& frame) { _classifier.onFrame(frame); }
+  void onWindowEnd() { _classifier.onWindowEnd(); }
+  AppClassifier& classifier() { return _classifier; }
+
+private:
+  AppClassifier _classifier;
+};
+
+// Extrai o nome consultado de uma mensagem DNS. Retorna false se não houver nome.
+bool parseDnsQuery(const uint8_t* data, int len, char* out, size_t outSize);
+
+#endif
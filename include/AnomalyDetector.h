@@ -2,16 +2,71 @@
 #define ANOMALY_DETECTOR_H
 
 #include <cstdint>
+#include <ctime>
+#include "FeatureVector.h"
+#include "AnomalyEngine.h"
+#include "AutoencoderEngine.h"
+#include "MahalanobisEngine.h"
+#include "ModelStore.h"
+#include "SeasonalBaseline.h"
 
 class AnomalyDetector {
 public:
   AnomalyDetector();
+  // Engine que decide as janelas globais; chamar antes de setup()
+  void setEngine(AnomalyEngineType type);
+  const AnomalyEngine& engine() const { return *_engine; }
   void setup();
-  // A função principal: recebe as métricas e retorna true se for uma anomalia
-  bool detect(uint32_t packet_count, uint64_t total_bytes);
+  // A função principal: recebe as características da janela e retorna true se for uma anomalia
+  bool detect(const FeatureVector& features);
+  // O mesmo, com a hora da janela explícita (o baseline sazonal usa a hora local)
+  bool detect(const FeatureVector& features, time_t now);
+  // Escore da engine na última chamada a detect() e o limite em uso
+  float lastError() const { return _lastError; }
+  float threshold() const { return _engine->threshold(); }
+
+  // Calibração online do autoencoder (ver AutoencoderEngine)
+  void setOnlineCalibration(bool enabled) { _autoencoder.setOnlineCalibration(enabled); }
+  bool isOnlineCalibration() const { return _autoencoder.isOnlineCalibration(); }
+  const OnlineCalibrator& calibrator() const { return _autoencoder.calibrator(); }
+
+  // Baseline por hora da semana (ver SeasonalBaseline): com o balde do horário
+  // aquecido, ele decide a janela e o modelo é o segundo sinal. Fora do típico
+  // do horário alerta mesmo com o modelo achando normal; uma anomalia do
+  // modelo só é confirmada se a janela também foge do balde. Precisa do
+  // relógio sincronizado por SNTP; sem ele (ou com o balde frio) só o modelo decide.
+  void setSeasonalBaseline(bool enabled);
+  const SeasonalBaseline& seasonal() const { return _seasonal; }
+  // Maior |z| da última janela contra o seu balde (0 se o balde ainda não vale)
+  float lastSeasonalScore() const { return _lastSeasonalScore; }
+
+  // Modelo do autoencoder nas partições model0/model1 (upload em /model).
+  // Um modelo novo entra em uso no começo da próxima chamada a detect().
+  ModelStore& modelStore() { return _models; }
+  uint32_t modelVersion() const { return _autoencoder.modelVersion(); }
+
+  // Pontuação por dispositivo, sempre com o autoencoder (inferência em lote)
+  size_t scoreDevices(const DeviceFeatures* devices, size_t count, DeviceScore* top, size_t maxTop) {
+    return _autoencoder.scoreDevices(devices, count, top, maxTop);
+  }
 
 private:
   bool _initialized = false;
+  float _lastError = 0.0f;
+
+  AutoencoderEngine _autoencoder;
+  MahalanobisEngine _mahalanobis;
+  AnomalyEngine* _engine;
+  ModelStore _models;
+
+  bool _seasonalEnabled = false;
+  SeasonalBaseline _seasonal;
+  int _seasonalBucket = -1;
+  float _lastSeasonalScore = 0.0f;
+
+  bool _applySeasonal(const FeatureVector& features, time_t now, bool modelAnomaly);
+  void _loadSeasonal();
+  void _saveSeasonalDay(int day);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,40 @@
+#ifndef ANOMALY_ENGINE_H
+#define ANOMALY_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FeatureVector.h"
+
+// Interface das engines de detecção usadas pelo AnomalyDetector.
+//
+// Cada engine recebe o vetor de características de uma janela, devolve um
+// escore e a decisão, e aprende com a janela quando for o caso. O filtro
+// sazonal, o alerta e a pontuação por dispositivo ficam no AnomalyDetector,
+// iguais para todas as engines.
+
+enum class AnomalyEngineType : uint8_t {
+  Autoencoder,  // Autoencoder treinado no PC (AutoencoderEngine)
+  Mahalanobis,  // Distância de Mahalanobis com média/covariância exponenciais, aprende sozinha
+};
+
+struct AnomalyScore {
+  float score;      // Escore da engine (erro de reconstrução, distância...)
+  float threshold;  // Limite em uso nesta janela
+  bool warm;        // false durante o aquecimento: nunca alerta
+  bool anomalous;
+};
+
+class AnomalyEngine {
+public:
+  virtual ~AnomalyEngine() {}
+
+  virtual const char* name() const = 0;
+  virtual bool begin() = 0;
+  // Pontua a janela e atualiza o estado aprendido
+  virtual bool evaluate(const FeatureVector& features, AnomalyScore* result) = 0;
+  virtual float threshold() const = 0;
+  // RAM do estado e dos buffers da engine (os pesos em flash não contam)
+  virtual size_t memoryBytes() const = 0;
+};
+
+#endif
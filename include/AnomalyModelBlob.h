@@ -0,0 +1,72 @@
+#ifndef ANOMALY_MODEL_BLOB_H
+#define ANOMALY_MODEL_BLOB_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Formato do modelo do autoencoder gravado numa partição de dados (ModelStore)
+// e gerado por scripts/TinyML_Module_9/generate_mlp_header.py.
+//
+//   AnomalyBlobHeader (48 bytes, little-endian)
+//   float inputMin[inputs]     normalização: x * inputScale + inputMin
+//   float inputScale[inputs]
+//   float params[paramCount]   mesmo layout de anomaly_mlp_params
+//
+// A arquitetura continua compilada no firmware (tipo AnomalyMlp); o blob só
+// troca pesos, normalização e limite. layoutHash e shapeHash garantem que ele
+// foi gerado para as mesmas colunas de entrada e as mesmas camadas.
+
+#define ANOMALY_BLOB_MAGIC 0x4C444D41u  // "AMDL"
+#define ANOMALY_BLOB_SCHEMA_VERSION 1
+
+struct AnomalyBlobHeader {
+  uint32_t magic;
+  uint16_t schemaVersion;
+  uint16_t headerSize;
+  uint32_t sequence;      // Maior = mais novo; o ModelStore numera ao gravar
+  uint32_t modelVersion;  // Identificador livre do treino (ex.: data)
+  uint32_t layoutHash;    // anomalyFeatureLayoutHash das entradas
+  uint32_t shapeHash;     // tinymlp::Sequential::shapeHash das camadas
+  uint16_t inputs;
+  uint16_t reserved;
+  uint32_t paramCount;
+  float threshold;
+  uint32_t payloadSize;
+  uint32_t payloadCrc;    // CRC-32 (o mesmo do zlib) do payload
+  uint32_t headerCrc;     // CRC-32 dos campos acima
+};
+static_assert(sizeof(AnomalyBlobHeader) == 48, "o cabeçalho do blob tem layout fixo");
+
+// O que o firmware espera do blob
+struct AnomalyBlobExpect {
+  uint32_t layoutHash;
+  uint32_t shapeHash;
+  int inputs;
+  uint32_t paramCount;
+};
+
+// Ponteiros para dentro do blob (sem cópia; válidos enquanto ele estiver mapeado)
+struct AnomalyModelView {
+  const float* params;
+  const float* inputMin;
+  const float* inputScale;
+  float threshold;
+  uint32_t modelVersion;
+  uint32_t sequence;
+};
+
+uint32_t anomalyBlobCrc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+inline size_t anomalyBlobSize(const AnomalyBlobExpect& expect) {
+  return sizeof(AnomalyBlobHeader) + sizeof(float) * (2 * expect.inputs + expect.paramCount);
+}
+
+// Confere só o cabeçalho (magic, versão, CRC e compatibilidade); em caso de
+// falha, *error descreve o motivo
+bool anomalyBlobCheckHeader(const AnomalyBlobHeader& header, const AnomalyBlobExpect& expect, const char** error);
+// Confere o blob inteiro, inclusive o CRC do payload, e monta a view
+bool anomalyBlobParse(const uint8_t* blob, size_t size, const AnomalyBlobExpect& expect, AnomalyModelView* view,
+                      const char** error);
+// Recalcula headerCrc depois de alterar algum campo (ex.: sequence)
+void anomalyBlobSealHeader(AnomalyBlobHeader* header);
+
+#endif
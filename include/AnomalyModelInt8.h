@@ -0,0 +1,167 @@
+#ifndef ANOMALY_MODEL_INT8_H
+#define ANOMALY_MODEL_INT8_H
+
+// Gerado por scripts/TinyML_Module_9/quantize_mlp_header.py a partir de
+// anomaly_model.tflite, calibrado com network_metrics_dataset.csv.
+// Não edite à mão: rode o script novamente.
+//
+// Mesma arquitetura, entradas e normalização de AnomalyModelWeights.h; aqui só
+// os pesos e as ativações int8 (tinymlp::QuantParams de cada camada).
+
+#include <cstdint>
+#include "TinyMlp.h"
+
+constexpr uint32_t anomaly_mlp_int8_layout_hash = 0x5cbed57bu;
+constexpr uint32_t anomaly_mlp_int8_shape_hash = 0xdfb58526u;
+// Entrada normalizada e saída reconstruída: valor = (q - zero point) * escala
+constexpr float anomaly_mlp_int8_input_scale = 3.921568859e-03f;
+constexpr int32_t anomaly_mlp_int8_input_zero_point = -128;
+constexpr float anomaly_mlp_int8_output_scale = 3.906250000e-03f;
+constexpr int32_t anomaly_mlp_int8_output_zero_point = -128;
+// Pesos, bias e tabelas da Sigmoid em flash
+constexpr uint32_t anomaly_mlp_int8_flash_bytes = 856;
+// Limite: média + 2 desvios do erro de reconstrução do próprio modelo int8 no dataset
+constexpr float anomaly_model_int8_threshold = 7.216037919e-03f;
+
+// Camada 0: 2 -> 16 (Relu)
+constexpr int8_t anomaly_mlp_int8_weights_0[] = {
+  3, -7, -8, -4, 15, -16, -20, -24, -15, -13, -23, 7, 1, -30, 21, 0,
+  13, -23, 55, 6, 8, -16, 53, -18, -18, -1, -1, 35, 49, 31, -127, -2,
+};
+constexpr int32_t anomaly_mlp_int8_bias_0[] = {
+  -69, 2598, 2924, 0, 0, 3306, 3072, 2676,
+  -86, 3097, 2817, 2137, 0, 44, 46, 338,
+};
+
+// Camada 1: 16 -> 8 (Relu)
+constexpr int8_t anomaly_mlp_int8_weights_1[] = {
+  -10, -33, -15, -21, 31, -38, 6, 14, -5, 63, 10, 63, 10, -24, 55, -118,
+  0, -1, 3, 30, 29, 34, 14, 58, -41, 41, -32, -2, -39, -40, 81, -127,
+  19, -27, 37, -2, 11, -33, -51, -3, 45, 54, 14, 56, 35, -16, 82, -68,
+  -20, 41, 53, -27, 34, 5, 56, 44, 19, 21, 52, 32, -34, -11, -73, 124,
+  25, 29, 68, -8, -42, 68, 61, 44, 13, 47, 22, 25, -38, -54, -71, 80,
+  -13, -2, -46, 39, -20, 37, 30, 35, -10, -33, -48, 32, 30, -40, 5, 25,
+  4, -1, 60, 8, -44, 21, 71, -10, -12, 45, 35, 29, 36, -23, -63, 87,
+  32, 21, -2, 4, 31, -33, 15, -5, -45, 46, 19, 42, 3, 39, 93, -127,
+};
+constexpr int32_t anomaly_mlp_int8_bias_1[] = {
+  -289, 451, -693, 3567, 3568, -562, 3500, -245,
+};
+
+// Camada 2: 8 -> 4 (Relu)
+constexpr int8_t anomaly_mlp_int8_weights_2[] = {
+  18, -64, -13, 22, -32, 60, -27, -29, -112, -40, -127, 69, 84, -11, 73, -95,
+  58, 108, 59, -15, 21, -29, 27, 89, 42, 33, 52, -20, -56, -44, -52, 60,
+};
+constexpr int32_t anomaly_mlp_int8_bias_2[] = {
+  -46, 2038, -68, -195,
+};
+
+// Camada 3: 4 -> 8 (Relu)
+constexpr int8_t anomaly_mlp_int8_weights_3[] = {
+  56, -109, 5, 58, -75, 93, -127, -54, -43, -83, 21, 3, -51, 115, -69, 44,
+  48, -7, 52, 48, 66, -43, -33, 81, -74, 104, 30, -36, -18, -38, 58, 10,
+};
+constexpr int32_t anomaly_mlp_int8_bias_3[] = {
+  -299, 325, -1234, 607, -540, -344, 929, 784,
+};
+
+// Camada 4: 8 -> 16 (Relu)
+constexpr int8_t anomaly_mlp_int8_weights_4[] = {
+  -2, 27, -6, 3, 18, -38, 35, 10, -19, -13, 29, -26, 28, -7, -9, 12,
+  10, 18, -9, 23, -5, -36, 42, 4, 1, -45, -10, 18, 6, -19, 2, 3,
+  -2, 11, -10, 1, 8, 4, -15, 28, 20, -21, -20, -14, 8, 23, -7, -24,
+  -6, -20, 27, 15, 33, 30, -4, -11, 24, -11, -23, 4, -18, -9, -8, 2,
+  32, -15, 4, -13, 25, -4, 16, 0, -6, 25, -20, 29, -58, 0, -4, -127,
+  7, -8, -11, 27, 1, 7, -27, -15, -16, 34, -10, 35, 4, 13, 24, 0,
+  -2, 36, -22, 32, 14, -8, -7, -4, -17, -20, -8, -3, -11, -26, -24, 19,
+  35, -20, 13, 2, 29, -7, 6, -13, -20, 4, 20, 14, 3, -28, 18, 20,
+};
+constexpr int32_t anomaly_mlp_int8_bias_4[] = {
+  618, -750, 563, -4, -551, 0, -197, 0,
+  -320, 226, 0, 580, 654, 0, -345, 542,
+};
+
+// Camada 5: 16 -> 2 (Sigmoid)
+constexpr int8_t anomaly_mlp_int8_weights_5[] = {
+  -27, 19, -47, 22, 36, 32, 26, -19, 41, -34, 34, -1, -50, 20, 20, -53,
+  -29, 3, -39, 84, 25, 22, 18, 15, 2, -127, 23, -60, -1, 37, 44, -44,
+};
+constexpr int32_t anomaly_mlp_int8_bias_5[] = {
+  -844, -751,
+};
+// Sigmoid: saída int8 para cada entrada + 128
+constexpr int8_t anomaly_mlp_int8_sigmoid_5[256] = {
+  -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+  -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+  -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -127, -127, -127, -127, -127,
+  -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127,
+  -127, -127, -127, -126, -126, -126, -126, -126, -126, -126, -126, -126, -126, -126, -125, -125,
+  -125, -125, -125, -125, -125, -124, -124, -124, -124, -124, -123, -123, -123, -123, -123, -122,
+  -122, -122, -121, -121, -121, -121, -120, -120, -119, -119, -119, -118, -118, -117, -117, -116,
+  -116, -115, -115, -114, -113, -113, -112, -111, -111, -110, -109, -108, -107, -106, -105, -104,
+  -103, -102, -101, -100, -99, -98, -96, -95, -94, -92, -91, -89, -88, -86, -85, -83,
+  -81, -79, -77, -75, -73, -71, -69, -67, -65, -63, -61, -58, -56, -53, -51, -48,
+  -46, -43, -40, -38, -35, -32, -29, -27, -24, -21, -18, -15, -12, -9, -6, -3,
+  0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 29, 32, 35, 38, 40, 43,
+  46, 48, 51, 53, 56, 58, 61, 63, 65, 67, 69, 71, 73, 75, 77, 79,
+  81, 83, 85, 86, 88, 89, 91, 92, 94, 95, 96, 98, 99, 100, 101, 102,
+  103, 104, 105, 106, 107, 108, 109, 110, 111, 111, 112, 113, 113, 114, 115, 115,
+  116, 116, 117, 117, 118, 118, 119, 119, 119, 120, 120, 121, 121, 121, 121, 122,
+};
+
+constexpr tinymlp::QuantParams anomaly_mlp_int8_layers[] = {
+  { anomaly_mlp_int8_weights_0, anomaly_mlp_int8_bias_0, 128, -128, 1821447506, -6, -128, 127, nullptr },
+  { anomaly_mlp_int8_weights_1, anomaly_mlp_int8_bias_1, 128, -128, 1590198166, -7, -128, 127, nullptr },
+  { anomaly_mlp_int8_weights_2, anomaly_mlp_int8_bias_2, 128, -128, 1983000169, -8, -128, 127, nullptr },
+  { anomaly_mlp_int8_weights_3, anomaly_mlp_int8_bias_3, 128, -128, 1772351205, -6, -128, 127, nullptr },
+  { anomaly_mlp_int8_weights_4, anomaly_mlp_int8_bias_4, 128, -128, 1668136644, -5, -128, 127, nullptr },
+  { anomaly_mlp_int8_weights_5, anomaly_mlp_int8_bias_5, 128, 48, 1274858242, -7, -128, 127, anomaly_mlp_int8_sigmoid_5 },
+};
+
+// Saídas int8 esperadas para anomaly_mlp_reference_inputs (AnomalyModelWeights.h)
+constexpr int anomaly_mlp_int8_reference_count = 40;
+constexpr int8_t anomaly_mlp_int8_reference_outputs[][2] = {
+  {-127, -128},
+  {-98, -107},
+  {-53, -73},
+  {32, -12},
+  {106, 63},
+  {122, 98},
+  {-124, -127},
+  {-81, -89},
+  {-29, -51},
+  {71, 24},
+  {115, 81},
+  {51, -24},
+  {-104, -111},
+  {-58, -67},
+  {12, -18},
+  {89, 43},
+  {6, -51},
+  {63, -9},
+  {-71, -77},
+  {-29, -43},
+  {35, -3},
+  {-40, -75},
+  {21, -40},
+  {79, 18},
+  {-51, -58},
+  {-3, -27},
+  {-77, -94},
+  {-27, -65},
+  {43, -12},
+  {108, 61},
+  {-27, -40},
+  {-110, -116},
+  {-71, -89},
+  {-6, -46},
+  {85, 32},
+  {119, 86},
+  {58, -15},
+  {-15, -35},
+  {122, 98},
+  {-83, -91},
+};
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef ANOMALY_MODEL_WEIGHTS_H
+#define ANOMALY_MODEL_WEIGHTS_H
+
+// Gerado por scripts/TinyML_Module_9/generate_mlp_header.py a partir de
+// anomaly_model.tflite. Não edite à mão: rode o script novamente.
+
+#include <cstdint>
+#include "TinyMlp.h"
+
+typedef tinymlp::Sequential<
+    tinymlp::Dense<2, 16, tinymlp::Activation::Relu>,
+    tinymlp::Dense<16, 8, tinymlp::Activation::Relu>,
+    tinymlp::Dense<8, 4, tinymlp::Activation::Relu>,
+    tinymlp::Dense<4, 8, tinymlp::Activation::Relu>,
+    tinymlp::Dense<8, 16, tinymlp::Activation::Relu>,
+    tinymlp::Dense<16, 2, tinymlp::Activation::Sigmoid>
+> AnomalyMlp;
+
+// Entradas: packet_count, total_bytes (prefixo de AnomalyFeatures.def)
+constexpr uint32_t anomaly_mlp_layout_hash = 0x5cbed57bu;
+// Normalização do treino (MinMaxScaler.min_ e scale_): x * scale + min
+constexpr float anomaly_mlp_input_min[2] = { -2.390955694e-03f, -6.702900503e-04f };
+constexpr float anomaly_mlp_input_scale[2] = { 9.839323842e-06f, 8.471708526e-09f };
+// Limite de anomalia: média + 2 desvios do erro de reconstrução no treino
+constexpr float anomaly_mlp_threshold = 6.252898358e-03f;
+
+// Pesos ([saída][entrada], linha a linha) seguidos do bias de cada camada
+constexpr float anomaly_mlp_params[AnomalyMlp::paramCount] = {
+  // Camada 0: 2 -> 16 (Relu)
+  6.190756708e-02f, -1.573821157e-01f,
+  -1.801356822e-01f, -9.024833888e-02f,
+  3.291533291e-01f, -3.566993773e-01f,
+  -4.444948435e-01f, -5.432088375e-01f,
+  -3.272888660e-01f, -2.960507572e-01f,
+  -5.072112083e-01f, 1.654002219e-01f,
+  1.578017697e-02f, -6.786810160e-01f,
+  4.665906429e-01f, 9.504595771e-03f,
+  2.910519838e-01f, -5.091417432e-01f,
+  1.213718176e+00f, 1.391717345e-01f,
+  1.681588590e-01f, -3.467645943e-01f,
+  1.171889305e+00f, -4.103774726e-01f,
+  -3.974025249e-01f, -2.206134796e-02f,
+  -2.969790250e-02f, 7.847616673e-01f,
+  1.091217637e+00f, 6.952864528e-01f,
+  -2.827945471e+00f, -3.613334894e-02f,
+  -5.993313622e-03f, 2.268738151e-01f, 2.553051114e-01f, 0.000000000e+00f, 0.000000000e+00f, 2.886482775e-01f, 2.682822645e-01f, 2.337121367e-01f, -7.538685575e-03f, 2.704380453e-01f, 2.459800988e-01f, 1.866472661e-01f, 0.000000000e+00f, 3.814631142e-03f, 4.036667291e-03f, 2.955244854e-02f,
+  // Camada 1: 16 -> 8 (Relu)
+  -1.073521376e-01f, -3.570096493e-01f, -1.665184796e-01f, -2.230120897e-01f, 3.354192972e-01f, -4.083751738e-01f, 6.694801152e-02f, 1.500746310e-01f, -4.993610457e-02f, 6.810222864e-01f, 1.055675745e-01f, 6.804139018e-01f, 1.054240465e-01f, -2.652999461e-01f, 5.983940959e-01f, -1.281650305e+00f,
+  -1.582519151e-03f, -1.509602275e-02f, 2.974435873e-02f, 3.236631155e-01f, 3.106690645e-01f, 3.714851737e-01f, 1.535388082e-01f, 6.351494193e-01f, -4.424692690e-01f, 4.440700412e-01f, -3.440957069e-01f, -1.718907990e-02f, -4.271718264e-01f, -4.381587207e-01f, 8.823484778e-01f, -1.379504442e+00f,
+  2.024233341e-01f, -2.946010232e-01f, 4.002587497e-01f, -2.087581158e-02f, 1.208034754e-01f, -3.543420434e-01f, -5.565302372e-01f, -3.157260269e-02f, 4.859096110e-01f, 5.858985186e-01f, 1.562384814e-01f, 6.086430550e-01f, 3.798364401e-01f, -1.769106984e-01f, 8.931114674e-01f, -7.431214452e-01f,
+  -2.120995075e-01f, 4.461073875e-01f, 5.739645362e-01f, -2.880324125e-01f, 3.668692112e-01f, 5.890773609e-02f, 6.103267670e-01f, 4.727421999e-01f, 2.069563419e-01f, 2.314296961e-01f, 5.605417490e-01f, 3.450266719e-01f, -3.734649420e-01f, -1.140725389e-01f, -7.914862037e-01f, 1.347451210e+00f,
+  2.738488615e-01f, 3.195079863e-01f, 7.389681339e-01f, -8.861923218e-02f, -4.549244642e-01f, 7.389397025e-01f, 6.664770842e-01f, 4.732693136e-01f, 1.376129091e-01f, 5.111011863e-01f, 2.405394614e-01f, 2.689834535e-01f, -4.162347317e-01f, -5.857148767e-01f, -7.683425546e-01f, 8.682879210e-01f,
+  -1.440825015e-01f, -2.410447784e-02f, -5.034449100e-01f, 4.231158495e-01f, -2.190200090e-01f, 3.995289505e-01f, 3.260683119e-01f, 3.839026093e-01f, -1.081357077e-01f, -3.564013541e-01f, -5.188375711e-01f, 3.427443504e-01f, 3.234326839e-01f, -4.356013238e-01f, 5.390269309e-02f, 2.686393857e-01f,
+  4.795460775e-02f, -8.037285879e-03f, 6.466441751e-01f, 8.622157574e-02f, -4.778089523e-01f, 2.251878530e-01f, 7.669019699e-01f, -1.079330146e-01f, -1.296901256e-01f, 4.927277565e-01f, 3.853590488e-01f, 3.188745081e-01f, 3.869985342e-01f, -2.540336847e-01f, -6.790708303e-01f, 9.417146444e-01f,
+  3.503135443e-01f, 2.258417755e-01f, -2.539763041e-02f, 4.667747021e-02f, 3.373116255e-01f, -3.595446944e-01f, 1.627391130e-01f, -5.844710395e-02f, -4.846793115e-01f, 5.031551123e-01f, 2.029110491e-01f, 4.537392557e-01f, 3.180801868e-02f, 4.258503914e-01f, 1.008632541e+00f, -1.375045419e+00f,
+  -2.071173117e-02f, 3.230300546e-02f, -4.962950200e-02f, 2.552943230e-01f, 2.553657591e-01f, -4.020896927e-02f, 2.504667342e-01f, -1.750456356e-02f,
+  // Camada 2: 8 -> 4 (Relu)
+  1.793289185e-01f, -6.291590333e-01f, -1.314043254e-01f, 2.173779756e-01f, -3.148641586e-01f, 5.905299187e-01f, -2.673195601e-01f, -2.822431028e-01f,
+  -1.103608847e+00f, -3.968543112e-01f, -1.247676373e+00f, 6.822033525e-01f, 8.257027864e-01f, -1.042145565e-01f, 7.167355418e-01f, -9.356538057e-01f,
+  5.699710250e-01f, 1.062207103e+00f, 5.840703249e-01f, -1.516084075e-01f, 2.077242136e-01f, -2.826855779e-01f, 2.673730552e-01f, 8.714358807e-01f,
+  4.135624468e-01f, 3.246427476e-01f, 5.086550713e-01f, -1.962890625e-01f, -5.482599735e-01f, -4.278510213e-01f, -5.104392767e-01f, 5.857717991e-01f,
+  -5.557986442e-03f, 2.477042526e-01f, -8.214764297e-03f, -2.364786714e-02f,
+  // Camada 3: 4 -> 8 (Relu)
+  4.388039708e-01f, -8.535487652e-01f, 3.676436841e-02f, 4.561082125e-01f,
+  -5.865014195e-01f, 7.314200997e-01f, -9.975517988e-01f, -4.258455038e-01f,
+  -3.372617662e-01f, -6.529553533e-01f, 1.623579115e-01f, 2.212217264e-02f,
+  -3.992245793e-01f, 9.058400989e-01f, -5.454109311e-01f, 3.428927660e-01f,
+  3.766507506e-01f, -5.238524079e-02f, 4.121962786e-01f, 3.768922985e-01f,
+  5.198293328e-01f, -3.373049200e-01f, -2.600396276e-01f, 6.350992322e-01f,
+  -5.802151561e-01f, 8.162517548e-01f, 2.332790047e-01f, -2.855772078e-01f,
+  -1.447716951e-01f, -2.978850603e-01f, 4.550197423e-01f, 7.979898900e-02f,
+  -7.900732756e-02f, 8.599839360e-02f, -3.265989721e-01f, 1.607628018e-01f, -1.429119706e-01f, -9.112223238e-02f, 2.458492219e-01f, 2.075459659e-01f,
+  // Camada 4: 8 -> 16 (Relu)
+  -3.089998476e-02f, 4.935768247e-01f, -1.162273064e-01f, 5.190435797e-02f, 3.299196362e-01f, -6.992332339e-01f, 6.473291516e-01f, 1.925524771e-01f,
+  -3.496409357e-01f, -2.383533120e-01f, 5.426395535e-01f, -4.850278795e-01f, 5.268263817e-01f, -1.321305633e-01f, -1.683607548e-01f, 2.294239402e-01f,
+  1.787365228e-01f, 3.261593580e-01f, -1.610128284e-01f, 4.311394989e-01f, -9.561320394e-02f, -6.730802059e-01f, 7.867354751e-01f, 7.479900122e-02f,
+  2.627837658e-02f, -8.317763209e-01f, -1.922518760e-01f, 3.269835114e-01f, 1.173911393e-01f, -3.456113040e-01f, 2.864241973e-02f, 6.333284080e-02f,
+  -3.105930053e-02f, 1.991183758e-01f, -1.867004037e-01f, 1.605437882e-02f, 1.563401520e-01f, 7.958124578e-02f, -2.739317715e-01f, 5.182349086e-01f,
+  3.694177866e-01f, -3.979859352e-01f, -3.639044762e-01f, -2.664937973e-01f, 1.496396065e-01f, 4.307307005e-01f, -1.360460520e-01f, -4.460270405e-01f,
+  -1.076707095e-01f, -3.779355288e-01f, 4.966687262e-01f, 2.764368653e-01f, 6.144836545e-01f, 5.640888810e-01f, -7.694076002e-02f, -2.059549689e-01f,
+  4.482349157e-01f, -2.107664347e-01f, -4.227615595e-01f, 7.839214802e-02f, -3.351286650e-01f, -1.647723913e-01f, -1.434153318e-01f, 3.736257553e-02f,
+  5.857713819e-01f, -2.801463902e-01f, 7.877263427e-02f, -2.357770950e-01f, 4.591138661e-01f, -7.787488401e-02f, 2.890677154e-01f, -2.189628314e-03f,
+  -1.100487709e-01f, 4.656972289e-01f, -3.735505939e-01f, 5.415340066e-01f, -1.067186236e+00f, -8.427143097e-03f, -6.702705473e-02f, -2.351734161e+00f,
+  1.386433840e-01f, -1.439777613e-01f, -2.050728798e-01f, 4.946032763e-01f, 2.249252796e-02f, 1.229135990e-01f, -4.963240623e-01f, -2.803667784e-01f,
+  -3.048845232e-01f, 6.387735009e-01f, -1.820244491e-01f, 6.433669925e-01f, 6.793226302e-02f, 2.465262264e-01f, 4.502672851e-01f, 1.273853821e-03f,
+  -3.216147795e-02f, 6.620734334e-01f, -3.988750577e-01f, 5.980519056e-01f, 2.654553354e-01f, -1.506122947e-01f, -1.313477010e-01f, -6.746520102e-02f,
+  -3.146295547e-01f, -3.679174185e-01f, -1.509820223e-01f, -6.315827370e-02f, -2.069305182e-01f, -4.892270565e-01f, -4.357153177e-01f, 3.475265503e-01f,
+  6.504814029e-01f, -3.769353628e-01f, 2.329563797e-01f, 4.016850889e-02f, 5.408160686e-01f, -1.257529855e-01f, 1.189700961e-01f, -2.455803305e-01f,
+  -3.765407205e-01f, 6.830222905e-02f, 3.645160496e-01f, 2.677274644e-01f, 5.526727811e-02f, -5.193367004e-01f, 3.296622932e-01f, 3.784096837e-01f,
+  2.350005507e-01f, -2.849066556e-01f, 2.138033956e-01f, -1.710070996e-03f, -2.093819827e-01f, 0.000000000e+00f, -7.479596883e-02f, 0.000000000e+00f, -1.215548143e-01f, 8.600592613e-02f, 0.000000000e+00f, 2.205671519e-01f, 2.484976798e-01f, 0.000000000e+00f, -1.313051879e-01f, 2.061661780e-01f,
+  // Camada 5: 16 -> 2 (Sigmoid)
+  -3.784835637e-01f, 2.606058121e-01f, -6.434583664e-01f, 3.046632707e-01f, 4.914692342e-01f, 4.493823051e-01f, 3.659847975e-01f, -2.604511678e-01f, 5.702373385e-01f, -4.771261215e-01f, 4.715007544e-01f, -9.124334902e-03f, -6.889462471e-01f, 2.734001279e-01f, 2.781443000e-01f, -7.299966216e-01f,
+  -3.984802961e-01f, 3.972450644e-02f, -5.420234203e-01f, 1.166956544e+00f, 3.472685814e-01f, 2.999020815e-01f, 2.478165478e-01f, 2.055922747e-01f, 2.638254687e-02f, -1.756511807e+00f, 3.133298159e-01f, -8.349671960e-01f, -1.911349967e-02f, 5.179430246e-01f, 6.119139194e-01f, -6.136323214e-01f,
+  -1.828655899e-01f, -1.626371443e-01f,
+};
+
+// Saídas esperadas (float32, ordem do kernel de referência do TFLM)
+constexpr int anomaly_mlp_reference_count = 40;
+constexpr float anomaly_mlp_reference_inputs[][2] = {
+  {0.000000000e+00f, 0.000000000e+00f},
+  {1.000000015e-01f, 1.000000015e-01f},
+  {2.500000000e-01f, 2.500000000e-01f},
+  {5.000000000e-01f, 5.000000000e-01f},
+  {7.500000000e-01f, 7.500000000e-01f},
+  {1.000000000e+00f, 1.000000000e+00f},
+  {0.000000000e+00f, 1.000000015e-01f},
+  {1.000000015e-01f, 2.500000000e-01f},
+  {2.500000000e-01f, 5.000000000e-01f},
+  {5.000000000e-01f, 7.500000000e-01f},
+  {7.500000000e-01f, 1.000000000e+00f},
+  {1.000000000e+00f, 0.000000000e+00f},
+  {0.000000000e+00f, 2.500000000e-01f},
+  {1.000000015e-01f, 5.000000000e-01f},
+  {2.500000000e-01f, 7.500000000e-01f},
+  {5.000000000e-01f, 1.000000000e+00f},
+  {7.500000000e-01f, 0.000000000e+00f},
+  {1.000000000e+00f, 1.000000015e-01f},
+  {0.000000000e+00f, 5.000000000e-01f},
+  {1.000000015e-01f, 7.500000000e-01f},
+  {2.500000000e-01f, 1.000000000e+00f},
+  {5.000000000e-01f, 0.000000000e+00f},
+  {7.500000000e-01f, 1.000000015e-01f},
+  {1.000000000e+00f, 2.500000000e-01f},
+  {0.000000000e+00f, 7.500000000e-01f},
+  {1.000000015e-01f, 1.000000000e+00f},
+  {2.500000000e-01f, 0.000000000e+00f},
+  {5.000000000e-01f, 1.000000015e-01f},
+  {7.500000000e-01f, 2.500000000e-01f},
+  {1.000000000e+00f, 5.000000000e-01f},
+  {0.000000000e+00f, 1.000000000e+00f},
+  {1.000000015e-01f, 0.000000000e+00f},
+  {2.500000000e-01f, 1.000000015e-01f},
+  {5.000000000e-01f, 2.500000000e-01f},
+  {7.500000000e-01f, 5.000000000e-01f},
+  {1.000000000e+00f, 7.500000000e-01f},
+  {1.500000000e+00f, 5.000000075e-02f},
+  {5.000000075e-02f, 2.000000000e+00f},
+  {3.000000000e+00f, 3.000000000e+00f},
+  {-2.000000030e-01f, 4.000000060e-01f},
+};
+constexpr float anomaly_mlp_reference_outputs[][2] = {
+  {2.909406321e-03f, 2.641950268e-04f},
+  {1.218816563e-01f, 8.095557988e-02f},
+  {2.810280323e-01f, 2.102589905e-01f},
+  {6.242448688e-01f, 4.721127152e-01f},
+  {9.121248126e-01f, 7.633720636e-01f},
+  {9.830399156e-01f, 9.143499732e-01f},
+  {1.670464128e-02f, 6.076053716e-03f},
+  {1.878483295e-01f, 1.506194919e-01f},
+  {3.883117437e-01f, 3.142116964e-01f},
+  {7.787072659e-01f, 6.127305031e-01f},
+  {9.506301880e-01f, 8.371239305e-01f},
+  {7.014176846e-01f, 4.345918894e-01f},
+  {8.904779702e-02f, 6.501558423e-02f},
+  {2.762114108e-01f, 2.392276973e-01f},
+  {5.439953208e-01f, 4.369256496e-01f},
+  {8.520035148e-01f, 6.951099634e-01f},
+  {5.284019113e-01f, 3.155372739e-01f},
+  {7.469249368e-01f, 4.968138337e-01f},
+  {2.168082148e-01f, 1.938317418e-01f},
+  {3.800295293e-01f, 3.328889310e-01f},
+  {6.344230771e-01f, 5.043877363e-01f},
+  {3.424995542e-01f, 2.115831226e-01f},
+  {5.851225853e-01f, 3.726736605e-01f},
+  {8.114075661e-01f, 5.959391594e-01f},
+  {2.993272245e-01f, 2.782256007e-01f},
+  {4.859133065e-01f, 4.040862918e-01f},
+  {1.937986761e-01f, 1.344460547e-01f},
+  {3.935889602e-01f, 2.548899651e-01f},
+  {6.673095822e-01f, 4.679324031e-01f},
+  {9.221248627e-01f, 7.613455653e-01f},
+  {3.975876570e-01f, 3.481419683e-01f},
+  {7.493000478e-02f, 4.677227139e-02f},
+  {2.205479145e-01f, 1.559832394e-01f},
+  {4.759193063e-01f, 3.316079676e-01f},
+  {8.286954761e-01f, 6.435442567e-01f},
+  {9.635421038e-01f, 8.544407487e-01f},
+  {9.188163877e-01f, 7.018687725e-01f},
+  {7.272406816e-01f, 5.759740472e-01f},
+  {9.999994636e-01f, 9.998853207e-01f},
+  {5.014796043e-04f, 1.357461588e-05f},
+};
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef APP_CLASS_FOREST_H
+#define APP_CLASS_FOREST_H
+
+// Gerado por scripts/TinyML_Module_12/train_app_forest.py a partir de 3000 janelas sintéticas (app_common.synthetic_window).
+// Acerto por classe em janelas sintéticas novas: video 100.0%, call 100.0%, bulk 100.0%, gaming 100.0%, idle 99.5%.
+// Não edite à mão: rode o script novamente.
+
+#include <cstdint>
+#include "DecisionForest.h"
+
+// Características inteiras (ordem de app_forest_features) e classes (ordem dos votos)
+#define APP_FEATURES 11
+#define APP_CLASSES 5
+#define APP_FOREST_TREES 16
+#define APP_FOREST_MAX_DEPTH 6  // Comparações por árvore, no máximo
+
+constexpr const char* app_forest_features[APP_FEATURES] = {
+  "down_kbps", "up_kbps", "down_pps", "up_pps", "down_size", "up_size",
+  "down_large_pct", "up_small_pct", "gap_cv_pct", "active_pct", "up_share_pct",
+};
+constexpr const char* app_class_names[APP_CLASSES] = { "video", "call", "bulk", "gaming", "idle" };
+
+// 282 nós (1692 B): {característica, classe da folha, limiar, filho direito}
+constexpr forest::Node app_forest_nodes[] = {
+  // Árvore 0
+  { 10, 0, 5, 12 },
+  { 6, 0, 85, 7 },
+  { 9, 0, 75, 6 },
+  { 1, 0, 1, 5 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  { 7, 0, 87, 9 },
+  { forest::LEAF, 0, 0, 0 },
+  { 8, 0, 170, 11 },
+  { forest::LEAF, 2, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 2, 0, 23, 22 },
+  { 5, 0, 77, 17 },
+  { 2, 0, 3, 16 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 0, 0, 50, 19 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 62, 21 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 0, 0, 699, 32 },
+  { 4, 0, 380, 31 },
+  { 6, 0, 6, 28 },
+  { 10, 0, 73, 27 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 2, 0, 55, 30 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  // Árvore 1
+  { 9, 0, 75, 37 },
+  { 0, 0, 60, 36 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 0, 0, 3489, 41 },
+  { 7, 0, 35, 40 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  // Árvore 2
+  { 9, 0, 75, 46 },
+  { 2, 0, 67, 45 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 0, 0, 3494, 50 },
+  { 7, 0, 35, 49 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  // Árvore 3
+  { 10, 0, 5, 57 },
+  { 9, 0, 75, 56 },
+  { 1, 0, 1, 55 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  { 0, 0, 59, 71 },
+  { 3, 0, 18, 66 },
+  { 6, 0, 6, 65 },
+  { 5, 0, 223, 64 },
+  { 2, 0, 17, 63 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 8, 0, 152, 70 },
+  { 10, 0, 47, 69 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 6, 0, 6, 79 },
+  { 9, 0, 94, 76 },
+  { 7, 0, 60, 75 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 4, 0, 380, 78 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { 1, 0, 185, 81 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  // Árvore 4
+  { 10, 0, 5, 96 },
+  { 6, 0, 84, 87 },
+  { 3, 0, 1, 86 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 4, 0, 1248, 89 },
+  { forest::LEAF, 0, 0, 0 },
+  { 2, 0, 363, 93 },
+  { 8, 0, 178, 92 },
+  { forest::LEAF, 2, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 8, 0, 170, 95 },
+  { forest::LEAF, 2, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 2, 0, 23, 102 },
+  { 2, 0, 16, 99 },
+  { forest::LEAF, 4, 0, 0 },
+  { 5, 0, 118, 101 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 4, 0, 380, 110 },
+  { 7, 0, 58, 107 },
+  { 4, 0, 155, 106 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { 10, 0, 78, 109 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  // Árvore 5
+  { 9, 0, 75, 115 },
+  { 2, 0, 43, 114 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 7, 0, 35, 117 },
+  { forest::LEAF, 1, 0, 0 },
+  { 6, 0, 6, 119 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  // Árvore 6
+  { 10, 0, 5, 126 },
+  { 9, 0, 75, 125 },
+  { 1, 0, 1, 124 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  { 2, 0, 22, 132 },
+  { 10, 0, 13, 131 },
+  { 2, 0, 4, 130 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 35, 136 },
+  { 1, 0, 170, 135 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { 5, 0, 259, 138 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  // Árvore 7
+  { 6, 0, 64, 153 },
+  { 0, 0, 59, 144 },
+  { 9, 0, 45, 143 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 10, 0, 34, 148 },
+  { 4, 0, 380, 147 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { 7, 0, 35, 152 },
+  { 4, 0, 1144, 151 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 8, 0, 170, 157 },
+  { 0, 0, 43, 156 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  { 5, 0, 120, 161 },
+  { 0, 0, 1074, 160 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  // Árvore 8
+  { 9, 0, 75, 166 },
+  { 0, 0, 60, 165 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 6, 0, 45, 170 },
+  { 5, 0, 259, 169 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  // Árvore 9
+  { 10, 0, 5, 181 },
+  { 3, 0, 958, 178 },
+  { 8, 0, 169, 175 },
+  { forest::LEAF, 2, 0, 0 },
+  { 7, 0, 64, 177 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 8, 0, 170, 180 },
+  { forest::LEAF, 2, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 9, 0, 45, 183 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 35, 185 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  // Árvore 10
+  { 10, 0, 5, 192 },
+  { 8, 0, 170, 189 },
+  { forest::LEAF, 2, 0, 0 },
+  { 1, 0, 0, 191 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 9, 0, 45, 194 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 35, 196 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  // Árvore 11
+  { 9, 0, 75, 203 },
+  { 10, 0, 5, 202 },
+  { 3, 0, 32, 201 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 4, 0, 1148, 207 },
+  { 5, 0, 259, 206 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  // Árvore 12
+  { 10, 0, 5, 214 },
+  { 8, 0, 170, 211 },
+  { forest::LEAF, 2, 0, 0 },
+  { 7, 0, 80, 213 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 2, 0, 29, 222 },
+  { 0, 0, 47, 217 },
+  { forest::LEAF, 4, 0, 0 },
+  { 1, 0, 12, 219 },
+  { forest::LEAF, 3, 0, 0 },
+  { 5, 0, 258, 221 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 5, 0, 259, 226 },
+  { 8, 0, 168, 225 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 1, 0, 237, 230 },
+  { 0, 0, 58, 229 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  { 4, 0, 352, 232 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 1, 0, 0 },
+  // Árvore 13
+  { 9, 0, 75, 239 },
+  { 6, 0, 64, 236 },
+  { forest::LEAF, 4, 0, 0 },
+  { 10, 0, 5, 238 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 35, 241 },
+  { forest::LEAF, 1, 0, 0 },
+  { 7, 0, 88, 245 },
+  { 4, 0, 379, 244 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  { 4, 0, 380, 247 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  // Árvore 14
+  { 6, 0, 64, 260 },
+  { 0, 0, 60, 257 },
+  { 2, 0, 18, 254 },
+  { 2, 0, 17, 253 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 6, 0, 6, 256 },
+  { forest::LEAF, 3, 0, 0 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 35, 259 },
+  { forest::LEAF, 1, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+  { 8, 0, 170, 264 },
+  { 9, 0, 41, 263 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 2, 0, 0 },
+  { 2, 0, 15, 266 },
+  { forest::LEAF, 4, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  // Árvore 15
+  { 9, 0, 75, 277 },
+  { 6, 0, 64, 270 },
+  { forest::LEAF, 4, 0, 0 },
+  { 3, 0, 11, 272 },
+  { forest::LEAF, 4, 0, 0 },
+  { 7, 0, 85, 276 },
+  { 4, 0, 1282, 275 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { forest::LEAF, 0, 0, 0 },
+  { 7, 0, 35, 279 },
+  { forest::LEAF, 1, 0, 0 },
+  { 10, 0, 5, 281 },
+  { forest::LEAF, 2, 0, 0 },
+  { forest::LEAF, 3, 0, 0 },
+};
+constexpr uint16_t app_forest_roots[APP_FOREST_TREES] = { 0, 33, 42, 51, 82, 111, 120, 139, 162, 171, 186, 197, 208, 233, 248, 267 };
+
+// Janelas de referência e a classe que a floresta deu para cada uma no Python
+constexpr int app_forest_reference_count = 11;
+constexpr uint16_t app_forest_reference_inputs[][APP_FEATURES] = {
+  { 8297, 218, 746, 245, 1389, 111, 71, 88, 248, 28, 3 },
+  { 6073, 153, 568, 263, 1336, 73, 74, 91, 614, 58, 2 },
+  { 2653, 2407, 495, 407, 669, 739, 9, 8, 114, 96, 48 },
+  { 3207, 2091, 951, 502, 421, 520, 38, 25, 127, 97, 39 },
+  { 8297, 265, 814, 315, 1273, 105, 90, 99, 80, 89, 3 },
+  { 19511, 273, 1642, 528, 1485, 65, 97, 96, 85, 100, 1 },
+  { 107, 146, 97, 91, 137, 200, 6, 67, 83, 88, 58 },
+  { 211, 145, 104, 89, 253, 203, 6, 86, 26, 92, 41 },
+  { 1, 1, 0, 0, 367, 831, 60, 40, 584, 24, 54 },
+  { 1, 0, 0, 0, 1287, 286, 32, 26, 276, 27, 15 },
+  { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+};
+constexpr uint8_t app_forest_reference_labels[] = { 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 4 };
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef APP_CLASSIFIER_H
+#define APP_CLASSIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "AppClassForest.h"
+#include "FrameParser.h"
+
+// Módulo 12: o que cada estação está fazendo (streaming de vídeo, chamada de
+// vídeo, download, jogo online ou nada), mesmo com o tráfego criptografado.
+//
+// Tamanho, sentido e ritmo dos quadros continuam visíveis sob WPA2. Durante a
+// janela de 30 s do sniffer cada estação acumula taxas, tamanhos médios,
+// rajadas (CV do intervalo entre quadros) e segundos ativos; no fim da janela
+// as características inteiras de AppClassForest.h passam pela floresta de
+// decisão (DecisionForest.h, no máximo APP_FOREST_TREES * APP_FOREST_MAX_DEPTH
+// comparações por estação). No ciclo, a atividade de cada estação é a que
+// somou mais bytes: é ela que está ocupando o link.
+//
+// Tudo roda na task do sniffer (ou com ele parado); o resumo para as outras
+// tasks é publicado pelo TrafficAnalyzer.
+
+#define APP_MAX_STATIONS 32        // Estações por ciclo (88 B cada)
+#define APP_MIN_WINDOW_MS 5000     // Janela final mais curta que isso não é classificada
+#define APP_MAX_GAP_MS 5000        // Intervalos maiores são pausas, não entram no CV
+
+// Mesma ordem de app_class_names
+enum class AppActivity : uint8_t { Video, Call, Bulk, Gaming, Idle };
+
+struct StationActivity {
+  uint8_t mac[6];
+  AppActivity activity;  // A que somou mais bytes no ciclo
+  uint8_t share;         // % dos bytes do ciclo nessa atividade
+  uint8_t votes;         // Árvores que votaram na atividade da última janela
+  uint8_t windows;       // Janelas classificadas
+  uint32_t downKbps;     // Médias do ciclo
+  uint32_t upKbps;
+};
+
+class AppClassifier {
+public:
+  AppClassifier() { reset(); }
+
+  void onFrame(const ParsedFrame& frame);
+  // Fim da janela: classifica as estações vistas nela
+  void onWindowEnd();
+  // Fim do ciclo: classifica a janela incompleta, se durou o bastante
+  void endCycle();
+  // Início de um ciclo novo
+  void reset();
+
+  // Estações do ciclo, da que mais trafegou para a que menos; retorna quantas
+  size_t summarize(StationActivity* out, size_t maxOut) const;
+
+  static const char* activityName(AppActivity activity);
+  // Nome para as mensagens ("streaming de vídeo"...)
+  static const char* activityLabel(AppActivity activity);
+
+private:
+  // Zerada a cada janela
+  struct Window {
+    uint32_t rxBytes;
+    uint32_t txBytes;
+    uint32_t rxPackets;
+    uint32_t txPackets;
+    uint32_t rxLarge;        // Quadros de descida com 1000 B ou mais
+    uint32_t txSmall;        // Quadros de subida com menos de 200 B
+    uint32_t activeSeconds;  // Bit s = algum quadro no segundo s da janela
+    uint32_t lastRxUs;       // 0 = nenhum quadro de descida ainda
+    uint32_t gaps;           // Intervalos de descida (Welford)
+    float gapMean;
+    float gapM2;
+  };
+
+  struct Station {
+    uint64_t key;            // MAC em 48 bits; 0 = livre
+    Window window;
+    uint32_t classBytes[APP_CLASSES];  // Bytes das janelas de cada atividade no ciclo
+    uint32_t cycleRxBytes;
+    uint32_t cycleTxBytes;
+    uint8_t votes;
+    uint8_t windows;
+  };
+
+  Station _stations[APP_MAX_STATIONS];
+  uint32_t _windowStartMs;
+  uint32_t _lastMs;
+  uint32_t _cycleStartMs;
+  bool _windowStarted;
+  bool _cycleStarted;
+
+  Station* _station(const uint8_t* mac);
+  void _features(const Window& window, uint32_t windowMs, uint16_t* out) const;
+  void _classifyWindow();
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef AUTOENCODER_ENGINE_H
+#define AUTOENCODER_ENGINE_H
+
+#include <cstdint>
+#include "AnomalyEngine.h"
+#include "AnomalyModelBlob.h"
+#include "InferenceRuntime.h"
+#include "OnlineCalibrator.h"
+
+// Engine do autoencoder treinado no PC (scripts/TinyML_Module_9): o MLP
+// compilado por padrão (em int8 com -DANOMALY_MODEL_INT8) ou o TFLite Micro com
+// -DANOMALY_ENGINE_TFLM. O escore é
+// o erro médio absoluto de reconstrução. As inferências rodam pelo
+// InferenceRuntime, na arena compartilhada com os outros modelos.
+
+// Pontuação por dispositivo: baselines mantidos e tamanho do lote de inferência
+#define ANOMALY_MAX_DEVICES FEATURE_MAX_STATIONS
+#define ANOMALY_BATCH_SIZE 16
+
+struct DeviceScore {
+  uint8_t mac[6];
+  float error;
+  float threshold;
+  bool warm;       // Baseline do dispositivo já passou do aquecimento
+  bool anomalous;
+};
+
+class AutoencoderEngine : public AnomalyEngine, public InferenceModel {
+public:
+  AutoencoderEngine();
+
+  const char* name() const override { return "autoencoder"; }
+  bool begin() override;
+  bool evaluate(const FeatureVector& features, AnomalyScore* result) override;
+  float threshold() const override;
+  // Sem a arena, que é do InferenceRuntime
+  size_t memoryBytes() const override { return sizeof(*this); }
+
+  // InferenceModel: rascunho do lote (MLP) ou tensor_arena (TFLM)
+  const char* modelName() const override { return "autoencoder"; }
+  size_t arenaBytes() const override;
+  bool prepare(uint8_t* arena, size_t size) override;
+  bool invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) override;
+  size_t arenaUsedBytes() const override;
+
+  // Troca pesos, normalização e limite por um modelo mapeado da flash (ver
+  // ModelStore); os ponteiros precisam continuar válidos enquanto ele estiver
+  // em uso. Reinicia a calibração online, que depende da escala do erro.
+  void useModel(const AnomalyModelView& view);
+  // O que um blob precisa declarar para servir à arquitetura compilada
+  static AnomalyBlobExpect blobExpect();
+  // 0 = pesos compilados no firmware
+  uint32_t modelVersion() const { return _modelVersion; }
+
+  // Modo online: normalização e limite aprendidos na própria rede (ver
+  // OnlineCalibrator) em vez das constantes do treino. O estado é restaurado
+  // do NVS ao ativar e salvo periodicamente.
+  void setOnlineCalibration(bool enabled);
+  bool isOnlineCalibration() const { return _online; }
+  const OnlineCalibrator& calibrator() const { return _calibrator; }
+
+  // Pontua cada dispositivo do ciclo contra o próprio baseline, com a
+  // inferência em lotes de ANOMALY_BATCH_SIZE. Preenche 'top' com os que mais
+  // excederam o limite (erro / limite, decrescente) e retorna quantos.
+  size_t scoreDevices(const DeviceFeatures* devices, size_t count, DeviceScore* top, size_t maxTop);
+
+private:
+  bool _initialized = false;
+  bool _online = false;
+
+  // Modelo em uso: os arrays do AnomalyModelWeights.h ou um blob mapeado
+  const float* _params;
+  const float* _inputMin;
+  const float* _inputScale;
+  float _modelThreshold;
+  uint32_t _modelVersion = 0;
+
+  OnlineCalibrator _calibrator;
+
+  // Baseline de normalização e de erro de cada dispositivo (só em RAM)
+  struct DeviceBaseline {
+    uint64_t key;        // MAC em 48 bits; 0 = livre
+    uint32_t lastCycle;
+    OnlineCalibrator calibrator;
+  };
+  DeviceBaseline _devices[ANOMALY_MAX_DEVICES];
+  uint32_t _deviceCycle = 0;
+  DeviceBaseline& _deviceBaseline(const uint8_t* mac);
+
+  // Estatísticas de latência do Invoke (microssegundos)
+  uint32_t _invocations = 0;
+  uint64_t _totalInvokeUs = 0;
+  uint32_t _maxInvokeUs = 0;
+
+  // Roda o autoencoder: entradas normalizadas -> saídas reconstruídas
+  bool _infer(const float* in, float* out);
+  bool _inferBatch(const float* in, float* out, int n);
+  bool _score(const float* in, float* error);
+  bool _evaluateStatic(const FeatureVector& features, AnomalyScore* result);
+  bool _evaluateOnline(const FeatureVector& features, AnomalyScore* result);
+  void _loadCalibration();
+  void _saveCalibration();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef DECISION_FOREST_H
+#define DECISION_FOREST_H
+
+#include <cstdint>
+
+// Avaliação de florestas de decisão gravadas como tabelas constexpr (ver
+// scripts/TinyML_Module_12/train_app_forest.py).
+//
+// Cada árvore fica em ordem pré-fixada: o filho esquerdo de um nó é sempre o
+// nó seguinte e só o direito é guardado. As características são inteiras, então
+// cada passo é uma comparação de inteiros e a floresta inteira custa no máximo
+// árvores * profundidade comparações, sem ponto flutuante nem alocação. Tudo é
+// constexpr: o firmware confere a tabela contra os vetores de referência do
+// gerador com static_assert.
+
+namespace forest {
+
+constexpr uint8_t LEAF = 0xFF;
+
+struct Node {
+  uint8_t feature;     // Característica comparada; LEAF = folha
+  uint8_t label;       // Classe votada pela folha
+  uint16_t threshold;  // x[feature] <= threshold vai para o nó seguinte
+  uint16_t right;      // Índice do filho direito
+};
+
+constexpr uint8_t evalTree(const Node* nodes, uint16_t root, const uint16_t* x) {
+  uint16_t i = root;
+  while (nodes[i].feature != LEAF) {
+    i = (x[nodes[i].feature] <= nodes[i].threshold) ? (uint16_t)(i + 1) : nodes[i].right;
+  }
+  return nodes[i].label;
+}
+
+// Classe mais votada (empate: a de menor índice); 'votes', se dado, recebe os
+// votos de cada classe
+template <int Classes>
+constexpr int predict(const Node* nodes, const uint16_t* roots, int trees, const uint16_t* x,
+                      uint8_t* votes = nullptr) {
+  uint8_t counts[Classes] = {};
+  for (int t = 0; t < trees; t++) counts[evalTree(nodes, roots[t], x)]++;
+  int best = 0;
+  for (int k = 0; k < Classes; k++) {
+    if (votes != nullptr) votes[k] = counts[k];
+    if (counts[k] > counts[best]) best = k;
+  }
+  return best;
+}
+
+}  // namespace forest
+
+#endif
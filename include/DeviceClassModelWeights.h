@@ -0,0 +1,95 @@
+#ifndef DEVICE_CLASS_MODEL_WEIGHTS_H
+#define DEVICE_CLASS_MODEL_WEIGHTS_H
+
+// Gerado por scripts/TinyML_Module_11/generate_fingerprint_header.py a partir de
+// pesos a priori escritos à mão (prior_weights), sem treino.
+// Não edite à mão: rode o script novamente.
+
+#include <cstdint>
+#include "TinyMlp.h"
+
+// Características em [0, 1] (ordem das entradas) e classes (ordem das saídas)
+#define FINGERPRINT_FEATURES 24
+#define FINGERPRINT_CLASSES 5
+
+// Saída: logits; o softmax fica com o DeviceFingerprinter
+typedef tinymlp::Sequential<
+    tinymlp::Dense<24, 5, tinymlp::Activation::Linear>
+> DeviceClassModel;
+
+constexpr const char* device_class_features[FINGERPRINT_FEATURES] = {
+  "size_96", "size_160", "size_320", "size_640", "size_1200", "size_max",
+  "burstiness", "rate", "uplink_share", "dns_apple", "dns_google", "dns_microsoft",
+  "dns_streaming", "dns_camera", "dns_iot", "dns_diversity", "vendor_mobile", "vendor_pc",
+  "vendor_tv", "vendor_camera", "vendor_iot", "random_mac", "active_hours", "night",
+};
+constexpr const char* device_class_names[FINGERPRINT_CLASSES] = { "phone", "laptop", "tv", "camera", "iot" };
+
+// Pesos [classe][característica] e bias
+constexpr float device_class_params[DeviceClassModel::paramCount] = {
+  // phone
+  0.000000000e+00f, 5.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.000000000e+00f, 0.000000000e+00f, 5.000000000e-01f, 1.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, -2.000000000e+00f, -2.000000000e+00f, 0.000000000e+00f, 2.500000000e+00f, -1.500000000e+00f,
+  -2.000000000e+00f, -3.000000000e+00f, -3.000000000e+00f, 3.000000000e+00f, 5.000000000e-01f, 0.000000000e+00f,
+  // laptop
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f,
+  0.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 5.000000000e-01f, 0.000000000e+00f, 2.500000000e+00f,
+  0.000000000e+00f, -2.000000000e+00f, -2.000000000e+00f, 2.000000000e+00f, 0.000000000e+00f, 3.000000000e+00f,
+  -2.000000000e+00f, -3.000000000e+00f, -3.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  // tv
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.500000000e+00f,
+  0.000000000e+00f, 1.000000000e+00f, -2.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  3.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  3.000000000e+00f, 0.000000000e+00f, -1.000000000e+00f, -1.500000000e+00f, 0.000000000e+00f, -5.000000000e-01f,
+  // camera
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f,
+  -1.500000000e+00f, 0.000000000e+00f, 3.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 3.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, -2.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 3.500000000e+00f, 0.000000000e+00f, -2.500000000e+00f, 1.500000000e+00f, 1.000000000e+00f,
+  // iot
+  1.500000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, -1.500000000e+00f,
+  0.000000000e+00f, -2.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 3.000000000e+00f, -2.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 3.000000000e+00f, -2.500000000e+00f, 1.000000000e+00f, 5.000000000e-01f,
+  0.000000000e+00f, -5.000000000e-01f, -1.000000000e+00f, -1.500000000e+00f, -5.000000000e-01f,
+};
+
+// Logits esperados (float32, mesma ordem de operações da engine)
+constexpr int device_class_reference_count = 6;
+constexpr float device_class_reference_inputs[][FINGERPRINT_FEATURES] = {
+  { 3.000000119e-01f, 3.000000119e-01f, 1.000000015e-01f, 1.000000015e-01f, 1.000000015e-01f, 1.000000015e-01f,
+    8.000000119e-01f, 5.000000000e-01f, 3.000000119e-01f, 1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 5.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f, 2.000000030e-01f, 0.000000000e+00f, },
+  { 2.000000030e-01f, 1.000000015e-01f, 1.000000015e-01f, 1.000000015e-01f, 1.000000015e-01f, 4.000000060e-01f,
+    6.999999881e-01f, 6.999999881e-01f, 2.000000030e-01f, 0.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 8.000000119e-01f, 0.000000000e+00f, 1.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 3.000000119e-01f, 0.000000000e+00f, },
+  { 2.000000030e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 8.000000119e-01f,
+    6.000000238e-01f, 8.000000119e-01f, 5.000000075e-02f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 3.000000119e-01f, 0.000000000e+00f, 0.000000000e+00f,
+    1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 2.000000030e-01f, 0.000000000e+00f, },
+  { 1.000000015e-01f, 0.000000000e+00f, 0.000000000e+00f, 2.000000030e-01f, 2.000000030e-01f, 5.000000000e-01f,
+    3.000000119e-01f, 6.999999881e-01f, 8.999999762e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 1.000000015e-01f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 5.000000000e-01f, 1.000000000e+00f, },
+  { 6.000000238e-01f, 3.000000119e-01f, 1.000000015e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    5.000000000e-01f, 2.000000030e-01f, 5.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f, 1.000000015e-01f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 5.000000000e-01f, 1.000000000e+00f, },
+  { 2.000000030e-01f, 2.000000030e-01f, 2.000000030e-01f, 2.000000030e-01f, 1.000000015e-01f, 1.000000015e-01f,
+    5.000000000e-01f, 4.000000060e-01f, 5.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+    0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, },
+};
+constexpr float device_class_reference_outputs[][FINGERPRINT_CLASSES] = {
+  { 5.199999809e+00f, 2.599999905e+00f, -2.450000048e+00f, -3.900000095e+00f, -4.199999809e+00f },
+  { 5.000000000e-01f, 7.699999809e+00f, -1.000000238e-01f, -1.099999905e+00f, -3.400000095e+00f },
+  { -1.274999976e+00f, -2.999999523e-01f, 6.900000095e+00f, -1.149999976e+00f, -3.399999857e+00f },
+  { -4.000000000e+00f, -4.099999905e+00f, -1.849999905e+00f, 9.500000000e+00f, -1.700000048e+00f },
+  { -3.849999905e+00f, -5.099999905e+00f, -3.299999952e+00f, 1.000000000e+00f, 7.100000381e+00f },
+  { 8.500000238e-01f, 0.000000000e+00f, -1.450000048e+00f, -6.499999762e-01f, -9.500000477e-01f },
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef DEVICE_FINGERPRINT_H
+#define DEVICE_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include "DeviceClassModelWeights.h"
+#include "FrameParser.h"
+#include "InferenceRuntime.h"
+
+// Módulo 11: tipo de cada dispositivo novo (celular, notebook, TV, câmera ou
+// IoT) a partir dos primeiros minutos de tráfego dele.
+//
+// Durante o modo sniffer, cada quadro de/para um dispositivo ainda não
+// classificado alimenta um acumulador de tamanho fixo: histograma do tamanho
+// dos quadros, intervalos entre quadros (rajadas), bytes enviados/recebidos,
+// categorias dos domínios consultados e horas do dia com tráfego. Quando o
+// acumulador já viu o bastante (FINGERPRINT_MIN_*), classify() monta as
+// características de DeviceClassModelWeights.h, junta o fabricante pelo OUI e
+// roda o modelo uma única vez, pelo InferenceRuntime. O resultado vai para a
+// tabela de impressões digitais (salva no NVS) e o acumulador é liberado.
+//
+// onFrame() roda na task do sniffer; endCycle() e classify() na task que
+// para o sniffer, com ele parado. fingerprint()/snapshot() podem ser chamados
+// de qualquer task.
+
+#define FINGERPRINT_MAX_TRACKED 32    // Dispositivos acumulando ao mesmo tempo (64 B cada)
+#define FINGERPRINT_MAX_DEVICES 64    // Impressões digitais guardadas (40 B + 8 B de índice cada)
+#define FINGERPRINT_SIZE_BINS 6
+
+// Pronto para classificar: ciclos sniffer em que apareceu e quadros vistos. Um
+// dispositivo quieto é classificado com menos quadros depois de mais ciclos.
+#define FINGERPRINT_MIN_CYCLES 2
+#define FINGERPRINT_MIN_PACKETS 200
+#define FINGERPRINT_QUIET_CYCLES 5
+#define FINGERPRINT_QUIET_PACKETS 20
+// Ciclos seguidos sem aparecer até o acumulador ser descartado
+#define FINGERPRINT_IDLE_CYCLES 10
+// Abaixo desta probabilidade o tipo fica "unknown"
+#define FINGERPRINT_MIN_CONFIDENCE 60
+
+// Mesma ordem de device_class_names; Unknown = confiança baixa
+enum class DeviceType : uint8_t { Phone, Laptop, Tv, Camera, Iot, Unknown };
+
+// Fabricante pelo OUI, agrupado pelo tipo de aparelho que ele costuma fazer
+enum class OuiVendor : uint8_t { Unknown, Mobile, Pc, Tv, Camera, Iot };
+
+struct DeviceFingerprint {
+  uint8_t mac[6];
+  DeviceType type;
+  uint8_t confidence;   // Probabilidade do tipo, em %
+  OuiVendor vendor;
+  uint8_t reserved;
+  uint32_t sequence;    // Ordem de classificação (a mais antiga sai quando a tabela lota)
+  uint8_t features[FINGERPRINT_FEATURES];  // round(x * 255), para /fingerprints.csv
+};
+
+class DeviceFingerprinter : public InferenceModel {
+public:
+  DeviceFingerprinter();
+  // Restaura a tabela do NVS e registra o modelo no InferenceRuntime
+  void setup();
+
+  void onFrame(const ParsedFrame& frame);
+  // Fim de um ciclo sniffer: conta o ciclo e marca a hora local (se o relógio
+  // estiver acertado) para quem apareceu nele
+  void endCycle(time_t now);
+  // Classifica os acumuladores prontos; copia para 'fresh' até 'maxFresh'
+  // dispositivos recém-classificados e retorna quantos
+  size_t classify(DeviceFingerprint* fresh, size_t maxFresh);
+
+  bool fingerprint(const uint8_t* mac, DeviceFingerprint* out) const;
+  size_t snapshot(DeviceFingerprint* out, size_t maxOut) const;
+  size_t trackedCount() const;
+
+  static const char* typeName(DeviceType type);
+  // Nome para as mensagens ("câmera", "não identificado"...)
+  static const char* typeLabel(DeviceType type);
+  static const char* vendorName(OuiVendor vendor);
+  // Fabricante pelo OUI; 'maker' recebe o nome dele (ou nullptr se desconhecido)
+  static OuiVendor lookupVendor(const uint8_t* mac, const char** maker = nullptr);
+
+  // InferenceModel: regressão logística, sem camadas ocultas nem arena
+  const char* modelName() const override { return "fingerprint"; }
+  size_t arenaBytes() const override { return 0; }
+  bool invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) override;
+
+private:
+  struct Accumulator {
+    uint64_t key;              // MAC em 48 bits; 0 = livre
+    uint32_t txBytes;
+    uint32_t rxBytes;
+    uint32_t packets;
+    uint32_t activeMs;         // Tempo de captura dos ciclos em que apareceu
+    uint16_t sizeBins[FINGERPRINT_SIZE_BINS];
+    uint32_t lastUs;           // Último quadro do ciclo (0 = nenhum ainda)
+    uint32_t gaps;             // Intervalos entre quadros (Welford)
+    float gapMean;
+    float gapM2;
+    uint32_t domains;          // Bitmap dos domínios consultados
+    uint32_t hours;            // Bit h = tráfego na hora local h
+    uint8_t dnsCategories;
+    uint8_t cycles;
+    uint8_t idleCycles;
+    bool seenInCycle;
+  };
+
+  Accumulator _tracked[FINGERPRINT_MAX_TRACKED];
+  DeviceFingerprint _devices[FINGERPRINT_MAX_DEVICES];
+  uint64_t _deviceKeys[FINGERPRINT_MAX_DEVICES];  // Índice de _devices; 0 = livre
+  size_t _deviceCount = 0;
+  uint32_t _sequence = 0;
+
+  uint32_t _cycleFirstMs = 0;
+  uint32_t _cycleLastMs = 0;
+  bool _cycleStarted = false;
+
+  void* _mutex = nullptr;  // SemaphoreHandle_t; protege _devices para as outras tasks
+
+  Accumulator* _accumulator(uint64_t key);
+  int _deviceSlot(uint64_t key) const;
+  void _store(const DeviceFingerprint& entry);
+  void _rebuildTracked();
+  void _features(const Accumulator& acc, const uint8_t* mac, float* out) const;
+  void _noteDns(Accumulator& acc, const ParsedFrame& frame);
+  void _lock() const;
+  void _unlock() const;
+  void _load();
+  void _save();
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef DEVICE_PROFILE_H
+#define DEVICE_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+// Perfil de comportamento de cada MAC conhecido, atualizado a cada janela do
+// sniffer só com aritmética inteira.
+//
+// Bytes e pacotes por minuto entram em log2 (Q8.8): o tráfego de um
+// dispositivo varia em ordens de grandeza, e no log o desvio de k sigmas vira
+// um fator ("8x o normal"), igual para um sensor e para uma TV. Média e
+// variância são EWMA (alfa = 1 / 2^PROFILE_EWMA_SHIFT; média simples nas
+// primeiras janelas). Depois de PROFILE_MIN_WINDOWS janelas, uma janela a mais
+// de k sigmas marca o dispositivo e entra na média recortada em k sigmas, para
+// um surto não virar o novo normal. Também são marcados o tráfego numa hora do
+// dia em que o dispositivo nunca tinha aparecido (depois de alguns dias de
+// histórico) e uma janela em que quase todos os destinos são novos.
+//
+// São 40 bytes por perfil em uma tabela fixa. Com a tabela cheia, o perfil
+// visto há mais tempo vai para o NVS (PROFILE_FLASH_SPILL) e volta quando o
+// dispositivo reaparece.
+//
+// update() roda na task do sniffer; snapshot()/deviations() podem ser
+// chamados de qualquer task.
+
+#define PROFILE_MAX_DEVICES 128      // Perfis na RAM (40 B cada)
+#define PROFILE_INDEX_SIZE 256       // Índice de endereçamento aberto (1 B por posição)
+#ifndef PROFILE_FLASH_SPILL
+#define PROFILE_FLASH_SPILL 1        // 0 = perfis expulsos da RAM são descartados
+#endif
+#define PROFILE_SPILL_SLOTS 64       // Perfis guardados no NVS
+#define PROFILE_SPILL_PER_BLOB 16    // Perfis por blob do NVS (640 B)
+
+#define PROFILE_EWMA_SHIFT 4         // Alfa = 1/16: meia-vida de ~11 janelas
+#define PROFILE_MIN_WINDOWS 20       // Janelas de histórico antes de marcar desvios
+#define PROFILE_K_SIGMA 4            // Padrão de setKSigma()
+#define PROFILE_MIN_SIGMA 128        // Sigma mínimo em log2 Q8.8 (0.5 = fator 1.4)
+#define PROFILE_PEER_EPOCH 32        // Janelas por época do bitmap de destinos
+#define PROFILE_NOVEL_PEERS_MIN 4    // Destinos na janela para avaliar a novidade
+#define PROFILE_NOVEL_PEERS_PCT 75   // % de destinos novos que marca a janela
+#define PROFILE_HOUR_MIN_DAYS 7      // Dias de histórico antes de estranhar o horário
+
+enum ProfileFlag : uint8_t {
+  PROFILE_FLAG_BYTES = 0x01,    // Bytes/min a mais de k sigmas
+  PROFILE_FLAG_PACKETS = 0x02,  // Pacotes/min a mais de k sigmas
+  PROFILE_FLAG_HOUR = 0x04,     // Hora do dia em que nunca tinha trafegado
+  PROFILE_FLAG_PEERS = 0x08,    // Quase todos os destinos da janela são novos
+};
+
+struct DeviceProfile {
+  uint8_t mac[6];
+  uint16_t windows;        // Janelas observadas (satura)
+  uint16_t bytesMean;      // log2(1 + bytes/min), Q8.8
+  uint16_t bytesVar;       // Variância do log2, Q8.8
+  uint16_t packetsMean;    // log2(1 + pacotes/min), Q8.8
+  uint16_t packetsVar;
+  uint32_t activeHours;    // Bits 0-23: horas locais com tráfego; 24-31: dias distintos (satura)
+  uint32_t lastSeen;       // Ordem da última atualização (o menor sai da RAM primeiro)
+  uint32_t peers;          // Bitmap (hash do IP remoto) dos destinos desta época
+  uint32_t peersPrevious;  // ... e da época anterior
+  uint16_t lastDay;        // Dia (desde 1970) da última janela com o relógio acertado
+  uint8_t peerEpoch;       // Janelas na época atual
+  uint8_t flags;           // ProfileFlag do ciclo atual
+  int8_t bytesZ;           // Último desvio, em décimos de sigma (satura em ±12.7)
+  int8_t packetsZ;
+  uint8_t reserved[2];
+};
+
+class DeviceProfileStore {
+public:
+  DeviceProfileStore();
+  // Cria o mutex e carrega o índice dos perfis guardados no NVS
+  void setup();
+  void setKSigma(uint8_t k) { _kSigma = k; }
+  uint8_t kSigma() const { return _kSigma; }
+
+  // Início de um ciclo sniffer: zera as marcas do ciclo anterior
+  void beginCycle();
+  // Uma janela de um dispositivo; 'peers' é o bitmap dos IPs remotos da
+  // janela. Retorna as ProfileFlag da janela.
+  uint8_t update(const uint8_t* mac, uint32_t bytesPerMin, uint32_t packetsPerMin, uint32_t peers, time_t now);
+
+  // Perfis marcados no ciclo, do maior desvio para o menor; retorna quantos
+  size_t deviations(DeviceProfile* out, size_t maxOut) const;
+  size_t snapshot(DeviceProfile* out, size_t maxOut) const;
+  size_t count() const { return _count; }
+  size_t spilledCount() const;
+
+  // log2(x) em Q8.8, com a mantissa interpolada linearmente (erro < 0.09)
+  static uint16_t log2q8(uint32_t x);
+  // Valor típico (2^média - 1) e fator de um sigma (2^sigma), para exibição
+  static float typicalValue(uint16_t meanQ8);
+  static float sigmaFactor(uint16_t varQ8);
+
+private:
+  DeviceProfile _profiles[PROFILE_MAX_DEVICES];
+  uint8_t _index[PROFILE_INDEX_SIZE];  // Posição + 1 em _profiles; 0 = livre
+  size_t _count = 0;
+  uint32_t _sequence = 0;
+  uint8_t _kSigma = PROFILE_K_SIGMA;
+
+  uint32_t _spillKeys[PROFILE_SPILL_SLOTS];  // Hash do MAC de cada perfil no NVS; 0 = livre
+  uint8_t _spillNext = 0;                    // Próxima posição do anel no NVS
+
+  void* _mutex = nullptr;  // SemaphoreHandle_t
+
+  DeviceProfile* _find(const uint8_t* mac);
+  DeviceProfile* _insert(const uint8_t* mac);
+  void _rebuildIndex();
+  bool _updateMetric(uint16_t& mean, uint16_t& var, uint16_t x, uint16_t windows, int8_t& z) const;
+  void _spill(const DeviceProfile& profile);
+  bool _restore(const uint8_t* mac, DeviceProfile* out);
+  void _lock() const;
+  void _unlock() const;
+};
+
+#endif
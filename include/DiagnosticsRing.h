@@ -0,0 +1,49 @@
+#ifndef DIAGNOSTICS_RING_H
+#define DIAGNOSTICS_RING_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Histórico das verificações de internet do modo monitor (uma por minuto):
+// tempo do HTTP GET, da consulta DNS, RTT médio e perda de uma rajada de
+// pings. Alimenta o OutagePredictor e, exportado como CSV (/diagnostics.csv),
+// o treino do modelo em scripts/TinyML_Module_10.
+//
+// Anel de tamanho fixo (12 bytes por amostra, ~8,5 h com 512). Cada amostra
+// tem um índice absoluto crescente, de modo que um leitor que percorre o anel
+// aos pedaços percebe quando o produtor sobrescreveu o que ainda faltava ler.
+
+#define DIAG_RING_CAPACITY 512
+#define DIAG_FAILED 0xFFFF  // Medida sem resposta (timeout ou erro)
+
+#define DIAG_FLAG_ONLINE 0x01  // Veredito da verificação
+#define DIAG_FLAG_EPOCH 0x02   // 'time' é epoch (SNTP); senão, segundos desde o boot
+
+struct DiagnosticSample {
+  uint32_t time;
+  uint16_t httpMs;  // Até o 204 do generate_204
+  uint16_t dnsMs;   // Consulta A direta ao servidor DNS, sem o cache do lwIP
+  uint16_t rttMs;   // Média dos pings respondidos
+  uint8_t lossPct;
+  uint8_t flags;
+};
+static_assert(sizeof(DiagnosticSample) == 12, "amostra do histórico com layout fixo");
+
+class DiagnosticsRing {
+public:
+  void push(const DiagnosticSample& sample);
+
+  size_t count() const;
+  // Índice absoluto da amostra mais antiga ainda no anel e da próxima a gravar
+  uint32_t oldest() const { return _total - (uint32_t)count(); }
+  uint32_t total() const { return _total; }
+  bool get(uint32_t index, DiagnosticSample* sample) const;
+  // As últimas n amostras, da mais antiga para a mais recente; retorna quantas
+  size_t latest(DiagnosticSample* out, size_t n) const;
+
+private:
+  DiagnosticSample _samples[DIAG_RING_CAPACITY];
+  uint32_t _total = 0;
+};
+
+#endif
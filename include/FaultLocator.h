@@ -0,0 +1,60 @@
+#ifndef FAULT_LOCATOR_H
+#define FAULT_LOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Onde está a falha quando a internet cai, camada por camada.
+//
+// NetworkDiagnostics::diagnose() dispara numa única rodada do ProbeEngine:
+// ping e TCP connect ao gateway, ecos com TTL 2 e 3 (o primeiro salto do
+// provedor e o seguinte, que respondem com Time Exceeded) e um ping ao salto
+// do provedor já aprendido, consultas DNS ao resolvedor da rede e a dois
+// públicos, ping e TCP connect a IPs anycast públicos e o HTTP generate_204.
+// classify() lê o FaultReport de baixo para cima e para na primeira camada
+// que não responde.
+//
+// Reiniciar o roteador só ajuda quando a falha pode ser dele (rebootHelps()):
+// Wi-Fi sem associação (o AP é o roteador), gateway mudo, só o DNS do
+// roteador parado ou nada depois do gateway (IspLink: também é o que uma
+// sessão PPPoE/DHCP da WAN travada no roteador produz). Quando o salto do
+// provedor responde e a internet não, ou só o DNS de fora caiu, o reboot só
+// somaria minutos de queda.
+
+enum class FaultVerdict : uint8_t {
+  Healthy,      // Internet de pé
+  WifiLink,     // ESP32 sem associação ao AP
+  RouterHung,   // Associado, mas o gateway não responde nem a ping nem a TCP
+  RouterDns,    // Tudo responde, menos o DNS do roteador (os públicos respondem)
+  DnsOnly,      // IPs públicos respondem, nenhum resolvedor responde
+  IspLink,      // Gateway responde, nada depois dele
+  IspUpstream,  // O salto do provedor responde, a internet não
+};
+
+struct FaultReport {
+  FaultVerdict verdict;
+  bool wifi;            // Associado ao AP
+  int8_t rssi;
+  bool gateway;         // Gateway respondeu a ping ou TCP
+  bool gatewayArp;      // MAC do gateway no cache ARP (informativo)
+  bool ispEdge;         // Algum salto depois do gateway respondeu
+  bool publicIp;        // Algum IP anycast público respondeu (ping ou TCP)
+  bool http;            // generate_204 respondeu
+  bool dnsNetwork;      // Resolvedor da rede respondeu
+  bool dnsNetworkLocal; // ... e ele é o próprio roteador (endereço privado)
+  bool dnsPublic;       // Algum resolvedor público respondeu
+  uint32_t ispHop;      // Salto do provedor (ordem de rede), 0 se desconhecido
+  uint16_t elapsedMs;
+};
+
+class FaultLocator {
+public:
+  static FaultVerdict classify(const FaultReport& report);
+  static bool rebootHelps(FaultVerdict verdict);
+  static const char* verdictName(FaultVerdict verdict);
+  static const char* verdictLabel(FaultVerdict verdict);
+  // Uma linha com o veredito e o estado de cada camada, para o Telegram
+  static size_t describe(const FaultReport& report, char* buffer, size_t maxLen);
+};
+
+#endif
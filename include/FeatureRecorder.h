@@ -0,0 +1,76 @@
+#ifndef FEATURE_RECORDER_H
+#define FEATURE_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include "FeatureVector.h"
+
+// Dataset de treino gravado pelo próprio ESP32: o vetor de características de
+// cada ciclo sniffer, exatamente o que o AnomalyDetector recebeu, vai para um
+// anel binário na partição 'features' (partitions.csv). Exportado como CSV
+// (/features.csv), com as colunas de network_metrics_dataset.csv, serve direto
+// para o train_and_convert.py: o modelo passa a ser treinado com o que o
+// firmware vê da rede, e não com o que o Wireshark do notebook via.
+//
+// Cada registro ocupa uma posição fixa do anel (sequência % capacidade). O
+// setor é apagado quando o anel chega ao primeiro registro dele, então ficam
+// sempre pelo menos FEATURE_RECORDER_SECTORS - 1 setores de histórico. O CRC
+// de cada registro parte do hash do layout (AnomalyFeatures.def): registro
+// cortado por queda de energia ou gravado com outro layout é ignorado.
+//
+// record() roda na task de operação; read() pode ser chamado da task do
+// servidor web. Sem a partição (ou no PC) begin() retorna false e record()
+// não faz nada.
+
+#define FEATURE_RECORDER_SECTOR 4096
+#define FEATURE_RECORDER_SECTORS 16  // 64 KB: ~1360 ciclos, mais de 3 dias com um ciclo a cada 4 min
+
+#define FEATURE_RECORD_EPOCH 0x01    // 'time' é epoch (SNTP); senão, segundos desde o boot
+#define FEATURE_RECORD_ANOMALY 0x02  // O detector marcou o ciclo como anomalia
+
+struct FeatureRecord {
+  uint32_t sequence;  // Índice absoluto; 0xFFFFFFFF = posição apagada
+  uint32_t time;      // Fim do ciclo
+  uint8_t flags;
+  uint8_t featureCount;  // ANOMALY_FEATURE_COUNT de quem gravou
+  uint16_t seconds;      // Duração do ciclo
+  float values[ANOMALY_FEATURE_COUNT];
+  uint32_t crc;       // CRC-32 dos campos acima, semente = hash do layout
+};
+
+#define FEATURE_RECORDS_PER_SECTOR (FEATURE_RECORDER_SECTOR / sizeof(FeatureRecord))
+#define FEATURE_RECORDER_CAPACITY (FEATURE_RECORDS_PER_SECTOR * FEATURE_RECORDER_SECTORS)
+
+class FeatureRecorder {
+public:
+  FeatureRecorder();
+  // Localiza a partição e o fim do anel (varre um registro por setor e o setor mais recente)
+  bool begin();
+  bool isReady() const { return _partition != nullptr; }
+
+  bool record(const FeatureVector& features, uint16_t seconds, bool anomaly, time_t now);
+
+  // Índice absoluto do registro mais antigo ainda no anel e do próximo a gravar
+  uint32_t oldest() const;
+  uint32_t next() const { return _next; }
+  size_t count() const { return _next - oldest(); }
+  // Próximo registro válido a partir de *cursor (avançado para depois dele).
+  // Um cursor que o anel já sobrescreveu salta para o mais antigo.
+  bool read(uint32_t* cursor, FeatureRecord* out) const;
+
+  // Primeira coluna e colunas de características do CSV, como em network_metrics_dataset.csv
+  static size_t csvHeader(char* buffer, size_t maxLen);
+  // Uma linha (com '\n'); retorna 0 se não couber
+  static size_t csvLine(const FeatureRecord& record, char* buffer, size_t maxLen);
+
+private:
+  const void* _partition = nullptr;  // const esp_partition_t*
+  volatile uint32_t _next = 0;
+
+  static uint32_t _crc(const FeatureRecord& record);
+  bool _readSlot(uint32_t slot, FeatureRecord* out) const;
+  bool _valid(const FeatureRecord& record) const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef FEATURE_VECTOR_H
+#define FEATURE_VECTOR_H
+
+#include <cstdint>
+#include <cstring>
+
+// Vetor de características por janela, com o layout de AnomalyFeatures.def
+
+enum AnomalyFeature {
+#define ANOMALY_FEATURE(id, column) FEATURE_##id,
+#include "AnomalyFeatures.def"
+#undef ANOMALY_FEATURE
+  ANOMALY_FEATURE_COUNT
+};
+
+// Nome da coluna de cada característica no dataset de treino
+constexpr const char* ANOMALY_FEATURE_COLUMNS[ANOMALY_FEATURE_COUNT] = {
+#define ANOMALY_FEATURE(id, column) #column,
+#include "AnomalyFeatures.def"
+#undef ANOMALY_FEATURE
+};
+
+struct FeatureVector {
+  float values[ANOMALY_FEATURE_COUNT];
+
+  FeatureVector() { memset(values, 0, sizeof(values)); }
+  float& operator[](int feature) { return values[feature]; }
+  float operator[](int feature) const { return values[feature]; }
+};
+
+#define FEATURE_MAX_STATIONS 64  // Transmissores rastreados por ciclo (maior transmissor e vetores por dispositivo)
+
+// Vetor de características de um único transmissor no ciclo
+struct DeviceFeatures {
+  uint8_t mac[6];
+  FeatureVector features;
+};
+
+// Índice da coluna pelo nome, ou -1
+inline int anomalyFeatureIndex(const char* column) {
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) {
+    if (strcmp(ANOMALY_FEATURE_COLUMNS[i], column) == 0) return i;
+  }
+  return -1;
+}
+
+// FNV-1a dos nomes das primeiras "count" colunas separados por vírgula. O
+// gerador dos pesos grava o mesmo hash para as entradas do modelo, e o
+// AnomalyDetector confere os dois em tempo de compilação.
+constexpr uint32_t anomalyFeatureLayoutHash(int count) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < count; i++) {
+    if (i > 0) hash = (hash ^ (uint8_t)',') * 16777619u;
+    for (const char* c = ANOMALY_FEATURE_COLUMNS[i]; *c != '\0'; c++) {
+      hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+#endif
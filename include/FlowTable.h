@@ -0,0 +1,83 @@
+#ifndef FLOW_TABLE_H
+#define FLOW_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "FrameParser.h"
+
+#define FLOW_TABLE_SIZE 128
+#define FLOW_HASH_BUCKETS 256   // Potência de 2
+
+// Motivo pelo qual um fluxo saiu do cache (vai no log e nas estatísticas)
+enum FlowExpiryReason : uint8_t {
+  FLOW_EXPIRED_IDLE = 1,
+  FLOW_EXPIRED_ACTIVE,
+  FLOW_EXPIRED_EVICTED,
+  FLOW_EXPIRED_FLUSH
+};
+
+struct FlowKey {
+  uint32_t srcIp;
+  uint32_t dstIp;
+  uint16_t srcPort;
+  uint16_t dstPort;
+  uint8_t proto;
+};
+
+struct FlowRecord {
+  FlowKey key;
+  uint32_t packets;
+  uint32_t bytes;          // Bytes da camada 3 (total_length do IP)
+  uint32_t firstMs;        // Mesmo relógio que 'nowMs' (millis() no ESP32)
+  uint32_t lastMs;
+  uint8_t tcpFlags;        // OR de todas as flags TCP vistas
+};
+
+typedef void (*FlowExpiredCallback)(const FlowRecord& record, FlowExpiryReason reason, void* context);
+
+// Cache de fluxos 5-tupla com memória fixa: hash com encadeamento por índice,
+// lista LRU duplamente ligada, timeouts ativo/ocioso e expulsão do menos
+// recentemente usado quando a tabela enche.
+class FlowTable {
+public:
+  FlowTable();
+  void reset();
+  void setTimeouts(uint32_t activeTimeoutMs, uint32_t idleTimeoutMs);
+  void setExpiredCallback(FlowExpiredCallback callback, void* context);
+
+  void onFrame(const ParsedFrame& frame, uint32_t nowMs);
+  void expire(uint32_t nowMs);
+  void flushAll();
+
+  size_t activeFlows() const { return _activeCount; }
+  uint32_t evictions() const { return _evictions; }
+
+private:
+  struct Entry {
+    FlowRecord record;
+    int16_t hashNext;
+    int16_t lruPrev;
+    int16_t lruNext;
+    bool inUse;
+  };
+
+  Entry _entries[FLOW_TABLE_SIZE];
+  int16_t _buckets[FLOW_HASH_BUCKETS];
+  int16_t _lruHead;       // Mais recente
+  int16_t _lruTail;       // Menos recente
+  int16_t _freeHead;
+  size_t _activeCount;
+  uint32_t _evictions;
+  uint32_t _activeTimeoutMs;
+  uint32_t _idleTimeoutMs;
+  FlowExpiredCallback _callback;
+  void* _callbackContext;
+
+  static uint32_t _hash(const FlowKey& key);
+  static bool _sameKey(const FlowKey& a, const FlowKey& b);
+  void _lruUnlink(int16_t index);
+  void _lruPushFront(int16_t index);
+  void _remove(int16_t index, FlowExpiryReason reason);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef FRAME_PARSER_H
+#define FRAME_PARSER_H
+
+#include <cstdint>
+
+// Flags do campo Frame Control (segundo byte) do cabeçalho 802.11
+#define WIFI_FC_TO_DS      0x01
+#define WIFI_FC_FROM_DS    0x02
+#define WIFI_FC_RETRY      0x08
+#define WIFI_FC_PROTECTED  0x40
+
+// Flags TCP
+#define TCP_FLAG_FIN 0x01
+#define TCP_FLAG_SYN 0x02
+#define TCP_FLAG_RST 0x04
+#define TCP_FLAG_PSH 0x08
+#define TCP_FLAG_ACK 0x10
+
+#define IP_PROTO_TCP 6
+#define IP_PROTO_UDP 17
+
+// Visão decodificada de um quadro capturado. Os ponteiros apontam para dentro
+// do buffer original, portanto só são válidos enquanto ele existir.
+struct ParsedFrame {
+  // --- Metadados da captura (preenchidos por quem chama o parser) ---
+  uint32_t timestampUs;
+  uint32_t uptimeMs;         // Relógio de parede do sistema (millis() no ESP32)
+  int8_t rssi;
+  uint8_t channel;
+
+  // --- Camada 2 (802.11) ---
+  const uint8_t* data;       // Quadro bruto, começando no Frame Control
+  uint16_t length;           // Tamanho do quadro no ar (sig_len)
+  uint16_t capturedLength;   // Bytes realmente disponíveis em 'data'
+  uint8_t fcFlags;           // Segundo byte do Frame Control
+  const uint8_t* transmitter; // addr2: quem transmitiu o quadro
+  const uint8_t* srcMac;
+  const uint8_t* dstMac;
+  const uint8_t* bssid;
+
+  // --- Camadas 3/4 (somente se o payload não estiver criptografado) ---
+  bool hasIpv4;
+  uint8_t ipProto;
+  uint16_t ipTotalLength;    // Campo total_length do cabeçalho IP
+  uint32_t srcIp;            // Ordem do host: a.b.c.d -> (a << 24) | ...
+  uint32_t dstIp;
+  uint16_t srcPort;
+  uint16_t dstPort;
+  uint32_t tcpSeq;
+  uint32_t tcpAck;
+  uint8_t tcpFlags;
+  const uint8_t* l4Payload;
+  uint16_t l4PayloadLength;
+
+  bool isUplink() const { return (fcFlags & (WIFI_FC_TO_DS | WIFI_FC_FROM_DS)) == WIFI_FC_TO_DS; }
+  bool isRetry() const { return (fcFlags & WIFI_FC_RETRY) != 0; }
+  bool isProtected() const { return (fcFlags & WIFI_FC_PROTECTED) != 0; }
+};
+
+// Decodifica um quadro de dados 802.11 (com ou sem QoS, 3 ou 4 endereços) e,
+// quando o corpo não é protegido, o LLC/SNAP, o IPv4 e o cabeçalho TCP/UDP.
+// Retorna false se o quadro for curto demais para ter um cabeçalho válido.
+bool parseWifiFrame(const uint8_t* data, uint16_t capturedLength, uint16_t length, ParsedFrame& out);
+
+#endif
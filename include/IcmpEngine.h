@@ -0,0 +1,114 @@
+#ifndef ICMP_ENGINE_H
+#define ICMP_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Ecos ICMP num socket raw do lwIP, vários pedidos em voo ao mesmo tempo.
+//
+// Cada instância tem seu próprio identificador ICMP e uma tabela de ecos
+// pendentes indexada pela sequência (sequência % ICMP_MAX_OUTSTANDING): a
+// resposta é casada em O(1) por id, sequência e endereço de origem, e a
+// posição só é reutilizada depois que o eco respondeu ou expirou. Todo
+// socket raw do lwIP recebe todas as respostas ICMP, então instâncias
+// diferentes (ProbeEngine, NetworkDiscovery) convivem sem trava: cada uma
+// descarta o que não tem o seu id.
+//
+// Um eco com TTL curto morre no caminho: o roteador daquele salto devolve
+// Time Exceeded com o começo do eco original, que também é casado pela
+// tabela. É assim que o primeiro salto do provedor é descoberto.
+//
+// Duas formas de uso:
+//  - baixo nível: send()/receive()/expire() com o descritor em fd(), para
+//    quem já tem o próprio select() (ProbeEngine);
+//  - sweep(): eco para cada alvo, com no máximo 'window' alvos em voo, e
+//    novas passadas só para quem não respondeu; entrega RTT e perda por alvo
+//    num callback assim que o alvo responde ou esgota as passadas.
+//
+// Cada alvo da LAN ocupa uma entrada da tabela ARP do lwIP (10 no ESP32)
+// enquanto o eco espera: com mais alvos em voo que entradas, o lwIP recicla
+// as pendentes, o eco nunca sai e o host parece fora do ar. Por isso a
+// janela do sweep fica abaixo do tamanho da tabela, e a segunda passada pega
+// quem perdeu o ARP ou estava dormindo (Wi-Fi em economia de energia). Numa
+// /24 quase vazia cada passada leva ~254 / janela x timeout (~16 s).
+//
+// Não é reentrante: uma task por instância.
+
+#define ICMP_MAX_OUTSTANDING 16   // Ecos em voo por instância (PROBE_MAX ou a janela do sweep)
+#define ICMP_MAX_TARGETS 256      // Alvos por sweep()
+#define ICMP_SWEEP_WINDOW 8       // Alvos em voo: abaixo das 10 entradas ARP do lwIP
+#define ICMP_SWEEP_PASSES 2
+#define ICMP_SWEEP_TIMEOUT_MS 500
+
+// Chamado por eco: 'from' é quem respondeu (o alvo, ou o salto que devolveu
+// Time Exceeded); rttUs < 0 quando expirou sem resposta (from = alvo)
+typedef void (*IcmpEchoHandler)(void* context, uint16_t tag, uint32_t from, int32_t rttUs);
+
+struct IcmpTargetResult {
+  uint32_t ip;  // Ordem de rede
+  uint8_t sent;
+  uint8_t received;
+  uint32_t rttMinUs;
+  uint32_t rttMaxUs;
+  uint32_t rttSumUs;
+
+  uint32_t rttAvgUs() const { return received ? rttSumUs / received : 0; }
+  uint8_t lossPct() const { return sent ? (uint8_t)(100 * (sent - received) / sent) : 100; }
+};
+
+typedef void (*IcmpTargetHandler)(void* context, const IcmpTargetResult& result);
+
+class IcmpEngine {
+public:
+  IcmpEngine();
+  ~IcmpEngine();
+
+  bool open();
+  // Fecha o socket e esquece os ecos pendentes
+  void close();
+  bool isOpen() const { return _fd >= 0; }
+  int fd() const { return _fd; }
+
+  // Envia um eco; 'tag' volta no handler. 'ttl' 0 = padrão do lwIP.
+  // False com a tabela cheia ou erro de envio.
+  bool send(uint32_t ip, uint16_t tag, uint32_t nowUs, uint8_t ttl = 0);
+  // Lê todas as respostas disponíveis sem bloquear
+  void receive(uint32_t nowUs, IcmpEchoHandler handler, void* context);
+  // Descarta os ecos mais velhos que timeoutUs; retorna o tempo até o próximo expirar (ou timeoutUs)
+  uint32_t expire(uint32_t nowUs, uint32_t timeoutUs, IcmpEchoHandler handler, void* context);
+  size_t outstanding() const { return _outstanding; }
+
+  // Varredura bloqueante; retorna false se o socket não abriu ou faltou memória.
+  // O estado por alvo só existe durante a chamada.
+  bool sweep(const uint32_t* targets, size_t count, uint8_t passes, IcmpTargetHandler handler, void* context,
+             uint16_t timeoutMs = ICMP_SWEEP_TIMEOUT_MS, uint8_t window = ICMP_SWEEP_WINDOW);
+
+private:
+  struct Echo {
+    uint32_t ip;
+    uint32_t sentUs;
+    uint16_t sequence;
+    uint16_t tag;
+    bool used;
+  };
+
+  int _fd = -1;
+  uint16_t _id;
+  uint16_t _sequence = 0;
+  size_t _outstanding = 0;
+  Echo _echoes[ICMP_MAX_OUTSTANDING];
+
+  // Estado do sweep() em andamento (alocado por ele)
+  struct SweepTarget {
+    IcmpTargetResult result;
+    bool done;
+  };
+  SweepTarget* _sweepTargets = nullptr;
+  bool _sweepLastPass = false;
+  IcmpTargetHandler _sweepHandler = nullptr;
+  void* _sweepContext = nullptr;
+
+  static void _onSweepEcho(void* context, uint16_t tag, uint32_t from, int32_t rttUs);
+};
+
+#endif
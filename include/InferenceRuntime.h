@@ -0,0 +1,121 @@
+#ifndef INFERENCE_RUNTIME_H
+#define INFERENCE_RUNTIME_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Registro dos modelos de TinyML (autoencoder, preditor de quedas...) com uma
+// única arena compartilhada.
+//
+// Os modelos nunca rodam ao mesmo tempo: todas as inferências passam por uma
+// fila e são executadas, uma por vez, numa task de baixa prioridade. Por isso
+// basta uma arena do tamanho da maior necessidade, planejada em begin() e
+// alocada uma única vez, em vez de um buffer estático por modelo. Um modelo
+// que guarda estado na arena (o interpretador do TFLM) é preparado de novo
+// quando outro a usou desde a última invocação dele.
+//
+// Cada modelo tem um InferenceProfiler (mesma interface BeginEvent/EndEvent
+// do tflite::MicroProfiler) com o tempo por op acumulado, exposto em
+// /inference_json junto com arenaUsedBytes().
+//
+// No PC (ferramentas native_*) não há task: run() executa na hora.
+
+#define INFERENCE_MAX_MODELS 4
+#define INFERENCE_MAX_OPS 12  // Ops medidos por invocação (camadas do TinyMlp)
+
+class InferenceProfiler {
+public:
+  struct OpStats {
+    const char* tag;
+    uint32_t count;
+    uint64_t totalUs;
+    uint32_t maxUs;
+  };
+
+  // Mesma assinatura do tflite::MicroProfiler; o handle é a posição do op na invocação
+  uint32_t BeginEvent(const char* tag);
+  void EndEvent(uint32_t handle);
+  // Chamado pelo runtime antes de cada invocação
+  void ClearEvents() { _next = 0; }
+
+  size_t opCount() const { return _opCount; }
+  const OpStats& op(size_t index) const { return _ops[index]; }
+
+private:
+  OpStats _ops[INFERENCE_MAX_OPS] = {};
+  int64_t _starts[INFERENCE_MAX_OPS] = {};
+  size_t _opCount = 0;
+  uint32_t _next = 0;
+};
+
+class InferenceModel {
+public:
+  virtual ~InferenceModel() {}
+
+  virtual const char* modelName() const = 0;
+  // Arena que o modelo precisa: entra no planejamento de begin()
+  virtual size_t arenaBytes() const = 0;
+  // O modelo vai usar a arena depois de outro: recria o que ele mantém nela
+  virtual bool prepare(uint8_t* arena, size_t size) {
+    (void)arena;
+    (void)size;
+    return true;
+  }
+  // in [n][entradas] -> out [n][saídas], usando a arena como rascunho
+  virtual bool invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) = 0;
+  // Quanto da arena a última invocação de fato usou
+  virtual size_t arenaUsedBytes() const { return arenaBytes(); }
+};
+
+class InferenceRuntime {
+public:
+  InferenceRuntime();
+
+  // Antes de begin(); depois dele, só modelos que caibam na arena já planejada
+  bool registerModel(InferenceModel* model);
+  // Planeja e aloca a arena e cria a task de inferência
+  bool begin();
+  bool isStarted() const { return _arena != nullptr; }
+
+  // Enfileira a inferência e espera o resultado (bloqueia a task que chamou)
+  bool run(InferenceModel* model, const float* in, float* out, int n = 1);
+
+  size_t arenaSize() const { return _arenaSize; }
+  // Soma das necessidades, o que custariam arenas separadas
+  size_t separateArenaBytes() const;
+
+  struct ModelStats {
+    const InferenceModel* model;
+    uint32_t invocations;
+    uint64_t totalUs;
+    uint32_t maxUs;
+    const InferenceProfiler* profiler;
+  };
+  size_t modelCount() const { return _count; }
+  ModelStats stats(size_t index) const;
+
+private:
+  struct Slot {
+    InferenceModel* model;
+    InferenceProfiler profiler;
+    uint32_t invocations;
+    uint64_t totalUs;
+    uint32_t maxUs;
+  };
+  Slot _slots[INFERENCE_MAX_MODELS];
+  size_t _count = 0;
+
+  uint8_t* _arena = nullptr;
+  size_t _arenaSize = 0;
+  int _owner = -1;  // Último modelo que usou a arena
+
+  void* _jobs = nullptr;  // QueueHandle_t
+
+  int _slotOf(const InferenceModel* model) const;
+  bool _execute(int slot, const float* in, float* out, int n);
+  static void _task(void* parameter);
+};
+
+extern InferenceRuntime inferenceRuntime;
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Histogramas de latência por alvo de sonda, com percentis.
+//
+// O histograma é log-linear, como o HDR: abaixo de 2^k µs cada µs tem seu
+// balde; dali em diante cada potência de 2 é dividida em 2^k baldes iguais
+// (k = LATENCY_SUB_BUCKET_BITS). O percentil sai do meio do balde, então o
+// erro relativo fica abaixo de 2^-(k+1): 6,25% com k = 3, em 352 bytes para
+// RTTs de 1 µs a 16 s. Perda e jitter (média de |RTT - RTT anterior|, como
+// no RFC 3550) vão junto, e dois histogramas se somam sem perder nada.
+//
+// Cada alvo (tipo de sonda + IP) tem o histograma do minuto corrente e o da
+// hora corrente. Ao virar o minuto, o minuto entra na hora e vira um resumo
+// de 16 bytes (p50, p90, p99, jitter, perda) no anel dos últimos 60 minutos;
+// ao virar a hora, o mesmo vai para o anel das últimas 24 horas. Memória
+// fixa: ~2,1 KB por alvo. Com a tabela cheia, o alvo visto há mais tempo dá
+// lugar ao novo.
+//
+// record()/advance() rodam na task de operação; snapshot() pode ser chamado
+// de qualquer task.
+
+#ifndef LATENCY_SUB_BUCKET_BITS
+#define LATENCY_SUB_BUCKET_BITS 3    // Erro relativo dos percentis < 2^-(k+1)
+#endif
+#define LATENCY_RANGE_BITS 24        // Até 2^24 µs (16,7 s); acima disso, último balde
+#define LATENCY_BUCKETS ((LATENCY_RANGE_BITS - LATENCY_SUB_BUCKET_BITS + 1) << LATENCY_SUB_BUCKET_BITS)
+
+#define LATENCY_MAX_TARGETS 8
+#define LATENCY_MINUTES 60           // Resumos por minuto guardados por alvo
+#define LATENCY_HOURS 24             // ... e por hora
+
+#define LATENCY_FLAG_EPOCH 0x01      // 'start' é epoch (SNTP); senão, segundos desde o boot
+
+struct LatencyHistogram {
+  uint16_t counts[LATENCY_BUCKETS];  // Saturam em 65535
+  uint16_t samples;                  // Respostas
+  uint16_t lost;                     // Sondas sem resposta
+  uint32_t jitterSumUs;
+  uint16_t jitterCount;
+
+  void clear();
+  void add(uint32_t rttUs);
+  void merge(const LatencyHistogram& other);
+  // RTT (µs) abaixo do qual ficam 'pct'% das respostas; 0 sem respostas
+  uint32_t percentile(uint8_t pct) const;
+  uint32_t jitterUs() const { return jitterCount ? jitterSumUs / jitterCount : 0; }
+  uint8_t lossPct() const;
+
+  static size_t bucketOf(uint32_t us);
+  static uint32_t bucketLow(size_t bucket);
+  static uint32_t bucketWidth(size_t bucket);
+};
+
+struct LatencySummary {
+  uint32_t start;                    // Início da janela
+  uint16_t p50, p90, p99, jitter;    // Décimos de ms (saturam em 6553,5 ms)
+  uint16_t samples;
+  uint8_t lossPct;
+  uint8_t flags;
+};
+static_assert(sizeof(LatencySummary) == 16, "resumo de latência com layout fixo");
+
+struct LatencyTarget {
+  uint32_t ip;                       // Ordem de rede; 0 para a sonda HTTP (o IP do host muda)
+  uint8_t kind;                      // ProbeKind
+  uint8_t flags;                     // LATENCY_FLAG_EPOCH das janelas correntes
+  uint32_t lastSeen;                 // Ordem do último registro (o menor sai primeiro)
+  uint32_t lastRttUs;                // Para o jitter; 0 depois de uma perda
+  uint32_t minuteStart;
+  uint32_t hourStart;
+  uint32_t minuteTotal;              // Resumos de minuto já gravados (índice absoluto)
+  uint32_t hourTotal;
+  LatencyHistogram minute;
+  LatencyHistogram hour;
+  LatencySummary minutes[LATENCY_MINUTES];
+  LatencySummary hours[LATENCY_HOURS];
+
+  size_t minuteCount() const { return minuteTotal < LATENCY_MINUTES ? minuteTotal : LATENCY_MINUTES; }
+  size_t hourCount() const { return hourTotal < LATENCY_HOURS ? hourTotal : LATENCY_HOURS; }
+  // i-ésimo resumo ainda no anel, do mais antigo para o mais recente
+  const LatencySummary& minuteAt(size_t i) const { return minutes[(minuteTotal - minuteCount() + i) % LATENCY_MINUTES]; }
+  const LatencySummary& hourAt(size_t i) const { return hours[(hourTotal - hourCount() + i) % LATENCY_HOURS]; }
+};
+
+class LatencyStore {
+public:
+  LatencyStore();
+  void setup();
+
+  // Uma sonda: RTT em µs se respondeu, perda se não. 'now' em epoch ou, sem o
+  // relógio acertado, segundos desde o boot.
+  void record(uint8_t kind, uint32_t ip, bool ok, uint32_t rttUs, uint32_t now);
+  // Fecha os minutos e horas que já viraram, mesmo de alvos sem sondas novas
+  void advance(uint32_t now);
+
+  size_t count() const { return _count; }
+  bool snapshot(size_t i, LatencyTarget* out) const;
+
+  static LatencySummary summarize(const LatencyHistogram& histogram, uint32_t start, uint8_t flags);
+
+private:
+  LatencyTarget _targets[LATENCY_MAX_TARGETS];
+  size_t _count = 0;
+  uint32_t _sequence = 0;
+  void* _mutex = nullptr;  // SemaphoreHandle_t
+
+  LatencyTarget* _find(uint8_t kind, uint32_t ip, uint32_t now);
+  void _advance(LatencyTarget& target, uint32_t now);
+  void _lock() const;
+  void _unlock() const;
+};
+
+#endif
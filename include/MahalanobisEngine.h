@@ -0,0 +1,59 @@
+#ifndef MAHALANOBIS_ENGINE_H
+#define MAHALANOBIS_ENGINE_H
+
+#include <cstdint>
+#include "AnomalyEngine.h"
+
+// Engine sem rede neural: distância de Mahalanobis da janela até a média,
+// com média e covariância exponenciais (EWMA) das características em escala
+// log1p. Aprende na própria rede desde a primeira janela, sem treino no PC,
+// em memória fixa (~300 bytes de estado) e O(F³) por janela com F = 8.
+//
+// O escore é d² / F. Como no OnlineCalibrator, o limite vem da média e do
+// desvio exponenciais do log do escore (exp(média + k·desvio)), as janelas
+// sinalizadas não entram nessas estatísticas e há um aquecimento sem alertas.
+
+#define MAHALANOBIS_FEATURES ANOMALY_FEATURE_COUNT
+#define MAHALANOBIS_ALPHA 0.01f             // Memória de ~100 janelas (~7 h) para média e covariância
+#define MAHALANOBIS_SCORE_ALPHA 0.02f       // Memória de ~50 janelas para o escore
+#define MAHALANOBIS_VARIANCE_FLOOR 0.01f    // Somada à diagonal: desvio mínimo de 0,1 em log1p
+#define MAHALANOBIS_THRESHOLD_SIGMAS 3.0f
+#define MAHALANOBIS_WARMUP_WINDOWS 60
+#define MAHALANOBIS_STATE_VERSION 1
+#define MAHALANOBIS_LOG_EPSILON 1e-6f
+
+class MahalanobisEngine : public AnomalyEngine {
+public:
+  // Estado completo, gravado como um blob no NVS
+  struct State {
+    uint8_t version;
+    uint32_t windows;
+    float mean[MAHALANOBIS_FEATURES];
+    float cov[MAHALANOBIS_FEATURES][MAHALANOBIS_FEATURES];
+    float logScoreMean;
+    float logScoreVar;
+  };
+
+  MahalanobisEngine();
+  void reset();
+
+  const char* name() const override { return "mahalanobis"; }
+  bool begin() override;
+  bool evaluate(const FeatureVector& features, AnomalyScore* result) override;
+  float threshold() const override;
+  size_t memoryBytes() const override { return sizeof(*this); }
+
+  bool isWarm() const { return _state.windows >= MAHALANOBIS_WARMUP_WINDOWS; }
+  const State& state() const { return _state; }
+  bool restore(const State& state);
+
+private:
+  State _state;
+
+  // d² da diferença até a média, por Cholesky de (cov + piso·I)
+  float _distance2(const float* diff) const;
+  void _load();
+  void _save();
+};
+
+#endif
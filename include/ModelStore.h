@@ -0,0 +1,70 @@
+#ifndef MODEL_STORE_H
+#define MODEL_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "AnomalyModelBlob.h"
+
+// Modelo do autoencoder em partições de dados (partitions.csv), fora do binário
+// do firmware.
+//
+// Há dois slots (A/B). O ativo é o válido (CRC e compatibilidade conferidos)
+// de maior sequence, e fica mapeado com esp_partition_mmap: os pesos são lidos
+// direto da flash, sem cópia. Um upload grava o slot inativo e escreve o
+// cabeçalho por último; até essa escrita o slot não é válido, então uma
+// queda de energia no meio deixa o modelo anterior intacto. A troca em si é
+// feita por takeUploaded(), na task do detector, entre duas janelas.
+//
+// Sem as partições (ou no PC) begin() retorna false e o detector segue com os
+// pesos compilados.
+
+#define MODEL_STORE_SLOTS 2
+#define MODEL_STORE_SECTOR 4096
+
+class ModelStore {
+public:
+  ModelStore();
+  bool begin(const AnomalyBlobExpect& expect);
+
+  bool hasModel() const { return _active >= 0; }
+  const AnomalyModelView& model() const { return _view; }
+  int activeSlot() const { return _active; }
+
+  // Upload em pedaços (task do servidor web): grava o slot inativo
+  bool beginUpload(size_t size);
+  bool writeUpload(const uint8_t* data, size_t length);
+  bool finishUpload();
+  // Motivo da última falha de upload, ou nullptr
+  const char* uploadError() const { return _uploadError; }
+
+  // Na task do detector: se há um modelo novo validado, passa a usá-lo e
+  // libera o mapeamento do anterior (os ponteiros antigos deixam de valer)
+  bool takeUploaded(AnomalyModelView* view);
+  bool isSwapPending() const { return _swapPending; }
+
+private:
+  AnomalyBlobExpect _expect;
+  const void* _partitions[MODEL_STORE_SLOTS];  // const esp_partition_t*
+  int _active = -1;
+  AnomalyModelView _view;
+  uint32_t _mapHandle = 0;
+
+  // Upload em andamento
+  int _uploadSlot = -1;
+  size_t _uploadSize = 0;
+  size_t _received = 0;
+  size_t _erasedUpTo = 0;
+  AnomalyBlobHeader _uploadHeader;
+  const char* _uploadError = nullptr;
+
+  // Modelo gravado esperando a troca
+  volatile bool _swapPending = false;
+  int _pendingSlot = -1;
+  AnomalyModelView _pendingView;
+  uint32_t _pendingHandle = 0;
+
+  bool _map(int slot, AnomalyModelView* view, uint32_t* handle, const char** error);
+  void _failUpload(const char* error);
+};
+
+#endif
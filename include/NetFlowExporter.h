@@ -0,0 +1,49 @@
+#ifndef NETFLOW_EXPORTER_H
+#define NETFLOW_EXPORTER_H
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "FlowTable.h"
+
+#define NETFLOW_DEFAULT_PORT 2055
+#define NETFLOW_MAX_PENDING 256
+#define NETFLOW_RECORDS_PER_DATAGRAM 24
+#define NETFLOW_TEMPLATE_ID 256
+
+// Exporta fluxos expirados como NetFlow v9 (RFC 3954). Os registros ficam num
+// buffer fixo enquanto o Wi-Fi está desconectado (modo sniffer) e são
+// enviados em lote, um datagrama UDP a cada NETFLOW_RECORDS_PER_DATAGRAM fluxos.
+class NetFlowExporter {
+public:
+  NetFlowExporter();
+  void setup();
+  void setCollector(const char* host, uint16_t port);
+  bool isEnabled() const { return _port != 0 && _host.length() > 0; }
+
+  // Chamado pela tarefa do sniffer; nunca bloqueia nem acessa a rede
+  void enqueue(const FlowRecord& record);
+  // Envia os registros pendentes. Com 'partial' false só envia lotes completos.
+  size_t flush(bool partial);
+
+  uint32_t droppedRecords() const { return _dropped; }
+
+  // Codifica um datagrama (cabeçalho + template + dados). Retorna o tamanho.
+  static size_t encodeDatagram(const FlowRecord* records, size_t count, uint32_t sysUptimeMs,
+                               uint32_t unixSecs, uint32_t sequence, uint32_t sourceId,
+                               uint8_t* out, size_t outSize);
+
+private:
+  WiFiUDP _udp;
+  String _host;
+  uint16_t _port;
+  SemaphoreHandle_t _mutex;
+  FlowRecord _pending[NETFLOW_MAX_PENDING];
+  size_t _pendingHead;
+  size_t _pendingCount;
+  uint32_t _sequence;
+  uint32_t _dropped;
+};
+
+#endif
@@ -1,27 +1,75 @@
 #ifndef NETWORK_DIAGNOSTICS_H
 #define NETWORK_DIAGNOSTICS_H
 
-// --- MUDANÇA 1 de 3: Adicionar esta declaração ---
-// "Avisa" ao compilador que a classe NetworkDiscovery existe, sem precisar incluir o .h aqui.
-class NetworkDiscovery;
-// ----------------------------------------------------
+#include <Arduino.h>
+#include "freertos/semphr.h"
+#include "DiagnosticsRing.h"
+#include "ProbeEngine.h"
+#include "LatencyHistogram.h"
+#include "FaultLocator.h"
 
 class NetworkDiagnostics {
 public:
   NetworkDiagnostics();
   void setup();
+  // Rodada rápida de sondas paralelas (ProbeEngine): retorna no quorum ou no
+  // prazo de PROBE_DEADLINE_MS, nunca depois
   bool isInternetConnected();
 
-  // --- MUDANÇA 2 de 3: Adicionar esta função ---
-  // Função para que o main.cpp possa nos dar acesso ao outro módulo
-  void setDiscoveryModule(NetworkDiscovery* discovery);
-  // ----------------------------------------------------
+  // Batida do ProbeScheduler: um eco ICMP com prazo de 1 s. 'attempt' é o
+  // número de falhas seguidas; cada tentativa vai a um IP anycast diferente.
+  // O RTT e a perda das batidas entram na próxima amostra do histórico.
+  bool heartbeat(uint8_t attempt, uint32_t* rttUs);
+  // Sondas das batidas, verificações e diagnósticos até agora: o que o
+  // ProbeScheduler cobra do orçamento (isInternetConnected() fica de fora)
+  uint32_t probesSent() const { return _probesSent; }
+
+  // Verificação periódica do modo monitor: além do veredito, mede HTTP, DNS,
+  // RTT e perda e grava a amostra no histórico (Módulo 10). Sem quorum,
+  // roda diagnose() antes de declarar a queda.
+  bool checkInternet();
+  // Veredito da última checkInternet(), sem sondar nem esperar trava: é o
+  // que o servidor web serve (os handlers rodam na task do async_tcp)
+  bool lastOnline() const { return _online; }
+  uint32_t lastCheckMs() const { return _checkedMs; }  // millis() da última; 0 antes dela
+
+  // Rodada de localização da falha, camada por camada (ver FaultLocator.h)
+  FaultVerdict diagnose(FaultReport* report);
+  // Último diagnóstico (Healthy enquanto a internet está de pé)
+  FaultReport lastFault();
+
+  // Histórico das verificações. Sem trava: só para a task que chama
+  // checkInternet(); as demais usam readHistory().
+  const DiagnosticsRing& history() const { return _history; }
+  // Copia até 'max' amostras a partir de *cursor (índice absoluto, ver
+  // DiagnosticsRing) e avança o cursor; amostras já sobrescritas são puladas
+  size_t readHistory(uint32_t* cursor, DiagnosticSample* out, size_t max);
+
+  // RTT, jitter e perda de cada alvo de sonda, por minuto e por hora (com trava própria)
+  const LatencyStore& latency() const { return _latency; }
 
 private:
-  // --- MUDANÇA 3 de 3: Adicionar este ponteiro ---
-  // Para guardar o endereço do módulo que tem o mutex
-  NetworkDiscovery* _discoveryModule;
-  // ----------------------------------------------------
+  DiagnosticsRing _history;
+  SemaphoreHandle_t _historyMutex;
+  // Uma rodada por vez (o ProbeEngine não é reentrante)
+  ProbeEngine _probes;
+  SemaphoreHandle_t _probeMutex;
+  LatencyStore _latency;
+  uint32_t _ispHop;       // Roteador que devolve o eco com TTL 2 (aprendido com a rede de pé)
+  volatile uint32_t _probesSent;
+  volatile bool _online;
+  volatile uint32_t _checkedMs;
+  // Batidas desde a última amostra (protegidas por _probeMutex)
+  uint16_t _beats;
+  uint16_t _beatsAnswered;
+  uint32_t _beatRttMsSum;
+  FaultReport _lastFault; // Protegido por _historyMutex
+
+  int _prepareProbes(uint8_t pings);
+  void _recordLatency();
+  ProbeVerdict _run(uint16_t deadlineMs, uint8_t quorum, bool stopAtQuorum, bool budgeted = true);
+  bool _measure(DiagnosticSample* sample);
+  void _storeFault(const FaultReport& report);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include "freertos/semphr.h"
+#include "DeviceFingerprint.h"
+#include "IcmpEngine.h"
 
 #define MAX_DEVICES 50
 
@@ -10,12 +12,9 @@ struct DiscoveredDevice {
   IPAddress ip;
   String macAddress;
   bool isOnline;
-};
-
-struct PingTaskParams {
-  int startIp;
-  int endIp;
-  class NetworkDiscovery* scanner;
+  // Módulo 11: tipo pela impressão digital do MAC (Unknown até ser classificado)
+  DeviceType type;
+  uint8_t typeConfidence;
 };
 
 class NetworkDiscovery {
@@ -24,14 +23,23 @@ public:
   void setup();
   void beginScan();
   bool isScanning();
+  // Fonte dos tipos de dispositivo da tabela (o DeviceFingerprinter do TrafficAnalyzer)
+  void setFingerprinter(const DeviceFingerprinter* fingerprinter);
 
   DiscoveredDevice devices[MAX_DEVICES];
   int deviceCount;
   
   SemaphoreHandle_t listMutex;
-  SemaphoreHandle_t pingMutex; // <-- ADICIONADO: Mutex para a biblioteca de Ping
   
   volatile int activeScanTasks;
+
+private:
+  const DeviceFingerprinter* _fingerprinter;
+  // Varredura da /24 em janelas que cabem na tabela ARP
+  IcmpEngine _icmp;
+  bool _arpLookup(const IPAddress& ip, uint8_t* mac);
+  void _onHost(const IPAddress& ip, uint32_t rttUs);
+  static void _onSweepResult(void* context, const IcmpTargetResult& result);
 };
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
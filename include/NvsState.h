@@ -0,0 +1,11 @@
+#ifndef NVS_STATE_H
+#define NVS_STATE_H
+
+// Partição NVS do estado aprendido em campo: calibração online, Mahalanobis,
+// baseline sazonal, impressões digitais e perfis expulsos da RAM (~12 KB de
+// blobs, regravados com frequência). Fica fora da "nvs" padrão, que guarda a
+// configuração e os dados do Wi-Fi: a cheia de uma não derruba a outra.
+// Use como terceiro argumento de Preferences::begin().
+#define NVS_STATE_PARTITION "nvs_state"
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ONLINE_CALIBRATOR_H
+#define ONLINE_CALIBRATOR_H
+
+#include <cstdint>
+#include "FeatureVector.h"
+
+// Calibração contínua do detector de anomalias para a rede onde ele está.
+//
+// Em vez das constantes de um único treino, mantém por característica um
+// mínimo/máximo que "esquece" devagar (decaem em direção à média móvel) e,
+// para o log do erro de reconstrução, média e variância exponenciais (EWMA).
+// O erro tem cauda longa; em escala log, média + k·desvio separa melhor os
+// picos. Tudo é O(1) por janela.
+//
+// Nas primeiras ONLINE_CAL_WARMUP_WINDOWS janelas o calibrador só aprende.
+// Depois disso as janelas sinalizadas ainda ajustam a faixa das
+// características, mas não as estatísticas do erro, para que uma anomalia
+// longa não eleve o próprio limite.
+
+#define ONLINE_CAL_FEATURES ANOMALY_FEATURE_COUNT
+#define ONLINE_CAL_WARMUP_WINDOWS 60     // ~4 h com um ciclo sniffer a cada 4 min
+#define ONLINE_CAL_ERROR_ALPHA 0.02f     // Memória de ~50 janelas (~3 h) para o erro
+#define ONLINE_CAL_RANGE_DECAY 0.002f    // Fração do excesso min/max esquecida por janela (~1 dia)
+#define ONLINE_CAL_THRESHOLD_SIGMAS 3.0f
+#define ONLINE_CAL_STATE_VERSION 2
+#define ONLINE_CAL_LOG_EPSILON 1e-6f     // Evita log(0) com reconstrução perfeita
+
+class OnlineCalibrator {
+public:
+  // Estado completo, gravado como um blob no NVS
+  struct State {
+    uint8_t version;
+    uint32_t windows;
+    float featureMean[ONLINE_CAL_FEATURES];
+    float featureMin[ONLINE_CAL_FEATURES];
+    float featureMax[ONLINE_CAL_FEATURES];
+    float logErrorMean;
+    float logErrorVar;
+  };
+
+  OnlineCalibrator();
+  void reset();
+
+  bool isWarm() const { return _state.windows >= ONLINE_CAL_WARMUP_WINDOWS; }
+  uint32_t windows() const { return _state.windows; }
+
+  // Normaliza pela faixa min/max atual, sem atualizá-la (fora dela limita a [-1, 2])
+  void normalize(const float* raw, float* out) const;
+
+  // Registra uma janela. error é o erro de reconstrução da entrada normalizada
+  // por normalize(); anomalous indica se a janela foi sinalizada.
+  void update(const float* raw, float error, bool anomalous);
+
+  // Limite em unidades de erro de reconstrução: exp(média + k·desvio) do log
+  float threshold() const;
+  float typicalError() const;
+
+  const State& state() const { return _state; }
+  bool restore(const State& state);
+
+private:
+  State _state;
+};
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef OUTAGE_MODEL_WEIGHTS_H
+#define OUTAGE_MODEL_WEIGHTS_H
+
+// Gerado por scripts/TinyML_Module_10/generate_outage_header.py a partir de
+// pesos a priori escritos à mão (prior_layers), sem treino.
+// Não edite à mão: rode o script novamente.
+
+#include <cstdint>
+#include "TinyMlp.h"
+
+// Janela de 30 verificações x 4 canais (http, rtt, loss, dns), normalizados para [0, 1]
+#define OUTAGE_WINDOW 30
+#define OUTAGE_CHANNELS 4
+// Saída: probabilidade de a internet cair nos próximos OUTAGE_HORIZON_MIN minutos
+#define OUTAGE_HORIZON_MIN 10
+
+typedef tinymlp::Sequential<
+    tinymlp::Conv1D<30, 4, 4, 6, 6, tinymlp::Activation::Relu>,
+    tinymlp::Dense<20, 8, tinymlp::Activation::Relu>,
+    tinymlp::Dense<8, 1, tinymlp::Activation::Sigmoid>
+> OutageModel;
+
+// Saturação da normalização: min(ms, limite) / limite; sem resposta = 1
+constexpr float outage_http_cap_ms = 5000.0f;
+constexpr float outage_rtt_cap_ms = 1000.0f;
+constexpr float outage_dns_cap_ms = 2000.0f;
+
+// Conv1D: pesos [filtro][kernel][canal] e bias; Dense: pesos [saída][entrada] e bias
+constexpr float outage_model_params[OutageModel::paramCount] = {
+  // Camada 0: Conv1D (Relu)
+  1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.666666667e-01f,
+  -1.000000000e-01f, -1.000000000e-01f, 0.000000000e+00f, -5.000000000e-02f,
+  // Camada 1: Dense (Relu)
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 3.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  6.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 3.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 6.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 3.000000000e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 6.000000000e-01f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.000000000e-01f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 3.000000000e-01f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 6.000000000e-01f,
+  -1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, -1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, -1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, -1.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 1.000000000e+00f,
+  0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f, 0.000000000e+00f,
+  // Camada 2: Dense (Sigmoid)
+  4.000000000e+00f, 3.000000000e+00f, 6.000000000e+00f, 3.000000000e+00f, 3.000000000e+00f, 3.000000000e+00f, 4.000000000e+00f, 2.000000000e+00f,
+  -4.000000000e+00f,
+};
+
+// Saídas esperadas (float32, mesma ordem de operações da engine)
+constexpr int outage_model_reference_count = 11;
+constexpr float outage_model_reference_inputs[][OUTAGE_WINDOW * OUTAGE_CHANNELS] = {
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 4.896551743e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    5.793103576e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 6.689655036e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    7.586207241e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 8.482758701e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    9.379310161e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.027586237e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.117241383e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.206896529e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.296551675e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.386206895e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.475862116e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.565517187e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.655172408e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.744827628e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.834482700e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.924137920e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.013793141e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.103448212e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.193103433e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.282758653e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.372413725e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.462068945e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.551724017e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.641379237e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.731034458e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.820689678e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.910344899e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.000000119e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 7.310345024e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.062068939e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.393103451e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    1.724137962e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.055172473e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    2.386206836e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 2.717241347e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.048276007e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.379310369e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.710344732e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 4.041379392e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    4.372413754e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 4.703448415e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    5.034482479e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 5.365517139e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    5.696551800e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 6.027586460e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    6.358620524e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 6.689655185e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    7.020689845e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 7.351723909e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    7.682758570e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 8.013793230e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    8.344827294e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 8.675861955e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    9.006896615e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 9.337931275e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    9.668965340e-01f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 1.000000000e+00f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 3.931034356e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 4.862068966e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 5.793103576e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 6.724137813e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 7.655172050e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 8.586207032e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 9.517241269e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.044827551e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.137931049e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.231034473e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.324137896e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.417241395e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.510344893e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.603448242e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.696551740e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.789655238e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.882758588e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.975862086e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.068965584e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.162068933e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.255172431e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.348275930e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.441379279e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.534482777e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.627586126e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.720689774e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.813793123e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.906896472e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 3.000000119e-01f, 0.000000000e+00f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 6.344827265e-02f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 9.689655155e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.303448230e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 1.637931019e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.972413808e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.306896597e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.641379237e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 2.975862026e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 3.310344815e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 3.644827604e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 3.979310393e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 4.313793182e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 4.648275971e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 4.982758760e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 5.317241549e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 5.651724339e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 5.986207128e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 6.320689917e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 6.655172706e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 6.989654899e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 7.324137688e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 7.658620477e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 7.993103266e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 8.327586055e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 8.662068844e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 8.996551633e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 9.331034422e-01f, 0.000000000e+00f, 1.999999955e-02f,
+    3.999999911e-02f, 9.665517211e-01f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 1.000000000e+00f, 0.000000000e+00f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.034482755e-02f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.068965510e-02f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 3.103448264e-02f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 4.137931019e-02f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 5.172413960e-02f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 6.206896529e-02f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 7.241379470e-02f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 8.275862038e-02f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 9.310344607e-02f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 1.034482792e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.137931049e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 1.241379306e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.344827563e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 1.448275894e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.551724076e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 1.655172408e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.758620739e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 1.862068921e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.965517253e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.068965584e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 2.172413766e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.275862098e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 2.379310280e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.482758611e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 2.586206794e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.689655125e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 2.793103456e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.896551788e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 3.000000119e-01f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 3.448275849e-02f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 6.896551698e-02f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.034482792e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 1.379310340e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.724137962e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.068965584e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 2.413793057e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 2.758620679e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 3.103448153e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 3.448275924e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 3.793103397e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 4.137931168e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 4.482758641e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 4.827586114e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 5.172413588e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 5.517241359e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 5.862069130e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 6.206896305e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 6.551724076e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 6.896551847e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 7.241379023e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 7.586206794e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 7.931034565e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 8.275862336e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 8.620689511e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 8.965517282e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 9.310345054e-01f, 1.999999955e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 9.655172229e-01f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 1.000000000e+00f, 1.999999955e-02f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.965517156e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 3.931034356e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 4.896551743e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 5.862069130e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 6.827586144e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 7.793103158e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 8.758620918e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 9.724137932e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.068965495e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.165517271e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.262068897e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.358620673e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.455172449e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.551724076e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.648275852e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.744827628e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.841379255e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.937931031e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.034482807e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.131034434e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.227586210e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.324137986e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.420689613e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.517241240e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.613793015e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.710344791e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.806896567e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.903448343e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 3.000000119e-01f,
+  },
+  {
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.999999955e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 5.379310250e-02f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 8.758620918e-02f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.213793084e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.551724076e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.889655143e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.227586210e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.565517128e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 2.903448343e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 3.241379261e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 3.579310477e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 3.917241395e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 4.255172312e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 4.593103528e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 4.931034446e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 5.268965364e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 5.606896281e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 5.944827795e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 6.282758713e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 6.620689631e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 6.958620548e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 7.296551466e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 7.634482980e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 7.972413898e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 8.310344815e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 8.648275733e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 8.986206651e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 9.324138165e-01f,
+    3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 9.662069082e-01f, 3.999999911e-02f, 2.999999933e-02f, 0.000000000e+00f, 1.000000000e+00f,
+  },
+  {
+    0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f,
+    7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f,
+    5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f,
+    3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f,
+    1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f,
+    0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f,
+    7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f,
+    5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f,
+    3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f,
+    1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f,
+    0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f,
+    7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f,
+    5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f,
+    3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f,
+    1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f, 0.000000000e+00f, 5.999999866e-02f, 1.999999955e-02f, 7.999999821e-02f, 3.999999911e-02f,
+  },
+  {
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+  },
+};
+constexpr float outage_model_reference_outputs[] = { 1.798621006e-02f, 5.393750221e-02f, 7.781940103e-01f, 4.637773335e-02f, 6.356142759e-01f, 1.753354073e-01f, 9.848189950e-01f, 4.937918484e-02f, 4.786337912e-01f, 2.412701957e-02f, 9.999856353e-01f };
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef OUTAGE_PREDICTOR_H
+#define OUTAGE_PREDICTOR_H
+
+#include "DiagnosticsRing.h"
+#include "InferenceRuntime.h"
+
+// Módulo 10: probabilidade de a internet cair nos próximos OUTAGE_HORIZON_MIN
+// minutos, a partir das últimas OUTAGE_WINDOW verificações do DiagnosticsRing.
+//
+// O modelo é uma Conv1D pequena (OutageModelWeights.h) rodando compilada pelo
+// TinyMlp, como o autoencoder, e divide com ele a arena do InferenceRuntime. Os pesos vêm de
+// scripts/TinyML_Module_10/train_outage_model.py, treinado com o próprio anel
+// exportado em /diagnostics.csv; até lá o header traz pesos a priori, que
+// reagem à subida de perda, RTT e tempos de HTTP/DNS.
+
+// Aviso quando a probabilidade passa deste valor; rearma abaixo do segundo
+#define OUTAGE_ALERT_PROBABILITY 0.7f
+#define OUTAGE_REARM_PROBABILITY 0.4f
+
+class OutagePredictor : public InferenceModel {
+public:
+  void setup();
+
+  // InferenceModel: os dois buffers de rascunho das camadas ocultas
+  const char* modelName() const override { return "outage"; }
+  size_t arenaBytes() const override;
+  bool invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) override;
+
+  // Roda o modelo sobre o fim do histórico. Retorna false enquanto não há
+  // OUTAGE_WINDOW amostras. Chame na mesma task que grava o anel.
+  bool update(const DiagnosticsRing& history);
+
+  bool hasPrediction() const { return _hasPrediction; }
+  float probability() const { return _probability; }
+  // true uma única vez a cada subida acima de OUTAGE_ALERT_PROBABILITY
+  bool takeWarning();
+  int horizonMinutes() const;
+
+  // Canais do modelo em [0, 1]: http, rtt, perda, dns
+  static void normalize(const DiagnosticSample& sample, float* out);
+
+private:
+  bool _hasPrediction = false;
+  float _probability = 0.0f;
+  bool _armed = true;
+  bool _warningPending = false;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef PCAP_STREAM_H
+#define PCAP_STREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+#define PCAP_LINKTYPE_RADIOTAP 127
+#define PCAP_MAX_FRAME 1500
+#define PCAP_RADIOTAP_LENGTH 15
+
+// Anel de bytes produtor-único/consumidor-único que transforma os quadros do
+// callback promíscuo num fluxo pcap (com cabeçalho radiotap mínimo) lido aos
+// pedaços pelo servidor web. Nada além do anel e de um registro é armazenado:
+// se o consumidor não acompanhar, os quadros novos são descartados e contados.
+class PcapStream {
+public:
+  PcapStream();
+  // Aloca o anel uma única vez; chamadas seguintes só validam a alocação
+  bool begin(size_t capacityBytes);
+  // Reinicia o fluxo (cabeçalho global incluso). Só chamar sem produtor ativo.
+  void start(uint64_t startEpochUs);
+
+  // Produtor (callback do Wi-Fi): nunca bloqueia
+  bool push(const uint8_t* frame, uint16_t capturedLength, uint16_t originalLength,
+            uint32_t timestampUs, int8_t rssi, uint8_t channel);
+
+  // Consumidor (tarefa do AsyncTCP): escreve até maxLen bytes do fluxo pcap
+  size_t read(uint8_t* out, size_t maxLen);
+  bool hasPending() const;
+  // Consumidor: joga fora o que falta entregar (o leitor foi embora)
+  void discard();
+
+  uint32_t capturedFrames() const { return _captured.load(); }
+  uint32_t droppedFrames() const { return _dropped.load(); }
+
+private:
+  struct RecordHeader {
+    uint16_t capturedLength;
+    uint16_t originalLength;
+    uint32_t timestampUs;
+    int8_t rssi;
+    uint8_t channel;
+  };
+
+  uint8_t* _ring;
+  size_t _capacity;
+  std::atomic<size_t> _head;   // Escrito só pelo produtor
+  std::atomic<size_t> _tail;   // Escrito só pelo consumidor
+  std::atomic<uint32_t> _captured;
+  std::atomic<uint32_t> _dropped;
+
+  // Registro pcap sendo entregue ao consumidor (cabeçalhos + quadro)
+  uint8_t _staging[16 + PCAP_RADIOTAP_LENGTH + PCAP_MAX_FRAME];
+  size_t _stagingLength;
+  size_t _stagingOffset;
+
+  uint64_t _startEpochUs;
+  uint32_t _firstFrameUs;
+  bool _haveFirstFrame;
+
+  void _ringWrite(size_t position, const void* data, size_t length);
+  void _ringRead(size_t position, void* data, size_t length) const;
+  bool _stageNextRecord();
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef PROBE_ENGINE_H
+#define PROBE_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "IcmpEngine.h"
+
+// Sondas de conectividade disparadas em paralelo, com prazo fixo.
+//
+// Cada rodada abre todas as sondas de uma vez com sockets não bloqueantes
+// (HTTP GET no generate_204, consulta DNS, TCP connect e ICMP echo, este
+// pelo IcmpEngine) e espera as respostas num único select(). O veredito é
+// por quorum: a internet está de pé quando pelo menos 'quorum' destinos
+// públicos distintos responderam.
+// Com stopAtQuorum a rodada termina assim que o quorum fecha; sem ele,
+// espera todas as sondas para medir tempos e perda. Em qualquer caso nada
+// passa do prazo: sonda sem resposta até lá conta como falha.
+//
+// A sonda HTTP sem endereço usa o IP que a última resposta DNS deu para o
+// host; sem nenhum ainda, espera a primeira resposta DNS da própria rodada.
+//
+// Não é reentrante: uma rodada por vez (task de operação).
+
+#define PROBE_MAX 16
+#define PROBE_HTTP_STATUS_LEN 12  // "HTTP/1.1 204": o bastante para decidir
+#define PROBE_DEADLINE_MS 2000  // Prazo padrão de uma rodada
+#define PROBE_HOST_MAX 64
+
+// Hop: eco ICMP com TTL curto, respondido pelo roteador onde o TTL acaba
+enum class ProbeKind : uint8_t { Http, Dns, TcpConnect, Icmp, Hop };
+
+struct ProbeResult {
+  ProbeKind kind;
+  uint32_t ip;        // Ordem de rede (como em sockaddr_in); 0 = HTTP sem endereço
+  uint16_t port;
+  bool ok;
+  bool votes;         // Conta para o quorum (destino público)
+  uint32_t us;        // Tempo até a resposta (válido com ok)
+  uint16_t startMs;   // Atraso do disparo a partir do início da rodada
+  uint8_t ttl;        // Hop: TTL do eco
+  uint32_t from;      // Quem respondeu (Hop: o roteador daquele salto)
+};
+
+struct ProbeVerdict {
+  bool online;
+  uint8_t answered;   // Destinos distintos que votam e responderam
+  uint8_t succeeded;  // Sondas com resposta
+  uint8_t failed;     // Sondas sem resposta no prazo (ou que nem partiram)
+  uint16_t elapsedMs;
+};
+
+class ProbeEngine {
+public:
+  ProbeEngine();
+
+  // Host das sondas HTTP e DNS (ex.: "clients3.google.com") e caminho do GET
+  void setHost(const char* host, const char* path);
+
+  void clear();
+  // Acrescenta uma sonda; 'startMs' atrasa o disparo (rajadas de ICMP). Retorna o índice ou -1.
+  int add(ProbeKind kind, uint32_t ip, uint16_t port = 0, uint16_t startMs = 0);
+  // Eco para 'ip' com TTL 'ttl'; nunca vota no quorum
+  int addHop(uint32_t ip, uint8_t ttl, uint16_t startMs = 0);
+  size_t count() const { return _count; }
+  const ProbeResult& result(size_t i) const { return _probes[i].result; }
+
+  ProbeVerdict run(uint16_t deadlineMs, uint8_t quorum, bool stopAtQuorum);
+
+  // Endereço aprendido para o host (0 enquanto nenhuma resposta DNS chegou)
+  uint32_t hostIp() const { return _hostIp; }
+
+  static const char* kindName(ProbeKind kind);
+  // IPv4 "a.b.c.d" em ordem de rede
+  static uint32_t ip(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+  static bool isPublic(uint32_t ip);
+
+private:
+  enum class State : uint8_t { Idle, WaitingAddress, Connecting, Sent, Done };
+
+  struct Probe {
+    ProbeResult result;
+    State state;
+    int fd;
+    uint16_t id;        // Id da consulta DNS
+    uint32_t startUs;
+    uint8_t statusLength;                 // HTTP: bytes da linha de status já lidos
+    char status[PROBE_HTTP_STATUS_LEN];   // "HTTP/1.1 204"
+  };
+
+  Probe _probes[PROBE_MAX];
+  size_t _count = 0;
+  char _host[PROBE_HOST_MAX];
+  char _path[PROBE_HOST_MAX];
+  uint32_t _hostIp = 0;
+  IcmpEngine _icmp;
+
+  void _start(Probe& probe, uint32_t nowUs);
+  void _finish(Probe& probe, bool ok, uint32_t nowUs);
+  void _onReadable(Probe& probe, uint32_t nowUs);
+  void _onWritable(Probe& probe, uint32_t nowUs);
+  static void _onEcho(void* context, uint16_t tag, uint32_t ip, int32_t rttUs);
+  void _onAddress(uint32_t address, uint32_t nowUs);
+  size_t _buildDnsQuery(uint16_t id, uint8_t* out, size_t maxLen) const;
+};
+
+#endif
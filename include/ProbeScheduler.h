@@ -0,0 +1,81 @@
+#ifndef PROBE_SCHEDULER_H
+#define PROBE_SCHEDULER_H
+
+#include <cstdint>
+
+// Intervalo adaptativo das batidas de conectividade, dentro de um orçamento
+// de sondas.
+//
+// A batida é um eco ICMP só (NetworkDiagnostics::heartbeat()). Com o link
+// saudável o intervalo dobra a cada PROBE_HEALTHY_STREAK batidas boas, até
+// PROBE_MAX_INTERVAL_MS. RTT acima de srtt + 4·rttvar (o limite do RTO do
+// TCP, RFC 6298) ou perda na amostra do minuto dividem o intervalo por 4.
+// Uma batida sem resposta vai direto a PROBE_MIN_INTERVAL_MS, e a seguinte
+// vai a outro alvo. PROBE_CONFIRM_FAILURES falhas seguidas em alvos
+// distintos equivalem a perder o quorum e pedem a verificação completa na
+// hora, sem esperar o minuto; durante a queda, a primeira resposta também.
+//
+// Toda sonda, inclusive as da verificação completa, sai de um crédito que
+// se recarrega a PROBE_BUDGET_PER_MIN por minuto até PROBE_BUDGET_BURST. Com
+// o link saudável sobra crédito; degradado, a rajada a cada 2 s gasta o
+// acumulado e depois o intervalo fica no que a recarga paga. Na média o
+// tráfego não passa do orçamento, que é o da antiga verificação fixa de 60 s.
+
+#define PROBE_MIN_INTERVAL_MS 2000
+#define PROBE_MAX_INTERVAL_MS 15000
+#define PROBE_HEALTHY_STREAK 3       // Batidas boas seguidas para dobrar o intervalo
+#define PROBE_CONFIRM_FAILURES 2     // Falhas seguidas (alvos distintos) para a verificação completa
+#define PROBE_RTT_SLACK_US 5000      // Folga sobre o limite do RTT (evita alarme com rttvar ~0)
+
+#ifndef PROBE_BUDGET_PER_MIN
+#define PROBE_BUDGET_PER_MIN 11      // 5 pings + 2 DNS + HTTP + 2 TCP + TTL 2 por minuto
+#endif
+#define PROBE_BUDGET_BURST 60        // Sondas de crédito guardadas no máximo
+
+enum class LinkHealth : uint8_t {
+  Healthy,   // Batidas em dia, intervalo crescendo
+  Degraded,  // RTT alto, perda ou uma batida perdida
+  Down,      // A verificação completa declarou a queda
+};
+
+class ProbeScheduler {
+public:
+  ProbeScheduler();
+  void start(uint32_t nowMs);
+
+  // Resultado de uma batida (já cobrada). Retorna true quando a verificação
+  // completa deve rodar agora: falhas seguidas ou resposta durante a queda.
+  bool onHeartbeat(bool ok, uint32_t rttUs, uint32_t nowMs);
+  // Resultado da verificação completa do minuto
+  void onCheck(bool online, uint8_t lossPct);
+  // Desconta 'probes' sondas do crédito (fica negativo até -PROBE_BUDGET_BURST)
+  void charge(uint32_t probes, uint32_t nowMs);
+
+  // ms até a próxima batida: o intervalo atual, ou mais se faltar crédito
+  uint32_t nextDelay(uint32_t nowMs);
+  // Falhas seguidas: a batida seguinte escolhe o alvo por elas
+  uint8_t failures() const { return _failures; }
+
+  LinkHealth health() const { return _health; }
+  uint32_t intervalMs() const { return _intervalMs; }
+  uint32_t srttUs() const { return _srttUs; }
+  int32_t credit() const { return _creditMilli / 1000; }
+
+  static const char* healthName(LinkHealth health);
+
+private:
+  LinkHealth _health;
+  uint32_t _intervalMs;
+  uint8_t _streak;
+  uint8_t _failures;
+  uint32_t _srttUs;       // 0 até a primeira resposta
+  uint32_t _rttvarUs;
+  int32_t _creditMilli;   // Milésimos de sonda
+  uint32_t _refillMs;
+
+  void _refill(uint32_t nowMs);
+  void _tighten(uint32_t intervalMs);
+  void _setHealth(LinkHealth health);
+};
+
+#endif
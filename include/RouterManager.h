@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "NotificationManager.h" 
+#include "FaultLocator.h"
 #include "freertos/semphr.h"
 
 // Define os estados possíveis do nosso sistema
@@ -24,8 +25,9 @@ public:
   // A função loop() agora conterá a lógica da máquina de estados
   void loop();
 
-  // Função para o Módulo 2 nos informar o status da internet
-  void updateInternetStatus(bool isUp);
+  // Função para o Módulo 2 nos informar o status da internet e onde está a
+  // falha: os reboots agendados só acontecem se reiniciar o roteador ajuda
+  void updateInternetStatus(bool isUp, FaultVerdict fault);
 
   // NOVA FUNÇÃO para ligar o notificador ao manager
   void setNotificationManager(NotificationManager* nm);
@@ -43,6 +45,8 @@ private:
   // --- Variáveis de Estado ---
   SystemState _currentState;
   bool _isInternetUp;
+  FaultVerdict _fault;
+  FaultVerdict _announcedFault;  // Último veredito avisado no adiamento (um aviso por mudança)
   unsigned long _lastStateChangeTime;
 
   // --- Handle para o nosso Mutex ---
@@ -0,0 +1,69 @@
+#ifndef SEASONAL_BASELINE_H
+#define SEASONAL_BASELINE_H
+
+#include <cstdint>
+#include <ctime>
+#include "FeatureVector.h"
+
+// Baseline sazonal do tráfego: um balde por hora da semana (168), cada um com
+// média e variância exponenciais de cada característica.
+//
+// O tráfego das 03:00 de domingo não se parece com o das 20:00 de uma terça;
+// o autoencoder e o OnlineCalibrator veem uma única distribuição e marcam
+// tanto os picos quanto os vales normais. Aqui a janela é comparada só com as
+// janelas do mesmo horário: o escore é o maior |z| entre as características,
+// em escala log1p (contagens e bytes têm cauda longa).
+//
+// Em RAM os baldes são float (~11 KB); no NVS ficam quantizados (média Q10 e
+// desvio Q11 em 16 bits), um blob por dia da semana de ~0,8 KB.
+
+#define SEASONAL_BUCKETS 168
+#define SEASONAL_BUCKETS_PER_DAY 24
+#define SEASONAL_MIN_SAMPLES 8           // Janelas no balde antes de ele valer
+#define SEASONAL_ALPHA_MIN (1.0f / 32)   // Memória de ~2 semanas (~15 janelas por hora)
+#define SEASONAL_SD_FLOOR 0.1f           // Desvio mínimo em log1p (~10%): baldes estáveis não explodem o z
+#define SEASONAL_Z_THRESHOLD 4.0f        // Fora do típico do horário, com ou sem o modelo
+#define SEASONAL_Z_CONFIRM 3.0f          // Basta isso quando o modelo também sinaliza
+#define SEASONAL_STATE_VERSION 1
+#define SEASONAL_MIN_VALID_TIME 1609459200  // 2021-01-01: antes disso o SNTP ainda não sincronizou
+
+class SeasonalBaseline {
+public:
+  struct Bucket {
+    uint16_t count;
+    float mean[ANOMALY_FEATURE_COUNT];
+    float var[ANOMALY_FEATURE_COUNT];
+  };
+
+  // Um dia no formato do NVS
+  struct StoredBucket {
+    uint16_t count;
+    int16_t mean[ANOMALY_FEATURE_COUNT];  // Q10
+    uint16_t sd[ANOMALY_FEATURE_COUNT];   // Q11
+  };
+  struct StoredDay {
+    uint8_t version;
+    StoredBucket buckets[SEASONAL_BUCKETS_PER_DAY];
+  };
+
+  SeasonalBaseline();
+  void reset();
+
+  // Balde da hora local (domingo 00h = 0), ou -1 se o relógio não é confiável
+  static int bucketFor(time_t now);
+
+  bool isWarm(int bucket) const { return _buckets[bucket].count >= SEASONAL_MIN_SAMPLES; }
+  const Bucket& bucket(int bucket) const { return _buckets[bucket]; }
+
+  // Maior |z| da janela contra o balde; worstFeature recebe a característica responsável
+  float score(int bucket, const float* raw, int* worstFeature) const;
+  void update(int bucket, const float* raw);
+
+  void exportDay(int day, StoredDay* out) const;
+  bool importDay(int day, const StoredDay& in);
+
+private:
+  Bucket _buckets[SEASONAL_BUCKETS];
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef TCP_RTT_TRACKER_H
+#define TCP_RTT_TRACKER_H
+
+#include <cstdint>
+#include <cstddef>
+#include "FrameParser.h"
+
+#define TCP_RTT_MAX_FLOWS 64            // Potência de 2 (índice por máscara)
+#define TCP_RTT_MAX_PREFIXES 16
+#define TCP_RTT_SAMPLES_PER_PREFIX 32
+#define TCP_RTT_PREFIX_LEN 24
+
+// Resumo de RTT por prefixo de destino (/24), pronto para exportação
+struct TcpRttPrefixSummary {
+  uint32_t prefix;           // Ordem do host, já mascarado
+  uint8_t prefixLen;
+  uint16_t lanSamples;
+  uint16_t wanSamples;
+  uint32_t lanMedianUs;      // ACK do cliente - SYN-ACK (lado da LAN / Wi-Fi)
+  uint32_t lanP99Us;
+  uint32_t wanMedianUs;      // SYN-ACK - SYN (lado da WAN / upstream)
+  uint32_t wanP99Us;
+  uint32_t handshakes;
+  uint32_t retransmissions;
+};
+
+// Acompanha o handshake TCP (SYN -> SYN-ACK -> ACK) de forma passiva a partir
+// dos quadros decodificáveis e conta retransmissões por número de sequência
+// repetido. Memória fixa: tabela de fluxos com timeouts e anéis de amostras.
+class TcpRttTracker {
+public:
+  TcpRttTracker();
+  void reset();
+  void onFrame(const ParsedFrame& frame);
+  // Descarta fluxos parados; 'nowUs' deve vir do mesmo relógio dos quadros
+  void expire(uint32_t nowUs);
+  // Calcula mediana e p99 por prefixo. Retorna quantos resumos foram escritos.
+  size_t summarize(TcpRttPrefixSummary* out, size_t maxOut) const;
+
+  uint32_t totalRetransmissions() const { return _totalRetransmissions; }
+
+private:
+  enum FlowState : uint8_t { FLOW_FREE = 0, FLOW_SYN_SENT, FLOW_SYN_ACKED, FLOW_ESTABLISHED };
+
+  struct FlowEntry {
+    uint32_t clientIp;
+    uint32_t serverIp;
+    uint16_t clientPort;
+    uint16_t serverPort;
+    uint32_t clientIsn;
+    uint32_t serverIsn;
+    uint32_t synUs;
+    uint32_t synAckUs;
+    uint32_t lastSeenUs;
+    uint32_t nextSeq[2];     // [0] cliente -> servidor, [1] servidor -> cliente
+    uint8_t state;
+    bool synRetransmitted;   // Algoritmo de Karn: não amostra RTT ambíguo
+    bool seqKnown[2];
+  };
+
+  struct PrefixStats {
+    uint32_t prefix;
+    uint32_t lastUpdateUs;
+    uint32_t lan[TCP_RTT_SAMPLES_PER_PREFIX];
+    uint32_t wan[TCP_RTT_SAMPLES_PER_PREFIX];
+    uint16_t lanCount;
+    uint16_t wanCount;
+    uint16_t lanHead;
+    uint16_t wanHead;
+    uint32_t handshakes;
+    uint32_t retransmissions;
+    bool inUse;
+  };
+
+  FlowEntry _flows[TCP_RTT_MAX_FLOWS];
+  PrefixStats _prefixes[TCP_RTT_MAX_PREFIXES];
+  uint32_t _totalRetransmissions;
+
+  FlowEntry* _findFlow(uint32_t ipA, uint16_t portA, uint32_t ipB, uint16_t portB, int& direction);
+  FlowEntry* _allocateFlow(uint32_t clientIp, uint16_t clientPort, uint32_t serverIp, uint16_t serverPort, uint32_t nowUs);
+  PrefixStats* _prefixFor(uint32_t ip, uint32_t nowUs);
+  void _trackSequence(FlowEntry& flow, int direction, const ParsedFrame& frame);
+  static uint32_t _hash(uint32_t ipA, uint16_t portA, uint32_t ipB, uint16_t portB);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Roda de timers (hashed timing wheel, Varghese & Lauck) para as tarefas
+// periódicas da operationalTask.
+//
+// A roda tem TIMER_WHEEL_SLOTS casas de TIMER_WHEEL_TICK_MS cada. Um timer
+// cai na casa (tick de vencimento % casas) com o número de voltas que ainda
+// faltam; advance() só visita as casas dos ticks que passaram e dispara quem
+// está na volta zero. Agendar e cancelar são O(1) e a task dorme até
+// untilNext() em vez de acordar todo segundo para comparar millis() de cada
+// tarefa.
+//
+// Os timers são identificados por um índice fixo (< TIMER_WHEEL_MAX_TIMERS)
+// e reagendar um timer armado substitui o prazo anterior. Sem trava: a roda
+// pertence à task que a avança.
+
+#define TIMER_WHEEL_SLOTS 64       // Potência de 2
+#define TIMER_WHEEL_TICK_MS 100    // Uma volta = 6,4 s
+#define TIMER_WHEEL_MAX_TIMERS 16
+#define TIMER_WHEEL_NONE 0xFF
+
+#define TIMER_BIT(id) (1u << (id))
+
+class TimerWheel {
+public:
+  TimerWheel();
+  void start(uint32_t nowMs);
+
+  // Arma 'id' para daqui a 'delayMs', contados do último advance()
+  void schedule(uint8_t id, uint32_t delayMs);
+  void cancel(uint8_t id);
+  bool armed(uint8_t id) const { return id < TIMER_WHEEL_MAX_TIMERS && _timers[id].armed; }
+
+  // Gira a roda até 'nowMs' e retorna a máscara (TIMER_BIT) dos timers
+  // vencidos; eles ficam desarmados até o próximo schedule()
+  uint32_t advance(uint32_t nowMs);
+  // ms até o próximo vencimento (UINT32_MAX com a roda vazia)
+  uint32_t untilNext(uint32_t nowMs) const;
+
+private:
+  struct Timer {
+    uint32_t due;     // Tick de vencimento
+    uint8_t next;     // Próximo da mesma casa
+    uint8_t prev;
+    bool armed;
+  };
+  Timer _timers[TIMER_WHEEL_MAX_TIMERS];
+  uint8_t _slots[TIMER_WHEEL_SLOTS];  // Cabeça da lista de cada casa
+  uint32_t _tick;                     // Último tick processado
+  uint32_t _tickMs;                   // millis() do início desse tick (a conta sobrevive à volta do millis())
+
+  void _unlink(uint8_t id);
+};
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef TINY_MLP_H
+#define TINY_MLP_H
+
+#include <cmath>
+#include <cstdint>
+
+// Inferência de MLPs densos pequenos sem interpretador.
+//
+// As dimensões de cada camada são parâmetros do template, então todos os laços
+// têm limites conhecidos em tempo de compilação e o compilador os desenrola.
+// Os parâmetros ficam num único array plano (ver AnomalyModelWeights.h, gerado
+// pelo script do TinyML): para cada camada, os pesos [Out][In] linha a linha e
+// em seguida o bias [Out]. A ordem das operações é a mesma do kernel
+// FULLY_CONNECTED de referência do TFLite Micro, então os resultados batem com
+// ele dentro da precisão do float32.
+//
+// shapeHash() resume dimensões e ativações das camadas (FNV-1a das palavras
+// In, Out, Act de cada uma): um modelo carregado em tempo de execução
+// (AnomalyModelBlob.h) só é aceito se foi gerado para a mesma arquitetura.
+//
+// forwardBatch() avalia n vetores de uma vez (linha a linha, [n][inputs]): cada
+// linha de pesos é carregada uma vez por lote em vez de uma vez por vetor, e o
+// resultado é idêntico ao de n chamadas a forward().
+//
+// Cada camada tem um 'tag' com o nome do op equivalente no TFLite. A sobrecarga
+// de forwardBatch() que recebe um profiler chama BeginEvent(tag)/EndEvent() em
+// volta de cada camada, com a mesma interface do MicroProfiler do TFLM (ver
+// InferenceRuntime.h); a versão sem profiler não mede nada.
+//
+// Conv1D cobre as séries temporais (OutagePredictor): entrada [Steps][Channels]
+// (channels_last, como no Keras), saída [passos][Filters], que já é o Flatten
+// esperado por um Dense seguinte. Os pesos de cada filtro ficam [Kernel][Channels]
+// em sequência, então a janela de um passo é um produto escalar contíguo.
+//
+// forwardBatchInt8() roda o mesmo Sequential com o modelo quantizado em int8
+// (AnomalyModelInt8.h, gerado por quantize_mlp_header.py): entradas, saídas e
+// ativações int8, a conta do FULLY_CONNECTED int8 do TFLM. Com o ESP-NN
+// disponível (ESP32-S3) o produto escalar vai para esp_nn_fully_connected_s8,
+// que dá o mesmo resultado bit a bit. Só Dense tem a versão int8.
+
+#if defined(__GNUC__)
+#define TINYMLP_INLINE inline __attribute__((always_inline))
+#else
+#define TINYMLP_INLINE inline
+#endif
+
+#if defined(ARDUINO) && defined(__has_include)
+#if __has_include(<esp_nn.h>)
+#include <esp_nn.h>
+#define TINYMLP_ESP_NN
+#endif
+#endif
+
+namespace tinymlp {
+
+enum class Activation { Linear, Relu, Sigmoid };
+
+// Profiler que não mede nada: o que a versão sem profiler usa
+struct NoProfiler {
+  TINYMLP_INLINE uint32_t BeginEvent(const char*) { return 0; }
+  TINYMLP_INLINE void EndEvent(uint32_t) {}
+};
+
+constexpr uint32_t fnvWord(uint32_t hash, uint32_t word) {
+  for (int b = 0; b < 4; b++) hash = (hash ^ ((word >> (8 * b)) & 0xFFu)) * 16777619u;
+  return hash;
+}
+
+template <Activation Act>
+TINYMLP_INLINE float activate(float x) {
+  if (Act == Activation::Relu) return x > 0.0f ? x : 0.0f;
+  if (Act == Activation::Sigmoid) return 1.0f / (1.0f + expf(-x));
+  return x;
+}
+
+// Uma camada densa int8 (esquema do conversor do TFLite): pesos simétricos por
+// tensor, bias int32 na escala entrada * peso e a saída reescalada por
+// multiplier * 2^shift (Q31)
+struct QuantParams {
+  const int8_t* weights;   // [Out][In], zero point 0
+  const int32_t* bias;     // [Out]
+  int32_t inputOffset;     // -zero point da entrada
+  int32_t outputOffset;    // Zero point da saída
+  int32_t multiplier;
+  int32_t shift;           // Positivo = à esquerda
+  int32_t activationMin;   // Relu fundida: o zero point da saída
+  int32_t activationMax;
+  const int8_t* lut;       // Sigmoid: saída para cada entrada + 128; nullptr nas demais
+};
+
+// MultiplyByQuantizedMultiplier do TFLM: x * multiplier / 2^31 * 2^shift com
+// arredondamento (SaturatingRoundingDoublingHighMul + RoundingDivideByPOT)
+TINYMLP_INLINE int32_t requantize(int32_t x, int32_t multiplier, int32_t shift) {
+  int32_t left = shift > 0 ? shift : 0;
+  int32_t right = shift > 0 ? 0 : -shift;
+  int64_t scaled = (int64_t)x * ((int64_t)1 << left);
+  int32_t a = scaled > INT32_MAX ? INT32_MAX : (scaled < INT32_MIN ? INT32_MIN : (int32_t)scaled);
+  int32_t high;
+  if (a == INT32_MIN && multiplier == INT32_MIN) {
+    high = INT32_MAX;
+  } else {
+    int64_t ab = (int64_t)a * multiplier;
+    int64_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+    high = (int32_t)((ab + nudge) / ((int64_t)1 << 31));
+  }
+  int32_t mask = (int32_t)(((int64_t)1 << right) - 1);
+  int32_t remainder = high & mask;
+  int32_t threshold = (mask >> 1) + (high < 0 ? 1 : 0);
+  return (high >> right) + (remainder > threshold ? 1 : 0);
+}
+
+template <int In, int Out, Activation Act>
+struct Dense {
+  static constexpr int inputs = In;
+  static constexpr int outputs = Out;
+  static constexpr int paramCount = In * Out + Out;
+  static constexpr const char* tag = "FULLY_CONNECTED";
+
+  static constexpr uint32_t shapeHash(uint32_t hash) {
+    return fnvWord(fnvWord(fnvWord(hash, In), Out), (uint32_t)Act);
+  }
+
+  static TINYMLP_INLINE void forward(const float* params, const float* in, float* out) {
+    const float* bias = params + In * Out;
+#pragma GCC unroll 16
+    for (int o = 0; o < Out; o++) {
+      const float* row = params + o * In;
+      float acc = 0.0f;
+#pragma GCC unroll 16
+      for (int i = 0; i < In; i++) acc += row[i] * in[i];
+      out[o] = activate<Act>(acc + bias[o]);
+    }
+  }
+
+  static TINYMLP_INLINE void forwardBatch(const float* params, const float* in, float* out, int n) {
+    const float* bias = params + In * Out;
+    for (int o = 0; o < Out; o++) {
+      const float* row = params + o * In;
+      for (int b = 0; b < n; b++) {
+        const float* x = in + b * In;
+        float acc = 0.0f;
+#pragma GCC unroll 16
+        for (int i = 0; i < In; i++) acc += row[i] * x[i];
+        out[b * Out + o] = activate<Act>(acc + bias[o]);
+      }
+    }
+  }
+
+  static TINYMLP_INLINE void forwardBatchInt8(const QuantParams& q, const int8_t* in, int8_t* out, int n) {
+    for (int b = 0; b < n; b++) {
+      const int8_t* x = in + b * In;
+      int8_t* y = out + b * Out;
+#ifdef TINYMLP_ESP_NN
+      esp_nn_fully_connected_s8(x, q.inputOffset, In, q.weights, 0, q.bias, y, Out, q.outputOffset, q.shift,
+                                q.multiplier, q.activationMin, q.activationMax);
+#else
+      for (int o = 0; o < Out; o++) {
+        const int8_t* row = q.weights + o * In;
+        int32_t acc = q.bias[o];
+#pragma GCC unroll 16
+        for (int i = 0; i < In; i++) acc += (x[i] + q.inputOffset) * row[i];
+        acc = requantize(acc, q.multiplier, q.shift) + q.outputOffset;
+        y[o] = (int8_t)(acc < q.activationMin ? q.activationMin : (acc > q.activationMax ? q.activationMax : acc));
+      }
+#endif
+      if (Act == Activation::Sigmoid) {
+        for (int o = 0; o < Out; o++) y[o] = q.lut[y[o] + 128];
+      }
+    }
+  }
+};
+
+template <int Steps, int Channels, int Filters, int Kernel, int Stride, Activation Act>
+struct Conv1D {
+  static_assert(Kernel <= Steps && Stride > 0, "janela da convolução inválida");
+  static constexpr int outSteps = (Steps - Kernel) / Stride + 1;
+  static constexpr int inputs = Steps * Channels;
+  static constexpr int outputs = outSteps * Filters;
+  static constexpr int paramCount = Filters * Kernel * Channels + Filters;
+  static constexpr const char* tag = "CONV_1D";
+
+  static constexpr uint32_t shapeHash(uint32_t hash) {
+    // 0x100 separa a convolução de um Dense com as mesmas dimensões
+    return fnvWord(fnvWord(fnvWord(fnvWord(hash, inputs), outputs), 0x100u | (uint32_t)Act),
+                   ((uint32_t)Kernel << 16) | (uint32_t)Stride);
+  }
+
+  static TINYMLP_INLINE void forward(const float* params, const float* in, float* out) {
+    const float* bias = params + Filters * Kernel * Channels;
+    for (int s = 0; s < outSteps; s++) {
+      const float* window = in + s * Stride * Channels;
+#pragma GCC unroll 8
+      for (int f = 0; f < Filters; f++) {
+        const float* kernel = params + f * Kernel * Channels;
+        float acc = 0.0f;
+#pragma GCC unroll 16
+        for (int i = 0; i < Kernel * Channels; i++) acc += kernel[i] * window[i];
+        out[s * Filters + f] = activate<Act>(acc + bias[f]);
+      }
+    }
+  }
+
+  static TINYMLP_INLINE void forwardBatch(const float* params, const float* in, float* out, int n) {
+    for (int b = 0; b < n; b++) forward(params, in + b * inputs, out + b * outputs);
+  }
+};
+
+// Encadeia as camadas; a saída de cada uma vai para um buffer na pilha do tamanho exato
+template <typename First, typename... Rest>
+struct Sequential {
+  typedef Sequential<Rest...> Tail;
+  static_assert(First::outputs == Tail::inputs, "dimensões de camadas consecutivas não combinam");
+
+  static constexpr int inputs = First::inputs;
+  static constexpr int outputs = Tail::outputs;
+  static constexpr int paramCount = First::paramCount + Tail::paramCount;
+  // Maior camada oculta: cada buffer de rascunho do lote precisa de n * hiddenWidth floats
+  static constexpr int hiddenWidth = (First::outputs > Tail::hiddenWidth) ? First::outputs : Tail::hiddenWidth;
+  static constexpr int layerCount = 1 + Tail::layerCount;
+
+  static constexpr uint32_t shapeHash(uint32_t hash = 2166136261u) { return Tail::shapeHash(First::shapeHash(hash)); }
+
+  static TINYMLP_INLINE void forward(const float* params, const float* in, float* out) {
+    float hidden[First::outputs];
+    First::forward(params, in, hidden);
+    Tail::forward(params + First::paramCount, hidden, out);
+  }
+
+  // As camadas ocultas alternam entre os dois buffers de rascunho
+  static TINYMLP_INLINE void forwardBatch(const float* params, const float* in, float* out, int n,
+                                          float* scratchA, float* scratchB) {
+    NoProfiler none;
+    forwardBatch(params, in, out, n, scratchA, scratchB, none);
+  }
+
+  template <typename Profiler>
+  static TINYMLP_INLINE void forwardBatch(const float* params, const float* in, float* out, int n,
+                                          float* scratchA, float* scratchB, Profiler& profiler) {
+    uint32_t event = profiler.BeginEvent(First::tag);
+    First::forwardBatch(params, in, scratchA, n);
+    profiler.EndEvent(event);
+    Tail::forwardBatch(params + First::paramCount, scratchA, out, n, scratchB, scratchA, profiler);
+  }
+
+  // Modelo int8: um QuantParams por camada; cada buffer de rascunho com n * hiddenWidth bytes
+  template <typename Profiler>
+  static TINYMLP_INLINE void forwardBatchInt8(const QuantParams* layers, const int8_t* in, int8_t* out, int n,
+                                              int8_t* scratchA, int8_t* scratchB, Profiler& profiler) {
+    uint32_t event = profiler.BeginEvent(First::tag);
+    First::forwardBatchInt8(layers[0], in, scratchA, n);
+    profiler.EndEvent(event);
+    Tail::forwardBatchInt8(layers + 1, scratchA, out, n, scratchB, scratchA, profiler);
+  }
+};
+
+template <typename Last>
+struct Sequential<Last> {
+  static constexpr int inputs = Last::inputs;
+  static constexpr int outputs = Last::outputs;
+  static constexpr int paramCount = Last::paramCount;
+  static constexpr int hiddenWidth = 0;
+  static constexpr int layerCount = 1;
+
+  static constexpr uint32_t shapeHash(uint32_t hash = 2166136261u) { return Last::shapeHash(hash); }
+
+  static TINYMLP_INLINE void forward(const float* params, const float* in, float* out) {
+    Last::forward(params, in, out);
+  }
+
+  static TINYMLP_INLINE void forwardBatch(const float* params, const float* in, float* out, int n,
+                                          float*, float*) {
+    Last::forwardBatch(params, in, out, n);
+  }
+
+  template <typename Profiler>
+  static TINYMLP_INLINE void forwardBatch(const float* params, const float* in, float* out, int n,
+                                          float*, float*, Profiler& profiler) {
+    uint32_t event = profiler.BeginEvent(Last::tag);
+    Last::forwardBatch(params, in, out, n);
+    profiler.EndEvent(event);
+  }
+
+  template <typename Profiler>
+  static TINYMLP_INLINE void forwardBatchInt8(const QuantParams* layers, const int8_t* in, int8_t* out, int n,
+                                              int8_t*, int8_t*, Profiler& profiler) {
+    uint32_t event = profiler.BeginEvent(Last::tag);
+    Last::forwardBatchInt8(layers[0], in, out, n);
+    profiler.EndEvent(event);
+  }
+};
+
+} // namespace tinymlp
+
+#endif
@@ -5,11 +5,24 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "TcpRttTracker.h"
+#include "FeatureVector.h"
+#include "NetFlowExporter.h"
+#include "AppClassifier.h"
+#include "DeviceFingerprint.h"
+#include "DeviceProfile.h"
+
+// Anel usado pela captura pcap ao vivo (/capture.pcap)
+#define PCAP_RING_BYTES (24 * 1024)
 
 // MUDANÇA: A struct agora carrega o pacote bruto para análise na tarefa
 struct CapturedPacketInfo {
   uint8_t payload[1500]; // Buffer para guardar o pacote
   int length;
+  uint32_t timestamp;    // rx_ctrl.timestamp (microssegundos)
+  int8_t rssi;
+  uint8_t channel;
 };
 
 void snifferTask(void *pvParameters);
@@ -24,6 +37,49 @@ public:
   uint32_t _total_packets_in_window;
   uint64_t _total_bytes_in_window;
 
+  // Características do último ciclo sniffer para o AnomalyDetector (válidas após stop())
+  const FeatureVector& windowFeatures() const { return _windowFeatures; }
+  // Características por transmissor do mesmo ciclo
+  const DeviceFeatures* deviceFeatures() const { return _deviceFeatures; }
+  size_t deviceFeatureCount() const { return _deviceFeatureCount; }
+  // Perfil de comportamento de cada MAC (bytes/pacotes por minuto, horas ativas
+  // e destinos); deviations() depois de stop()
+  DeviceProfileStore& profiles();
+  // Tipo de cada dispositivo pelos primeiros minutos de tráfego (Módulo 11);
+  // classify() depois de stop()
+  DeviceFingerprinter& fingerprinter();
+
+  // Copia o último resumo de RTT TCP por prefixo de destino (thread-safe)
+  size_t getRttSummary(TcpRttPrefixSummary* out, size_t maxOut);
+  // Atividade de cada estação no ciclo atual/último (Módulo 12), da que mais
+  // trafegou para a que menos (thread-safe)
+  size_t getActivities(StationActivity* out, size_t maxOut);
+  bool activityOf(const uint8_t* mac, StationActivity* out);
+
+  // Coletor NetFlow v9 (host vazio desativa a exportação)
+  void setFlowCollector(const char* host, uint16_t port);
+  // Envia os fluxos expirados pendentes; chamar com o Wi-Fi conectado
+  size_t exportFlows();
+
+  // Captura pcap ao vivo sem desconectar do AP (modo promíscuo no canal atual).
+  // Retorna o id da captura, ou 0 se recusada: outra captura em curso, fluxo
+  // ainda com dono ou com bytes por entregar, ou modo sniffer ativo. O fluxo
+  // pertence a esse id até releaseCapture(); as demais chamadas com outro id
+  // não fazem nada.
+  uint32_t startCapture(uint32_t seconds);
+  void stopCapture(uint32_t captureId);
+  // Encerra a captura cujo prazo venceu (operationalTask e leitor do fluxo)
+  void expireCapture();
+  // Captura em curso ou fluxo ainda sendo entregue
+  bool isCapturing() const;
+  // Lê o próximo pedaço do fluxo pcap; 0 significa "nada disponível agora"
+  size_t readCapture(uint32_t captureId, uint8_t* buffer, size_t maxLen);
+  bool isCaptureFinished(uint32_t captureId) const;
+  // A resposta terminou ou o cliente caiu: encerra a captura e libera o fluxo
+  void releaseCapture(uint32_t captureId);
+  uint32_t capturedFrames() const;
+  uint32_t droppedCaptureFrames() const;
+
 private:
   QueueHandle_t _packetQueue;
   TaskHandle_t _snifferTaskHandle;
@@ -32,6 +88,20 @@ private:
   uint8_t _target_bssid[6];
   uint8_t _target_channel;
 
+  SemaphoreHandle_t _summaryMutex;
+  TcpRttPrefixSummary _rttSummary[TCP_RTT_MAX_PREFIXES];
+  size_t _rttSummaryCount;
+  void _publishRttSummary();
+  StationActivity _activities[APP_MAX_STATIONS];
+  size_t _activityCount;
+  void _publishActivities();
+
+  NetFlowExporter _flowExporter;
+  FeatureVector _windowFeatures;
+  DeviceFeatures _deviceFeatures[FEATURE_MAX_STATIONS];
+  size_t _deviceFeatureCount = 0;
+  unsigned long _captureDeadline;
+
   static void snifferCallback(void *buf, wifi_promiscuous_pkt_type_t type);
   friend void snifferTask(void *pvParameters);
 };
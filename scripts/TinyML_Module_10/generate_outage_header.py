@@ -0,0 +1,194 @@
+"""Gera include/OutageModelWeights.h, os pesos do preditor de quedas.
+
+O header traz o tipo tinymlp::Sequential<Conv1D, Dense, Dense> do modelo, as
+constantes da janela e da normalização (outage_common.py) e os parâmetros em
+um array constexpr, na ordem que include/TinyMlp.h espera: para a Conv1D, os
+pesos de cada filtro [kernel][canal] e depois o bias; para cada Dense, os pesos
+[saída][entrada] e depois o bias. Também grava vetores de referência,
+calculados aqui em float32 na mesma ordem de operações; tools/mlp_check
+compara a engine C++ com eles.
+
+Sem argumentos grava os pesos a priori (prior_layers): um modelo escrito à mão,
+com o mesmo formato do treinado, que só olha para o nível e a tendência de cada
+medida. Ele vale até haver quedas gravadas para treinar com
+train_outage_model.py, que chama generate() com os pesos do Keras.
+
+Uso (só biblioteca padrão):
+    python generate_outage_header.py [saida.h]
+"""
+import math
+import os
+import struct
+import sys
+
+from outage_common import (CHANNEL_NAMES, CHANNELS, DNS_CAP_MS, FILTERS, HIDDEN, HORIZON_MIN, HTTP_CAP_MS, KERNEL,
+                           RTT_CAP_MS, STRIDE, WINDOW)
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_HEADER = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'OutageModelWeights.h')
+
+OUT_STEPS = (WINDOW - KERNEL) // STRIDE + 1
+
+
+def f32(x):
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+
+def prior_layers():
+    """Pesos a priori: [(conv[f][k][c], bias)], [(dense[o][i], bias)] x 2.
+
+    Filtro c = excesso médio do canal c sobre o normal em cada bloco de KERNEL
+    amostras. Ocultos 0..3 = nível recente de cada canal; 4..7 = subida do canal
+    entre o primeiro e o último bloco. A saída pesa os dois, com viés que dá
+    ~2% de probabilidade para uma rede saudável.
+    """
+    normal = [0.1, 0.1, 0.0, 0.05]   # HTTP 500 ms, RTT 100 ms, sem perda, DNS 100 ms
+    conv = [[[1.0 / KERNEL if c == f else 0.0 for c in range(CHANNELS)] for _ in range(KERNEL)]
+            for f in range(FILTERS)]
+    conv_bias = [0.0 - normal[f] for f in range(FILTERS)]
+
+    recent = {OUT_STEPS - 1: 0.6, OUT_STEPS - 2: 0.3, OUT_STEPS - 3: 0.1}
+    hidden = []
+    for c in range(CHANNELS):
+        hidden.append([recent.get(s, 0.0) if f == c else 0.0 for s in range(OUT_STEPS) for f in range(FILTERS)])
+    for c in range(CHANNELS):
+        trend = {OUT_STEPS - 1: 1.0, 0: -1.0}
+        hidden.append([trend.get(s, 0.0) if f == c else 0.0 for s in range(OUT_STEPS) for f in range(FILTERS)])
+    hidden_bias = [0.0] * HIDDEN
+
+    level_weight = [4.0, 3.0, 6.0, 3.0]
+    trend_weight = [3.0, 3.0, 4.0, 2.0]
+    output = [level_weight + trend_weight]
+    return [('Conv1D', conv, conv_bias, 'Relu'), ('Dense', hidden, hidden_bias, 'Relu'),
+            ('Dense', output, [-4.0], 'Sigmoid')]
+
+
+def activate(x, activation):
+    if activation == 'Relu':
+        return max(x, 0.0)
+    if activation == 'Sigmoid':
+        return f32(1.0 / (1.0 + math.exp(-x)))
+    return x
+
+
+def reference_forward(layers, window):
+    """Emula tinymlp em float32; 'window' é [WINDOW][CHANNELS]."""
+    x = [v for row in window for v in row]
+    for kind, weights, bias, activation in layers:
+        y = []
+        if kind == 'Conv1D':
+            for s in range(OUT_STEPS):
+                patch = x[s * STRIDE * CHANNELS:(s * STRIDE + KERNEL) * CHANNELS]
+                for f, kernel in enumerate(weights):
+                    acc = 0.0
+                    for w, v in zip([w for row in kernel for w in row], patch):
+                        acc = f32(acc + f32(w * v))
+                    y.append(activate(f32(acc + bias[f]), activation))
+        else:
+            for o, row in enumerate(weights):
+                acc = 0.0
+                for w, v in zip(row, x):
+                    acc = f32(acc + f32(w * v))
+                y.append(activate(f32(acc + bias[o]), activation))
+        x = y
+    return x
+
+
+def flat_params(layers):
+    params = []
+    for kind, weights, bias, _ in layers:
+        for row in weights:
+            params += [w for k in row for w in k] if kind == 'Conv1D' else row
+        params += bias
+    return params
+
+
+def reference_windows():
+    """Cenários sintéticos: rede saudável, degradação crescente de cada medida e tudo fora."""
+    healthy = [0.04, 0.03, 0.0, 0.02]
+    windows = [[list(healthy) for _ in range(WINDOW)]]
+    for c in range(CHANNELS):
+        for level in (0.3, 1.0):
+            windows.append([[healthy[k] if k != c else healthy[k] + (level - healthy[k]) * t / (WINDOW - 1)
+                             for k in range(CHANNELS)] for t in range(WINDOW)])
+    windows.append([[0.02 * ((t * 7 + k * 3) % 5) for k in range(CHANNELS)] for t in range(WINDOW)])
+    windows.append([[1.0] * CHANNELS for _ in range(WINDOW)])
+    return [[[f32(v) for v in row] for row in w] for w in windows]
+
+
+def fmt(v):
+    return '%.9ef' % v
+
+
+def generate(layers=None, header_path=DEFAULT_HEADER, source=None):
+    if layers is None:
+        layers = prior_layers()
+        source = 'pesos a priori escritos à mão (prior_layers), sem treino'
+    params = flat_params(layers)
+    windows = reference_windows()
+    outputs = [reference_forward(layers, w)[0] for w in windows]
+
+    lines = [
+        '#ifndef OUTAGE_MODEL_WEIGHTS_H',
+        '#define OUTAGE_MODEL_WEIGHTS_H',
+        '',
+        '// Gerado por scripts/TinyML_Module_10/generate_outage_header.py a partir de',
+        '// %s.' % source,
+        '// Não edite à mão: rode o script novamente.',
+        '',
+        '#include <cstdint>',
+        '#include "TinyMlp.h"',
+        '',
+        '// Janela de %d verificações x %d canais (%s), normalizados para [0, 1]'
+        % (WINDOW, CHANNELS, ', '.join(CHANNEL_NAMES)),
+        '#define OUTAGE_WINDOW %d' % WINDOW,
+        '#define OUTAGE_CHANNELS %d' % CHANNELS,
+        '// Saída: probabilidade de a internet cair nos próximos OUTAGE_HORIZON_MIN minutos',
+        '#define OUTAGE_HORIZON_MIN %d' % HORIZON_MIN,
+        '',
+        'typedef tinymlp::Sequential<',
+        '    tinymlp::Conv1D<%d, %d, %d, %d, %d, tinymlp::Activation::%s>,'
+        % (WINDOW, CHANNELS, FILTERS, KERNEL, STRIDE, layers[0][3]),
+        '    tinymlp::Dense<%d, %d, tinymlp::Activation::%s>,' % (OUT_STEPS * FILTERS, HIDDEN, layers[1][3]),
+        '    tinymlp::Dense<%d, 1, tinymlp::Activation::%s>' % (HIDDEN, layers[2][3]),
+        '> OutageModel;',
+        '',
+        '// Saturação da normalização: min(ms, limite) / limite; sem resposta = 1',
+        'constexpr float outage_http_cap_ms = %.1ff;' % HTTP_CAP_MS,
+        'constexpr float outage_rtt_cap_ms = %.1ff;' % RTT_CAP_MS,
+        'constexpr float outage_dns_cap_ms = %.1ff;' % DNS_CAP_MS,
+        '',
+        '// Conv1D: pesos [filtro][kernel][canal] e bias; Dense: pesos [saída][entrada] e bias',
+        'constexpr float outage_model_params[OutageModel::paramCount] = {',
+    ]
+    for i, (kind, weights, bias, activation) in enumerate(layers):
+        lines.append('  // Camada %d: %s (%s)' % (i, kind, activation))
+        for row in weights:
+            # Conv1D: uma linha por passo do kernel de cada filtro
+            for values in (row if kind == 'Conv1D' else [row]):
+                lines += ['  ' + ', '.join(fmt(w) for w in values[i:i + 8]) + ',' for i in range(0, len(values), 8)]
+        lines.append('  ' + ', '.join(fmt(b) for b in bias) + ',')
+    lines += ['};', '']
+
+    lines.append('// Saídas esperadas (float32, mesma ordem de operações da engine)')
+    lines.append('constexpr int outage_model_reference_count = %d;' % len(windows))
+    lines.append('constexpr float outage_model_reference_inputs[][OUTAGE_WINDOW * OUTAGE_CHANNELS] = {')
+    for w in windows:
+        values = [fmt(v) for row in w for v in row]
+        lines.append('  {')
+        lines += ['    ' + ', '.join(values[i:i + 8]) + ',' for i in range(0, len(values), 8)]
+        lines.append('  },')
+    lines.append('};')
+    lines.append('constexpr float outage_model_reference_outputs[] = { %s };' % ', '.join(fmt(v) for v in outputs))
+    lines += ['', '#endif', '']
+
+    with open(header_path, 'w', newline='\n') as f:
+        f.write('\n'.join(lines))
+    print("Pesos do preditor de quedas (%d parâmetros, %d B) salvos em '%s'"
+          % (len(params), 4 * len(params), os.path.normpath(header_path)))
+    for w, p in zip(windows, outputs):
+        print('  referência: último passo %s -> p(queda) = %.3f' % (['%.2f' % v for v in w[-1]], p))
+
+
+if __name__ == '__main__':
+    generate(header_path=sys.argv[1] if len(sys.argv) > 1 else DEFAULT_HEADER)
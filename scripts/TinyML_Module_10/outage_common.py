@@ -0,0 +1,98 @@
+"""Janela, normalização e rótulos do preditor de quedas (include/OutagePredictor.h).
+
+Lê os CSVs baixados de http://<ip-do-esp32>/diagnostics.csv (o anel de
+include/DiagnosticsRing.h) e monta as janelas de treino. As constantes e a
+normalização precisam bater com o firmware: generate_outage_header.py as
+grava em include/OutageModelWeights.h.
+"""
+import bisect
+import csv
+
+# Arquitetura: Conv1D(FILTERS, KERNEL, strides=STRIDE, relu) -> Flatten ->
+# Dense(HIDDEN, relu) -> Dense(1, sigmoid), sobre WINDOW amostras x CHANNELS
+WINDOW = 30
+CHANNELS = 4
+FILTERS = 4
+KERNEL = 6
+STRIDE = 6
+HIDDEN = 8
+CHANNEL_NAMES = ['http', 'rtt', 'loss', 'dns']
+
+# Probabilidade de queda nos próximos HORIZON_MIN minutos
+HORIZON_MIN = 10
+
+# Saturação da normalização (ms); medida sem resposta vale 1.0
+HTTP_CAP_MS = 5000.0
+RTT_CAP_MS = 1000.0
+DNS_CAP_MS = 2000.0
+
+# Um intervalo maior que este entre amostras (reboot, Wi-Fi fora) quebra a sequência
+MAX_GAP_S = 600
+
+
+def _capped(ms, cap):
+    return 1.0 if ms < 0 else min(ms, cap) / cap
+
+
+def normalize(sample):
+    """Mesma conta de OutagePredictor::normalize()."""
+    return [_capped(sample['http_ms'], HTTP_CAP_MS), _capped(sample['rtt_ms'], RTT_CAP_MS),
+            sample['loss_pct'] / 100.0, _capped(sample['dns_ms'], DNS_CAP_MS)]
+
+
+def read_rings(paths):
+    """Amostras de vários downloads do anel, sem repetições e em ordem de tempo.
+
+    Só entram amostras com horário do SNTP (epoch=1): o rótulo depende de
+    comparar horários entre downloads diferentes.
+    """
+    samples = {}
+    for path in paths:
+        with open(path, newline='') as f:
+            for row in csv.DictReader(f):
+                if row['epoch'] != '1':
+                    continue
+                t = int(row['time'])
+                samples[t] = {
+                    'time': t,
+                    'online': row['online'] == '1',
+                    'http_ms': int(row['http_ms']),
+                    'dns_ms': int(row['dns_ms']),
+                    'rtt_ms': int(row['rtt_ms']),
+                    'loss_pct': int(row['loss_pct']),
+                }
+    return [samples[t] for t in sorted(samples)]
+
+
+def segments(samples):
+    """Divide em trechos sem intervalos maiores que MAX_GAP_S."""
+    current = []
+    for s in samples:
+        if current and s['time'] - current[-1]['time'] > MAX_GAP_S:
+            yield current
+            current = []
+        current.append(s)
+    if current:
+        yield current
+
+
+def build_windows(samples):
+    """(janelas [n][WINDOW][CHANNELS], rótulos [n]).
+
+    Uma janela termina numa verificação online; o rótulo é 1 se alguma
+    verificação offline acontece nos HORIZON_MIN minutos seguintes. Janelas que
+    terminam já com a internet fora não entram: aí não há o que prever.
+    """
+    offline_times = [s['time'] for s in samples if not s['online']]
+    horizon_s = HORIZON_MIN * 60
+    windows, labels = [], []
+    for seg in segments(samples):
+        for end in range(WINDOW - 1, len(seg)):
+            last = seg[end]
+            if not last['online']:
+                continue
+            t = last['time']
+            windows.append([normalize(s) for s in seg[end - WINDOW + 1:end + 1]])
+            k = bisect.bisect_right(offline_times, t)
+            labels.append(1 if k < len(offline_times) and offline_times[k] <= t + horizon_s else 0)
+    return windows, labels
@@ -0,0 +1,86 @@
+"""Treina o preditor de quedas com os históricos gravados pelo próprio ESP32.
+
+Baixe o anel de diagnósticos de tempos em tempos (ele guarda ~8 h) e passe
+todos os arquivos; amostras repetidas entre downloads são descartadas:
+    curl http://<ip-do-esp32>/diagnostics.csv > aneis/$(date +%Y%m%d-%H%M).csv
+    python train_outage_model.py aneis/*.csv
+
+Gera include/OutageModelWeights.h (via generate_outage_header.py) e
+outage_model.tflite, com a mesma arquitetura, para conferir no TFLite.
+"""
+import sys
+
+import numpy as np
+import tensorflow as tf
+from tensorflow import keras
+
+from outage_common import (CHANNELS, FILTERS, HIDDEN, HORIZON_MIN, KERNEL, STRIDE, WINDOW, build_windows,
+                           read_rings)
+from generate_outage_header import generate as generate_outage_header
+
+MODEL_TFLITE_FILE = 'outage_model.tflite'
+EPOCHS = 200
+BATCH_SIZE = 64
+# Fração final (em ordem de tempo) separada para validação
+VALIDATION_SPLIT = 0.2
+ALERT_PROBABILITY = 0.7  # Mesmo limite de OUTAGE_ALERT_PROBABILITY no firmware
+
+if len(sys.argv) < 2:
+    print(__doc__)
+    sys.exit(1)
+
+# --- FASE 1: JANELAS E RÓTULOS ---
+samples = read_rings(sys.argv[1:])
+windows, labels = build_windows(samples)
+if not windows:
+    sys.exit(f"Nenhuma janela de {WINDOW} amostras seguidas nos arquivos informados.")
+x = np.array(windows, dtype=np.float32)
+y = np.array(labels, dtype=np.float32)
+positives = int(y.sum())
+print(f"{len(samples)} amostras, {len(x)} janelas, {positives} seguidas de queda em até {HORIZON_MIN} min")
+if positives == 0:
+    sys.exit("Nenhuma queda nos históricos: mantenha os pesos a priori até gravar alguma.")
+
+# Validação no fim da série: janelas vizinhas se sobrepõem, um corte aleatório vazaria
+split = int(len(x) * (1 - VALIDATION_SPLIT))
+x_train, y_train, x_val, y_val = x[:split], y[:split], x[split:], y[split:]
+# Quedas são raras: equilibra o peso das duas classes
+weight_pos = (len(y_train) - y_train.sum()) / max(y_train.sum(), 1.0)
+
+# --- FASE 2: MODELO ---
+model = keras.Sequential([
+    keras.layers.Input(shape=(WINDOW, CHANNELS)),
+    keras.layers.Conv1D(FILTERS, KERNEL, strides=STRIDE, activation='relu'),
+    keras.layers.Flatten(),
+    keras.layers.Dense(HIDDEN, activation='relu'),
+    keras.layers.Dense(1, activation='sigmoid'),
+])
+model.compile(optimizer='adam', loss='binary_crossentropy',
+              metrics=[keras.metrics.Precision(name='precision'), keras.metrics.Recall(name='recall')])
+model.summary()
+model.fit(x_train, y_train, epochs=EPOCHS, batch_size=BATCH_SIZE, validation_data=(x_val, y_val),
+          class_weight={0: 1.0, 1: float(weight_pos)},
+          callbacks=[keras.callbacks.EarlyStopping(monitor='val_loss', patience=20, restore_best_weights=True)])
+
+predicted = model.predict(x_val, verbose=0).ravel() >= ALERT_PROBABILITY
+hits = int((predicted & (y_val == 1)).sum())
+print(f"Validação (limite {ALERT_PROBABILITY}): {hits}/{int(y_val.sum())} quedas avisadas, "
+      f"{int((predicted & (y_val == 0)).sum())} alarmes falsos em {int((y_val == 0).sum())} janelas")
+
+# --- FASE 3: EXPORTAÇÃO ---
+conv, dense, output = [layer for layer in model.layers if layer.get_weights()]
+kernel, conv_bias = conv.get_weights()          # [kernel][canal][filtro]
+hidden, hidden_bias = dense.get_weights()       # [entrada][saída]
+out, out_bias = output.get_weights()
+layers = [
+    ('Conv1D', [[[float(kernel[k][c][f]) for c in range(CHANNELS)] for k in range(KERNEL)] for f in range(FILTERS)],
+     conv_bias.tolist(), 'Relu'),
+    ('Dense', hidden.T.tolist(), hidden_bias.tolist(), 'Relu'),
+    ('Dense', out.T.tolist(), out_bias.tolist(), 'Sigmoid'),
+]
+generate_outage_header(layers, source=f"train_outage_model.py ({len(x)} janelas, {positives} antes de quedas)")
+
+converter = tf.lite.TFLiteConverter.from_keras_model(model)
+with open(MODEL_TFLITE_FILE, 'wb') as f:
+    f.write(converter.convert())
+print(f"Modelo TFLite salvo em '{MODEL_TFLITE_FILE}'")
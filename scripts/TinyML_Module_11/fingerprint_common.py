@@ -0,0 +1,55 @@
+"""Características, classes e leitura dos dados do classificador de dispositivos.
+
+As características são calculadas no firmware (src/DeviceFingerprint.cpp) a
+partir dos primeiros minutos de tráfego de cada dispositivo, todas em [0, 1]. A
+ordem de FEATURES é a das entradas do modelo: generate_fingerprint_header.py a
+grava em include/DeviceClassModelWeights.h, e o firmware usa os mesmos nomes
+nas colunas de /fingerprints.csv.
+"""
+import csv
+
+CLASSES = ['phone', 'laptop', 'tv', 'camera', 'iot']
+
+FEATURES = [
+    # Histograma do tamanho dos quadros (fração de cada faixa, em bytes no ar)
+    'size_96', 'size_160', 'size_320', 'size_640', 'size_1200', 'size_max',
+    # Rajadas: (B + 1) / 2, com B = (sd - média) / (sd + média) do intervalo entre quadros
+    'burstiness',
+    # log10(1 + quadros por minuto observado) / 4
+    'rate',
+    # Bytes enviados / (enviados + recebidos)
+    'uplink_share',
+    # Consultou algum domínio de cada categoria
+    'dns_apple', 'dns_google', 'dns_microsoft', 'dns_streaming', 'dns_camera', 'dns_iot',
+    # Domínios distintos (bitmap de 32 bits), fração de bits
+    'dns_diversity',
+    # Fabricante pelo OUI (todas zero se desconhecido) e MAC aleatório (bit "localmente administrado")
+    'vendor_mobile', 'vendor_pc', 'vendor_tv', 'vendor_camera', 'vendor_iot', 'random_mac',
+    # Horas do dia com tráfego (fração) e tráfego de madrugada (0h-5h)
+    'active_hours', 'night',
+]
+
+# Quantização das características em /fingerprints.csv: round(x * 255)
+FEATURE_SCALE = 255.0
+
+
+def read_labelled(paths):
+    """(entradas [n][len(FEATURES)], rótulos [n]) dos CSVs com a coluna 'label' preenchida.
+
+    Baixe http://<ip-do-esp32>/fingerprints.csv, escreva na coluna 'label' o
+    tipo real de cada dispositivo (um de CLASSES) e deixe em branco os que não
+    souber. Um MAC repetido entre arquivos vale a última linha.
+    """
+    rows = {}
+    for path in paths:
+        with open(path, newline='') as f:
+            for row in csv.DictReader(f):
+                label = (row.get('label') or '').strip().lower()
+                if not label:
+                    continue
+                if label not in CLASSES:
+                    raise ValueError("%s: rótulo '%s' de %s não é um de %s" % (path, label, row['mac'], CLASSES))
+                rows[row['mac']] = ([int(row[name]) / FEATURE_SCALE for name in FEATURES], CLASSES.index(label))
+    inputs = [v[0] for v in rows.values()]
+    labels = [v[1] for v in rows.values()]
+    return inputs, labels
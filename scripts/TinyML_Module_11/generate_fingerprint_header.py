@@ -0,0 +1,163 @@
+"""Gera include/DeviceClassModelWeights.h, os pesos do classificador de dispositivos.
+
+O modelo é uma regressão logística multinomial: tinymlp::Dense<entradas,
+classes> linear, com o softmax feito no firmware (DeviceFingerprinter). É
+pequeno o bastante para treinar com algumas dezenas de dispositivos rotulados.
+Os parâmetros vão na ordem de include/TinyMlp.h (pesos [classe][entrada] e
+depois o bias), seguidos dos nomes das características e das classes e de
+vetores de referência calculados aqui em float32; tools/mlp_check compara a
+engine C++ com eles.
+
+Sem argumentos grava os pesos a priori (prior_weights): escritos à mão a partir
+do que se sabe de cada tipo de aparelho (fabricante, domínios consultados,
+tamanho dos quadros, sentido do tráfego). Valem até haver dispositivos
+rotulados para train_fingerprint_model.py, que chama generate() com os pesos do
+Keras.
+
+Uso (só biblioteca padrão):
+    python generate_fingerprint_header.py [saida.h]
+"""
+import math
+import os
+import struct
+import sys
+
+from fingerprint_common import CLASSES, FEATURES
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_HEADER = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'DeviceClassModelWeights.h')
+
+
+def f32(x):
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+
+def prior_weights():
+    """Pesos a priori: (pesos [classe][característica], bias [classe])."""
+    prior = {
+        'phone': ({'random_mac': 3.0, 'vendor_mobile': 2.5, 'dns_apple': 1.0, 'dns_google': 1.0, 'burstiness': 1.0,
+                   'size_160': 0.5, 'uplink_share': 0.5, 'active_hours': 0.5, 'vendor_pc': -1.5, 'vendor_tv': -2.0,
+                   'vendor_camera': -3.0, 'vendor_iot': -3.0, 'dns_camera': -2.0, 'dns_iot': -2.0}, 0.0),
+        'laptop': ({'vendor_pc': 3.0, 'dns_microsoft': 2.5, 'dns_apple': 0.5, 'random_mac': 1.0, 'size_max': 1.0,
+                    'dns_diversity': 2.0, 'rate': 1.0, 'vendor_tv': -2.0, 'vendor_camera': -3.0, 'vendor_iot': -3.0,
+                    'dns_camera': -2.0, 'dns_iot': -2.0}, -0.5),
+        'tv': ({'vendor_tv': 3.0, 'dns_streaming': 3.0, 'size_max': 1.5, 'rate': 1.0, 'uplink_share': -2.0,
+                'random_mac': -1.5, 'vendor_iot': -1.0, 'night': -0.5}, -1.0),
+        'camera': ({'vendor_camera': 3.5, 'dns_camera': 3.0, 'uplink_share': 3.0, 'size_max': 1.0,
+                    'burstiness': -1.5, 'active_hours': 1.5, 'night': 1.0, 'random_mac': -2.5,
+                    'vendor_mobile': -2.0}, -1.5),
+        'iot': ({'vendor_iot': 3.0, 'dns_iot': 3.0, 'size_96': 1.5, 'size_160': 1.0, 'rate': -2.0,
+                 'dns_diversity': -2.0, 'size_max': -1.5, 'night': 0.5, 'active_hours': 1.0,
+                 'random_mac': -2.5}, -0.5),
+    }
+    weights = [[prior[c][0].get(name, 0.0) for name in FEATURES] for c in CLASSES]
+    bias = [prior[c][1] for c in CLASSES]
+    return weights, bias
+
+
+def reference_forward(weights, bias, x):
+    """Emula tinymlp::Dense linear em float32: logits por classe."""
+    logits = []
+    for row, b in zip(weights, bias):
+        acc = 0.0
+        for w, v in zip(row, x):
+            acc = f32(acc + f32(f32(w) * v))
+        logits.append(f32(acc + f32(b)))
+    return logits
+
+
+def reference_inputs():
+    """Aparelhos típicos, um por classe, e um vetor neutro."""
+    def device(**values):
+        return [f32(values.get(name, 0.0)) for name in FEATURES]
+    return [
+        device(size_96=0.3, size_160=0.3, size_320=0.1, size_640=0.1, size_1200=0.1, size_max=0.1, burstiness=0.8,
+               rate=0.5, uplink_share=0.3, dns_apple=1, dns_diversity=0.5, random_mac=1, active_hours=0.2),
+        device(size_96=0.2, size_160=0.1, size_320=0.1, size_640=0.1, size_1200=0.1, size_max=0.4, burstiness=0.7,
+               rate=0.7, uplink_share=0.2, dns_microsoft=1, dns_google=1, dns_diversity=0.8, vendor_pc=1,
+               active_hours=0.3),
+        device(size_96=0.2, size_max=0.8, burstiness=0.6, rate=0.8, uplink_share=0.05, dns_streaming=1,
+               dns_diversity=0.3, vendor_tv=1, active_hours=0.2),
+        device(size_96=0.1, size_640=0.2, size_1200=0.2, size_max=0.5, burstiness=0.3, rate=0.7, uplink_share=0.9,
+               dns_camera=1, dns_diversity=0.1, vendor_camera=1, active_hours=0.5, night=1),
+        device(size_96=0.6, size_160=0.3, size_320=0.1, burstiness=0.5, rate=0.2, uplink_share=0.5, dns_iot=1,
+               dns_diversity=0.1, vendor_iot=1, active_hours=0.5, night=1),
+        device(size_96=0.2, size_160=0.2, size_320=0.2, size_640=0.2, size_1200=0.1, size_max=0.1, burstiness=0.5,
+               rate=0.4, uplink_share=0.5),
+    ]
+
+
+def fmt(v):
+    return '%.9ef' % v
+
+
+def generate(weights=None, bias=None, header_path=DEFAULT_HEADER, source=None):
+    if weights is None:
+        weights, bias = prior_weights()
+        source = 'pesos a priori escritos à mão (prior_weights), sem treino'
+    inputs = reference_inputs()
+    outputs = [reference_forward(weights, bias, x) for x in inputs]
+    n_in, n_out = len(FEATURES), len(CLASSES)
+
+    lines = [
+        '#ifndef DEVICE_CLASS_MODEL_WEIGHTS_H',
+        '#define DEVICE_CLASS_MODEL_WEIGHTS_H',
+        '',
+        '// Gerado por scripts/TinyML_Module_11/generate_fingerprint_header.py a partir de',
+        '// %s.' % source,
+        '// Não edite à mão: rode o script novamente.',
+        '',
+        '#include <cstdint>',
+        '#include "TinyMlp.h"',
+        '',
+        '// Características em [0, 1] (ordem das entradas) e classes (ordem das saídas)',
+        '#define FINGERPRINT_FEATURES %d' % n_in,
+        '#define FINGERPRINT_CLASSES %d' % n_out,
+        '',
+        '// Saída: logits; o softmax fica com o DeviceFingerprinter',
+        'typedef tinymlp::Sequential<',
+        '    tinymlp::Dense<%d, %d, tinymlp::Activation::Linear>' % (n_in, n_out),
+        '> DeviceClassModel;',
+        '',
+        'constexpr const char* device_class_features[FINGERPRINT_FEATURES] = {',
+    ]
+    lines += ['  ' + ', '.join('"%s"' % n for n in FEATURES[i:i + 6]) + ',' for i in range(0, n_in, 6)]
+    lines += [
+        '};',
+        'constexpr const char* device_class_names[FINGERPRINT_CLASSES] = { %s };'
+        % ', '.join('"%s"' % c for c in CLASSES),
+        '',
+        '// Pesos [classe][característica] e bias',
+        'constexpr float device_class_params[DeviceClassModel::paramCount] = {',
+    ]
+    for c, row in zip(CLASSES, weights):
+        lines.append('  // %s' % c)
+        lines += ['  ' + ', '.join(fmt(w) for w in row[i:i + 6]) + ',' for i in range(0, n_in, 6)]
+    lines.append('  ' + ', '.join(fmt(b) for b in bias) + ',')
+    lines += ['};', '']
+
+    lines.append('// Logits esperados (float32, mesma ordem de operações da engine)')
+    lines.append('constexpr int device_class_reference_count = %d;' % len(inputs))
+    lines.append('constexpr float device_class_reference_inputs[][FINGERPRINT_FEATURES] = {')
+    for x in inputs:
+        lines.append('  { ' + ', '.join(fmt(v) for v in x[:6]) + ',')
+        lines += ['    ' + ', '.join(fmt(v) for v in x[i:i + 6]) + ',' for i in range(6, n_in, 6)]
+        lines[-1] += ' },'
+    lines.append('};')
+    lines.append('constexpr float device_class_reference_outputs[][FINGERPRINT_CLASSES] = {')
+    lines += ['  { ' + ', '.join(fmt(v) for v in y) + ' },' for y in outputs]
+    lines += ['};', '', '#endif', '']
+
+    with open(header_path, 'w', newline='\n') as f:
+        f.write('\n'.join(lines))
+    params = n_in * n_out + n_out
+    print("Pesos do classificador de dispositivos (%d parâmetros, %d B) salvos em '%s'"
+          % (params, 4 * params, os.path.normpath(header_path)))
+    for y in outputs:
+        top = max(range(n_out), key=lambda k: y[k])
+        total = sum(math.exp(v - y[top]) for v in y)
+        print('  referência: %-6s (%.0f%%)' % (CLASSES[top], 100.0 / total))
+
+
+if __name__ == '__main__':
+    generate(header_path=sys.argv[1] if len(sys.argv) > 1 else DEFAULT_HEADER)
@@ -0,0 +1,55 @@
+"""Treina o classificador de dispositivos com aparelhos rotulados da própria rede.
+
+Baixe as impressões digitais que o ESP32 já calculou, preencha a coluna
+'label' (phone, laptop, tv, camera ou iot) dos dispositivos que você conhece e
+passe os arquivos:
+    curl http://<ip-do-esp32>/fingerprints.csv > fingerprints.csv
+    python train_fingerprint_model.py fingerprints.csv [outra-rede.csv ...]
+
+Gera include/DeviceClassModelWeights.h (via generate_fingerprint_header.py).
+"""
+import sys
+
+import numpy as np
+from tensorflow import keras
+
+from fingerprint_common import CLASSES, FEATURES, read_labelled
+from generate_fingerprint_header import generate as generate_fingerprint_header
+
+EPOCHS = 500
+# Regularização forte: poucas dezenas de exemplos e 125 parâmetros
+L2 = 1e-2
+
+if len(sys.argv) < 2:
+    print(__doc__)
+    sys.exit(1)
+
+inputs, labels = read_labelled(sys.argv[1:])
+if not inputs:
+    sys.exit("Nenhum dispositivo rotulado: preencha a coluna 'label' do CSV.")
+x = np.array(inputs, dtype=np.float32)
+y = np.array(labels)
+counts = np.bincount(y, minlength=len(CLASSES))
+print(f"{len(x)} dispositivos rotulados: " + ", ".join(f"{c} {n}" for c, n in zip(CLASSES, counts)))
+missing = [c for c, n in zip(CLASSES, counts) if n == 0]
+if missing:
+    print(f"Aviso: sem exemplos de {missing}; essas classes só serão previstas pelo bias.")
+# Classes raras pesam mais, para não virarem 'phone' por maioria
+class_weight = {k: float(len(y)) / (len(CLASSES) * n) for k, n in enumerate(counts) if n > 0}
+
+model = keras.Sequential([
+    keras.layers.Input(shape=(len(FEATURES),)),
+    keras.layers.Dense(len(CLASSES), activation='softmax', kernel_regularizer=keras.regularizers.l2(L2)),
+])
+model.compile(optimizer=keras.optimizers.Adam(0.05), loss='sparse_categorical_crossentropy', metrics=['accuracy'])
+model.fit(x, y, epochs=EPOCHS, batch_size=len(x), class_weight=class_weight, verbose=0)
+
+predicted = model.predict(x, verbose=0).argmax(axis=1)
+print(f"Acerto no próprio conjunto: {(predicted == y).mean() * 100:.1f}%")
+for k, c in enumerate(CLASSES):
+    if counts[k]:
+        print(f"  {c:6s}: {int(((predicted == k) & (y == k)).sum())}/{int(counts[k])}")
+
+kernel, bias = model.layers[-1].get_weights()   # [entrada][classe]
+generate_fingerprint_header(kernel.T.tolist(), bias.tolist(),
+                            source=f"train_fingerprint_model.py ({len(x)} dispositivos rotulados)")
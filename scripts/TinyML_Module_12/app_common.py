@@ -0,0 +1,119 @@
+"""Características, classes e dados do classificador de atividade por estação.
+
+As características são calculadas no firmware (src/AppClassifier.cpp) para cada
+estação em cada janela de 30 s do sniffer. Mesmo com WPA2 dá para ver o
+tamanho, o sentido e o ritmo dos quadros. Todas são inteiras (0 a 65535): a
+floresta compara inteiros, e os limiares gravados em include/AppClassForest.h
+estão nas mesmas unidades. A ordem de FEATURES é a de app_forest_features.
+"""
+import csv
+import math
+
+CLASSES = ['video', 'call', 'bulk', 'gaming', 'idle']
+
+FEATURES = [
+    # Taxa média na janela, em kbit/s (descida = do AP para a estação)
+    'down_kbps', 'up_kbps',
+    # Quadros por segundo
+    'down_pps', 'up_pps',
+    # Tamanho médio dos quadros no ar, em bytes
+    'down_size', 'up_size',
+    # % dos quadros de descida com 1000 B ou mais e % dos de subida com menos de 200 B (ACKs)
+    'down_large_pct', 'up_small_pct',
+    # Coeficiente de variação (x100) do intervalo entre quadros de descida: alto = rajadas
+    'gap_cv_pct',
+    # % dos segundos da janela com algum quadro
+    'active_pct',
+    # % dos bytes que são de subida
+    'up_share_pct',
+]
+
+FEATURE_MAX = 65535
+
+
+def _clamp(x):
+    return max(0, min(FEATURE_MAX, int(round(x))))
+
+
+def synthetic_window(label, rng):
+    """Uma janela sintética da classe 'label' (índice em CLASSES).
+
+    São os perfis conhecidos de cada atividade, vistos por um sniffer no canal
+    do AP (que perde parte dos quadros):
+      video:  blocos de alguns segundos a taxa alta e pausas entre eles (DASH/HLS),
+              quadros cheios na descida e só ACKs na subida;
+      call:   fluxo contínuo e quase simétrico de quadros médios (áudio + vídeo);
+      bulk:   descida saturada e contínua, quadros cheios, ACKs na subida;
+      gaming: dezenas de quadros pequenos por segundo nos dois sentidos;
+      idle:   quase nada, em momentos esparsos.
+    """
+    name = CLASSES[label]
+    u = rng.uniform
+    if name == 'video':
+        active = u(12, 75)
+        down_kbps = u(6000, 40000) * active / 100
+        down_size, up_size = u(1150, 1500), u(60, 120)
+        large, small = u(65, 97), u(85, 100)
+        gap_cv = u(170, 700)
+        up_pkt_ratio = u(0.25, 0.6)
+    elif name == 'call':
+        active = u(94, 100)
+        down_kbps = u(250, 3500)
+        down_size, up_size = u(350, 1150), u(300, 1150)
+        large, small = u(3, 45), u(3, 35)
+        gap_cv = u(35, 150)
+        up_pkt_ratio = u(0.5, 1.5) * down_size / up_size
+    elif name == 'bulk':
+        active = u(88, 100)
+        down_kbps = math.exp(u(math.log(4000), math.log(80000)))
+        down_size, up_size = u(1250, 1500), u(60, 110)
+        large, small = u(85, 99), u(88, 100)
+        gap_cv = u(35, 170)
+        up_pkt_ratio = u(0.25, 0.6)
+    elif name == 'gaming':
+        active = u(88, 100)
+        down_kbps = u(40, 700)
+        down_size, up_size = u(80, 380), u(70, 260)
+        large, small = u(0, 6), u(60, 100)
+        gap_cv = u(25, 170)
+        up_pkt_ratio = u(0.4, 1.2)
+    else:
+        active = u(0, 45)
+        down_kbps = math.exp(u(math.log(0.5), math.log(60)))
+        down_size, up_size = u(60, 1500), u(60, 1500)
+        large, small = u(0, 70), u(10, 100)
+        gap_cv = u(0, 900)
+        up_pkt_ratio = u(0.2, 2.0)
+    down_pps = down_kbps * 1000 / 8 / down_size
+    up_pps = down_pps * up_pkt_ratio
+    up_kbps = up_pps * up_size * 8 / 1000
+    up_share = 100 * up_kbps / (up_kbps + down_kbps) if up_kbps + down_kbps > 0 else 0
+    return [_clamp(v) for v in (down_kbps, up_kbps, down_pps, up_pps, down_size, up_size, large, small, gap_cv,
+                                active, up_share)]
+
+
+def synthetic_dataset(per_class, rng):
+    """(entradas, rótulos) com 'per_class' janelas sintéticas de cada classe."""
+    inputs, labels = [], []
+    for label in range(len(CLASSES)):
+        for _ in range(per_class):
+            inputs.append(synthetic_window(label, rng))
+            labels.append(label)
+    return inputs, labels
+
+
+def read_labelled(paths):
+    """(entradas, rótulos) dos CSVs com uma coluna por característica e a coluna 'label'.
+
+    Linhas sem rótulo (ou com um rótulo fora de CLASSES) são ignoradas.
+    """
+    inputs, labels = [], []
+    for path in paths:
+        with open(path, newline='') as f:
+            for row in csv.DictReader(f):
+                label = (row.get('label') or '').strip().lower()
+                if label not in CLASSES:
+                    continue
+                inputs.append([_clamp(float(row[name])) for name in FEATURES])
+                labels.append(CLASSES.index(label))
+    return inputs, labels
@@ -0,0 +1,207 @@
+"""Treina a floresta de decisão da atividade por estação e gera include/AppClassForest.h.
+
+Sem argumentos, treina com janelas sintéticas (app_common.synthetic_window),
+geradas a partir dos perfis conhecidos de cada atividade. Com CSVs rotulados
+(uma coluna por característica de app_common.FEATURES e a coluna 'label' com um
+de CLASSES), as janelas reais entram junto com as sintéticas:
+    python train_app_forest.py [janelas.csv ...]
+
+A floresta é treinada aqui mesmo (CART com Gini, bootstrap e sorteio de
+características por nó), só com a biblioteca padrão. As árvores vão para o
+header em ordem pré-fixada: o filho esquerdo (x <= limiar) é sempre o nó
+seguinte e só o índice do direito é gravado, 6 bytes por nó. No firmware a
+avaliação é constexpr (include/DecisionForest.h), no máximo
+TREES * MAX_DEPTH comparações de inteiros, e src/AppClassifier.cpp confere em
+tempo de compilação que ela dá, para os vetores de referência, a mesma classe
+que a floresta daqui.
+"""
+import os
+import random
+import sys
+
+from app_common import CLASSES, FEATURES, read_labelled, synthetic_dataset
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_HEADER = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'AppClassForest.h')
+
+TREES = 16
+MAX_DEPTH = 6
+MIN_LEAF = 4
+FEATURES_PER_SPLIT = 4
+SYNTHETIC_PER_CLASS = 600
+SEED = 12
+LEAF = 0xFF
+
+
+def gini(counts, total):
+    return 1.0 - sum((c / total) ** 2 for c in counts) if total else 0.0
+
+
+def majority(labels, idx):
+    counts = [0] * len(CLASSES)
+    for i in idx:
+        counts[labels[i]] += 1
+    return max(range(len(CLASSES)), key=lambda k: (counts[k], -k)), counts
+
+
+def best_split(inputs, labels, idx, features):
+    """(ganho, característica, limiar) do melhor corte 'x <= limiar', ou None."""
+    _, parent = majority(labels, idx)
+    n = len(idx)
+    base = gini(parent, n)
+    best = None
+    for f in features:
+        order = sorted(idx, key=lambda i: inputs[i][f])
+        left = [0] * len(CLASSES)
+        right = parent[:]
+        for pos in range(n - 1):
+            i = order[pos]
+            left[labels[i]] += 1
+            right[labels[i]] -= 1
+            a, b = inputs[i][f], inputs[order[pos + 1]][f]
+            if a == b or pos + 1 < MIN_LEAF or n - pos - 1 < MIN_LEAF:
+                continue
+            nl, nr = pos + 1, n - pos - 1
+            gain = base - (nl * gini(left, nl) + nr * gini(right, nr)) / n
+            if best is None or gain > best[0]:
+                best = (gain, f, a)
+    return best
+
+
+def build_tree(inputs, labels, idx, depth, rng, nodes):
+    """Acrescenta a (sub)árvore em 'nodes' em ordem pré-fixada: [feature, label, limiar, direito]."""
+    label, counts = majority(labels, idx)
+    split = None
+    if depth < MAX_DEPTH and len(idx) >= 2 * MIN_LEAF and max(counts) < len(idx):
+        features = rng.sample(range(len(FEATURES)), FEATURES_PER_SPLIT)
+        split = best_split(inputs, labels, idx, features)
+    if split is None or split[0] <= 0:
+        nodes.append([LEAF, label, 0, 0])
+        return
+    _, f, threshold = split
+    node = [f, 0, threshold, 0]
+    nodes.append(node)
+    build_tree(inputs, labels, [i for i in idx if inputs[i][f] <= threshold], depth + 1, rng, nodes)
+    node[3] = len(nodes)
+    build_tree(inputs, labels, [i for i in idx if inputs[i][f] > threshold], depth + 1, rng, nodes)
+
+
+def train_forest(inputs, labels, rng):
+    """(nós de todas as árvores, raiz de cada árvore); os índices de 'direito' são absolutos."""
+    nodes, roots = [], []
+    for _ in range(TREES):
+        sample = [rng.randrange(len(inputs)) for _ in range(len(inputs))]
+        tree = []
+        build_tree(inputs, labels, sample, 0, rng, tree)
+        base = len(nodes)
+        roots.append(base)
+        for node in tree:
+            nodes.append([node[0], node[1], node[2], node[3] + base if node[0] != LEAF else 0])
+    return nodes, roots
+
+
+def predict(nodes, roots, x):
+    """Mesma regra de include/DecisionForest.h: maioria dos votos, empate para a menor classe."""
+    votes = [0] * len(CLASSES)
+    for root in roots:
+        i = root
+        while nodes[i][0] != LEAF:
+            i = i + 1 if x[nodes[i][0]] <= nodes[i][2] else nodes[i][3]
+        votes[nodes[i][1]] += 1
+    return max(range(len(CLASSES)), key=lambda k: (votes[k], -k))
+
+
+def write_header(path, nodes, roots, references, source, accuracy):
+    lines = [
+        '#ifndef APP_CLASS_FOREST_H',
+        '#define APP_CLASS_FOREST_H',
+        '',
+        f'// Gerado por scripts/TinyML_Module_12/train_app_forest.py a partir de {source}.',
+        '// Acerto por classe em janelas sintéticas novas: ' +
+        ', '.join(f'{c} {a:.1%}' for c, a in zip(CLASSES, accuracy)) + '.',
+        '// Não edite à mão: rode o script novamente.',
+        '',
+        '#include <cstdint>',
+        '#include "DecisionForest.h"',
+        '',
+        '// Características inteiras (ordem de app_forest_features) e classes (ordem dos votos)',
+        f'#define APP_FEATURES {len(FEATURES)}',
+        f'#define APP_CLASSES {len(CLASSES)}',
+        f'#define APP_FOREST_TREES {TREES}',
+        f'#define APP_FOREST_MAX_DEPTH {MAX_DEPTH}  // Comparações por árvore, no máximo',
+        '',
+        'constexpr const char* app_forest_features[APP_FEATURES] = {',
+    ]
+    for k in range(0, len(FEATURES), 6):
+        lines.append('  ' + ' '.join(f'"{name}",' for name in FEATURES[k:k + 6]))
+    lines += [
+        '};',
+        'constexpr const char* app_class_names[APP_CLASSES] = { ' +
+        ', '.join(f'"{c}"' for c in CLASSES) + ' };',
+        '',
+        f'// {len(nodes)} nós ({len(nodes) * 6} B): {{característica, classe da folha, limiar, filho direito}}',
+        'constexpr forest::Node app_forest_nodes[] = {',
+    ]
+    for t, root in enumerate(roots):
+        end = roots[t + 1] if t + 1 < len(roots) else len(nodes)
+        lines.append(f'  // Árvore {t}')
+        for f, label, threshold, right in nodes[root:end]:
+            if f == LEAF:
+                lines.append(f'  {{ forest::LEAF, {label}, 0, 0 }},')
+            else:
+                lines.append(f'  {{ {f}, 0, {threshold}, {right} }},')
+    lines += [
+        '};',
+        'constexpr uint16_t app_forest_roots[APP_FOREST_TREES] = { ' + ', '.join(map(str, roots)) + ' };',
+        '',
+        '// Janelas de referência e a classe que a floresta deu para cada uma no Python',
+        f'constexpr int app_forest_reference_count = {len(references)};',
+        'constexpr uint16_t app_forest_reference_inputs[][APP_FEATURES] = {',
+    ]
+    for x, _ in references:
+        lines.append('  { ' + ', '.join(map(str, x)) + ' },')
+    lines += [
+        '};',
+        'constexpr uint8_t app_forest_reference_labels[] = { ' + ', '.join(str(y) for _, y in references) + ' };',
+        '',
+        '#endif',
+        '',
+    ]
+    with open(path, 'w', newline='\n') as f:
+        f.write('\n'.join(lines))
+
+
+def main():
+    rng = random.Random(SEED)
+    inputs, labels = synthetic_dataset(SYNTHETIC_PER_CLASS, rng)
+    source = f'{len(inputs)} janelas sintéticas (app_common.synthetic_window)'
+    if len(sys.argv) > 1:
+        real_inputs, real_labels = read_labelled(sys.argv[1:])
+        if not real_inputs:
+            sys.exit("Nenhuma janela rotulada: preencha a coluna 'label' do CSV.")
+        inputs += real_inputs
+        labels += real_labels
+        source = f'{len(real_inputs)} janelas rotuladas e ' + source
+    print(f'Treinando {TREES} árvores (profundidade {MAX_DEPTH}) com {len(inputs)} janelas...')
+    nodes, roots = train_forest(inputs, labels, rng)
+
+    test_inputs, test_labels = synthetic_dataset(200, random.Random(SEED + 1))
+    accuracy = []
+    for label in range(len(CLASSES)):
+        rows = [x for x, y in zip(test_inputs, test_labels) if y == label]
+        accuracy.append(sum(predict(nodes, roots, x) == label for x in rows) / len(rows))
+    print('Acerto por classe: ' + ', '.join(f'{c} {a:.1%}' for c, a in zip(CLASSES, accuracy)))
+
+    references = []
+    for label in range(len(CLASSES)):
+        rows = [x for x, y in zip(test_inputs, test_labels) if y == label][:2]
+        references += [(x, predict(nodes, roots, x)) for x in rows]
+    references.append(([0] * len(FEATURES), predict(nodes, roots, [0] * len(FEATURES))))
+
+    header = os.path.abspath(DEFAULT_HEADER)
+    write_header(header, nodes, roots, references, source, accuracy)
+    print(f'{header}: {len(nodes)} nós, {len(nodes) * 6} B')
+
+
+if __name__ == '__main__':
+    main()
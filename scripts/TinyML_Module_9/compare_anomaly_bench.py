@@ -0,0 +1,127 @@
+"""Compara o detector do firmware (tools/anomaly_bench) com o modelo Python.
+
+1. Confere se a normalização do firmware (include/AnomalyModelWeights.h) é o
+   min_/scale_ do MinMaxScaler ajustado sobre o dataset.
+2. Recalcula o erro de reconstrução de cada linha no Python e compara com o
+   arquivo gravado pelo benchmark (erro por linha e decisão de anomalia).
+
+O modelo Python é o Keras (anomaly_detector.h5 + data_scaler.gz) quando o
+TensorFlow está instalado; sem ele, usa o anomaly_model.tflite avaliado pela
+emulação float32 de generate_mlp_header.py e um MinMaxScaler refeito sobre o CSV.
+
+Uso (na raiz do repositório):
+    .pio/build/native_anomaly_bench/program "" erros_cpp.csv
+    python scripts/TinyML_Module_9/compare_anomaly_bench.py erros_cpp.csv
+"""
+import csv
+import os
+import re
+import sys
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, SCRIPT_DIR)
+from feature_layout import model_columns  # noqa: E402
+from generate_mlp_header import load_layers, reference_forward  # noqa: E402
+
+CSV_FILE = os.path.join(SCRIPT_DIR, 'network_metrics_dataset.csv')
+SCALER_FILE = os.path.join(SCRIPT_DIR, 'data_scaler.gz')
+MODEL_H5_FILE = os.path.join(SCRIPT_DIR, 'anomaly_detector.h5')
+MODEL_TFLITE_FILE = os.path.join(SCRIPT_DIR, 'anomaly_model.tflite')
+FIRMWARE_FILE = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'AnomalyModelWeights.h')
+# Diferença aceitável entre o erro do C++ e o do Python
+ERROR_TOLERANCE = 1e-4
+
+
+def firmware_constants():
+    source = open(FIRMWARE_FILE, encoding='utf-8').read()
+
+    def array(name):
+        m = re.search(r'%s\[\d*\]\s*=\s*\{([^}]*)\}' % name, source)
+        return [float(v.strip().rstrip('f')) for v in m.group(1).split(',')]
+    threshold = float(re.search(r'anomaly_mlp_threshold\s*=\s*([0-9.eE+-]+)f?\s*;', source).group(1))
+    return array('anomaly_mlp_input_min'), array('anomaly_mlp_input_scale'), threshold
+
+
+def load_dataset(count):
+    with open(CSV_FILE, newline='') as f:
+        reader = csv.DictReader(f)
+        columns = model_columns(reader.fieldnames)[:count]
+        return columns, [[float(r[c]) for c in columns] for r in reader]
+
+
+def python_errors(rows):
+    """Devolve (min_, scale_, erros por linha, descrição do modelo usado)."""
+    try:
+        import joblib
+        import numpy as np
+        from tensorflow import keras
+    except ImportError:
+        columns = list(zip(*rows))
+        scale = [1.0 / (max(c) - min(c)) for c in columns]
+        min_ = [-min(c) * s for c, s in zip(columns, scale)]
+        layers = load_layers(MODEL_TFLITE_FILE)
+        errors = []
+        for row in rows:
+            x = [v * s + m for v, s, m in zip(row, scale, min_)]
+            y = reference_forward(layers, x)
+            errors.append(sum(abs(a - b) for a, b in zip(x, y)) / len(x))
+        return min_, scale, errors, 'anomaly_model.tflite (emulação float32, sem TensorFlow)'
+
+    scaler = joblib.load(SCALER_FILE)
+    model = keras.models.load_model(MODEL_H5_FILE, compile=False)
+    x = scaler.transform(np.array(rows, dtype=np.float64)).astype(np.float32)
+    y = model.predict(x, verbose=0)
+    errors = np.mean(np.abs(y - x), axis=1)
+    return list(scaler.min_), list(scaler.scale_), [float(e) for e in errors], 'anomaly_detector.h5 (Keras)'
+
+
+def load_cpp_errors(path):
+    with open(path, newline='') as f:
+        return [(float(r['error']), r['anomaly'] == '1') for r in csv.DictReader(f)]
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 2
+    fw_min, fw_scale, threshold = firmware_constants()
+    columns, rows = load_dataset(len(fw_min))
+    cpp = load_cpp_errors(sys.argv[1])
+    if len(cpp) != len(rows):
+        print('O arquivo do benchmark tem %d linhas, o dataset tem %d' % (len(cpp), len(rows)))
+        return 1
+
+    min_, scale, errors, source = python_errors(rows)
+    ok = True
+
+    print('--- Normalização (firmware x MinMaxScaler) ---')
+    for i, name in enumerate(columns):
+        rel_min = abs(fw_min[i] - min_[i]) / abs(min_[i])
+        rel_scale = abs(fw_scale[i] - scale[i]) / abs(scale[i])
+        print('%-19s data_min %.8g x %.8g   data_scale %.8g x %.8g' % (name, fw_min[i], min_[i], fw_scale[i], scale[i]))
+        if rel_min > 1e-5 or rel_scale > 1e-5:
+            print('  !!! constantes divergentes: regenere-as com train_and_convert.py')
+            ok = False
+
+    print('\n--- Erro de reconstrução (C++ x %s) ---' % source)
+    deltas = [abs(c[0] - p) for c, p in zip(cpp, errors)]
+    worst = max(range(len(deltas)), key=deltas.__getitem__)
+    print('|Delta| médio %.3g, máximo %.3g (linha %d)' % (sum(deltas) / len(deltas), deltas[worst], worst))
+    if deltas[worst] > ERROR_TOLERANCE:
+        ok = False
+
+    py_flags = [e > threshold for e in errors]
+    disagreements = [i for i, (c, p) in enumerate(zip(cpp, py_flags)) if c[1] != p]
+    print('Anomalias: %d (C++) x %d (Python), limite %.6f' % (sum(c[1] for c in cpp), sum(py_flags), threshold))
+    print('Concordância das decisões: %.2f%%' % (100.0 * (1 - len(disagreements) / len(rows))))
+    for i in disagreements[:20]:
+        print('  linha %5d  erro C++ %.6f  Python %.6f' % (i, cpp[i][0], errors[i]))
+    if disagreements:
+        ok = False
+
+    print('\n' + ('OK: o firmware reproduz o modelo Python.' if ok else 'DIVERGÊNCIA entre o firmware e o modelo Python.'))
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
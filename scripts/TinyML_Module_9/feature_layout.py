@@ -0,0 +1,36 @@
+"""Layout do vetor de características, lido de include/AnomalyFeatures.def.
+
+O firmware e os scripts de treino usam a mesma lista; não duplique os nomes
+das colunas aqui.
+"""
+import os
+import re
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+LAYOUT_FILE = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'AnomalyFeatures.def')
+
+
+def load_feature_columns(path=LAYOUT_FILE):
+    with open(path, encoding='utf-8') as f:
+        return re.findall(r'^ANOMALY_FEATURE\(\s*\w+\s*,\s*(\w+)\s*\)', f.read(), re.MULTILINE)
+
+
+FEATURE_COLUMNS = load_feature_columns()
+
+
+def model_columns(available):
+    """Maior prefixo do layout presente em 'available' (o modelo usa sempre um prefixo)."""
+    columns = []
+    for name in FEATURE_COLUMNS:
+        if name not in available:
+            break
+        columns.append(name)
+    return columns
+
+
+def layout_hash(columns):
+    """Mesmo FNV-1a de anomalyFeatureLayoutHash() em FeatureVector.h."""
+    h = 2166136261
+    for byte in ','.join(columns).encode():
+        h = ((h ^ byte) * 16777619) & 0xFFFFFFFF
+    return h
@@ -0,0 +1,310 @@
+"""Gera include/AnomalyModelWeights.h a partir de anomaly_model.tflite.
+
+O header contém os pesos do autoencoder como arrays constexpr e o tipo
+tinymlp::Sequential<Dense<...>, ...> com as dimensões de cada camada, para que
+o firmware faça a inferência sem o interpretador do TFLite Micro. Também
+grava a normalização (min_/scale_ do MinMaxScaler), o limite de anomalia e o
+hash das colunas de entrada (um prefixo de include/AnomalyFeatures.def).
+
+Usa apenas a biblioteca padrão: o flatbuffer do .tflite é lido diretamente.
+Também grava vetores de referência (entrada -> saída esperada) calculados aqui
+com a mesma ordem de operações do kernel FULLY_CONNECTED de referência do
+TFLM, em float32; tools/mlp_check compara a engine C++ com eles.
+
+Junto com o header grava anomaly_model.bin (formato de include/AnomalyModelBlob.h):
+os mesmos pesos, normalização e limite num blob com CRC, para trocar o modelo
+sem regravar o firmware:
+    curl --data-binary @anomaly_model.bin http://<ip-do-esp32>/model
+
+Uso:
+    python generate_mlp_header.py [modelo.tflite] [saida.h] [dataset.csv]
+
+Pela linha de comando a normalização e o limite são recalculados sobre o
+dataset, como em train_and_convert.py (MinMaxScaler; média + 2 desvios do erro).
+"""
+import csv
+import math
+import os
+import struct
+import sys
+import time
+import zlib
+
+from feature_layout import FEATURE_COLUMNS, layout_hash
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_TFLITE = os.path.join(SCRIPT_DIR, 'anomaly_model.tflite')
+DEFAULT_HEADER = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'AnomalyModelWeights.h')
+DEFAULT_DATASET = os.path.join(SCRIPT_DIR, 'network_metrics_dataset.csv')
+DEFAULT_BLOB = os.path.join(SCRIPT_DIR, 'anomaly_model.bin')
+
+# Cabeçalho do blob (AnomalyBlobHeader em include/AnomalyModelBlob.h)
+BLOB_MAGIC = 0x4C444D41
+BLOB_SCHEMA_VERSION = 1
+BLOB_HEADER = struct.Struct('<IHHIIIIHHIfIII')
+ACTIVATION_CODES = {'Linear': 0, 'Relu': 1, 'Sigmoid': 2}  # tinymlp::Activation
+
+# Códigos do schema do TFLite
+OP_FULLY_CONNECTED = 9
+OP_LOGISTIC = 14
+OP_RELU = 19
+ACT_NONE = 0
+ACT_RELU = 1
+TENSOR_FLOAT32 = 0
+
+
+class TfliteReader:
+    """Leitor mínimo do flatbuffer do TFLite (apenas o que um MLP denso usa)."""
+
+    def __init__(self, data):
+        self.buf = data
+
+    def u32(self, o):
+        return struct.unpack_from('<I', self.buf, o)[0]
+
+    def i32(self, o):
+        return struct.unpack_from('<i', self.buf, o)[0]
+
+    def ref(self, o):
+        return o + self.u32(o)
+
+    def table(self, o):
+        vtable = o - self.i32(o)
+        vlen = struct.unpack_from('<H', self.buf, vtable)[0]
+
+        def field(i):
+            if 4 + 2 * i >= vlen:
+                return None
+            off = struct.unpack_from('<H', self.buf, vtable + 4 + 2 * i)[0]
+            return o + off if off else None
+        return field
+
+    def vector(self, o):
+        p = self.ref(o)
+        return p + 4, self.u32(p)
+
+    def int_vector(self, o):
+        p, n = self.vector(o)
+        return [self.i32(p + 4 * k) for k in range(n)]
+
+    def byte(self, o, default=0):
+        return self.buf[o] if o is not None else default
+
+
+def load_layers(path):
+    """Devolve [(pesos[out][in], bias[out], ativacao)] na ordem de execução."""
+    r = TfliteReader(open(path, 'rb').read())
+    model = r.table(r.ref(0))
+
+    opcodes = []
+    p, n = r.vector(model(1))
+    for i in range(n):
+        t = r.table(r.ref(p + 4 * i))
+        # builtin_code (campo 3) substitui deprecated_builtin_code (campo 0) nos schemas novos
+        code = r.i32(t(3)) if t(3) is not None else r.byte(t(0))
+        opcodes.append(max(code, r.byte(t(0))))
+
+    p, n = r.vector(model(2))
+    if n != 1:
+        raise ValueError('esperado um único subgrafo')
+    subgraph = r.table(r.ref(p))
+    buffers_p, _ = r.vector(model(4))
+
+    tensors = []
+    p, n = r.vector(subgraph(0))
+    for i in range(n):
+        t = r.table(r.ref(p + 4 * i))
+        shape = r.int_vector(t(0)) if t(0) is not None else []
+        ttype = r.byte(t(1))
+        data = b''
+        if t(2) is not None:
+            b = r.table(r.ref(buffers_p + 4 * r.u32(t(2))))
+            if b(0) is not None:
+                dp, dn = r.vector(b(0))
+                data = r.buf[dp:dp + dn]
+        tensors.append((shape, ttype, data))
+
+    def floats(index):
+        shape, ttype, data = tensors[index]
+        if ttype != TENSOR_FLOAT32:
+            raise ValueError('apenas modelos float32 são suportados (tensor %d)' % index)
+        return list(struct.unpack('<%df' % (len(data) // 4), data)), shape
+
+    layers = []
+    p, n = r.vector(subgraph(3))
+    for i in range(n):
+        op = r.table(r.ref(p + 4 * i))
+        code = opcodes[r.u32(op(0)) if op(0) is not None else 0]
+        inputs = r.int_vector(op(1))
+        if code == OP_FULLY_CONNECTED:
+            weights, shape = floats(inputs[1])
+            out_dim, in_dim = shape
+            bias = floats(inputs[2])[0] if len(inputs) > 2 and inputs[2] >= 0 else [0.0] * out_dim
+            activation = ACT_NONE
+            if op(4) is not None:  # FullyConnectedOptions.fused_activation_function
+                activation = r.byte(r.table(r.ref(op(4)))(0))
+            if activation not in (ACT_NONE, ACT_RELU):
+                raise ValueError('ativação fundida %d não suportada' % activation)
+            rows = [weights[o * in_dim:(o + 1) * in_dim] for o in range(out_dim)]
+            layers.append([rows, bias, 'Relu' if activation == ACT_RELU else 'Linear'])
+        elif code in (OP_LOGISTIC, OP_RELU) and layers and layers[-1][2] == 'Linear':
+            # Ativação separada logo após a camada densa: funde na camada
+            layers[-1][2] = 'Sigmoid' if code == OP_LOGISTIC else 'Relu'
+        else:
+            raise ValueError('operador %d não suportado' % code)
+    return layers
+
+
+def f32(x):
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+
+def reference_forward(layers, x):
+    """Emula a inferência em float32, na ordem do kernel de referência do TFLM."""
+    for rows, bias, activation in layers:
+        y = []
+        for o, row in enumerate(rows):
+            acc = 0.0
+            for w, v in zip(row, x):
+                acc = f32(acc + f32(w * v))
+            acc = f32(acc + bias[o])
+            if activation == 'Relu':
+                acc = max(acc, 0.0)
+            elif activation == 'Sigmoid':
+                acc = f32(1.0 / (1.0 + math.exp(-acc)))
+            y.append(acc)
+        x = y
+    return x
+
+
+def fmt(v):
+    return '%.9ef' % v
+
+
+def shape_hash(layers):
+    """Mesmo FNV-1a de tinymlp::Sequential::shapeHash() (palavras In, Out, Act)."""
+    h = 2166136261
+    for rows, _, activation in layers:
+        for word in (len(rows[0]), len(rows), ACTIVATION_CODES[activation]):
+            for byte in struct.pack('<I', word):
+                h = ((h ^ byte) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def write_model_blob(layers, scaler_min, scaler_scale, threshold, columns, blob_path, model_version=None):
+    """Grava o blob carregável pelo ModelStore (sequence 0: o firmware numera)."""
+    params = []
+    for rows, bias, _ in layers:
+        for row in rows:
+            params += row
+        params += bias
+    payload = struct.pack('<%df' % (2 * len(columns) + len(params)), *(list(scaler_min) + list(scaler_scale) + params))
+    if model_version is None:
+        model_version = int(time.strftime('%Y%m%d'))
+    fields = [BLOB_MAGIC, BLOB_SCHEMA_VERSION, BLOB_HEADER.size, 0, model_version, layout_hash(columns),
+              shape_hash(layers), len(columns), 0, len(params), threshold, len(payload), zlib.crc32(payload)]
+    header_crc = zlib.crc32(BLOB_HEADER.pack(*(fields + [0]))[:-4])
+    with open(blob_path, 'wb') as f:
+        f.write(BLOB_HEADER.pack(*(fields + [header_crc])) + payload)
+    print("Blob do modelo (%d B, versão %d) salvo em '%s'" % (BLOB_HEADER.size + len(payload), model_version,
+                                                             os.path.normpath(blob_path)))
+
+
+def calibrate_from_dataset(layers, dataset_path):
+    """MinMaxScaler (min_, scale_) e limite média + 2 desvios do MAE, sobre o dataset."""
+    columns = FEATURE_COLUMNS[:len(layers[0][0][0])]
+    with open(dataset_path, newline='') as f:
+        rows = [[float(r[c]) for c in columns] for r in csv.DictReader(f)]
+    scale, min_ = [], []
+    for values in zip(*rows):
+        span = max(values) - min(values)
+        scale.append(1.0 / span if span > 0 else 1.0)
+        min_.append(-min(values) * scale[-1])
+    errors = []
+    for row in rows:
+        x = [f32(v * s + m) for v, s, m in zip(row, scale, min_)]
+        y = reference_forward(layers, x)
+        errors.append(sum(abs(a - b) for a, b in zip(x, y)) / len(x))
+    mean = sum(errors) / len(errors)
+    std = math.sqrt(sum((e - mean) ** 2 for e in errors) / len(errors))
+    return min_, scale, mean + 2 * std
+
+
+def reference_inputs(in_dim):
+    """Grade no intervalo normalizado e alguns pontos fora dele (cada coordenada
+    percorre a grade com um passo diferente, para qualquer número de entradas)."""
+    grid = [0.0, 0.1, 0.25, 0.5, 0.75, 1.0]
+    inputs = [[grid[(n + k * (n // len(grid))) % len(grid)] for k in range(in_dim)] for n in range(len(grid) ** 2)]
+    inputs += [[1.5, 0.05] * in_dim, [0.05, 2.0] * in_dim, [3.0] * in_dim, [-0.2, 0.4] * in_dim]
+    return [[f32(v) for v in row[:in_dim]] for row in inputs]
+
+
+def generate(tflite_path=DEFAULT_TFLITE, header_path=DEFAULT_HEADER, scaler_min=None, scaler_scale=None,
+             threshold=None, dataset_path=DEFAULT_DATASET, blob_path=DEFAULT_BLOB):
+    layers = load_layers(tflite_path)
+    in_dim = len(layers[0][0][0])
+    out_dim = len(layers[-1][0])
+    if in_dim != out_dim or in_dim > len(FEATURE_COLUMNS):
+        raise ValueError('o autoencoder tem %d entradas; o layout tem %d características' % (in_dim, len(FEATURE_COLUMNS)))
+    if scaler_min is None or scaler_scale is None or threshold is None:
+        scaler_min, scaler_scale, threshold = calibrate_from_dataset(layers, dataset_path)
+    columns = FEATURE_COLUMNS[:in_dim]
+
+    inputs = reference_inputs(in_dim)
+    outputs = [reference_forward(layers, row) for row in inputs]
+
+    lines = [
+        '#ifndef ANOMALY_MODEL_WEIGHTS_H',
+        '#define ANOMALY_MODEL_WEIGHTS_H',
+        '',
+        '// Gerado por scripts/TinyML_Module_9/generate_mlp_header.py a partir de',
+        '// %s. Não edite à mão: rode o script novamente.' % os.path.basename(tflite_path),
+        '',
+        '#include <cstdint>',
+        '#include "TinyMlp.h"',
+        '',
+        'typedef tinymlp::Sequential<',
+    ]
+    for i, (rows, _, activation) in enumerate(layers):
+        sep = ',' if i + 1 < len(layers) else ''
+        lines.append('    tinymlp::Dense<%d, %d, tinymlp::Activation::%s>%s' % (len(rows[0]), len(rows), activation, sep))
+    lines += ['> AnomalyMlp;', '']
+
+    lines.append('// Entradas: %s (prefixo de AnomalyFeatures.def)' % ', '.join(columns))
+    lines.append('constexpr uint32_t anomaly_mlp_layout_hash = 0x%08xu;' % layout_hash(columns))
+    lines.append('// Normalização do treino (MinMaxScaler.min_ e scale_): x * scale + min')
+    lines.append('constexpr float anomaly_mlp_input_min[%d] = { %s };' % (in_dim, ', '.join(fmt(v) for v in scaler_min)))
+    lines.append('constexpr float anomaly_mlp_input_scale[%d] = { %s };' % (in_dim, ', '.join(fmt(v) for v in scaler_scale)))
+    lines.append('// Limite de anomalia: média + 2 desvios do erro de reconstrução no treino')
+    lines.append('constexpr float anomaly_mlp_threshold = %s;' % fmt(threshold))
+    lines.append('')
+
+    lines.append('// Pesos ([saída][entrada], linha a linha) seguidos do bias de cada camada')
+    lines.append('constexpr float anomaly_mlp_params[AnomalyMlp::paramCount] = {')
+    for i, (rows, bias, activation) in enumerate(layers):
+        lines.append('  // Camada %d: %d -> %d (%s)' % (i, len(rows[0]), len(rows), activation))
+        for row in rows:
+            lines.append('  ' + ', '.join(fmt(w) for w in row) + ',')
+        lines.append('  ' + ', '.join(fmt(b) for b in bias) + ',')
+    lines += ['};', '']
+
+    lines.append('// Saídas esperadas (float32, ordem do kernel de referência do TFLM)')
+    lines.append('constexpr int anomaly_mlp_reference_count = %d;' % len(inputs))
+    lines.append('constexpr float anomaly_mlp_reference_inputs[][%d] = {' % in_dim)
+    lines += ['  {' + ', '.join(fmt(v) for v in row) + '},' for row in inputs]
+    lines += ['};', 'constexpr float anomaly_mlp_reference_outputs[][%d] = {' % out_dim]
+    lines += ['  {' + ', '.join(fmt(v) for v in row) + '},' for row in outputs]
+    lines += ['};', '', '#endif', '']
+
+    with open(header_path, 'w', newline='\n') as f:
+        f.write('\n'.join(lines))
+    params = sum(len(rows) * len(rows[0]) + len(rows) for rows, _, _ in layers)
+    print("Pesos do MLP (%d camadas, %d parâmetros, %d B) salvos em '%s'"
+          % (len(layers), params, 4 * params, os.path.normpath(header_path)))
+    if blob_path:
+        write_model_blob(layers, scaler_min, scaler_scale, threshold, columns, blob_path)
+
+
+if __name__ == '__main__':
+    args = sys.argv[1:4]
+    generate(*args[:2], dataset_path=args[2] if len(args) > 2 else DEFAULT_DATASET)
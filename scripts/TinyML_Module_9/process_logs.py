@@ -1,9 +1,16 @@
 import os
+import ipaddress
 import pyshark
 import pandas as pd
 import datetime
+from collections import defaultdict
 from tqdm import tqdm
 
+from feature_layout import FEATURE_COLUMNS
+
+# Para arquivos grandes, o env native_pcap_features (tools/pcap_features) gera
+# o mesmo CSV em C++, com várias threads e o parser/FeatureStage do firmware.
+
 # --- CONFIGURAÇÕES ---
 # Coloque o caminho para a pasta onde estão seus logs do Wireshark
 LOGS_FOLDER = 'Wireshark_Logs'  # '.' significa 'a pasta atual'
@@ -48,12 +55,9 @@ def process_pcap_files(folder_path):
                     
                     # Inicializa a janela de tempo no nosso dicionário se for a primeira vez
                     if window_ts not in metrics:
-                        metrics[window_ts] = {'packet_count': 0, 'total_bytes': 0}
-                        
-                    # Acumula as métricas: incrementa a contagem e soma o tamanho do pacote
-                    metrics[window_ts]['packet_count'] += 1
-                    metrics[window_ts]['total_bytes'] += int(packet.length)
-                    
+                        metrics[window_ts] = new_window()
+                    accumulate(metrics[window_ts], packet)
+
                 except (AttributeError, KeyError):
                     # Ignora pacotes que possam estar malformados ou não ter os campos necessários
                     continue
@@ -62,7 +66,57 @@ def process_pcap_files(folder_path):
             print(f"Erro ao processar o arquivo {file_path}: {e}")
             continue
             
-    return metrics
+    return {ts: window_features(w) for ts, w in metrics.items()}
+
+
+# --- Características por janela (mesma definição do FeatureStage do firmware) ---
+def new_window():
+    return {'packets': 0, 'bytes': 0, 'retries': 0, 'dns_queries': 0,
+            'station_bytes': defaultdict(int), 'peers': set()}
+
+
+def is_public_ip(address):
+    ip = ipaddress.ip_address(address)
+    return not (ip.is_private or ip.is_loopback or ip.is_link_local or ip.is_multicast
+                or ip.is_reserved or ip.is_unspecified)
+
+
+def accumulate(window, packet):
+    length = int(packet.length)
+    window['packets'] += 1
+    window['bytes'] += length
+    # Transmissor: endereço TA do 802.11 ou, em capturas Ethernet, o MAC de origem
+    if hasattr(packet, 'wlan'):
+        station = getattr(packet.wlan, 'ta', None) or getattr(packet.wlan, 'sa', None)
+        if getattr(packet.wlan, 'fc_retry', '0') in ('1', 'True'):
+            window['retries'] += 1
+    else:
+        station = getattr(getattr(packet, 'eth', None), 'src', None)
+    if station:
+        window['station_bytes'][station] += length
+    if hasattr(packet, 'ip'):
+        for address in (packet.ip.src, packet.ip.dst):
+            if is_public_ip(address):
+                window['peers'].add(address)
+        if hasattr(packet, 'udp') and packet.udp.dstport == '53':
+            window['dns_queries'] += 1
+
+
+def window_features(window):
+    packets = window['packets']
+    values = {
+        'packet_count': packets,
+        'total_bytes': window['bytes'],
+        'active_stations': len(window['station_bytes']),
+        'top_talker_share': max(window['station_bytes'].values(), default=0) / max(window['bytes'], 1),
+        'dns_queries_per_min': window['dns_queries'] * 60.0 / TIME_WINDOW_SECONDS,
+        'distinct_peers': len(window['peers']),
+        'mean_frame_size': window['bytes'] / max(packets, 1),
+        'retry_rate': window['retries'] / max(packets, 1),
+    }
+    # Colunas na ordem do layout compartilhado com o firmware
+    return {name: values[name] for name in FEATURE_COLUMNS}
+
 
 def save_metrics_to_csv(metrics, output_file):
     """
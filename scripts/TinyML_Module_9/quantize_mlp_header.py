@@ -0,0 +1,277 @@
+"""Gera include/AnomalyModelInt8.h: o autoencoder quantizado em int8.
+
+Usa o esquema de quantização completa (int8 nas entradas, saídas e ativações)
+do conversor do TFLite, calibrado com o dataset como conjunto representativo:
+
+  - pesos simétricos por tensor (zero point 0, escala max|w| / 127);
+  - bias int32 na escala entrada * peso;
+  - ativações assimétricas, com a faixa observada no modelo float sobre o
+    dataset (a Relu fundida vira o piso do clamp no zero point da saída);
+  - escala entrada * peso / saída de cada camada como multiplicador Q31 e
+    expoente (QuantizeMultiplier do TFLite);
+  - Sigmoid por uma tabela de 256 entradas, com a saída em escala 1/256 e
+    zero point -128, como o LOGISTIC int8 do TFLM.
+
+O firmware roda as camadas com tinymlp::Dense::forwardBatchInt8() (TinyMlp.h),
+que é a conta do kernel FULLY_CONNECTED int8 de referência do TFLM e do
+esp_nn_fully_connected_s8 do ESP-NN. A inferência inteira é emulada aqui, bit
+a bit, para recalcular o limite de anomalia sobre o erro do próprio modelo int8
+e gravar vetores de referência para o tools/mlp_check.
+
+Só a biblioteca padrão: o .tflite float é lido por generate_mlp_header.py.
+
+Uso:
+    python quantize_mlp_header.py [modelo.tflite] [saida.h] [dataset.csv]
+"""
+import csv
+import math
+import os
+import sys
+
+from feature_layout import FEATURE_COLUMNS, layout_hash
+from generate_mlp_header import (DEFAULT_DATASET, DEFAULT_TFLITE, calibrate_from_dataset, f32, fmt, load_layers,
+                                 reference_forward, reference_inputs, shape_hash)
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_HEADER = os.path.join(SCRIPT_DIR, '..', '..', 'include', 'AnomalyModelInt8.h')
+
+# Saída do LOGISTIC int8 no TFLite
+SIGMOID_SCALE = 1.0 / 256
+SIGMOID_ZERO_POINT = -128
+
+
+def round_half_away(x):
+    """std::round / lroundf: metade para longe do zero."""
+    return int(math.floor(abs(x) + 0.5)) * (1 if x >= 0 else -1)
+
+
+def choose_qparams(rmin, rmax):
+    """Escala e zero point int8 assimétricos cobrindo [rmin, rmax] (que inclui o zero)."""
+    rmin, rmax = min(rmin, 0.0), max(rmax, 0.0)
+    scale = f32((rmax - rmin) / 255.0) if rmax > rmin else 1.0
+    zero_point = max(-128, min(127, round_half_away(-128 - rmin / scale)))
+    return scale, zero_point
+
+
+def quantize_multiplier(real):
+    """QuantizeMultiplier do TFLite: real = multiplicador / 2^31 * 2^expoente."""
+    if real == 0.0:
+        return 0, 0
+    mantissa, shift = math.frexp(real)
+    q = round_half_away(mantissa * (1 << 31))
+    if q == 1 << 31:
+        q //= 2
+        shift += 1
+    if shift < -31:
+        return 0, 0
+    return q, shift
+
+
+def div_trunc(a, b):
+    """Divisão inteira do C (trunca em direção ao zero)."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+def multiply_by_quantized_multiplier(x, multiplier, shift):
+    """MultiplyByQuantizedMultiplier do TFLM (SaturatingRoundingDoublingHighMul + RoundingDivideByPOT)."""
+    left, right = max(shift, 0), max(-shift, 0)
+    a = x * (1 << left)
+    a = max(-(1 << 31), min((1 << 31) - 1, a))
+    if a == multiplier == -(1 << 31):
+        high = (1 << 31) - 1
+    else:
+        ab = a * multiplier
+        nudge = (1 << 30) if ab >= 0 else 1 - (1 << 30)
+        high = div_trunc(ab + nudge, 1 << 31)
+    mask = (1 << right) - 1
+    remainder = high & mask
+    threshold = (mask >> 1) + (1 if high < 0 else 0)
+    return (high >> right) + (1 if remainder > threshold else 0)
+
+
+def activation_ranges(layers, samples):
+    """Faixa (mín, máx) da saída de cada camada no modelo float; na Sigmoid, antes da ativação."""
+    ranges = [[0.0, 0.0] for _ in layers]
+    for x in samples:
+        for k, (rows, bias, activation) in enumerate(layers):
+            pre = [sum(w * v for w, v in zip(row, x)) + b for row, b in zip(rows, bias)]
+            x = [max(v, 0.0) for v in pre] if activation == 'Relu' else pre
+            ranges[k][0] = min(ranges[k][0], min(x))
+            ranges[k][1] = max(ranges[k][1], max(x))
+            if activation == 'Sigmoid':
+                x = [1.0 / (1.0 + math.exp(-v)) for v in pre]
+    return ranges
+
+
+def quantize(layers, samples):
+    """Parâmetros int8 de cada camada, na ordem de tinymlp::QuantParams."""
+    input_scale, input_zero_point = choose_qparams(min(min(s) for s in samples), max(max(s) for s in samples))
+    quantized = []
+    in_scale, in_zero_point = input_scale, input_zero_point
+    for (rows, bias, activation), (rmin, rmax) in zip(layers, activation_ranges(layers, samples)):
+        max_abs = max(abs(w) for row in rows for w in row)
+        w_scale = f32(max_abs / 127.0) if max_abs > 0 else 1.0
+        weights = [[max(-127, min(127, round_half_away(w / w_scale))) for w in row] for row in rows]
+        bias_q = [round_half_away(b / (in_scale * w_scale)) for b in bias]
+        out_scale, out_zero_point = choose_qparams(rmin, rmax)
+        multiplier, shift = quantize_multiplier(in_scale * w_scale / out_scale)
+        act_min = out_zero_point if activation == 'Relu' else -128
+        lut = None
+        if activation == 'Sigmoid':
+            lut = [max(-128, min(127, round_half_away(1.0 / (1.0 + math.exp(-(q - out_zero_point) * out_scale))
+                                                      / SIGMOID_SCALE) + SIGMOID_ZERO_POINT))
+                   for q in range(-128, 128)]
+        quantized.append({
+            'weights': weights, 'bias': bias_q, 'input_offset': -in_zero_point, 'output_offset': out_zero_point,
+            'multiplier': multiplier, 'shift': shift, 'act_min': act_min, 'act_max': 127, 'lut': lut,
+            'activation': activation,
+        })
+        in_scale, in_zero_point = (SIGMOID_SCALE, SIGMOID_ZERO_POINT) if lut else (out_scale, out_zero_point)
+    return quantized, (input_scale, input_zero_point), (in_scale, in_zero_point)
+
+
+def quantize_input(x, scale, zero_point):
+    """Como AutoencoderEngine::invoke(): lroundf(x / scale) + zero point, saturado."""
+    return max(-128, min(127, round_half_away(f32(f32(x) / scale)) + zero_point))
+
+
+def int8_forward(quantized, q_in):
+    """Emula tinymlp::Dense::forwardBatchInt8() camada a camada."""
+    x = q_in
+    for layer in quantized:
+        y = []
+        for row, b in zip(layer['weights'], layer['bias']):
+            acc = b + sum((v + layer['input_offset']) * w for v, w in zip(x, row))
+            acc = multiply_by_quantized_multiplier(acc, layer['multiplier'], layer['shift']) + layer['output_offset']
+            acc = max(layer['act_min'], min(layer['act_max'], acc))
+            y.append(layer['lut'][acc + 128] if layer['lut'] else acc)
+        x = y
+    return x
+
+
+def reconstruction_error(x, y):
+    """Erro médio absoluto em float32, na ordem de AutoencoderEngine::_score()."""
+    total = 0.0
+    for a, b in zip(x, y):
+        total = f32(total + abs(f32(a - b)))
+    return f32(total / len(x))
+
+
+def mean_std(values):
+    mean = sum(values) / len(values)
+    return mean, math.sqrt(sum((v - mean) ** 2 for v in values) / len(values))
+
+
+def flash_bytes(quantized):
+    return sum(len(l['weights']) * len(l['weights'][0]) + 4 * len(l['bias']) + (256 if l['lut'] else 0)
+               for l in quantized)
+
+
+def c_array(values, per_line=16):
+    return ['  ' + ', '.join(str(v) for v in values[i:i + per_line]) + ',' for i in range(0, len(values), per_line)]
+
+
+def generate_int8(tflite_path=DEFAULT_TFLITE, header_path=DEFAULT_HEADER, dataset_path=DEFAULT_DATASET):
+    layers = load_layers(tflite_path)
+    in_dim = len(layers[0][0][0])
+    columns = FEATURE_COLUMNS[:in_dim]
+    scaler_min, scaler_scale, float_threshold = calibrate_from_dataset(layers, dataset_path)
+    with open(dataset_path, newline='') as f:
+        rows = [[float(r[c]) for c in columns] for r in csv.DictReader(f)]
+    # Mesma normalização em float32 do firmware: x * scale + min
+    samples = [[f32(f32(f32(v) * f32(s)) + f32(m)) for v, s, m in zip(row, scaler_scale, scaler_min)] for row in rows]
+
+    quantized, (in_scale, in_zp), (out_scale, out_zp) = quantize(layers, samples)
+
+    def run(x):
+        q = int8_forward(quantized, [quantize_input(v, in_scale, in_zp) for v in x])
+        return q, [f32((v - out_zp) * out_scale) for v in q]
+
+    float_errors = [reconstruction_error(x, reference_forward(layers, x)) for x in samples]
+    int8_errors = [reconstruction_error(x, run(x)[1]) for x in samples]
+    mean, std = mean_std(int8_errors)
+    threshold = mean + 2 * std
+    float_flags = [e > float_threshold for e in float_errors]
+    int8_flags = [e > threshold for e in int8_errors]
+    agree = sum(a == b for a, b in zip(float_flags, int8_flags))
+
+    ref_inputs = reference_inputs(in_dim)
+    ref_outputs = [run(x)[0] for x in ref_inputs]
+
+    lines = [
+        '#ifndef ANOMALY_MODEL_INT8_H',
+        '#define ANOMALY_MODEL_INT8_H',
+        '',
+        '// Gerado por scripts/TinyML_Module_9/quantize_mlp_header.py a partir de',
+        '// %s, calibrado com %s.' % (os.path.basename(tflite_path), os.path.basename(dataset_path)),
+        '// Não edite à mão: rode o script novamente.',
+        '//',
+        '// Mesma arquitetura, entradas e normalização de AnomalyModelWeights.h; aqui só',
+        '// os pesos e as ativações int8 (tinymlp::QuantParams de cada camada).',
+        '',
+        '#include <cstdint>',
+        '#include "TinyMlp.h"',
+        '',
+        'constexpr uint32_t anomaly_mlp_int8_layout_hash = 0x%08xu;' % layout_hash(columns),
+        'constexpr uint32_t anomaly_mlp_int8_shape_hash = 0x%08xu;' % shape_hash(layers),
+        '// Entrada normalizada e saída reconstruída: valor = (q - zero point) * escala',
+        'constexpr float anomaly_mlp_int8_input_scale = %s;' % fmt(in_scale),
+        'constexpr int32_t anomaly_mlp_int8_input_zero_point = %d;' % in_zp,
+        'constexpr float anomaly_mlp_int8_output_scale = %s;' % fmt(out_scale),
+        'constexpr int32_t anomaly_mlp_int8_output_zero_point = %d;' % out_zp,
+        '// Pesos, bias e tabelas da Sigmoid em flash',
+        'constexpr uint32_t anomaly_mlp_int8_flash_bytes = %d;' % flash_bytes(quantized),
+        '// Limite: média + 2 desvios do erro de reconstrução do próprio modelo int8 no dataset',
+        'constexpr float anomaly_model_int8_threshold = %s;' % fmt(threshold),
+        '',
+    ]
+    for k, layer in enumerate(quantized):
+        rows_k = layer['weights']
+        lines.append('// Camada %d: %d -> %d (%s)' % (k, len(rows_k[0]), len(rows_k), layer['activation']))
+        lines.append('constexpr int8_t anomaly_mlp_int8_weights_%d[] = {' % k)
+        lines += c_array([w for row in rows_k for w in row])
+        lines += ['};', 'constexpr int32_t anomaly_mlp_int8_bias_%d[] = {' % k]
+        lines += c_array(layer['bias'], 8)
+        lines += ['};']
+        if layer['lut']:
+            lines.append('// Sigmoid: saída int8 para cada entrada + 128')
+            lines.append('constexpr int8_t anomaly_mlp_int8_sigmoid_%d[256] = {' % k)
+            lines += c_array(layer['lut'])
+            lines += ['};']
+        lines.append('')
+
+    lines.append('constexpr tinymlp::QuantParams anomaly_mlp_int8_layers[] = {')
+    for k, layer in enumerate(quantized):
+        lines.append('  { anomaly_mlp_int8_weights_%d, anomaly_mlp_int8_bias_%d, %d, %d, %d, %d, %d, %d, %s },'
+                     % (k, k, layer['input_offset'], layer['output_offset'], layer['multiplier'], layer['shift'],
+                        layer['act_min'], layer['act_max'],
+                        'anomaly_mlp_int8_sigmoid_%d' % k if layer['lut'] else 'nullptr'))
+    lines += ['};', '']
+
+    lines.append('// Saídas int8 esperadas para anomaly_mlp_reference_inputs (AnomalyModelWeights.h)')
+    lines.append('constexpr int anomaly_mlp_int8_reference_count = %d;' % len(ref_inputs))
+    lines.append('constexpr int8_t anomaly_mlp_int8_reference_outputs[][%d] = {' % in_dim)
+    lines += ['  {' + ', '.join(str(v) for v in row) + '},' for row in ref_outputs]
+    lines += ['};', '', '#endif', '']
+
+    with open(header_path, 'w', newline='\r\n') as f:
+        f.write('\n'.join(lines))
+
+    weight_bytes = flash_bytes(quantized)
+    float_bytes = 4 * sum(len(rows) * len(rows[0]) + len(rows) for rows, _, _ in layers)
+    print("Modelo int8 salvo em '%s'" % os.path.normpath(header_path))
+    print('\n--- Relatório float32 x int8 (%d linhas de %s) ---' % (len(samples), os.path.basename(dataset_path)))
+    print('Pesos em flash:              %d B x %d B' % (float_bytes, weight_bytes))
+    print('Erro médio de reconstrução:  %.6f x %.6f' % (mean_std(float_errors)[0], mean))
+    print('|Delta| médio do erro:       %.6f' % (sum(abs(a - b) for a, b in zip(float_errors, int8_errors))
+                                                / len(samples)))
+    print('Limite de anomalia:          %.6f x %.6f' % (float_threshold, threshold))
+    print('Anomalias sinalizadas:       %d x %d' % (sum(float_flags), sum(int8_flags)))
+    print('Concordância das decisões:   %.2f%%' % (100.0 * agree / len(samples)))
+    return quantized
+
+
+if __name__ == '__main__':
+    args = sys.argv[1:4]
+    generate_int8(*args)
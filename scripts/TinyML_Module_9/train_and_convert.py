@@ -1,4 +1,5 @@
 import os
+import sys
 import pandas as pd
 import numpy as np
 import tensorflow as tf
@@ -7,12 +8,21 @@ from sklearn.preprocessing import MinMaxScaler
 from sklearn.model_selection import train_test_split
 import joblib
 
+from feature_layout import FEATURE_COLUMNS, model_columns
+from generate_mlp_header import generate as generate_mlp_header
+from quantize_mlp_header import generate_int8 as generate_int8_header
+
 # --- CONFIGURAÇÕES ---
-CSV_FILE = 'network_metrics_dataset.csv'
+# Outro CSV (ex.: o /features.csv gravado pelo próprio ESP32) como 1º argumento
+CSV_FILE = sys.argv[1] if len(sys.argv) > 1 else 'network_metrics_dataset.csv'
 SCALER_FILE = 'data_scaler.gz'
 MODEL_H5_FILE = 'anomaly_detector.h5'
 MODEL_TFLITE_FILE = 'anomaly_model.tflite'
 MODEL_H_FILE = 'anomaly_model.h'
+# Pesos em arrays constexpr para a engine sem interpretador (ver generate_mlp_header.py)
+MODEL_WEIGHTS_H_FILE = 'anomaly_model_weights.h'
+# Variante totalmente quantizada (int8), executada pelos kernels ESP-NN no ESP32-S3
+MODEL_INT8_H_FILE = 'anomaly_model_int8.h'
 
 # --- MUDANÇA 1: Aumentar o número máximo de épocas ---
 EPOCHS = 500 # Um número bem alto para dar espaço para o EarlyStopping funcionar
@@ -24,7 +34,18 @@ print(f"--- Fase 1: Preparando dados do arquivo '{CSV_FILE}' ---")
 
 # (O código de preparação de dados permanece o mesmo)
 df = pd.read_csv(CSV_FILE)
-data_for_training = df[['packet_count', 'total_bytes']]
+# O /features.csv do firmware marca os ciclos que o detector considerou anomalia;
+# o autoencoder aprende só o tráfego normal
+if 'anomaly' in df.columns:
+    print(f"Descartando {int((df['anomaly'] == 1).sum())} ciclos marcados como anomalia.")
+    df = df[df['anomaly'] != 1]
+# O modelo usa o maior prefixo do layout (include/AnomalyFeatures.def) presente no CSV
+feature_columns = model_columns(df.columns)
+if len(feature_columns) < len(FEATURE_COLUMNS):
+    print(f"AVISO: o dataset tem só {feature_columns}; regenere-o com process_logs.py "
+          f"para treinar com as {len(FEATURE_COLUMNS)} características do layout.")
+print(f"Características de entrada: {feature_columns}")
+data_for_training = df[feature_columns]
 scaler = MinMaxScaler()
 data_scaled = scaler.fit_transform(data_for_training)
 joblib.dump(scaler, SCALER_FILE)
@@ -89,25 +110,50 @@ with open(MODEL_TFLITE_FILE, 'wb') as f:
     f.write(tflite_model)
 print(f"Modelo TFLite salvo em '{MODEL_TFLITE_FILE}'")
 
-try:
-    with open(MODEL_H_FILE, 'w') as h_file:
-        h_file.write('#ifndef ANOMALY_MODEL_H\n')
-        h_file.write('#define ANOMALY_MODEL_H\n\n')
+def write_c_header(model_bytes, h_path, var_name, guard, extra_lines=()):
+    """Gera o arquivo .h com o modelo como array de bytes (mesmo formato do xxd -i)."""
+    with open(h_path, 'w') as h_file:
+        h_file.write(f'#ifndef {guard}\n')
+        h_file.write(f'#define {guard}\n\n')
         h_file.write('// Modelo treinado para detecção de anomalias na rede\n')
-        h_file.write(f'const unsigned int {os.path.splitext(MODEL_TFLITE_FILE)[0]}_tflite_len = {len(tflite_model)};\n')
-        h_file.write(f'const unsigned char {os.path.splitext(MODEL_TFLITE_FILE)[0]}_tflite[] = {{\n  ')
-        
-        for i, byte in enumerate(tflite_model):
+        for line in extra_lines:
+            h_file.write(line + '\n')
+        h_file.write(f'const unsigned int {var_name}_len = {len(model_bytes)};\n')
+        h_file.write(f'const unsigned char {var_name}[] = {{\n  ')
+
+        for i, byte in enumerate(model_bytes):
             h_file.write(f'0x{byte:02x}, ')
             if (i + 1) % 12 == 0:
                 h_file.write('\n  ')
-        
+
         h_file.write('\n};\n\n')
-        h_file.write('#endif // ANOMALY_MODEL_H\n')
-        
-    print(f"Modelo C++ salvo com sucesso em '{MODEL_H_FILE}'")
-    print("\nPROCESSO CONCLUÍDO!")
+        h_file.write(f'#endif // {guard}\n')
+
 
+try:
+    write_c_header(tflite_model, MODEL_H_FILE, os.path.splitext(MODEL_TFLITE_FILE)[0] + '_tflite', 'ANOMALY_MODEL_H')
+    print(f"Modelo C++ salvo com sucesso em '{MODEL_H_FILE}'")
 except Exception as e:
     print(f"\nErro ao gerar o arquivo .h: {e}")
-    print("Se o erro persistir, use o comando 'xxd -i anomaly_model.tflite > anomaly_model.h' no seu terminal (Git Bash).")
\ No newline at end of file
+    print("Se o erro persistir, use o comando 'xxd -i anomaly_model.tflite > anomaly_model.h' no seu terminal (Git Bash).")
+
+# Pesos para a engine compilada do firmware (TinyMlp), que dispensa o interpretador
+try:
+    generate_mlp_header(MODEL_TFLITE_FILE, MODEL_WEIGHTS_H_FILE, scaler_min=list(scaler.min_),
+                        scaler_scale=list(scaler.scale_), threshold=float(threshold))
+    print(f"Copie '{MODEL_WEIGHTS_H_FILE}' para include/AnomalyModelWeights.h")
+    print("Ou, sem regravar o firmware: curl --data-binary @anomaly_model.bin http://<ip-do-esp32>/model")
+except Exception as e:
+    print(f"\nErro ao gerar os pesos do MLP: {e}")
+
+
+# --- FASE 5: VARIANTE INT8 TOTALMENTE QUANTIZADA ---
+# Quantiza o modelo float para a engine compilada (TinyMlp), calibrando as
+# ativações com o dataset; os kernels ESP-NN rodam as camadas no ESP32-S3
+print("\n--- Fase 5: Quantização int8 completa (ESP-NN) ---")
+try:
+    generate_int8_header(MODEL_TFLITE_FILE, MODEL_INT8_H_FILE, CSV_FILE)
+    print(f"Copie '{MODEL_INT8_H_FILE}' para include/AnomalyModelInt8.h e compile com -DANOMALY_MODEL_INT8")
+    print("\nPROCESSO CONCLUÍDO!")
+except Exception as e:
+    print(f"\nErro ao gerar o modelo int8: {e}")
@@ -0,0 +1,238 @@
+#include "AnalyzerStages.h"
+#include "esp_log.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+static const char* TAG_TA = "TrafficAnalyzer";
+
+uint64_t StatsStage::macToKey(const uint8_t* mac) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+  return key;
+}
+
+// Estação do quadro: quem transmite na subida, o destino unicast na descida.
+// Tabela de endereçamento aberto; se lotar, as estações novas não são contadas.
+StatsStage::Counters* StatsStage::_station(const ParsedFrame& frame) {
+  const uint8_t* mac;
+  if (frame.isUplink()) {
+    mac = frame.transmitter;
+  } else if ((frame.fcFlags & (WIFI_FC_TO_DS | WIFI_FC_FROM_DS)) == WIFI_FC_FROM_DS && !(frame.dstMac[0] & 0x01)) {
+    mac = frame.dstMac;
+  } else {
+    return nullptr;
+  }
+  uint64_t key = macToKey(mac);
+  if (key == 0) return nullptr;
+  uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 58) % STATS_MAX_STATIONS;
+  for (int probe = 0; probe < STATS_MAX_STATIONS; probe++) {
+    Counters& counters = _stations[(slot + probe) % STATS_MAX_STATIONS];
+    if (counters.key == key) return &counters;
+    if (counters.key == 0) {
+      counters.key = key;
+      return &counters;
+    }
+  }
+  return nullptr;
+}
+
+void StatsStage::onWindowEnd() {
+  ESP_LOGI(TAG_TA, "--- Estatísticas de Tráfego (últimos 30s) ---");
+
+  _windowPackets = _pendingPackets;
+  _windowBytes = _pendingBytes;
+  uint32_t windowMs = _lastMs - _windowStartMs;
+  bool updateProfiles = _pendingPackets > 0 && windowMs >= STATS_MIN_PROFILE_WINDOW_MS;
+  time_t now = time(nullptr);
+  for (const Counters& counters : _stations) {
+    if (counters.key == 0) continue;
+    uint64_t mac = counters.key;
+    uint8_t flags = 0;
+    if (updateProfiles) {
+      const uint8_t bytes[6] = { (uint8_t)(mac >> 40), (uint8_t)(mac >> 32), (uint8_t)(mac >> 24),
+                                 (uint8_t)(mac >> 16), (uint8_t)(mac >> 8), (uint8_t)mac };
+      flags = _profiles.update(bytes, (uint32_t)((uint64_t)counters.bytes * 60000 / windowMs),
+                               (uint32_t)((uint64_t)counters.packets * 60000 / windowMs), counters.peers, now);
+    }
+    ESP_LOGD(TAG_TA, "MAC: %02X:%02X:%02X:%02X:%02X:%02X - Pacotes: %u, Bytes: %u, desvios: 0x%02X",
+             (unsigned)(mac >> 40) & 0xFF, (unsigned)(mac >> 32) & 0xFF, (unsigned)(mac >> 24) & 0xFF,
+             (unsigned)(mac >> 16) & 0xFF, (unsigned)(mac >> 8) & 0xFF, (unsigned)mac & 0xFF,
+             (unsigned)counters.packets, (unsigned)counters.bytes, flags);
+  }
+  memset(_stations, 0, sizeof(_stations));
+  _pendingPackets = 0;
+  _pendingBytes = 0;
+}
+
+// Zera a janela; os perfis continuam
+void StatsStage::reset() {
+  memset(_stations, 0, sizeof(_stations));
+  _pendingPackets = 0;
+  _pendingBytes = 0;
+  _windowStartMs = 0;
+  _lastMs = 0;
+  _windowPackets = 0;
+  _windowBytes = 0;
+}
+
+void DnsStage::_handleQuery(const ParsedFrame& frame) {
+  char qname[128];
+  if (!parseDnsQuery(frame.l4Payload, frame.l4PayloadLength, qname, sizeof(qname))) return;
+  _queriesInWindow++;
+  const uint8_t* mac = frame.transmitter;
+  ESP_LOGW(TAG_TA, "DNS Query from MAC %02X:%02X:%02X:%02X:%02X:%02X -> %s",
+           mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], qname);
+}
+
+void FeatureStage::reset() {
+  memset(_stations, 0, sizeof(_stations));
+  memset(_peerBitmap, 0, sizeof(_peerBitmap));
+  _stationCount = 0;
+  _packets = 0;
+  _bytes = 0;
+  _retries = 0;
+  _dnsQueries = 0;
+  _firstMs = 0;
+  _lastMs = 0;
+}
+
+// Tabela de endereçamento aberto; se lotar, os transmissores novos não são rastreados
+FeatureStage::Station* FeatureStage::_station(const uint8_t* mac) {
+  return _stationByKey(StatsStage::macToKey(mac));
+}
+
+FeatureStage::Station* FeatureStage::_stationByKey(uint64_t key) {
+  if (key == 0) return nullptr;
+  uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 58) % FEATURE_MAX_STATIONS;
+  for (int probe = 0; probe < FEATURE_MAX_STATIONS; probe++) {
+    Station& station = _stations[(slot + probe) % FEATURE_MAX_STATIONS];
+    if (station.key == key) return &station;
+    if (station.key == 0) {
+      station.key = key;
+      _stationCount++;
+      return &station;
+    }
+  }
+  return nullptr;
+}
+
+void FeatureStage::merge(const FeatureStage& other) {
+  if (other._packets == 0) return;
+  if (_packets == 0 || other._firstMs < _firstMs) _firstMs = other._firstMs;
+  if (_packets == 0 || other._lastMs > _lastMs) _lastMs = other._lastMs;
+  _packets += other._packets;
+  _bytes += other._bytes;
+  _retries += other._retries;
+  _dnsQueries += other._dnsQueries;
+  for (int i = 0; i < FEATURE_PEER_BITMAP_BITS / 32; i++) _peerBitmap[i] |= other._peerBitmap[i];
+  for (const Station& theirs : other._stations) {
+    Station* station = _stationByKey(theirs.key);
+    if (station == nullptr) continue;
+    station->bytes += theirs.bytes;
+    station->packets += theirs.packets;
+    station->retries += theirs.retries;
+    station->dnsQueries += theirs.dnsQueries;
+    for (int i = 0; i < FEATURE_DEVICE_PEER_BITS / 32; i++) station->peerBitmap[i] |= theirs.peerBitmap[i];
+  }
+}
+
+// Só endereços públicos contam como peers (o mesmo critério do process_logs.py)
+static bool isPublicIpv4(uint32_t ip) {
+  uint8_t a = ip >> 24, b = (ip >> 16) & 0xFF;
+  if (a == 0 || a == 10 || a == 127 || a >= 224) return false;
+  if (a == 172 && (b & 0xF0) == 16) return false;
+  if (a == 192 && b == 168) return false;
+  if (a == 169 && b == 254) return false;
+  if (a == 100 && (b & 0xC0) == 64) return false; // CGNAT
+  return true;
+}
+
+void FeatureStage::_notePeer(uint32_t ip, Station* station) {
+  if (!isPublicIpv4(ip)) return;
+  uint32_t hash = ip * 2654435761u;
+  uint32_t bit = hash >> (32 - 10);
+  _peerBitmap[bit / 32] |= 1u << (bit % 32);
+  if (station != nullptr) {
+    bit = hash >> (32 - 7);
+    station->peerBitmap[bit / 32] |= 1u << (bit % 32);
+  }
+}
+
+// Estimativa por contagem linear: n ≈ m·ln(m / bits zerados)
+static uint32_t linearCount(const uint32_t* bitmap, uint32_t bits) {
+  uint32_t set = 0;
+  for (uint32_t i = 0; i < bits / 32; i++) set += __builtin_popcount(bitmap[i]);
+  uint32_t zeros = bits - set;
+  if (zeros == 0) zeros = 1;
+  return (uint32_t)lroundf(bits * logf((float)bits / zeros));
+}
+
+// Menos de 1 s de captura não dá uma taxa confiável
+uint32_t FeatureStage::_durationMs() const {
+  uint32_t durationMs = _lastMs - _firstMs;
+  return (durationMs < 1000) ? 1000 : durationMs;
+}
+
+FeatureVector FeatureStage::features() const {
+  FeatureVector v;
+  if (_packets == 0) return v;
+
+  uint64_t topBytes = 0;
+  for (const Station& station : _stations) {
+    if (station.bytes > topBytes) topBytes = station.bytes;
+  }
+
+  v[FEATURE_PACKET_COUNT] = (float)_packets;
+  v[FEATURE_TOTAL_BYTES] = (float)_bytes;
+  v[FEATURE_ACTIVE_STATIONS] = (float)_stationCount;
+  v[FEATURE_TOP_TALKER_SHARE] = (float)topBytes / (float)_bytes;
+  v[FEATURE_DNS_QUERY_RATE] = _dnsQueries * 60000.0f / _durationMs();
+  v[FEATURE_DISTINCT_PEERS] = (float)linearCount(_peerBitmap, FEATURE_PEER_BITMAP_BITS);
+  v[FEATURE_MEAN_FRAME_SIZE] = (float)_bytes / _packets;
+  v[FEATURE_RETRY_RATE] = (float)_retries / _packets;
+  return v;
+}
+
+// Mesmo layout, restrito ao tráfego de cada transmissor; a "fatia do maior
+// transmissor" vira a fatia do próprio dispositivo no total do ciclo
+size_t FeatureStage::deviceFeatures(DeviceFeatures* out, size_t maxOut) const {
+  size_t count = 0;
+  for (const Station& station : _stations) {
+    if (station.key == 0 || station.packets == 0) continue;
+    if (count == maxOut) break;
+    DeviceFeatures& device = out[count++];
+    for (int i = 0; i < 6; i++) device.mac[i] = (uint8_t)(station.key >> (40 - 8 * i));
+    FeatureVector& v = device.features;
+    v = FeatureVector();
+    v[FEATURE_PACKET_COUNT] = (float)station.packets;
+    v[FEATURE_TOTAL_BYTES] = (float)station.bytes;
+    v[FEATURE_ACTIVE_STATIONS] = 1.0f;
+    v[FEATURE_TOP_TALKER_SHARE] = (float)station.bytes / (float)_bytes;
+    v[FEATURE_DNS_QUERY_RATE] = station.dnsQueries * 60000.0f / _durationMs();
+    v[FEATURE_DISTINCT_PEERS] = (float)linearCount(station.peerBitmap, FEATURE_DEVICE_PEER_BITS);
+    v[FEATURE_MEAN_FRAME_SIZE] = (float)station.bytes / station.packets;
+    v[FEATURE_RETRY_RATE] = (float)station.retries / station.packets;
+  }
+  return count;
+}
+
+// Função para extrair a query de um pacote DNS
+bool parseDnsQuery(const uint8_t* data, int len, char* out, size_t outSize) {
+  if (len < 13 || outSize == 0) return false;
+  const uint8_t* query = data + 12;
+  const uint8_t* q_end = data + len;
+  size_t written = 0;
+  while (query < q_end && *query != 0) {
+    uint8_t label_len = *query++;
+    if (label_len == 0 || query + label_len > q_end) break;
+    if (written > 0 && written + 1 < outSize) out[written++] = '.';
+    for (int i = 0; i < label_len && written + 1 < outSize; i++) {
+      out[written++] = (char)query[i];
+    }
+    query += label_len;
+  }
+  out[written] = '\0';
+  return written > 0;
+}
@@ -1,99 +1,128 @@
 #include "AnomalyDetector.h"
 #include "esp_log.h"
 
-// --- INÍCIO DAS CORREÇÕES ---
-#include "tensorflow/lite/micro/micro_interpreter.h"
-#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
-#include "tensorflow/lite/micro/system_setup.h"
-#include "tensorflow/lite/schema/schema_generated.h"
-// Adiciona o header para o reportador de erros
-#include "tensorflow/lite/micro/micro_error_reporter.h"
-// --- FIM DAS CORREÇÕES ---
-
-// Inclui o modelo que foi gerado pelo Python
-#include "AnomalyModel.h"
-
 static const char* TAG = "AnomalyDetector";
 
-// --- CORREÇÃO: Adicionada a palavra-chave 'static' para evitar erros de redefinição ---
-static const float data_min[] = { -0.00239096, -0.00067029 };
-static const float data_scale[] = { 9.83932384e-06, 8.47170853e-09 };
-static const float ANOMALY_THRESHOLD = 0.006253;
-// ------------------------------------------------------------------------------------
-
-// --- Configuração do TensorFlow Lite ---
-const tflite::Model* model = nullptr;
-tflite::MicroInterpreter* interpreter = nullptr;
-TfLiteTensor* input = nullptr;
-TfLiteTensor* output = nullptr;
-constexpr int kTensorArenaSize = 5 * 1024;
-uint8_t tensor_arena[kTensorArenaSize];
+#ifdef ARDUINO
+#include <Preferences.h>
+#include "NvsState.h"
+// Baseline sazonal: um blob por dia da semana ("d0" = domingo)
+static const char* SEASONAL_NAMESPACE = "anomaly-sea";
+#endif
 
-// --- CORREÇÃO: Cria um 'ErrorReporter' para o TensorFlow Lite ---
-tflite::ErrorReporter* error_reporter = nullptr;
-tflite::MicroErrorReporter micro_error_reporter;
-// ------------------------------------------------------------
+AnomalyDetector::AnomalyDetector() : _engine(&_autoencoder) {}
 
-AnomalyDetector::AnomalyDetector() {}
+void AnomalyDetector::setEngine(AnomalyEngineType type) {
+  _engine = (type == AnomalyEngineType::Mahalanobis) ? static_cast<AnomalyEngine*>(&_mahalanobis)
+                                                     : static_cast<AnomalyEngine*>(&_autoencoder);
+}
 
 void AnomalyDetector::setup() {
-  // --- CORREÇÃO: Inicializa o error_reporter ---
-  error_reporter = &micro_error_reporter;
-  // -------------------------------------------
-
-  model = tflite::GetModel(anomaly_model_tflite);
-  if (model->version() != TFLITE_SCHEMA_VERSION) {
-    ESP_LOGE(TAG, "Erro: Versão do modelo incompatível!");
-    return;
-  }
+  // O autoencoder sobe sempre: a pontuação por dispositivo usa a inferência em lote dele
+  _initialized = _autoencoder.begin();
+  // Modelo gravado na flash, se houver, no lugar dos pesos compilados
+  if (_models.begin(AutoencoderEngine::blobExpect()) && _models.hasModel()) _autoencoder.useModel(_models.model());
+  if (_engine != &_autoencoder) _initialized = _engine->begin() && _initialized;
+  ESP_LOGI(TAG, "Engine das janelas globais: %s (%u bytes de RAM).", _engine->name(), (unsigned)_engine->memoryBytes());
+}
 
-  static tflite::MicroMutableOpResolver<4> op_resolver;
-  op_resolver.AddFullyConnected();
-  op_resolver.AddRelu();
-  op_resolver.AddLogistic(); // --- CORREÇÃO: AddSigmoid foi substituído por AddLogistic ---
-  op_resolver.AddReshape();
+bool AnomalyDetector::detect(const FeatureVector& features) {
+  return detect(features, time(nullptr));
+}
 
-  // --- CORREÇÃO: Adicionado o error_reporter como último parâmetro ---
-  static tflite::MicroInterpreter static_interpreter(model, op_resolver, tensor_arena, kTensorArenaSize, error_reporter);
-  interpreter = &static_interpreter;
-  // --------------------------------------------------------------------
+bool AnomalyDetector::detect(const FeatureVector& features, time_t now) {
+  if (!_initialized) return false;
 
-  if (interpreter->AllocateTensors() != kTfLiteOk) {
-    ESP_LOGE(TAG, "Falha ao alocar tensores!");
-    return;
+  // Troca de modelo entre janelas, na mesma task que roda a inferência
+  AnomalyModelView uploaded;
+  if (_models.takeUploaded(&uploaded)) _autoencoder.useModel(uploaded);
+
+  AnomalyScore result;
+  if (!_engine->evaluate(features, &result)) return false;
+  _lastError = result.score;
+  bool anomaly = result.anomalous;
+  if (anomaly) {
+    ESP_LOGW(TAG, "*** ANOMALIA DE TRÁFEGO DETECTADA (%s)! Escore: %.6f (limite %.6f) ***",
+             _engine->name(), result.score, result.threshold);
   }
-
-  input = interpreter->input(0);
-  output = interpreter->output(0);
-  
-  _initialized = true;
-  ESP_LOGI(TAG, "Módulo de Detecção de Anomalias com TinyML inicializado.");
+  if (_seasonalEnabled) anomaly = _applySeasonal(features, now, anomaly);
+  return anomaly;
 }
 
-bool AnomalyDetector::detect(uint32_t packet_count, uint64_t total_bytes) {
-  if (!_initialized) return false;
-
-  float norm_packet_count = ( (float)packet_count - data_min[0]) * data_scale[0];
-  float norm_total_bytes = ( (float)total_bytes - data_min[1]) * data_scale[1];
+void AnomalyDetector::setSeasonalBaseline(bool enabled) {
+  _seasonalEnabled = enabled;
+  _seasonalBucket = -1;
+  if (enabled) _loadSeasonal();
+}
 
-  input->data.f[0] = norm_packet_count;
-  input->data.f[1] = norm_total_bytes;
+// Decide a janela pelo balde da hora atual, com o modelo como segundo sinal, e aprende a janela
+bool AnomalyDetector::_applySeasonal(const FeatureVector& features, time_t now, bool modelAnomaly) {
+  _lastSeasonalScore = 0.0f;
+  int bucket = SeasonalBaseline::bucketFor(now);
+  if (bucket < 0) {
+    ESP_LOGI(TAG, "Baseline sazonal inativo: relógio ainda não sincronizado (SNTP).");
+    return modelAnomaly;
+  }
 
-  if (interpreter->Invoke() != kTfLiteOk) {
-    ESP_LOGE(TAG, "Falha na invocação do interpretador");
-    return false;
+  bool anomaly = modelAnomaly;
+  if (_seasonal.isWarm(bucket)) {
+    int worst;
+    _lastSeasonalScore = _seasonal.score(bucket, features.values, &worst);
+    ESP_LOGI(TAG, "Baseline sazonal (dia %d, %02dh): maior desvio %.1f sd em %s (%u janelas no balde)",
+             bucket / SEASONAL_BUCKETS_PER_DAY, bucket % SEASONAL_BUCKETS_PER_DAY, _lastSeasonalScore,
+             ANOMALY_FEATURE_COLUMNS[worst], (unsigned)_seasonal.bucket(bucket).count);
+    // O balde decide sozinho a partir de SEASONAL_Z_THRESHOLD; com o modelo
+    // concordando basta SEASONAL_Z_CONFIRM
+    anomaly = _lastSeasonalScore >= SEASONAL_Z_THRESHOLD ||
+              (modelAnomaly && _lastSeasonalScore >= SEASONAL_Z_CONFIRM);
+    if (anomaly && !modelAnomaly) {
+      ESP_LOGW(TAG, "*** ANOMALIA DE TRÁFEGO PARA ESTE HORÁRIO! %s a %.1f sd do balde (modelo: normal) ***",
+               ANOMALY_FEATURE_COLUMNS[worst], _lastSeasonalScore);
+    } else if (!anomaly && modelAnomaly) {
+      ESP_LOGI(TAG, "Anomalia do modelo descartada: tráfego típico para este horário.");
+    }
+  } else {
+    ESP_LOGI(TAG, "Baseline sazonal: balde (dia %d, %02dh) com %u de %u janelas, só o modelo decide.",
+             bucket / SEASONAL_BUCKETS_PER_DAY, bucket % SEASONAL_BUCKETS_PER_DAY,
+             (unsigned)_seasonal.bucket(bucket).count, (unsigned)SEASONAL_MIN_SAMPLES);
   }
 
-  float recon_packet_count = output->data.f[0];
-  float recon_total_bytes = output->data.f[1];
-  
-  float error = (abs(norm_packet_count - recon_packet_count) + abs(norm_total_bytes - recon_total_bytes)) / 2.0;
+  // Anomalias confirmadas não entram no baseline do horário
+  if (!anomaly) _seasonal.update(bucket, features.values);
+  // Grava o dia no NVS quando a hora vira (no máximo 24 gravações por dia)
+  if (_seasonalBucket >= 0 && bucket != _seasonalBucket) _saveSeasonalDay(_seasonalBucket / SEASONAL_BUCKETS_PER_DAY);
+  _seasonalBucket = bucket;
+  return anomaly;
+}
 
-  ESP_LOGI(TAG, "Análise TinyML - Erro de reconstrução: %.6f (Limite: %.6f)", error, ANOMALY_THRESHOLD);
-  if (error > ANOMALY_THRESHOLD) {
-    ESP_LOGW(TAG, "*** ANOMALIA DE TRÁFEGO DETECTADA! Erro: %.6f ***", error);
-    return true;
+void AnomalyDetector::_loadSeasonal() {
+  _seasonal.reset();
+#ifdef ARDUINO
+  Preferences preferences;
+  preferences.begin(SEASONAL_NAMESPACE, true, NVS_STATE_PARTITION);
+  static SeasonalBaseline::StoredDay day;
+  int restored = 0;
+  for (int d = 0; d < SEASONAL_BUCKETS / SEASONAL_BUCKETS_PER_DAY; d++) {
+    char key[4] = { 'd', (char)('0' + d), '\0' };
+    if (preferences.getBytes(key, &day, sizeof(day)) == sizeof(day) && _seasonal.importDay(d, day)) restored++;
   }
+  preferences.end();
+  ESP_LOGI(TAG, "Baseline sazonal: %d de 7 dias restaurados do NVS.", restored);
+#endif
+}
 
-  return false;
-}
\ No newline at end of file
+void AnomalyDetector::_saveSeasonalDay(int day) {
+#ifdef ARDUINO
+  static SeasonalBaseline::StoredDay stored;
+  _seasonal.exportDay(day, &stored);
+  char key[4] = { 'd', (char)('0' + day), '\0' };
+  Preferences preferences;
+  preferences.begin(SEASONAL_NAMESPACE, false, NVS_STATE_PARTITION);
+  if (preferences.putBytes(key, &stored, sizeof(stored)) != sizeof(stored)) {
+    ESP_LOGW(TAG, "Falha ao gravar o dia %d do baseline sazonal no NVS (partição %s cheia?).", day, NVS_STATE_PARTITION);
+  }
+  preferences.end();
+#else
+  (void)day;
+#endif
+}
@@ -0,0 +1,68 @@
+#include "AnomalyModelBlob.h"
+#include <cmath>
+#include <cstring>
+
+uint32_t anomalyBlobCrc32(const uint8_t* data, size_t length, uint32_t crc) {
+  // CRC-32 refletido (0xEDB88320), bit a bit: roda só ao carregar/gravar o modelo
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+static uint32_t headerCrc(const AnomalyBlobHeader& header) {
+  return anomalyBlobCrc32(reinterpret_cast<const uint8_t*>(&header), offsetof(AnomalyBlobHeader, headerCrc));
+}
+
+void anomalyBlobSealHeader(AnomalyBlobHeader* header) {
+  header->headerCrc = headerCrc(*header);
+}
+
+bool anomalyBlobCheckHeader(const AnomalyBlobHeader& header, const AnomalyBlobExpect& expect, const char** error) {
+  const char* problem = nullptr;
+  if (header.magic != ANOMALY_BLOB_MAGIC) {
+    problem = "não é um modelo (magic inválido)";
+  } else if (header.schemaVersion != ANOMALY_BLOB_SCHEMA_VERSION || header.headerSize != sizeof(AnomalyBlobHeader)) {
+    problem = "versão de schema incompatível";
+  } else if (header.headerCrc != headerCrc(header)) {
+    problem = "CRC do cabeçalho inválido";
+  } else if (header.layoutHash != expect.layoutHash) {
+    problem = "gerado para outras colunas de entrada (layout)";
+  } else if (header.shapeHash != expect.shapeHash || header.inputs != expect.inputs ||
+             header.paramCount != expect.paramCount) {
+    problem = "camadas diferentes das compiladas no firmware";
+  } else if (header.payloadSize != anomalyBlobSize(expect) - sizeof(AnomalyBlobHeader)) {
+    problem = "tamanho do payload inconsistente";
+  } else if (!std::isfinite(header.threshold) || header.threshold <= 0.0f) {
+    problem = "limite inválido";
+  }
+  if (error != nullptr) *error = problem;
+  return problem == nullptr;
+}
+
+bool anomalyBlobParse(const uint8_t* blob, size_t size, const AnomalyBlobExpect& expect, AnomalyModelView* view,
+                      const char** error) {
+  if (size < anomalyBlobSize(expect)) {
+    if (error != nullptr) *error = "blob truncado";
+    return false;
+  }
+  AnomalyBlobHeader header;
+  memcpy(&header, blob, sizeof(header));
+  if (!anomalyBlobCheckHeader(header, expect, error)) return false;
+  const uint8_t* payload = blob + sizeof(header);
+  if (anomalyBlobCrc32(payload, header.payloadSize) != header.payloadCrc) {
+    if (error != nullptr) *error = "CRC do payload inválido";
+    return false;
+  }
+
+  const float* floats = reinterpret_cast<const float*>(payload);
+  view->inputMin = floats;
+  view->inputScale = floats + expect.inputs;
+  view->params = floats + 2 * expect.inputs;
+  view->threshold = header.threshold;
+  view->modelVersion = header.modelVersion;
+  view->sequence = header.sequence;
+  return true;
+}
@@ -0,0 +1,216 @@
+#include "AppClassifier.h"
+#include "AnalyzerStages.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char* TAG = "AppClassifier";
+
+// Posição de cada característica no vetor da floresta
+enum AppFeature {
+  APP_DOWN_KBPS, APP_UP_KBPS, APP_DOWN_PPS, APP_UP_PPS, APP_DOWN_SIZE, APP_UP_SIZE,
+  APP_DOWN_LARGE_PCT, APP_UP_SMALL_PCT, APP_GAP_CV_PCT, APP_ACTIVE_PCT, APP_UP_SHARE_PCT,
+  APP_FEATURE_COUNT
+};
+
+constexpr bool sameName(const char* a, const char* b) {
+  return *a == *b && (*a == '\0' || sameName(a + 1, b + 1));
+}
+
+static_assert(APP_FEATURE_COUNT == APP_FEATURES, "AppClassForest.h tem outro número de características");
+static_assert(sameName(app_forest_features[APP_DOWN_KBPS], "down_kbps") &&
+                  sameName(app_forest_features[APP_DOWN_LARGE_PCT], "down_large_pct") &&
+                  sameName(app_forest_features[APP_GAP_CV_PCT], "gap_cv_pct") &&
+                  sameName(app_forest_features[APP_UP_SHARE_PCT], "up_share_pct"),
+              "Ordem das características diferente de AppClassForest.h; rode train_app_forest.py de novo");
+static_assert(sameName(app_class_names[(int)AppActivity::Video], "video") &&
+                  sameName(app_class_names[(int)AppActivity::Idle], "idle"),
+              "Ordem das classes diferente de AppClassForest.h");
+
+// A tabela tem de dar, para os vetores de referência, a classe que a floresta deu no Python
+constexpr bool forestMatchesReferences() {
+  for (int i = 0; i < app_forest_reference_count; i++) {
+    if (forest::predict<APP_CLASSES>(app_forest_nodes, app_forest_roots, APP_FOREST_TREES,
+                                     app_forest_reference_inputs[i]) != app_forest_reference_labels[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(forestMatchesReferences(), "AppClassForest.h não reproduz os vetores de referência");
+
+static const uint16_t LARGE_FRAME_BYTES = 1000;
+static const uint16_t SMALL_FRAME_BYTES = 200;
+
+static uint16_t saturate(uint64_t value) {
+  return value > UINT16_MAX ? UINT16_MAX : (uint16_t)value;
+}
+
+static void keyToMac(uint64_t key, uint8_t* mac) {
+  for (int i = 0; i < 6; i++) mac[i] = (uint8_t)(key >> (40 - 8 * i));
+}
+
+void AppClassifier::reset() {
+  memset(_stations, 0, sizeof(_stations));
+  _windowStartMs = 0;
+  _lastMs = 0;
+  _cycleStartMs = 0;
+  _windowStarted = false;
+  _cycleStarted = false;
+}
+
+const char* AppClassifier::activityName(AppActivity activity) {
+  return app_class_names[(int)activity];
+}
+
+const char* AppClassifier::activityLabel(AppActivity activity) {
+  static const char* const labels[] = { "streaming de vídeo", "chamada de vídeo", "download", "jogo online", "ociosa" };
+  return labels[(int)activity];
+}
+
+// Estação do quadro (criada se houver espaço), ou nullptr
+AppClassifier::Station* AppClassifier::_station(const uint8_t* mac) {
+  uint64_t key = StatsStage::macToKey(mac);
+  if (key == 0) return nullptr;
+  uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 58) % APP_MAX_STATIONS;
+  for (int probe = 0; probe < APP_MAX_STATIONS; probe++) {
+    Station& station = _stations[(slot + probe) % APP_MAX_STATIONS];
+    if (station.key == key) return &station;
+    if (station.key == 0) {
+      station.key = key;
+      return &station;
+    }
+  }
+  return nullptr;
+}
+
+void AppClassifier::onFrame(const ParsedFrame& frame) {
+  if (!_cycleStarted) {
+    _cycleStarted = true;
+    _cycleStartMs = frame.uptimeMs;
+  }
+  if (!_windowStarted) {
+    _windowStarted = true;
+    _windowStartMs = frame.uptimeMs;
+  }
+  _lastMs = frame.uptimeMs;
+
+  // Subida: a estação é quem transmite; descida: o destino unicast
+  bool uplink = frame.isUplink();
+  const uint8_t* mac;
+  if (uplink) {
+    mac = frame.transmitter;
+  } else if ((frame.fcFlags & (WIFI_FC_TO_DS | WIFI_FC_FROM_DS)) == WIFI_FC_FROM_DS && !(frame.dstMac[0] & 0x01)) {
+    mac = frame.dstMac;
+  } else {
+    return;
+  }
+  Station* station = _station(mac);
+  if (station == nullptr) return;
+
+  Window& w = station->window;
+  uint32_t second = (frame.uptimeMs - _windowStartMs) / 1000;
+  w.activeSeconds |= 1u << std::min<uint32_t>(second, 31);
+
+  if (uplink) {
+    w.txBytes += frame.length;
+    w.txPackets++;
+    if (frame.length < SMALL_FRAME_BYTES) w.txSmall++;
+    return;
+  }
+  w.rxBytes += frame.length;
+  w.rxPackets++;
+  if (frame.length >= LARGE_FRAME_BYTES) w.rxLarge++;
+  if (w.lastRxUs != 0) {
+    float gapMs = (uint32_t)(frame.timestampUs - w.lastRxUs) / 1000.0f;
+    if (gapMs < APP_MAX_GAP_MS) {
+      w.gaps++;
+      float delta = gapMs - w.gapMean;
+      w.gapMean += delta / w.gaps;
+      w.gapM2 += delta * (gapMs - w.gapMean);
+    }
+  }
+  w.lastRxUs = frame.timestampUs | 1;  // 0 fica reservado para "nenhum quadro"
+}
+
+void AppClassifier::_features(const Window& w, uint32_t windowMs, uint16_t* out) const {
+  uint32_t windowSeconds = std::min<uint32_t>((windowMs + 999) / 1000, 32);
+  uint64_t bytes = (uint64_t)w.rxBytes + w.txBytes;
+  out[APP_DOWN_KBPS] = saturate((uint64_t)w.rxBytes * 8 / windowMs);
+  out[APP_UP_KBPS] = saturate((uint64_t)w.txBytes * 8 / windowMs);
+  out[APP_DOWN_PPS] = saturate((uint64_t)w.rxPackets * 1000 / windowMs);
+  out[APP_UP_PPS] = saturate((uint64_t)w.txPackets * 1000 / windowMs);
+  out[APP_DOWN_SIZE] = w.rxPackets ? saturate(w.rxBytes / w.rxPackets) : 0;
+  out[APP_UP_SIZE] = w.txPackets ? saturate(w.txBytes / w.txPackets) : 0;
+  out[APP_DOWN_LARGE_PCT] = w.rxPackets ? (uint16_t)(100 * (uint64_t)w.rxLarge / w.rxPackets) : 0;
+  out[APP_UP_SMALL_PCT] = w.txPackets ? (uint16_t)(100 * (uint64_t)w.txSmall / w.txPackets) : 0;
+  float cv = 0.0f;
+  if (w.gaps > 1 && w.gapMean > 0.0f) cv = sqrtf(w.gapM2 / (w.gaps - 1)) / w.gapMean;
+  out[APP_GAP_CV_PCT] = saturate((uint64_t)lroundf(cv * 100.0f));
+  out[APP_ACTIVE_PCT] = (uint16_t)std::min<uint32_t>(100 * __builtin_popcount(w.activeSeconds) / windowSeconds, 100);
+  out[APP_UP_SHARE_PCT] = bytes ? (uint16_t)(100 * (uint64_t)w.txBytes / bytes) : 0;
+}
+
+void AppClassifier::_classifyWindow() {
+  uint32_t windowMs = std::max<uint32_t>(_lastMs - _windowStartMs, 1000);
+  for (Station& s : _stations) {
+    Window& w = s.window;
+    if (s.key == 0 || w.rxPackets + w.txPackets == 0) continue;
+    uint16_t x[APP_FEATURES];
+    uint8_t votes[APP_CLASSES];
+    _features(w, windowMs, x);
+    int label = forest::predict<APP_CLASSES>(app_forest_nodes, app_forest_roots, APP_FOREST_TREES, x, votes);
+    s.classBytes[label] += w.rxBytes + w.txBytes;
+    s.cycleRxBytes += w.rxBytes;
+    s.cycleTxBytes += w.txBytes;
+    s.votes = votes[label];
+    if (s.windows < UINT8_MAX) s.windows++;
+    if (label != (int)AppActivity::Idle) {
+      ESP_LOGD(TAG, "%012llx: %s (%u/%u votos), %u kbit/s de descida", (unsigned long long)s.key,
+               app_class_names[label], votes[label], APP_FOREST_TREES, x[APP_DOWN_KBPS]);
+    }
+    memset(&w, 0, sizeof(w));
+  }
+  _windowStarted = false;
+}
+
+void AppClassifier::onWindowEnd() {
+  if (_windowStarted) _classifyWindow();
+}
+
+void AppClassifier::endCycle() {
+  if (_windowStarted && _lastMs - _windowStartMs >= APP_MIN_WINDOW_MS) _classifyWindow();
+  _windowStarted = false;
+}
+
+size_t AppClassifier::summarize(StationActivity* out, size_t maxOut) const {
+  uint32_t cycleMs = std::max<uint32_t>(_lastMs - _cycleStartMs, 1000);
+  size_t count = 0;
+  for (const Station& s : _stations) {
+    if (s.key == 0 || s.windows == 0) continue;
+    uint64_t total = (uint64_t)s.cycleRxBytes + s.cycleTxBytes;
+    int best = (int)AppActivity::Idle;
+    for (int k = 0; k < APP_CLASSES; k++) {
+      if (s.classBytes[k] > s.classBytes[best]) best = k;
+    }
+    StationActivity entry;
+    keyToMac(s.key, entry.mac);
+    entry.activity = (AppActivity)best;
+    entry.share = total ? (uint8_t)(100 * (uint64_t)s.classBytes[best] / total) : 100;
+    entry.votes = s.votes;
+    entry.windows = s.windows;
+    entry.downKbps = (uint32_t)((uint64_t)s.cycleRxBytes * 8 / cycleMs);
+    entry.upKbps = (uint32_t)((uint64_t)s.cycleTxBytes * 8 / cycleMs);
+
+    // Inserção ordenada pelo tráfego; com a saída cheia, só entra quem trafegou mais
+    size_t pos = count;
+    while (pos > 0 && out[pos - 1].downKbps + out[pos - 1].upKbps < entry.downKbps + entry.upKbps) pos--;
+    if (pos >= maxOut) continue;
+    size_t last = std::min(count, maxOut - 1);
+    for (size_t i = last; i > pos; i--) out[i] = out[i - 1];
+    out[pos] = entry;
+    if (count < maxOut) count++;
+  }
+  return count;
+}
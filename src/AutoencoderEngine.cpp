@@ -0,0 +1,475 @@
+#include "AutoencoderEngine.h"
+#include "esp_log.h"
+
+#include "esp_timer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+// Engine padrão: o autoencoder compilado (TinyMlp + AnomalyModelWeights.h), sem
+// interpretador nem tensor_arena. Com -DANOMALY_MODEL_INT8 o mesmo MLP roda
+// quantizado (AnomalyModelInt8.h, kernels ESP-NN no ESP32-S3). Com
+// -DANOMALY_ENGINE_TFLM volta ao TFLite Micro, só com o modelo float32.
+#if defined(ANOMALY_MODEL_INT8) && defined(ANOMALY_ENGINE_TFLM)
+#error "O modelo int8 roda na engine compilada: não combine -DANOMALY_MODEL_INT8 com -DANOMALY_ENGINE_TFLM"
+#endif
+
+#ifdef ANOMALY_ENGINE_TFLM
+// --- INÍCIO DAS CORREÇÕES ---
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/system_setup.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+// Adiciona o header para o reportador de erros
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+// --- FIM DAS CORREÇÕES ---
+
+// Inclui o modelo que foi gerado pelo Python
+#include "AnomalyModel.h"
+#define ANOMALY_MODEL_DATA anomaly_model_tflite
+#endif
+
+// Pesos, normalização, limite e colunas de entrada, gerados por
+// scripts/TinyML_Module_9/generate_mlp_header.py (o caminho TFLM usa o mesmo
+// modelo, então também tira daqui a normalização e o número de entradas)
+#include "AnomalyModelWeights.h"
+
+static constexpr int kModelInputs = AnomalyMlp::inputs;
+static_assert(kModelInputs <= ANOMALY_FEATURE_COUNT, "o modelo tem mais entradas que o layout de características");
+static_assert(anomaly_mlp_layout_hash == anomalyFeatureLayoutHash(kModelInputs),
+              "AnomalyModelWeights.h foi gerado com outro layout: rode generate_mlp_header.py novamente");
+
+#ifdef ANOMALY_MODEL_INT8
+#include "AnomalyModelInt8.h"
+static_assert(anomaly_mlp_int8_layout_hash == anomaly_mlp_layout_hash &&
+              anomaly_mlp_int8_shape_hash == AnomalyMlp::shapeHash() &&
+              sizeof(anomaly_mlp_int8_layers) / sizeof(anomaly_mlp_int8_layers[0]) == AnomalyMlp::layerCount,
+              "AnomalyModelInt8.h é de outro modelo: rode quantize_mlp_header.py novamente");
+#endif
+
+static const char* TAG = "AutoencoderEngine";
+
+// Frequência de gravação da calibração online no NVS
+static const uint32_t CAL_SAVE_EVERY_WINDOWS = 15;
+#ifdef ARDUINO
+#include <Preferences.h>
+#include "NvsState.h"
+static const char* CAL_NAMESPACE = "anomaly-cal";
+static const char* CAL_KEY = "state";
+#endif
+
+// São os atributos min_ e scale_ do MinMaxScaler do treino: o valor normalizado
+// é x * scale + min (min já vem dividido pela amplitude e negado). Ficam em
+// membros porque um modelo da partição (useModel) troca os dois.
+#ifdef ANOMALY_MODEL_INT8
+static const float ANOMALY_THRESHOLD = anomaly_model_int8_threshold;
+#else
+static const float ANOMALY_THRESHOLD = anomaly_mlp_threshold;
+#endif
+
+#ifdef ANOMALY_ENGINE_TFLM
+// --- Configuração do TensorFlow Lite ---
+const tflite::Model* model = nullptr;
+tflite::MicroInterpreter* interpreter = nullptr;
+TfLiteTensor* input = nullptr;
+TfLiteTensor* output = nullptr;
+// A tensor_arena é a arena do InferenceRuntime; aqui fica só o tamanho pedido
+constexpr int kTensorArenaSize = 5 * 1024;
+static tflite::MicroMutableOpResolver<4> op_resolver;
+// O interpretador é recriado nesta memória sempre que outro modelo usou a arena
+alignas(tflite::MicroInterpreter) static uint8_t interpreter_storage[sizeof(tflite::MicroInterpreter)];
+
+// --- CORREÇÃO: Cria um 'ErrorReporter' para o TensorFlow Lite ---
+tflite::ErrorReporter* error_reporter = nullptr;
+tflite::MicroErrorReporter micro_error_reporter;
+// ------------------------------------------------------------
+#endif
+
+AutoencoderEngine::AutoencoderEngine()
+    : _params(anomaly_mlp_params), _inputMin(anomaly_mlp_input_min), _inputScale(anomaly_mlp_input_scale),
+      _modelThreshold(ANOMALY_THRESHOLD) {}
+
+AnomalyBlobExpect AutoencoderEngine::blobExpect() {
+  return { anomaly_mlp_layout_hash, AnomalyMlp::shapeHash(), AnomalyMlp::inputs, (uint32_t)AnomalyMlp::paramCount };
+}
+
+void AutoencoderEngine::useModel(const AnomalyModelView& view) {
+#ifdef ANOMALY_ENGINE_TFLM
+  // O blob traz pesos do MLP compilado; o interpretador continua com o flatbuffer do firmware
+  (void)view;
+  ESP_LOGW(TAG, "Modelo da partição ignorado: com -DANOMALY_ENGINE_TFLM os pesos vêm de AnomalyModel.h.");
+#elif defined(ANOMALY_MODEL_INT8)
+  // O blob traz pesos float32; o modelo int8 só muda regravando o firmware
+  (void)view;
+  ESP_LOGW(TAG, "Modelo da partição ignorado: com -DANOMALY_MODEL_INT8 os pesos vêm de AnomalyModelInt8.h.");
+#else
+  _params = view.params;
+  _inputMin = view.inputMin;
+  _inputScale = view.inputScale;
+  _modelThreshold = view.threshold;
+  _modelVersion = view.modelVersion;
+  // O erro de reconstrução muda de escala com o modelo: as estatísticas aprendidas não valem mais
+  for (DeviceBaseline& device : _devices) device.key = 0;
+  if (_online) {
+    _calibrator.reset();
+    _saveCalibration();
+  }
+  ESP_LOGI(TAG, "Usando o modelo versão %u da flash (limite %.6f)%s.", (unsigned)_modelVersion, _modelThreshold,
+           _online ? "; calibração online reiniciada" : "");
+#endif
+}
+
+#ifdef ANOMALY_ENGINE_TFLM
+bool AutoencoderEngine::begin() {
+  if (_initialized) return true;
+  // --- CORREÇÃO: Inicializa o error_reporter ---
+  error_reporter = &micro_error_reporter;
+  // -------------------------------------------
+
+  model = tflite::GetModel(ANOMALY_MODEL_DATA);
+  if (model->version() != TFLITE_SCHEMA_VERSION) {
+    ESP_LOGE(TAG, "Erro: Versão do modelo incompatível!");
+    return false;
+  }
+
+  op_resolver.AddFullyConnected();
+  op_resolver.AddRelu();
+  op_resolver.AddLogistic(); // --- CORREÇÃO: AddSigmoid foi substituído por AddLogistic ---
+  op_resolver.AddReshape();
+
+  // O interpretador só é criado em prepare(), quando o InferenceRuntime entrega a arena
+  if (!inferenceRuntime.registerModel(this)) return false;
+
+  _initialized = true;
+  ESP_LOGI(TAG, "Módulo de Detecção de Anomalias com TinyML inicializado (TFLM, arena de %d bytes no InferenceRuntime).",
+           kTensorArenaSize);
+  return true;
+}
+
+size_t AutoencoderEngine::arenaBytes() const {
+  return kTensorArenaSize;
+}
+
+// Recria o interpretador sobre a arena compartilhada: outro modelo pode ter
+// sobrescrito os tensores desde a última invocação
+bool AutoencoderEngine::prepare(uint8_t* arena, size_t size) {
+  if (interpreter) interpreter->~MicroInterpreter();
+  // --- CORREÇÃO: Adicionado o error_reporter como último parâmetro ---
+  interpreter = new (interpreter_storage) tflite::MicroInterpreter(model, op_resolver, arena, size, error_reporter);
+  // --------------------------------------------------------------------
+
+  if (interpreter->AllocateTensors() != kTfLiteOk) {
+    ESP_LOGE(TAG, "Falha ao alocar tensores!");
+    interpreter->~MicroInterpreter();
+    interpreter = nullptr;
+    return false;
+  }
+
+  input = interpreter->input(0);
+  output = interpreter->output(0);
+  ESP_LOGD(TAG, "Interpretador preparado (%s, arena usada: %u de %u bytes).",
+           (input->type == kTfLiteInt8) ? "int8" : "float32", (unsigned)interpreter->arena_used_bytes(), (unsigned)size);
+  return true;
+}
+
+size_t AutoencoderEngine::arenaUsedBytes() const {
+  return interpreter ? interpreter->arena_used_bytes() : 0;
+}
+
+// Roda o modelo no interpretador, quantizando/dequantizando se ele for int8. O
+// modelo do TFLM tem lote fixo em 1 (o MicroInterpreter não redimensiona
+// entradas), então o lote vira uma sequência de Invoke(). Esta versão da
+// biblioteca não aceita profiler no interpretador: o Invoke é medido inteiro.
+bool AutoencoderEngine::invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) {
+  (void)arena;
+  for (int b = 0; b < n; b++, in += kModelInputs, out += kModelInputs) {
+    for (int i = 0; i < kModelInputs; i++) {
+      if (input->type == kTfLiteInt8) {
+        int32_t q = (int32_t)lroundf(in[i] / input->params.scale) + input->params.zero_point;
+        if (q < -128) q = -128;
+        if (q > 127) q = 127;
+        input->data.int8[i] = (int8_t)q;
+      } else {
+        input->data.f[i] = in[i];
+      }
+    }
+
+    uint32_t event = profiler.BeginEvent("INVOKE");
+    TfLiteStatus status = interpreter->Invoke();
+    profiler.EndEvent(event);
+    if (status != kTfLiteOk) {
+      ESP_LOGE(TAG, "Falha na invocação do interpretador");
+      return false;
+    }
+
+    for (int i = 0; i < kModelInputs; i++) {
+      if (output->type == kTfLiteInt8) {
+        out[i] = (output->data.int8[i] - output->params.zero_point) * output->params.scale;
+      } else {
+        out[i] = output->data.f[i];
+      }
+    }
+  }
+  return true;
+}
+#elif defined(ANOMALY_MODEL_INT8)
+bool AutoencoderEngine::begin() {
+  if (!inferenceRuntime.registerModel(this)) return false;
+  _initialized = true;
+  ESP_LOGI(TAG, "Módulo de Detecção de Anomalias com TinyML inicializado (MLP int8, %u bytes em flash, rascunho de %u bytes no InferenceRuntime).",
+           (unsigned)anomaly_mlp_int8_flash_bytes, (unsigned)arenaBytes());
+  return true;
+}
+
+// Entrada e saída quantizadas do lote e os dois buffers de rascunho, em int8
+size_t AutoencoderEngine::arenaBytes() const {
+  return ANOMALY_BATCH_SIZE * (AnomalyMlp::inputs + AnomalyMlp::outputs + 2 * AnomalyMlp::hiddenWidth);
+}
+
+bool AutoencoderEngine::prepare(uint8_t* arena, size_t size) {
+  (void)arena;
+  return size >= arenaBytes();
+}
+
+size_t AutoencoderEngine::arenaUsedBytes() const {
+  return arenaBytes();
+}
+
+bool AutoencoderEngine::invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) {
+  if (n > ANOMALY_BATCH_SIZE) return false;
+  int8_t* qIn = reinterpret_cast<int8_t*>(arena);
+  int8_t* qOut = qIn + ANOMALY_BATCH_SIZE * AnomalyMlp::inputs;
+  int8_t* scratchA = qOut + ANOMALY_BATCH_SIZE * AnomalyMlp::outputs;
+  int8_t* scratchB = scratchA + ANOMALY_BATCH_SIZE * AnomalyMlp::hiddenWidth;
+  for (int i = 0; i < n * AnomalyMlp::inputs; i++) {
+    int32_t q = (int32_t)lroundf(in[i] / anomaly_mlp_int8_input_scale) + anomaly_mlp_int8_input_zero_point;
+    qIn[i] = (int8_t)std::min<int32_t>(127, std::max<int32_t>(-128, q));
+  }
+  AnomalyMlp::forwardBatchInt8(anomaly_mlp_int8_layers, qIn, qOut, n, scratchA, scratchB, profiler);
+  for (int i = 0; i < n * AnomalyMlp::outputs; i++) {
+    out[i] = (qOut[i] - anomaly_mlp_int8_output_zero_point) * anomaly_mlp_int8_output_scale;
+  }
+  return true;
+}
+#else
+bool AutoencoderEngine::begin() {
+  if (!inferenceRuntime.registerModel(this)) return false;
+  _initialized = true;
+  ESP_LOGI(TAG, "Módulo de Detecção de Anomalias com TinyML inicializado (MLP compilado, %d parâmetros, %u bytes em flash, rascunho de %u bytes no InferenceRuntime).",
+           AnomalyMlp::paramCount, (unsigned)sizeof(anomaly_mlp_params), (unsigned)arenaBytes());
+  return true;
+}
+
+// Os dois buffers de rascunho do lote
+size_t AutoencoderEngine::arenaBytes() const {
+  return 2 * sizeof(float) * ANOMALY_BATCH_SIZE * AnomalyMlp::hiddenWidth;
+}
+
+bool AutoencoderEngine::prepare(uint8_t* arena, size_t size) {
+  (void)arena;
+  return size >= arenaBytes();
+}
+
+size_t AutoencoderEngine::arenaUsedBytes() const {
+  return arenaBytes();
+}
+
+bool AutoencoderEngine::invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) {
+  if (n > ANOMALY_BATCH_SIZE) return false;
+  float* scratchA = reinterpret_cast<float*>(arena);
+  float* scratchB = scratchA + ANOMALY_BATCH_SIZE * AnomalyMlp::hiddenWidth;
+  AnomalyMlp::forwardBatch(_params, in, out, n, scratchA, scratchB, profiler);
+  return true;
+}
+#endif
+
+bool AutoencoderEngine::_infer(const float* in, float* out) {
+  return inferenceRuntime.run(this, in, out, 1);
+}
+
+bool AutoencoderEngine::_inferBatch(const float* in, float* out, int n) {
+  return inferenceRuntime.run(this, in, out, n);
+}
+
+bool AutoencoderEngine::evaluate(const FeatureVector& features, AnomalyScore* result) {
+  if (!_initialized) return false;
+  return _online ? _evaluateOnline(features, result) : _evaluateStatic(features, result);
+}
+
+bool AutoencoderEngine::_evaluateStatic(const FeatureVector& features, AnomalyScore* result) {
+  // O modelo usa as primeiras kModelInputs características do layout
+  float in[kModelInputs];
+  for (int i = 0; i < kModelInputs; i++) in[i] = features[i] * _inputScale[i] + _inputMin[i];
+
+  float error;
+  if (!_score(in, &error)) return false;
+
+  ESP_LOGI(TAG, "Análise TinyML - Erro de reconstrução: %.6f (Limite: %.6f)", error, _modelThreshold);
+  result->score = error;
+  result->threshold = _modelThreshold;
+  result->warm = true;
+  result->anomalous = error > _modelThreshold;
+  return true;
+}
+
+// Roda o autoencoder sobre a entrada normalizada e devolve o erro médio absoluto
+bool AutoencoderEngine::_score(const float* in, float* error) {
+  float out[kModelInputs];
+  int64_t start = esp_timer_get_time();
+  if (!_infer(in, out)) return false;
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+  _invocations++;
+  _totalInvokeUs += elapsed;
+  if (elapsed > _maxInvokeUs) _maxInvokeUs = elapsed;
+  ESP_LOGI(TAG, "Invoke: %u us (média %u us, máx %u us em %u execuções)",
+           elapsed, (unsigned)(_totalInvokeUs / _invocations), _maxInvokeUs, _invocations);
+
+  float sum = 0.0f;
+  for (int i = 0; i < kModelInputs; i++) sum += fabsf(in[i] - out[i]);
+  *error = sum / kModelInputs;
+  return true;
+}
+
+float AutoencoderEngine::threshold() const {
+  if (_online && _calibrator.isWarm()) return _calibrator.threshold();
+  return _modelThreshold;
+}
+
+void AutoencoderEngine::setOnlineCalibration(bool enabled) {
+  _online = enabled;
+  if (enabled) _loadCalibration();
+}
+
+bool AutoencoderEngine::_evaluateOnline(const FeatureVector& features, AnomalyScore* result) {
+  float normalized[ONLINE_CAL_FEATURES];
+  _calibrator.normalize(features.values, normalized);
+  float error;
+  if (!_score(normalized, &error)) return false;
+
+  bool wasWarm = _calibrator.isWarm();
+  bool anomaly = wasWarm && error > _calibrator.threshold();
+  result->score = error;
+  result->threshold = _calibrator.threshold();
+  result->warm = wasWarm;
+  result->anomalous = anomaly;
+  if (wasWarm) {
+    ESP_LOGI(TAG, "Análise TinyML (online) - Erro: %.6f (Limite: %.6f, erro típico %.6f)",
+             error, _calibrator.threshold(), _calibrator.typicalError());
+  }
+  _calibrator.update(features.values, error, anomaly);
+
+  if (!wasWarm) {
+    ESP_LOGI(TAG, "Calibração online: janela %u de %u (erro %.6f), sem alertas até o fim do aquecimento.",
+             (unsigned)_calibrator.windows(), (unsigned)ONLINE_CAL_WARMUP_WINDOWS, error);
+  }
+  if ((_calibrator.isWarm() && !wasWarm) || _calibrator.windows() % CAL_SAVE_EVERY_WINDOWS == 0) {
+    _saveCalibration();
+  }
+  return true;
+}
+
+void AutoencoderEngine::_loadCalibration() {
+#ifdef ARDUINO
+  Preferences preferences;
+  preferences.begin(CAL_NAMESPACE, true, NVS_STATE_PARTITION);
+  OnlineCalibrator::State state;
+  size_t length = preferences.getBytes(CAL_KEY, &state, sizeof(state));
+  preferences.end();
+  if (length == sizeof(state) && _calibrator.restore(state)) {
+    ESP_LOGI(TAG, "Calibração online restaurada do NVS (%u janelas, limite %.6f).",
+             (unsigned)_calibrator.windows(), _calibrator.threshold());
+    return;
+  }
+#endif
+  _calibrator.reset();
+  ESP_LOGI(TAG, "Calibração online iniciada do zero (aquecimento de %u janelas).", (unsigned)ONLINE_CAL_WARMUP_WINDOWS);
+}
+
+void AutoencoderEngine::_saveCalibration() {
+#ifdef ARDUINO
+  Preferences preferences;
+  preferences.begin(CAL_NAMESPACE, false, NVS_STATE_PARTITION);
+  if (preferences.putBytes(CAL_KEY, &_calibrator.state(), sizeof(OnlineCalibrator::State)) != sizeof(OnlineCalibrator::State)) {
+    ESP_LOGW(TAG, "Falha ao gravar a calibração online no NVS (partição %s cheia?).", NVS_STATE_PARTITION);
+  }
+  preferences.end();
+#endif
+}
+
+// Baseline do dispositivo; se a tabela lotar, recicla o visto há mais tempo
+AutoencoderEngine::DeviceBaseline& AutoencoderEngine::_deviceBaseline(const uint8_t* mac) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+
+  DeviceBaseline* oldest = &_devices[0];
+  for (DeviceBaseline& device : _devices) {
+    if (device.key == key) return device;
+    if (device.key == 0) {
+      oldest = &device;
+      break;
+    }
+    if (device.lastCycle < oldest->lastCycle) oldest = &device;
+  }
+  oldest->key = key;
+  oldest->calibrator.reset();
+  return *oldest;
+}
+
+size_t AutoencoderEngine::scoreDevices(const DeviceFeatures* devices, size_t count, DeviceScore* top, size_t maxTop) {
+  if (!_initialized || count == 0) return 0;
+  _deviceCycle++;
+
+  static DeviceScore scores[ANOMALY_MAX_DEVICES];
+  if (count > ANOMALY_MAX_DEVICES) count = ANOMALY_MAX_DEVICES;
+  size_t anomalies = 0;
+  int64_t start = esp_timer_get_time();
+
+  for (size_t first = 0; first < count; first += ANOMALY_BATCH_SIZE) {
+    int n = (int)std::min((size_t)ANOMALY_BATCH_SIZE, count - first);
+    float in[ANOMALY_BATCH_SIZE][ONLINE_CAL_FEATURES];
+    float out[ANOMALY_BATCH_SIZE][kModelInputs];
+    float batch[ANOMALY_BATCH_SIZE][kModelInputs];
+    DeviceBaseline* baselines[ANOMALY_BATCH_SIZE];
+
+    for (int b = 0; b < n; b++) {
+      baselines[b] = &_deviceBaseline(devices[first + b].mac);
+      baselines[b]->lastCycle = _deviceCycle;
+      baselines[b]->calibrator.normalize(devices[first + b].features.values, in[b]);
+      memcpy(batch[b], in[b], sizeof(batch[b]));
+    }
+    if (!_inferBatch(&batch[0][0], &out[0][0], n)) return 0;
+
+    for (int b = 0; b < n; b++) {
+      float sum = 0.0f;
+      for (int i = 0; i < kModelInputs; i++) sum += fabsf(batch[b][i] - out[b][i]);
+      DeviceScore& score = scores[first + b];
+      OnlineCalibrator& calibrator = baselines[b]->calibrator;
+      memcpy(score.mac, devices[first + b].mac, 6);
+      score.error = sum / kModelInputs;
+      score.warm = calibrator.isWarm();
+      score.threshold = score.warm ? calibrator.threshold() : 0.0f;
+      score.anomalous = score.warm && score.error > score.threshold;
+      if (score.anomalous) anomalies++;
+      calibrator.update(devices[first + b].features.values, score.error, score.anomalous);
+    }
+  }
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+  // Ranking pelo quanto cada dispositivo passou do próprio limite; os ainda
+  // em aquecimento ficam no fim
+  auto excess = [](const DeviceScore& s) { return s.warm ? s.error / (s.threshold + ONLINE_CAL_LOG_EPSILON) : -1.0f; };
+  size_t ranked = std::min(count, maxTop);
+  std::partial_sort(scores, scores + ranked, scores + count,
+                    [&](const DeviceScore& a, const DeviceScore& b) { return excess(a) > excess(b); });
+  memcpy(top, scores, ranked * sizeof(DeviceScore));
+
+  ESP_LOGI(TAG, "Pontuação por dispositivo: %u dispositivos em %u us (%u anômalos).",
+           (unsigned)count, elapsed, (unsigned)anomalies);
+  for (size_t i = 0; i < ranked && top[i].anomalous; i++) {
+    ESP_LOGW(TAG, "*** Dispositivo %02X:%02X:%02X:%02X:%02X:%02X anômalo: erro %.6f (limite %.6f) ***",
+             top[i].mac[0], top[i].mac[1], top[i].mac[2], top[i].mac[3], top[i].mac[4], top[i].mac[5],
+             top[i].error, top[i].threshold);
+  }
+  return ranked;
+}
@@ -0,0 +1,490 @@
+#include "DeviceFingerprint.h"
+#include "AnalyzerStages.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Preferences.h>
+#include "NvsState.h"
+#include "freertos/semphr.h"
+static const char* FP_NAMESPACE = "fingerprints";
+static const char* FP_KEY = "table";
+#endif
+
+static const char* TAG = "DeviceFingerprint";
+
+// Posição de cada característica no vetor do modelo
+enum FingerprintFeature {
+  FP_SIZE_96, FP_SIZE_160, FP_SIZE_320, FP_SIZE_640, FP_SIZE_1200, FP_SIZE_MAX,
+  FP_BURSTINESS, FP_RATE, FP_UPLINK_SHARE,
+  FP_DNS_APPLE, FP_DNS_GOOGLE, FP_DNS_MICROSOFT, FP_DNS_STREAMING, FP_DNS_CAMERA, FP_DNS_IOT,
+  FP_DNS_DIVERSITY,
+  FP_VENDOR_MOBILE, FP_VENDOR_PC, FP_VENDOR_TV, FP_VENDOR_CAMERA, FP_VENDOR_IOT, FP_RANDOM_MAC,
+  FP_ACTIVE_HOURS, FP_NIGHT,
+  FP_FEATURE_COUNT
+};
+
+constexpr bool sameName(const char* a, const char* b) {
+  return *a == *b && (*a == '\0' || sameName(a + 1, b + 1));
+}
+static_assert(FP_FEATURE_COUNT == FINGERPRINT_FEATURES && sameName(device_class_features[FP_SIZE_96], "size_96") &&
+                  sameName(device_class_features[FP_BURSTINESS], "burstiness") &&
+                  sameName(device_class_features[FP_DNS_APPLE], "dns_apple") &&
+                  sameName(device_class_features[FP_VENDOR_MOBILE], "vendor_mobile") &&
+                  sameName(device_class_features[FP_NIGHT], "night"),
+              "DeviceClassModelWeights.h foi gerado com outra lista de características");
+static_assert(FINGERPRINT_CLASSES == (int)DeviceType::Unknown && sameName(device_class_names[(int)DeviceType::Tv], "tv") &&
+                  sameName(device_class_names[(int)DeviceType::Iot], "iot"),
+              "DeviceType não segue a ordem das classes do modelo");
+
+// Limite superior de cada faixa do histograma (bytes no ar); a última é o resto
+static const uint16_t SIZE_BIN_LIMITS[FINGERPRINT_SIZE_BINS - 1] = { 96, 160, 320, 640, 1200 };
+
+// Intervalos maiores que isto não são rajada, são o aparelho parado
+static const float MAX_GAP_MS = 60000.0f;
+
+// Categorias de domínio: basta o nome consultado conter o trecho
+static const struct {
+  const char* fragment;
+  uint8_t category;  // Bit em Accumulator::dnsCategories (= FP_DNS_* - FP_DNS_APPLE)
+} DNS_CATEGORIES[] = {
+  { "apple.com", 0 }, { "icloud", 0 }, { "mzstatic", 0 }, { "apple-dns", 0 },
+  { "android", 1 }, { "googleapis", 1 }, { "gstatic", 1 }, { "play.google", 1 },
+  { "windowsupdate", 2 }, { "microsoft", 2 }, { "msftconnecttest", 2 }, { "msedge", 2 }, { "live.com", 2 },
+  { "netflix", 3 }, { "nflx", 3 }, { "youtube", 3 }, { "googlevideo", 3 }, { "roku", 3 }, { "primevideo", 3 },
+  { "disney", 3 }, { "globoplay", 3 }, { "samsungcloudsolution", 3 }, { "lgtvsdp", 3 }, { "tizen", 3 },
+  { "hik-connect", 4 }, { "ezviz", 4 }, { "dahua", 4 }, { "imou", 4 }, { "wyze", 4 }, { "arlo", 4 },
+  { "tuya", 5 }, { "smartlife", 5 }, { "ewelink", 5 }, { "coolkit", 5 }, { "shelly", 5 }, { "espressif", 5 },
+  { "tplinkcloud", 5 }, { "iot.mi.com", 5 },
+};
+
+// OUIs conhecidos. Tabela curta, com os fabricantes que mais ajudam a separar
+// os tipos; amplie com os aparelhos da sua rede.
+static const struct {
+  uint8_t oui[3];
+  OuiVendor vendor;
+  const char* maker;
+} OUI_TABLE[] = {
+  { { 0xF0, 0x18, 0x98 }, OuiVendor::Mobile, "Apple" },
+  { { 0xAC, 0xBC, 0x32 }, OuiVendor::Mobile, "Apple" },
+  { { 0x3C, 0x22, 0xFB }, OuiVendor::Mobile, "Apple" },
+  { { 0x28, 0xCF, 0xE9 }, OuiVendor::Mobile, "Apple" },
+  { { 0xA4, 0x5E, 0x60 }, OuiVendor::Mobile, "Apple" },
+  { { 0x3C, 0xA9, 0xF4 }, OuiVendor::Pc, "Intel" },
+  { { 0xA4, 0x4E, 0x31 }, OuiVendor::Pc, "Intel" },
+  { { 0x5C, 0x51, 0x4F }, OuiVendor::Pc, "Intel" },
+  { { 0x8C, 0x70, 0x5A }, OuiVendor::Pc, "Intel" },
+  { { 0xF8, 0x16, 0x54 }, OuiVendor::Pc, "Intel" },
+  { { 0xB0, 0xA7, 0x37 }, OuiVendor::Tv, "Roku" },
+  { { 0xD8, 0x31, 0x34 }, OuiVendor::Tv, "Roku" },
+  { { 0xCC, 0x6D, 0xA0 }, OuiVendor::Tv, "Roku" },
+  { { 0xAC, 0x3A, 0x7A }, OuiVendor::Tv, "Roku" },
+  { { 0x44, 0x19, 0xB6 }, OuiVendor::Camera, "Hikvision" },
+  { { 0xC0, 0x56, 0xE3 }, OuiVendor::Camera, "Hikvision" },
+  { { 0xBC, 0xAD, 0x28 }, OuiVendor::Camera, "Hikvision" },
+  { { 0x28, 0x57, 0xBE }, OuiVendor::Camera, "Hikvision" },
+  { { 0x4C, 0xBD, 0x8F }, OuiVendor::Camera, "Hikvision" },
+  { { 0x3C, 0xEF, 0x8C }, OuiVendor::Camera, "Dahua" },
+  { { 0x90, 0x02, 0xA9 }, OuiVendor::Camera, "Dahua" },
+  { { 0xE0, 0x50, 0x8B }, OuiVendor::Camera, "Dahua" },
+  { { 0x2C, 0xAA, 0x8E }, OuiVendor::Camera, "Wyze" },
+  { { 0x24, 0x0A, 0xC4 }, OuiVendor::Iot, "Espressif" },
+  { { 0x30, 0xAE, 0xA4 }, OuiVendor::Iot, "Espressif" },
+  { { 0x24, 0x6F, 0x28 }, OuiVendor::Iot, "Espressif" },
+  { { 0xA4, 0xCF, 0x12 }, OuiVendor::Iot, "Espressif" },
+  { { 0x84, 0xF3, 0xEB }, OuiVendor::Iot, "Espressif" },
+  { { 0x5C, 0xCF, 0x7F }, OuiVendor::Iot, "Espressif" },
+  { { 0x18, 0xFE, 0x34 }, OuiVendor::Iot, "Espressif" },
+  { { 0x3C, 0x71, 0xBF }, OuiVendor::Iot, "Espressif" },
+  { { 0xCC, 0x50, 0xE3 }, OuiVendor::Iot, "Espressif" },
+  { { 0x7C, 0x9E, 0xBD }, OuiVendor::Iot, "Espressif" },
+  { { 0xBC, 0xDD, 0xC2 }, OuiVendor::Iot, "Espressif" },
+  { { 0xEC, 0xFA, 0xBC }, OuiVendor::Iot, "Espressif" },
+  { { 0xB8, 0x27, 0xEB }, OuiVendor::Iot, "Raspberry Pi" },
+  { { 0xDC, 0xA6, 0x32 }, OuiVendor::Iot, "Raspberry Pi" },
+  { { 0xE4, 0x5F, 0x01 }, OuiVendor::Iot, "Raspberry Pi" },
+};
+
+static uint32_t slotFor(uint64_t key, uint32_t capacity) {
+  return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 58) % capacity;
+}
+
+static void keyToMac(uint64_t key, uint8_t* mac) {
+  for (int i = 0; i < 6; i++) mac[i] = (uint8_t)(key >> (40 - 8 * i));
+}
+
+DeviceFingerprinter::DeviceFingerprinter() {
+  memset(_tracked, 0, sizeof(_tracked));
+  memset(_devices, 0, sizeof(_devices));
+  memset(_deviceKeys, 0, sizeof(_deviceKeys));
+}
+
+void DeviceFingerprinter::setup() {
+#ifdef ARDUINO
+  _mutex = xSemaphoreCreateMutex();
+#endif
+  _load();
+  inferenceRuntime.registerModel(this);
+  ESP_LOGI(TAG, "Impressão digital de dispositivos: %u classificados, %u B de acumuladores + %u B de tabela.",
+           (unsigned)_deviceCount, (unsigned)sizeof(_tracked), (unsigned)(sizeof(_devices) + sizeof(_deviceKeys)));
+}
+
+void DeviceFingerprinter::_lock() const {
+#ifdef ARDUINO
+  if (_mutex) xSemaphoreTake((SemaphoreHandle_t)_mutex, portMAX_DELAY);
+#endif
+}
+
+void DeviceFingerprinter::_unlock() const {
+#ifdef ARDUINO
+  if (_mutex) xSemaphoreGive((SemaphoreHandle_t)_mutex);
+#endif
+}
+
+const char* DeviceFingerprinter::typeName(DeviceType type) {
+  return type == DeviceType::Unknown ? "unknown" : device_class_names[(int)type];
+}
+
+const char* DeviceFingerprinter::typeLabel(DeviceType type) {
+  static const char* const labels[] = { "celular", "notebook", "TV", "câmera", "IoT", "não identificado" };
+  return labels[(int)type];
+}
+
+const char* DeviceFingerprinter::vendorName(OuiVendor vendor) {
+  static const char* const names[] = { "unknown", "mobile", "pc", "tv", "camera", "iot" };
+  return names[(int)vendor];
+}
+
+OuiVendor DeviceFingerprinter::lookupVendor(const uint8_t* mac, const char** maker) {
+  if (maker) *maker = nullptr;
+  // MAC aleatório (bit "localmente administrado"): o OUI não diz nada
+  if (mac[0] & 0x02) return OuiVendor::Unknown;
+  for (const auto& entry : OUI_TABLE) {
+    if (memcmp(entry.oui, mac, 3) == 0) {
+      if (maker) *maker = entry.maker;
+      return entry.vendor;
+    }
+  }
+  return OuiVendor::Unknown;
+}
+
+// Posição do dispositivo na tabela de impressões digitais, ou -1
+int DeviceFingerprinter::_deviceSlot(uint64_t key) const {
+  uint32_t slot = slotFor(key, FINGERPRINT_MAX_DEVICES);
+  for (int probe = 0; probe < FINGERPRINT_MAX_DEVICES; probe++) {
+    uint32_t i = (slot + probe) % FINGERPRINT_MAX_DEVICES;
+    if (_deviceKeys[i] == key) return (int)i;
+    if (_deviceKeys[i] == 0) return -1;
+  }
+  return -1;
+}
+
+// Acumulador do dispositivo, criado se ele ainda não foi classificado. Com a
+// tabela cheia, dispositivos novos esperam o próximo endCycle() liberar espaço.
+DeviceFingerprinter::Accumulator* DeviceFingerprinter::_accumulator(uint64_t key) {
+  uint32_t slot = slotFor(key, FINGERPRINT_MAX_TRACKED);
+  for (int probe = 0; probe < FINGERPRINT_MAX_TRACKED; probe++) {
+    Accumulator& acc = _tracked[(slot + probe) % FINGERPRINT_MAX_TRACKED];
+    if (acc.key == key) return &acc;
+    if (acc.key == 0) {
+      if (_deviceSlot(key) >= 0) return nullptr;
+      acc.key = key;
+      return &acc;
+    }
+  }
+  return nullptr;
+}
+
+void DeviceFingerprinter::onFrame(const ParsedFrame& frame) {
+  if (!_cycleStarted) {
+    _cycleStarted = true;
+    _cycleFirstMs = frame.uptimeMs;
+  }
+  _cycleLastMs = frame.uptimeMs;
+
+  // Subida: o dispositivo é quem transmite; descida: o destino unicast
+  const uint8_t* mac;
+  bool uplink = frame.isUplink();
+  if (uplink) {
+    mac = frame.transmitter;
+  } else if ((frame.fcFlags & (WIFI_FC_TO_DS | WIFI_FC_FROM_DS)) == WIFI_FC_FROM_DS && !(frame.dstMac[0] & 0x01)) {
+    mac = frame.dstMac;
+  } else {
+    return;
+  }
+  uint64_t key = StatsStage::macToKey(mac);
+  if (key == 0) return;
+  Accumulator* acc = _accumulator(key);
+  if (acc == nullptr) return;
+
+  acc->seenInCycle = true;
+  acc->packets++;
+  if (uplink) {
+    acc->txBytes += frame.length;
+  } else {
+    acc->rxBytes += frame.length;
+  }
+
+  int bin = 0;
+  while (bin < FINGERPRINT_SIZE_BINS - 1 && frame.length > SIZE_BIN_LIMITS[bin]) bin++;
+  if (++acc->sizeBins[bin] == UINT16_MAX) {
+    // Satura: mantém as proporções com metade da contagem
+    for (uint16_t& count : acc->sizeBins) count /= 2;
+  }
+
+  if (acc->lastUs != 0) {
+    float gapMs = (uint32_t)(frame.timestampUs - acc->lastUs) / 1000.0f;
+    if (gapMs < MAX_GAP_MS) {
+      acc->gaps++;
+      float delta = gapMs - acc->gapMean;
+      acc->gapMean += delta / acc->gaps;
+      acc->gapM2 += delta * (gapMs - acc->gapMean);
+    }
+  }
+  acc->lastUs = frame.timestampUs | 1;  // 0 fica reservado para "nenhum quadro"
+
+  if (uplink && frame.hasIpv4 && frame.ipProto == IP_PROTO_UDP && frame.dstPort == 53 && frame.l4Payload != nullptr) {
+    _noteDns(*acc, frame);
+  }
+}
+
+void DeviceFingerprinter::_noteDns(Accumulator& acc, const ParsedFrame& frame) {
+  char qname[128];
+  if (!parseDnsQuery(frame.l4Payload, frame.l4PayloadLength, qname, sizeof(qname))) return;
+  uint32_t hash = 2166136261u;
+  for (const char* c = qname; *c; c++) hash = (hash ^ (uint8_t)*c) * 16777619u;
+  acc.domains |= 1u << (hash >> 27);
+  for (const auto& category : DNS_CATEGORIES) {
+    if (strstr(qname, category.fragment) != nullptr) acc.dnsCategories |= 1u << category.category;
+  }
+}
+
+void DeviceFingerprinter::endCycle(time_t now) {
+  uint32_t cycleMs = _cycleStarted ? _cycleLastMs - _cycleFirstMs : 0;
+  _cycleStarted = false;
+  int hour = -1;
+  if (now > 1600000000) {  // Relógio já acertado pelo SNTP
+    struct tm local;
+    localtime_r(&now, &local);
+    hour = local.tm_hour;
+  }
+
+  bool evicted = false;
+  for (Accumulator& acc : _tracked) {
+    if (acc.key == 0) continue;
+    if (acc.seenInCycle) {
+      acc.seenInCycle = false;
+      acc.lastUs = 0;
+      acc.idleCycles = 0;
+      acc.activeMs += cycleMs;
+      if (acc.cycles < UINT8_MAX) acc.cycles++;
+      if (hour >= 0) acc.hours |= 1u << hour;
+    } else if (++acc.idleCycles >= FINGERPRINT_IDLE_CYCLES) {
+      acc.key = 0;
+      evicted = true;
+    }
+  }
+  if (evicted) _rebuildTracked();
+}
+
+// Reinsere os acumuladores ocupados: remover no meio quebraria a sondagem linear
+void DeviceFingerprinter::_rebuildTracked() {
+  static Accumulator kept[FINGERPRINT_MAX_TRACKED];
+  size_t count = 0;
+  for (const Accumulator& acc : _tracked) {
+    if (acc.key != 0) kept[count++] = acc;
+  }
+  memset(_tracked, 0, sizeof(_tracked));
+  for (size_t i = 0; i < count; i++) {
+    uint32_t slot = slotFor(kept[i].key, FINGERPRINT_MAX_TRACKED);
+    while (_tracked[slot].key != 0) slot = (slot + 1) % FINGERPRINT_MAX_TRACKED;
+    _tracked[slot] = kept[i];
+  }
+}
+
+void DeviceFingerprinter::_features(const Accumulator& acc, const uint8_t* mac, float* out) const {
+  memset(out, 0, FINGERPRINT_FEATURES * sizeof(float));
+
+  uint32_t frames = 0;
+  for (uint16_t count : acc.sizeBins) frames += count;
+  for (int i = 0; i < FINGERPRINT_SIZE_BINS && frames > 0; i++) out[FP_SIZE_96 + i] = (float)acc.sizeBins[i] / frames;
+
+  // Coeficiente de rajada de Goh-Barabási: -1 periódico, 0 Poisson, 1 rajadas
+  out[FP_BURSTINESS] = 0.5f;
+  if (acc.gaps >= 2) {
+    float sd = sqrtf(acc.gapM2 / (acc.gaps - 1));
+    if (sd + acc.gapMean > 0.0f) out[FP_BURSTINESS] = ((sd - acc.gapMean) / (sd + acc.gapMean) + 1.0f) / 2.0f;
+  }
+
+  float minutes = std::max(acc.activeMs, (uint32_t)60000) / 60000.0f;
+  out[FP_RATE] = std::min(log10f(1.0f + acc.packets / minutes) / 4.0f, 1.0f);
+  uint64_t bytes = (uint64_t)acc.txBytes + acc.rxBytes;
+  out[FP_UPLINK_SHARE] = bytes > 0 ? (float)acc.txBytes / bytes : 0.5f;
+
+  for (int i = 0; i <= FP_DNS_IOT - FP_DNS_APPLE; i++) {
+    if (acc.dnsCategories & (1u << i)) out[FP_DNS_APPLE + i] = 1.0f;
+  }
+  out[FP_DNS_DIVERSITY] = __builtin_popcount(acc.domains) / 32.0f;
+
+  OuiVendor vendor = lookupVendor(mac);
+  if (vendor != OuiVendor::Unknown) out[FP_VENDOR_MOBILE + (int)vendor - (int)OuiVendor::Mobile] = 1.0f;
+  out[FP_RANDOM_MAC] = (mac[0] & 0x02) ? 1.0f : 0.0f;
+
+  out[FP_ACTIVE_HOURS] = __builtin_popcount(acc.hours & 0xFFFFFF) / 24.0f;
+  out[FP_NIGHT] = (acc.hours & 0x3F) ? 1.0f : 0.0f;  // 0h-5h
+}
+
+bool DeviceFingerprinter::invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) {
+  (void)arena;
+  DeviceClassModel::forwardBatch(device_class_params, in, out, n, nullptr, nullptr, profiler);
+  return true;
+}
+
+size_t DeviceFingerprinter::classify(DeviceFingerprint* fresh, size_t maxFresh) {
+  static float inputs[FINGERPRINT_MAX_TRACKED][FINGERPRINT_FEATURES];
+  static float logits[FINGERPRINT_MAX_TRACKED][FINGERPRINT_CLASSES];
+  Accumulator* ready[FINGERPRINT_MAX_TRACKED];
+  uint8_t macs[FINGERPRINT_MAX_TRACKED][6];
+  int n = 0;
+  for (Accumulator& acc : _tracked) {
+    if (acc.key == 0) continue;
+    bool enough = (acc.cycles >= FINGERPRINT_MIN_CYCLES && acc.packets >= FINGERPRINT_MIN_PACKETS) ||
+                  (acc.cycles >= FINGERPRINT_QUIET_CYCLES && acc.packets >= FINGERPRINT_QUIET_PACKETS);
+    if (!enough) continue;
+    keyToMac(acc.key, macs[n]);
+    _features(acc, macs[n], inputs[n]);
+    ready[n++] = &acc;
+  }
+  if (n == 0) return 0;
+  if (!inferenceRuntime.run(this, &inputs[0][0], &logits[0][0], n)) return 0;
+
+  size_t freshCount = 0;
+  for (int b = 0; b < n; b++) {
+    // Softmax só para a confiança; o tipo é o maior logit
+    const float* y = logits[b];
+    int top = (int)(std::max_element(y, y + FINGERPRINT_CLASSES) - y);
+    float sum = 0.0f;
+    for (int k = 0; k < FINGERPRINT_CLASSES; k++) sum += expf(y[k] - y[top]);
+    int confidence = (int)lroundf(100.0f / sum);
+
+    DeviceFingerprint entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.mac, macs[b], 6);
+    entry.type = confidence >= FINGERPRINT_MIN_CONFIDENCE ? (DeviceType)top : DeviceType::Unknown;
+    entry.confidence = (uint8_t)confidence;
+    entry.vendor = lookupVendor(entry.mac);
+    entry.sequence = ++_sequence;
+    for (int i = 0; i < FINGERPRINT_FEATURES; i++) entry.features[i] = (uint8_t)lroundf(inputs[b][i] * 255.0f);
+    _store(entry);
+    ready[b]->key = 0;
+    if (freshCount < maxFresh) fresh[freshCount++] = entry;
+
+    ESP_LOGI(TAG, "Dispositivo %02X:%02X:%02X:%02X:%02X:%02X: %s (%s, %d%%) após %u quadros em %u ciclos.",
+             entry.mac[0], entry.mac[1], entry.mac[2], entry.mac[3], entry.mac[4], entry.mac[5],
+             typeName(entry.type), device_class_names[top], confidence, (unsigned)ready[b]->packets,
+             (unsigned)ready[b]->cycles);
+  }
+  _rebuildTracked();
+  _save();
+  return freshCount;
+}
+
+// Grava na tabela; se ela lotar, sai a impressão digital mais antiga
+void DeviceFingerprinter::_store(const DeviceFingerprint& entry) {
+  uint64_t key = StatsStage::macToKey(entry.mac);
+  _lock();
+  if (_deviceSlot(key) < 0 && _deviceCount == FINGERPRINT_MAX_DEVICES) {
+    static DeviceFingerprint kept[FINGERPRINT_MAX_DEVICES];
+    int oldest = 0;
+    for (int i = 1; i < FINGERPRINT_MAX_DEVICES; i++) {
+      if (_devices[i].sequence < _devices[oldest].sequence) oldest = i;
+    }
+    size_t count = 0;
+    for (int i = 0; i < FINGERPRINT_MAX_DEVICES; i++) {
+      if (i != oldest) kept[count++] = _devices[i];
+    }
+    memset(_deviceKeys, 0, sizeof(_deviceKeys));
+    _deviceCount = 0;
+    for (size_t i = 0; i < count; i++) {
+      uint64_t keptKey = StatsStage::macToKey(kept[i].mac);
+      uint32_t slot = slotFor(keptKey, FINGERPRINT_MAX_DEVICES);
+      while (_deviceKeys[slot] != 0) slot = (slot + 1) % FINGERPRINT_MAX_DEVICES;
+      _deviceKeys[slot] = keptKey;
+      _devices[slot] = kept[i];
+      _deviceCount++;
+    }
+  }
+  int index = _deviceSlot(key);
+  if (index < 0) {
+    uint32_t slot = slotFor(key, FINGERPRINT_MAX_DEVICES);
+    while (_deviceKeys[slot] != 0) slot = (slot + 1) % FINGERPRINT_MAX_DEVICES;
+    _deviceKeys[slot] = key;
+    _deviceCount++;
+    index = (int)slot;
+  }
+  _devices[index] = entry;
+  _unlock();
+}
+
+bool DeviceFingerprinter::fingerprint(const uint8_t* mac, DeviceFingerprint* out) const {
+  _lock();
+  int index = _deviceSlot(StatsStage::macToKey(mac));
+  if (index >= 0) *out = _devices[index];
+  _unlock();
+  return index >= 0;
+}
+
+size_t DeviceFingerprinter::snapshot(DeviceFingerprint* out, size_t maxOut) const {
+  size_t count = 0;
+  _lock();
+  for (int i = 0; i < FINGERPRINT_MAX_DEVICES && count < maxOut; i++) {
+    if (_deviceKeys[i] != 0) out[count++] = _devices[i];
+  }
+  _unlock();
+  // Na ordem em que foram classificados
+  std::sort(out, out + count, [](const DeviceFingerprint& a, const DeviceFingerprint& b) { return a.sequence < b.sequence; });
+  return count;
+}
+
+size_t DeviceFingerprinter::trackedCount() const {
+  size_t count = 0;
+  for (const Accumulator& acc : _tracked) {
+    if (acc.key != 0) count++;
+  }
+  return count;
+}
+
+void DeviceFingerprinter::_load() {
+#ifdef ARDUINO
+  static DeviceFingerprint saved[FINGERPRINT_MAX_DEVICES];
+  Preferences preferences;
+  preferences.begin(FP_NAMESPACE, true, NVS_STATE_PARTITION);
+  size_t length = preferences.getBytes(FP_KEY, saved, sizeof(saved));
+  preferences.end();
+  if (length % sizeof(DeviceFingerprint) != 0) {
+    ESP_LOGW(TAG, "Tabela de impressões digitais no NVS com outro formato; recomeçando.");
+    return;
+  }
+  for (size_t i = 0; i < length / sizeof(DeviceFingerprint); i++) {
+    _store(saved[i]);
+    _sequence = std::max(_sequence, saved[i].sequence);
+  }
+#endif
+}
+
+void DeviceFingerprinter::_save() {
+#ifdef ARDUINO
+  static DeviceFingerprint table[FINGERPRINT_MAX_DEVICES];
+  size_t count = snapshot(table, FINGERPRINT_MAX_DEVICES);
+  Preferences preferences;
+  preferences.begin(FP_NAMESPACE, false, NVS_STATE_PARTITION);
+  if (preferences.putBytes(FP_KEY, table, count * sizeof(DeviceFingerprint)) != count * sizeof(DeviceFingerprint)) {
+    ESP_LOGW(TAG, "Falha ao gravar %u impressões digitais no NVS (partição %s cheia?).", (unsigned)count,
+             NVS_STATE_PARTITION);
+  }
+  preferences.end();
+#endif
+}
@@ -0,0 +1,346 @@
+#include "DeviceProfile.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Preferences.h>
+#include "NvsState.h"
+#include "freertos/semphr.h"
+static const char* PROFILE_NAMESPACE = "profiles";
+#endif
+
+static const char* TAG = "DeviceProfile";
+
+static_assert(sizeof(DeviceProfile) == 40, "DeviceProfile mudou de tamanho: o NVS guarda a struct crua");
+static_assert(PROFILE_MAX_DEVICES < 255 && PROFILE_INDEX_SIZE >= 2 * PROFILE_MAX_DEVICES,
+              "O índice guarda posição + 1 em um byte e precisa de folga");
+static_assert(PROFILE_SPILL_SLOTS % PROFILE_SPILL_PER_BLOB == 0, "Blobs do NVS incompletos");
+
+static uint64_t macKey(const uint8_t* mac) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+  return key;
+}
+
+static uint32_t indexSlot(const uint8_t* mac) {
+  return (uint32_t)((macKey(mac) * 0x9E3779B97F4A7C15ULL) >> 56) % PROFILE_INDEX_SIZE;
+}
+
+#if defined(ARDUINO) && PROFILE_FLASH_SPILL
+// FNV-1a do MAC; nunca 0 (0 marca posição livre no anel do NVS)
+static uint32_t macHash(const uint8_t* mac) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < 6; i++) hash = (hash ^ mac[i]) * 16777619u;
+  return hash | 1;
+}
+#endif
+
+static uint32_t isqrt(uint32_t x) {
+  uint32_t root = 0;
+  uint32_t bit = 1u << 30;
+  while (bit > x) bit >>= 2;
+  while (bit != 0) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+uint16_t DeviceProfileStore::log2q8(uint32_t x) {
+  if (x == 0) return 0;
+  int msb = 31 - __builtin_clz(x);
+  uint32_t fraction = (msb >= 8) ? (x >> (msb - 8)) & 0xFF : (x << (8 - msb)) & 0xFF;
+  return (uint16_t)((msb << 8) | fraction);
+}
+
+float DeviceProfileStore::typicalValue(uint16_t meanQ8) {
+  return exp2f(meanQ8 / 256.0f) - 1.0f;
+}
+
+float DeviceProfileStore::sigmaFactor(uint16_t varQ8) {
+  return exp2f(sqrtf(varQ8 / 256.0f));
+}
+
+DeviceProfileStore::DeviceProfileStore() {
+  memset(_profiles, 0, sizeof(_profiles));
+  memset(_index, 0, sizeof(_index));
+  memset(_spillKeys, 0, sizeof(_spillKeys));
+}
+
+void DeviceProfileStore::setup() {
+#ifdef ARDUINO
+  _mutex = xSemaphoreCreateMutex();
+#if PROFILE_FLASH_SPILL
+  static DeviceProfile blob[PROFILE_SPILL_PER_BLOB];
+  Preferences preferences;
+  preferences.begin(PROFILE_NAMESPACE, true, NVS_STATE_PARTITION);
+  for (int b = 0; b < PROFILE_SPILL_SLOTS / PROFILE_SPILL_PER_BLOB; b++) {
+    char key[8];
+    snprintf(key, sizeof(key), "spill%d", b);
+    if (preferences.getBytes(key, blob, sizeof(blob)) != sizeof(blob)) continue;
+    for (int i = 0; i < PROFILE_SPILL_PER_BLOB; i++) {
+      static const uint8_t empty[6] = {};
+      if (memcmp(blob[i].mac, empty, 6) != 0) _spillKeys[b * PROFILE_SPILL_PER_BLOB + i] = macHash(blob[i].mac);
+    }
+  }
+  _spillNext = preferences.getUChar("next", 0) % PROFILE_SPILL_SLOTS;
+  preferences.end();
+#endif
+#endif
+  ESP_LOGI(TAG, "Perfis por dispositivo: %u na RAM (%u B), %u guardados no NVS, desvio a partir de %u sigmas.",
+           (unsigned)PROFILE_MAX_DEVICES, (unsigned)(sizeof(_profiles) + sizeof(_index)), (unsigned)spilledCount(),
+           _kSigma);
+}
+
+void DeviceProfileStore::_lock() const {
+#ifdef ARDUINO
+  if (_mutex) xSemaphoreTake((SemaphoreHandle_t)_mutex, portMAX_DELAY);
+#endif
+}
+
+void DeviceProfileStore::_unlock() const {
+#ifdef ARDUINO
+  if (_mutex) xSemaphoreGive((SemaphoreHandle_t)_mutex);
+#endif
+}
+
+DeviceProfile* DeviceProfileStore::_find(const uint8_t* mac) {
+  uint32_t slot = indexSlot(mac);
+  for (int probe = 0; probe < PROFILE_INDEX_SIZE; probe++) {
+    uint8_t entry = _index[(slot + probe) % PROFILE_INDEX_SIZE];
+    if (entry == 0) return nullptr;
+    if (memcmp(_profiles[entry - 1].mac, mac, 6) == 0) return &_profiles[entry - 1];
+  }
+  return nullptr;
+}
+
+void DeviceProfileStore::_rebuildIndex() {
+  memset(_index, 0, sizeof(_index));
+  for (size_t i = 0; i < _count; i++) {
+    uint32_t slot = indexSlot(_profiles[i].mac);
+    while (_index[slot] != 0) slot = (slot + 1) % PROFILE_INDEX_SIZE;
+    _index[slot] = (uint8_t)(i + 1);
+  }
+}
+
+// Perfil novo (ou de volta do NVS). Com a tabela cheia, o visto há mais tempo
+// sai da RAM.
+DeviceProfile* DeviceProfileStore::_insert(const uint8_t* mac) {
+  size_t pos;
+  bool evicted = false;
+  if (_count < PROFILE_MAX_DEVICES) {
+    pos = _count++;
+  } else {
+    pos = 0;
+    for (size_t i = 1; i < _count; i++) {
+      if (_profiles[i].lastSeen < _profiles[pos].lastSeen) pos = i;
+    }
+    _spill(_profiles[pos]);
+    evicted = true;
+  }
+
+  DeviceProfile& profile = _profiles[pos];
+  if (!_restore(mac, &profile)) {
+    memset(&profile, 0, sizeof(profile));
+    memcpy(profile.mac, mac, 6);
+  }
+  profile.flags = 0;
+
+  if (evicted) {
+    _rebuildIndex();
+  } else {
+    uint32_t slot = indexSlot(mac);
+    while (_index[slot] != 0) slot = (slot + 1) % PROFILE_INDEX_SIZE;
+    _index[slot] = (uint8_t)(pos + 1);
+  }
+  return &profile;
+}
+
+// Média e variância EWMA de uma métrica em log2 Q8.8; true se a amostra está a
+// mais de k sigmas
+bool DeviceProfileStore::_updateMetric(uint16_t& mean, uint16_t& var, uint16_t x, uint16_t windows, int8_t& z) const {
+  int32_t diff = (int32_t)x - mean;
+  bool deviant = false;
+  z = 0;
+  if (windows >= PROFILE_MIN_WINDOWS) {
+    int32_t sigma = std::max<int32_t>((int32_t)isqrt((uint32_t)var << 8), PROFILE_MIN_SIGMA);
+    z = (int8_t)std::max<int32_t>(-127, std::min<int32_t>(127, diff * 10 / sigma));
+    int32_t limit = sigma * _kSigma;
+    if (diff > limit || diff < -limit) {
+      deviant = true;
+      // Recorta o surto: ele entra na média como k sigmas
+      diff = diff > 0 ? limit : -limit;
+    }
+  }
+  // Alfa = 1/n nas primeiras janelas (média simples), depois 1/2^PROFILE_EWMA_SHIFT
+  int32_t n = std::min<int32_t>(windows + 1, 1 << PROFILE_EWMA_SHIFT);
+  mean = (uint16_t)std::max<int32_t>(0, mean + diff / n);
+  // v <- (1 - alfa) * (v + alfa * d^2)
+  int64_t v = (int64_t)var + (((int64_t)diff * diff) >> 8) / n;
+  v -= v / n;
+  var = (uint16_t)std::min<int64_t>(v, UINT16_MAX);
+  return deviant;
+}
+
+uint8_t DeviceProfileStore::update(const uint8_t* mac, uint32_t bytesPerMin, uint32_t packetsPerMin, uint32_t peers,
+                                   time_t now) {
+  _lock();
+  DeviceProfile* p = _find(mac);
+  if (p == nullptr) p = _insert(mac);
+  p->lastSeen = ++_sequence;
+
+  uint8_t flags = 0;
+  bool warm = p->windows >= PROFILE_MIN_WINDOWS;
+  uint32_t bytesX = bytesPerMin < UINT32_MAX ? bytesPerMin + 1 : bytesPerMin;
+  uint32_t packetsX = packetsPerMin < UINT32_MAX ? packetsPerMin + 1 : packetsPerMin;
+  if (_updateMetric(p->bytesMean, p->bytesVar, log2q8(bytesX), p->windows, p->bytesZ)) flags |= PROFILE_FLAG_BYTES;
+  if (_updateMetric(p->packetsMean, p->packetsVar, log2q8(packetsX), p->windows, p->packetsZ)) {
+    flags |= PROFILE_FLAG_PACKETS;
+  }
+
+  // Destinos: novos = fora dos bitmaps desta época e da anterior
+  int seen = __builtin_popcount(peers);
+  int novel = __builtin_popcount(peers & ~(p->peers | p->peersPrevious));
+  if (warm && seen >= PROFILE_NOVEL_PEERS_MIN && novel * 100 >= PROFILE_NOVEL_PEERS_PCT * seen) {
+    flags |= PROFILE_FLAG_PEERS;
+  }
+  p->peers |= peers;
+  if (++p->peerEpoch >= PROFILE_PEER_EPOCH) {
+    p->peersPrevious = p->peers;
+    p->peers = 0;
+    p->peerEpoch = 0;
+  }
+
+  // Horário: só com o relógio acertado pelo SNTP
+  if (now > 1600000000) {
+    struct tm local;
+    localtime_r(&now, &local);
+    uint32_t hourBit = 1u << local.tm_hour;
+    uint32_t days = p->activeHours >> 24;
+    if (days >= PROFILE_HOUR_MIN_DAYS && !(p->activeHours & hourBit)) flags |= PROFILE_FLAG_HOUR;
+    uint16_t day = (uint16_t)(now / 86400);
+    if (day != p->lastDay) {
+      p->lastDay = day;
+      if (days < 255) days++;
+    }
+    p->activeHours = (days << 24) | (p->activeHours & 0xFFFFFF) | hourBit;
+  }
+
+  if (p->windows < UINT16_MAX) p->windows++;
+  p->flags |= flags;
+  _unlock();
+  return flags;
+}
+
+void DeviceProfileStore::beginCycle() {
+  _lock();
+  for (size_t i = 0; i < _count; i++) _profiles[i].flags = 0;
+  _unlock();
+}
+
+static int deviationRank(const DeviceProfile& p) {
+  return std::max(std::abs((int)p.bytesZ), std::abs((int)p.packetsZ));
+}
+
+size_t DeviceProfileStore::deviations(DeviceProfile* out, size_t maxOut) const {
+  static DeviceProfile flagged[PROFILE_MAX_DEVICES];
+  size_t count = 0;
+  _lock();
+  for (size_t i = 0; i < _count; i++) {
+    if (_profiles[i].flags != 0) flagged[count++] = _profiles[i];
+  }
+  _unlock();
+  std::sort(flagged, flagged + count,
+            [](const DeviceProfile& a, const DeviceProfile& b) { return deviationRank(a) > deviationRank(b); });
+  count = std::min(count, maxOut);
+  memcpy(out, flagged, count * sizeof(DeviceProfile));
+  return count;
+}
+
+size_t DeviceProfileStore::snapshot(DeviceProfile* out, size_t maxOut) const {
+  _lock();
+  size_t count = std::min(_count, maxOut);
+  memcpy(out, _profiles, count * sizeof(DeviceProfile));
+  _unlock();
+  return count;
+}
+
+size_t DeviceProfileStore::spilledCount() const {
+  size_t count = 0;
+  for (uint32_t key : _spillKeys) {
+    if (key != 0) count++;
+  }
+  return count;
+}
+
+// Grava o perfil na próxima posição do anel do NVS (sobrescreve o mais antigo)
+void DeviceProfileStore::_spill(const DeviceProfile& profile) {
+#if defined(ARDUINO) && PROFILE_FLASH_SPILL
+  if (profile.windows < PROFILE_MIN_WINDOWS) return;  // Pouco histórico: não vale a escrita
+  static DeviceProfile blob[PROFILE_SPILL_PER_BLOB];
+  int slot = _spillNext;
+  char key[8];
+  snprintf(key, sizeof(key), "spill%d", slot / PROFILE_SPILL_PER_BLOB);
+  Preferences preferences;
+  preferences.begin(PROFILE_NAMESPACE, false, NVS_STATE_PARTITION);
+  if (preferences.getBytes(key, blob, sizeof(blob)) != sizeof(blob)) memset(blob, 0, sizeof(blob));
+  blob[slot % PROFILE_SPILL_PER_BLOB] = profile;
+  blob[slot % PROFILE_SPILL_PER_BLOB].flags = 0;
+  if (preferences.putBytes(key, blob, sizeof(blob)) != sizeof(blob)) {
+    preferences.end();
+    ESP_LOGW(TAG, "Falha ao guardar o perfil %02X:%02X:%02X:%02X:%02X:%02X no NVS (partição %s cheia?); descartado.",
+             profile.mac[0], profile.mac[1], profile.mac[2], profile.mac[3], profile.mac[4], profile.mac[5],
+             NVS_STATE_PARTITION);
+    return;
+  }
+  _spillNext = (uint8_t)((slot + 1) % PROFILE_SPILL_SLOTS);
+  preferences.putUChar("next", _spillNext);
+  preferences.end();
+  _spillKeys[slot] = macHash(profile.mac);
+  ESP_LOGD(TAG, "Perfil %02X:%02X:%02X:%02X:%02X:%02X guardado no NVS (posição %d).", profile.mac[0],
+           profile.mac[1], profile.mac[2], profile.mac[3], profile.mac[4], profile.mac[5], slot);
+#else
+  (void)profile;
+#endif
+}
+
+// Traz o perfil de volta do NVS e libera a posição dele no anel
+bool DeviceProfileStore::_restore(const uint8_t* mac, DeviceProfile* out) {
+#if defined(ARDUINO) && PROFILE_FLASH_SPILL
+  uint32_t hash = macHash(mac);
+  for (int slot = 0; slot < PROFILE_SPILL_SLOTS; slot++) {
+    if (_spillKeys[slot] != hash) continue;
+    static DeviceProfile blob[PROFILE_SPILL_PER_BLOB];
+    char key[8];
+    snprintf(key, sizeof(key), "spill%d", slot / PROFILE_SPILL_PER_BLOB);
+    Preferences preferences;
+    preferences.begin(PROFILE_NAMESPACE, false, NVS_STATE_PARTITION);
+    bool found = preferences.getBytes(key, blob, sizeof(blob)) == sizeof(blob) &&
+                 memcmp(blob[slot % PROFILE_SPILL_PER_BLOB].mac, mac, 6) == 0;
+    if (found) {
+      *out = blob[slot % PROFILE_SPILL_PER_BLOB];
+      memset(&blob[slot % PROFILE_SPILL_PER_BLOB], 0, sizeof(DeviceProfile));
+      // Sem a gravação a cópia antiga fica na flash até o anel passar por ela de novo
+      if (preferences.putBytes(key, blob, sizeof(blob)) != sizeof(blob)) {
+        ESP_LOGW(TAG, "Falha ao liberar a posição %d do anel no NVS (partição %s cheia?).", slot, NVS_STATE_PARTITION);
+      }
+      _spillKeys[slot] = 0;
+    }
+    preferences.end();
+    if (found) return true;
+  }
+#else
+  (void)mac;
+  (void)out;
+#endif
+  return false;
+}
@@ -0,0 +1,23 @@
+#include "DiagnosticsRing.h"
+
+void DiagnosticsRing::push(const DiagnosticSample& sample) {
+  _samples[_total % DIAG_RING_CAPACITY] = sample;
+  _total++;
+}
+
+size_t DiagnosticsRing::count() const {
+  return _total < DIAG_RING_CAPACITY ? _total : DIAG_RING_CAPACITY;
+}
+
+bool DiagnosticsRing::get(uint32_t index, DiagnosticSample* sample) const {
+  if (index >= _total || index < oldest()) return false;
+  *sample = _samples[index % DIAG_RING_CAPACITY];
+  return true;
+}
+
+size_t DiagnosticsRing::latest(DiagnosticSample* out, size_t n) const {
+  if (n > count()) n = count();
+  uint32_t first = _total - (uint32_t)n;
+  for (size_t i = 0; i < n; i++) out[i] = _samples[(first + i) % DIAG_RING_CAPACITY];
+  return n;
+}
@@ -0,0 +1,46 @@
+#include "FaultLocator.h"
+#include <cstdio>
+
+FaultVerdict FaultLocator::classify(const FaultReport& report) {
+  if (!report.wifi) return FaultVerdict::WifiLink;
+  if (!report.gateway) return FaultVerdict::RouterHung;
+  if (report.publicIp || report.http) {
+    // Sem nenhum resolvedor, o HTTP só respondeu porque o IP do host estava em cache
+    if (!report.dnsNetwork && !report.dnsPublic) return FaultVerdict::DnsOnly;
+    if (!report.dnsNetwork && report.dnsNetworkLocal) return FaultVerdict::RouterDns;
+    return FaultVerdict::Healthy;
+  }
+  return report.ispEdge ? FaultVerdict::IspUpstream : FaultVerdict::IspLink;
+}
+
+bool FaultLocator::rebootHelps(FaultVerdict verdict) {
+  // IspLink inclui a sessão PPPoE/DHCP da WAN travada no próprio roteador, o
+  // caso clássico que o reboot resolve. Só o que o provedor confirma segura o reboot.
+  return verdict != FaultVerdict::Healthy && verdict != FaultVerdict::IspUpstream &&
+         verdict != FaultVerdict::DnsOnly;
+}
+
+const char* FaultLocator::verdictName(FaultVerdict verdict) {
+  static const char* const names[] = { "healthy", "wifi_link", "router_hung", "router_dns",
+                                       "dns_only", "isp_link", "isp_upstream" };
+  return names[(int)verdict];
+}
+
+const char* FaultLocator::verdictLabel(FaultVerdict verdict) {
+  static const char* const labels[] = { "internet normal", "Wi-Fi sem associação", "roteador travado",
+                                        "DNS do roteador parado", "só o DNS", "link do provedor",
+                                        "provedor (depois do primeiro salto)" };
+  return labels[(int)verdict];
+}
+
+size_t FaultLocator::describe(const FaultReport& report, char* buffer, size_t maxLen) {
+  auto mark = [](bool ok) { return ok ? "ok" : "X"; };
+  int written = snprintf(buffer, maxLen,
+                         "Diagnóstico: *%s*\nWi-Fi %s (%d dBm) | gateway %s%s | provedor %s | "
+                         "internet %s | DNS rede %s, público %s (%u ms)",
+                         verdictLabel(report.verdict), mark(report.wifi), report.rssi, mark(report.gateway),
+                         report.gateway || !report.gatewayArp ? "" : " (responde ARP)", mark(report.ispEdge),
+                         mark(report.publicIp || report.http), mark(report.dnsNetwork), mark(report.dnsPublic),
+                         report.elapsedMs);
+  return written > 0 && (size_t)written < maxLen ? (size_t)written : 0;
+}
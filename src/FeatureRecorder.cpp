@@ -0,0 +1,188 @@
+#include "FeatureRecorder.h"
+#include "AnomalyModelBlob.h"
+#include <cstdio>
+#include <cstring>
+
+static_assert(sizeof(FeatureRecord) == 16 + 4 * ANOMALY_FEATURE_COUNT, "registro do anel com layout fixo");
+static_assert(FEATURE_RECORDER_SECTORS >= 2, "o anel precisa de um setor para apagar e outro com histórico");
+
+FeatureRecorder::FeatureRecorder() {}
+
+uint32_t FeatureRecorder::_crc(const FeatureRecord& record) {
+  return anomalyBlobCrc32(reinterpret_cast<const uint8_t*>(&record), offsetof(FeatureRecord, crc),
+                          anomalyFeatureLayoutHash(ANOMALY_FEATURE_COUNT));
+}
+
+bool FeatureRecorder::_valid(const FeatureRecord& record) const {
+  return record.featureCount == ANOMALY_FEATURE_COUNT && record.crc == _crc(record);
+}
+
+uint32_t FeatureRecorder::oldest() const {
+  // O setor do próximo registro já foi (ou vai ser) apagado; os outros estão cheios
+  uint32_t next = _next;
+  uint32_t retained = (FEATURE_RECORDER_SECTORS - 1) * FEATURE_RECORDS_PER_SECTOR + next % FEATURE_RECORDS_PER_SECTOR;
+  return next > retained ? next - retained : 0;
+}
+
+bool FeatureRecorder::read(uint32_t* cursor, FeatureRecord* out) const {
+  if (_partition == nullptr) return false;
+  if (*cursor < oldest()) *cursor = oldest();
+  while (*cursor < _next) {
+    uint32_t sequence = (*cursor)++;
+    // Lido enquanto o setor era apagado, ou cortado na gravação: pula
+    if (_readSlot(sequence % FEATURE_RECORDER_CAPACITY, out) && _valid(*out) && out->sequence == sequence) return true;
+  }
+  return false;
+}
+
+size_t FeatureRecorder::csvHeader(char* buffer, size_t maxLen) {
+  size_t written = snprintf(buffer, maxLen, "timestamp");
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT && written < maxLen; i++) {
+    written += snprintf(buffer + written, maxLen - written, ",%s", ANOMALY_FEATURE_COLUMNS[i]);
+  }
+  if (written < maxLen) written += snprintf(buffer + written, maxLen - written, ",anomaly\n");
+  return written < maxLen ? written : 0;
+}
+
+size_t FeatureRecorder::csvLine(const FeatureRecord& record, char* buffer, size_t maxLen) {
+  // Hora local, como em network_metrics_dataset.csv; sem o relógio acertado a coluna fica vazia
+  size_t written = 0;
+  if (record.flags & FEATURE_RECORD_EPOCH) {
+    time_t t = record.time;
+    struct tm local;
+    localtime_r(&t, &local);
+    written = strftime(buffer, maxLen, "%Y-%m-%d %H:%M:%S", &local);
+    if (written == 0) return 0;
+  }
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT && written < maxLen; i++) {
+    written += snprintf(buffer + written, maxLen - written, ",%.9g", (double)record.values[i]);
+  }
+  if (written < maxLen) {
+    written += snprintf(buffer + written, maxLen - written, ",%d\n", (record.flags & FEATURE_RECORD_ANOMALY) ? 1 : 0);
+  }
+  return written < maxLen ? written : 0;
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+
+static const char* TAG = "FeatureRecorder";
+
+static inline const esp_partition_t* recorderPartition(const void* partition) {
+  return static_cast<const esp_partition_t*>(partition);
+}
+
+static inline size_t slotOffset(uint32_t slot) {
+  return (slot / FEATURE_RECORDS_PER_SECTOR) * FEATURE_RECORDER_SECTOR +
+         (slot % FEATURE_RECORDS_PER_SECTOR) * sizeof(FeatureRecord);
+}
+
+bool FeatureRecorder::_readSlot(uint32_t slot, FeatureRecord* out) const {
+  return esp_partition_read(recorderPartition(_partition), slotOffset(slot), out, sizeof(*out)) == ESP_OK;
+}
+
+bool FeatureRecorder::begin() {
+  const esp_partition_t* partition =
+      esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "features");
+  if (partition == nullptr) {
+    ESP_LOGW(TAG, "Partição 'features' ausente (ver partitions.csv): ciclos não serão gravados.");
+    return false;
+  }
+  if (partition->size < FEATURE_RECORDER_SECTORS * FEATURE_RECORDER_SECTOR) {
+    ESP_LOGW(TAG, "Partição 'features' menor que %u KB.", FEATURE_RECORDER_SECTORS * FEATURE_RECORDER_SECTOR / 1024);
+    return false;
+  }
+  _partition = partition;
+
+  // O setor mais recente é o de maior sequência no primeiro registro
+  FeatureRecord record;
+  bool found = false;
+  uint32_t last = 0;
+  for (uint32_t sector = 0; sector < FEATURE_RECORDER_SECTORS; sector++) {
+    uint32_t slot = sector * FEATURE_RECORDS_PER_SECTOR;
+    if (_readSlot(slot, &record) && _valid(record) && record.sequence % FEATURE_RECORDER_CAPACITY == slot &&
+        (!found || record.sequence > last)) {
+      found = true;
+      last = record.sequence;
+    }
+  }
+  // ... e o fim do anel é o último registro em sequência dentro dele
+  if (found) {
+    while ((last + 1) % FEATURE_RECORDS_PER_SECTOR != 0 &&
+           _readSlot((last + 1) % FEATURE_RECORDER_CAPACITY, &record) && _valid(record) &&
+           record.sequence == last + 1) {
+      last++;
+    }
+    _next = last + 1;
+  } else {
+    _next = 0;
+  }
+
+  // Uma gravação cortada deixa a posição suja: recomeça no próximo setor, que será apagado
+  if (_next % FEATURE_RECORDS_PER_SECTOR != 0 && _readSlot(_next % FEATURE_RECORDER_CAPACITY, &record)) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+    for (size_t i = 0; i < sizeof(record); i++) {
+      if (bytes[i] != 0xFF) {
+        _next += FEATURE_RECORDS_PER_SECTOR - _next % FEATURE_RECORDS_PER_SECTOR;
+        break;
+      }
+    }
+  }
+  ESP_LOGI(TAG, "Anel de características: %u ciclos gravados (capacidade %u), próximo #%u.", (unsigned)count(),
+           (unsigned)FEATURE_RECORDER_CAPACITY, (unsigned)_next);
+  return true;
+}
+
+bool FeatureRecorder::record(const FeatureVector& features, uint16_t seconds, bool anomaly, time_t now) {
+  if (_partition == nullptr) return false;
+  const esp_partition_t* partition = recorderPartition(_partition);
+  uint32_t sequence = _next;
+  uint32_t slot = sequence % FEATURE_RECORDER_CAPACITY;
+
+  if (slot % FEATURE_RECORDS_PER_SECTOR == 0 &&
+      esp_partition_erase_range(partition, (slot / FEATURE_RECORDS_PER_SECTOR) * FEATURE_RECORDER_SECTOR,
+                                FEATURE_RECORDER_SECTOR) != ESP_OK) {
+    ESP_LOGW(TAG, "Falha ao apagar o setor do registro #%u.", (unsigned)sequence);
+    return false;
+  }
+
+  FeatureRecord record;
+  memset(&record, 0, sizeof(record));
+  record.sequence = sequence;
+  if (now > 1600000000) {  // Relógio já acertado pelo SNTP
+    record.time = (uint32_t)now;
+    record.flags |= FEATURE_RECORD_EPOCH;
+  } else {
+    record.time = millis() / 1000;
+  }
+  if (anomaly) record.flags |= FEATURE_RECORD_ANOMALY;
+  record.featureCount = ANOMALY_FEATURE_COUNT;
+  record.seconds = seconds;
+  memcpy(record.values, features.values, sizeof(record.values));
+  record.crc = _crc(record);
+
+  // A posição passa a valer como usada mesmo se a escrita falhar: não é regravada sem apagar
+  _next = sequence + 1;
+  if (esp_partition_write(partition, slotOffset(slot), &record, sizeof(record)) != ESP_OK) {
+    ESP_LOGW(TAG, "Falha ao gravar o registro #%u.", (unsigned)sequence);
+    return false;
+  }
+  ESP_LOGD(TAG, "Ciclo #%u gravado (%u s).", (unsigned)sequence, seconds);
+  return true;
+}
+#else
+// No PC não há partições: nada é gravado
+bool FeatureRecorder::begin() {
+  return false;
+}
+
+bool FeatureRecorder::record(const FeatureVector&, uint16_t, bool, time_t) {
+  return false;
+}
+
+bool FeatureRecorder::_readSlot(uint32_t, FeatureRecord*) const {
+  return false;
+}
+#endif
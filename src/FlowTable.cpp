@@ -0,0 +1,157 @@
+#include "FlowTable.h"
+#include <cstring>
+
+static const uint32_t DEFAULT_ACTIVE_TIMEOUT_MS = 60 * 1000;
+static const uint32_t DEFAULT_IDLE_TIMEOUT_MS = 15 * 1000;
+
+FlowTable::FlowTable() {
+  _activeTimeoutMs = DEFAULT_ACTIVE_TIMEOUT_MS;
+  _idleTimeoutMs = DEFAULT_IDLE_TIMEOUT_MS;
+  _callback = nullptr;
+  _callbackContext = nullptr;
+  reset();
+}
+
+void FlowTable::reset() {
+  memset(_entries, 0, sizeof(_entries));
+  for (int i = 0; i < FLOW_HASH_BUCKETS; i++) _buckets[i] = -1;
+  // Todas as entradas começam na lista livre (reaproveitando 'hashNext')
+  for (int i = 0; i < FLOW_TABLE_SIZE; i++) {
+    _entries[i].hashNext = (i + 1 < FLOW_TABLE_SIZE) ? i + 1 : -1;
+    _entries[i].lruPrev = -1;
+    _entries[i].lruNext = -1;
+  }
+  _freeHead = 0;
+  _lruHead = -1;
+  _lruTail = -1;
+  _activeCount = 0;
+  _evictions = 0;
+}
+
+void FlowTable::setTimeouts(uint32_t activeTimeoutMs, uint32_t idleTimeoutMs) {
+  _activeTimeoutMs = activeTimeoutMs;
+  _idleTimeoutMs = idleTimeoutMs;
+}
+
+void FlowTable::setExpiredCallback(FlowExpiredCallback callback, void* context) {
+  _callback = callback;
+  _callbackContext = context;
+}
+
+uint32_t FlowTable::_hash(const FlowKey& key) {
+  uint32_t h = key.srcIp * 0x9E3779B1u;
+  h ^= key.dstIp + 0x7F4A7C15u + (h << 6) + (h >> 2);
+  h ^= (((uint32_t)key.srcPort << 16) | key.dstPort) + (h << 6) + (h >> 2);
+  h ^= key.proto;
+  return (h ^ (h >> 16)) & (FLOW_HASH_BUCKETS - 1);
+}
+
+bool FlowTable::_sameKey(const FlowKey& a, const FlowKey& b) {
+  return a.srcIp == b.srcIp && a.dstIp == b.dstIp && a.srcPort == b.srcPort &&
+         a.dstPort == b.dstPort && a.proto == b.proto;
+}
+
+void FlowTable::_lruUnlink(int16_t index) {
+  Entry& e = _entries[index];
+  if (e.lruPrev >= 0) _entries[e.lruPrev].lruNext = e.lruNext; else _lruHead = e.lruNext;
+  if (e.lruNext >= 0) _entries[e.lruNext].lruPrev = e.lruPrev; else _lruTail = e.lruPrev;
+  e.lruPrev = -1;
+  e.lruNext = -1;
+}
+
+void FlowTable::_lruPushFront(int16_t index) {
+  Entry& e = _entries[index];
+  e.lruPrev = -1;
+  e.lruNext = _lruHead;
+  if (_lruHead >= 0) _entries[_lruHead].lruPrev = index;
+  _lruHead = index;
+  if (_lruTail < 0) _lruTail = index;
+}
+
+void FlowTable::_remove(int16_t index, FlowExpiryReason reason) {
+  Entry& e = _entries[index];
+  // Fluxos zerados pelo timeout ativo e sem tráfego novo não geram registro
+  if (_callback && e.record.packets > 0) _callback(e.record, reason, _callbackContext);
+
+  // Retira da cadeia do bucket
+  int16_t* link = &_buckets[_hash(e.record.key)];
+  while (*link >= 0 && *link != index) link = &_entries[*link].hashNext;
+  if (*link == index) *link = e.hashNext;
+
+  _lruUnlink(index);
+  e.inUse = false;
+  e.hashNext = _freeHead;
+  _freeHead = index;
+  _activeCount--;
+}
+
+void FlowTable::onFrame(const ParsedFrame& frame, uint32_t nowMs) {
+  if (!frame.hasIpv4) return;
+
+  FlowKey key;
+  memset(&key, 0, sizeof(key));
+  key.srcIp = frame.srcIp;
+  key.dstIp = frame.dstIp;
+  key.proto = frame.ipProto;
+  if (frame.l4Payload != nullptr) {
+    key.srcPort = frame.srcPort;
+    key.dstPort = frame.dstPort;
+  }
+
+  uint32_t bucket = _hash(key);
+  int16_t index = _buckets[bucket];
+  while (index >= 0 && !_sameKey(_entries[index].record.key, key)) {
+    index = _entries[index].hashNext;
+  }
+
+  if (index < 0) {
+    if (_freeHead < 0) {
+      // Tabela cheia: expulsa o fluxo menos recentemente usado
+      _evictions++;
+      _remove(_lruTail, FLOW_EXPIRED_EVICTED);
+    }
+    index = _freeHead;
+    Entry& e = _entries[index];
+    _freeHead = e.hashNext;
+    memset(&e.record, 0, sizeof(e.record));
+    e.record.key = key;
+    e.record.firstMs = nowMs;
+    e.inUse = true;
+    e.hashNext = _buckets[bucket];
+    _buckets[bucket] = index;
+    _activeCount++;
+  } else {
+    _lruUnlink(index);
+  }
+  _lruPushFront(index);
+
+  FlowRecord& record = _entries[index].record;
+  record.packets++;
+  record.bytes += frame.ipTotalLength;
+  record.lastMs = nowMs;
+  if (frame.ipProto == IP_PROTO_TCP) record.tcpFlags |= frame.tcpFlags;
+}
+
+void FlowTable::expire(uint32_t nowMs) {
+  // Timeout ocioso: a cauda da LRU é sempre o fluxo parado há mais tempo
+  while (_lruTail >= 0 && nowMs - _entries[_lruTail].record.lastMs > _idleTimeoutMs) {
+    _remove(_lruTail, FLOW_EXPIRED_IDLE);
+  }
+
+  // Timeout ativo: fluxos longos são exportados e recomeçam a contagem
+  for (int16_t i = 0; i < FLOW_TABLE_SIZE; i++) {
+    Entry& e = _entries[i];
+    if (!e.inUse || nowMs - e.record.firstMs <= _activeTimeoutMs) continue;
+    if (_callback && e.record.packets > 0) _callback(e.record, FLOW_EXPIRED_ACTIVE, _callbackContext);
+    e.record.packets = 0;
+    e.record.bytes = 0;
+    e.record.tcpFlags = 0;
+    e.record.firstMs = nowMs;
+  }
+}
+
+void FlowTable::flushAll() {
+  while (_lruTail >= 0) {
+    _remove(_lruTail, FLOW_EXPIRED_FLUSH);
+  }
+}
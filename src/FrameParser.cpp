@@ -0,0 +1,106 @@
+#include "FrameParser.h"
+#include <cstring>
+
+static inline uint16_t readBe16(const uint8_t* p) {
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t readBe32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// Decodifica IPv4 + TCP/UDP a partir do início do cabeçalho IP
+static void parseIpv4(const uint8_t* ip, int available, ParsedFrame& out) {
+  if (available < 20 || (ip[0] >> 4) != 4) return;
+  int ihl = (ip[0] & 0x0F) * 4;
+  int totalLength = readBe16(ip + 2);
+  if (ihl < 20 || totalLength < ihl) return;
+  out.ipTotalLength = (uint16_t)totalLength;
+  // O payload IP termina no total_length, nunca no FCS nem no fim do buffer
+  if (totalLength > available) totalLength = available;
+
+  out.hasIpv4 = true;
+  out.ipProto = ip[9];
+  out.srcIp = readBe32(ip + 12);
+  out.dstIp = readBe32(ip + 16);
+
+  // Fragmentos que não são o primeiro não têm cabeçalho de transporte
+  if ((readBe16(ip + 6) & 0x1FFF) != 0) return;
+
+  const uint8_t* l4 = ip + ihl;
+  int l4Length = totalLength - ihl;
+  if (out.ipProto == IP_PROTO_TCP && l4Length >= 20) {
+    int dataOffset = (l4[12] >> 4) * 4;
+    if (dataOffset < 20 || dataOffset > l4Length) return;
+    out.srcPort = readBe16(l4);
+    out.dstPort = readBe16(l4 + 2);
+    out.tcpSeq = readBe32(l4 + 4);
+    out.tcpAck = readBe32(l4 + 8);
+    out.tcpFlags = l4[13];
+    out.l4Payload = l4 + dataOffset;
+    out.l4PayloadLength = (uint16_t)(l4Length - dataOffset);
+  } else if (out.ipProto == IP_PROTO_UDP && l4Length >= 8) {
+    out.srcPort = readBe16(l4);
+    out.dstPort = readBe16(l4 + 2);
+    out.l4Payload = l4 + 8;
+    out.l4PayloadLength = (uint16_t)(l4Length - 8);
+  }
+}
+
+bool parseWifiFrame(const uint8_t* data, uint16_t capturedLength, uint16_t length, ParsedFrame& out) {
+  uint32_t timestampUs = out.timestampUs;
+  uint32_t uptimeMs = out.uptimeMs;
+  int8_t rssi = out.rssi;
+  uint8_t channel = out.channel;
+  memset(&out, 0, sizeof(out));
+  out.timestampUs = timestampUs;
+  out.uptimeMs = uptimeMs;
+  out.rssi = rssi;
+  out.channel = channel;
+  out.data = data;
+  out.length = length;
+  out.capturedLength = capturedLength;
+
+  if (capturedLength < 24) return false;
+
+  uint8_t fc0 = data[0];
+  uint8_t type = (fc0 >> 2) & 0x03;
+  uint8_t subtype = (fc0 >> 4) & 0x0F;
+  out.fcFlags = data[1];
+  out.transmitter = data + 10;
+
+  // Só quadros de dados interessam (o filtro do hardware já garante isso)
+  if (type != 2) return true;
+
+  bool toDs = out.fcFlags & WIFI_FC_TO_DS;
+  bool fromDs = out.fcFlags & WIFI_FC_FROM_DS;
+  bool isQos = subtype & 0x08;
+  int headerLength = 24;
+  if (toDs && fromDs) headerLength += 6;
+  if (isQos) headerLength += 2;
+  // Campo HT Control presente quando o bit Order está ligado em quadros QoS
+  if (isQos && (out.fcFlags & 0x80)) headerLength += 4;
+  if (capturedLength < headerLength) return false;
+
+  if (!toDs && !fromDs) {
+    out.dstMac = data + 4; out.srcMac = data + 10; out.bssid = data + 16;
+  } else if (toDs && !fromDs) {
+    out.bssid = data + 4; out.srcMac = data + 10; out.dstMac = data + 16;
+  } else if (!toDs && fromDs) {
+    out.dstMac = data + 4; out.bssid = data + 10; out.srcMac = data + 16;
+  } else {
+    out.dstMac = data + 16; out.srcMac = data + 24; out.bssid = nullptr;
+  }
+
+  // Null data (subtipos com o bit 2 ligado) não têm corpo; corpo protegido é ilegível
+  if ((subtype & 0x04) || out.isProtected()) return true;
+
+  // LLC/SNAP: AA AA 03 00 00 00 + EtherType
+  const uint8_t* llc = data + headerLength;
+  int available = capturedLength - headerLength;
+  if (available < 8 || llc[0] != 0xAA || llc[1] != 0xAA || llc[2] != 0x03) return true;
+  if (readBe16(llc + 6) == 0x0800) {
+    parseIpv4(llc + 8, available - 8, out);
+  }
+  return true;
+}
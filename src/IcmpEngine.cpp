@@ -0,0 +1,231 @@
+#include "IcmpEngine.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "lwip/sockets.h"
+static uint16_t randomId() { return (uint16_t)esp_random(); }
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <random>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+static uint16_t randomId() { return (uint16_t)std::random_device()(); }
+#endif
+
+static const char* TAG = "IcmpEngine";
+
+#define ICMP_DEFAULT_TTL 64  // IP_DEFAULT_TTL do lwIP
+
+static inline uint32_t nowUs() {
+  return (uint32_t)esp_timer_get_time();
+}
+
+static uint16_t checksum(const uint8_t* data, size_t length) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i + 1 < length; i += 2) sum += (uint32_t)(data[i] << 8 | data[i + 1]);
+  if (length & 1) sum += (uint32_t)data[length - 1] << 8;
+  while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+  return (uint16_t)~sum;
+}
+
+IcmpEngine::IcmpEngine() {
+  _id = randomId();
+  memset(_echoes, 0, sizeof(_echoes));
+}
+
+IcmpEngine::~IcmpEngine() {
+  close();
+}
+
+bool IcmpEngine::open() {
+  if (_fd >= 0) return true;
+  _fd = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+  if (_fd < 0) {
+    ESP_LOGW(TAG, "Sem socket ICMP (errno %d).", errno);
+    return false;
+  }
+  int flags = fcntl(_fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(_fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void IcmpEngine::close() {
+  if (_fd >= 0) ::close(_fd);
+  _fd = -1;
+  memset(_echoes, 0, sizeof(_echoes));
+  _outstanding = 0;
+}
+
+bool IcmpEngine::send(uint32_t ip, uint16_t tag, uint32_t now, uint8_t ttl) {
+  if (_fd < 0) return false;
+  // Próxima sequência cuja posição está livre (um eco lento não trava as
+  // demais); todas ocupadas: tabela cheia
+  uint16_t sequence = _sequence;
+  Echo* slot = nullptr;
+  for (size_t i = 0; i < ICMP_MAX_OUTSTANDING && slot == nullptr; i++) {
+    sequence++;
+    if (!_echoes[sequence % ICMP_MAX_OUTSTANDING].used) slot = &_echoes[sequence % ICMP_MAX_OUTSTANDING];
+  }
+  if (slot == nullptr) return false;
+  Echo& echo = *slot;
+
+  uint8_t packet[16] = { 8, 0, 0, 0, (uint8_t)(_id >> 8), (uint8_t)_id, (uint8_t)(sequence >> 8), (uint8_t)sequence };
+  memcpy(packet + 8, "watchdog", 8);
+  uint16_t sum = checksum(packet, sizeof(packet));
+  packet[2] = (uint8_t)(sum >> 8);
+  packet[3] = (uint8_t)sum;
+
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = ip;
+  // O TTL vale para o socket: volta ao padrão logo depois do envio
+  int socketTtl = ttl;
+  if (ttl != 0 && setsockopt(_fd, IPPROTO_IP, IP_TTL, &socketTtl, sizeof(socketTtl)) != 0) return false;
+  bool sent = sendto(_fd, packet, sizeof(packet), 0, (sockaddr*)&address, sizeof(address)) >= 0;
+  if (ttl != 0) {
+    socketTtl = ICMP_DEFAULT_TTL;
+    setsockopt(_fd, IPPROTO_IP, IP_TTL, &socketTtl, sizeof(socketTtl));
+  }
+  if (!sent) return false;
+
+  _sequence = sequence;
+  echo.ip = ip;
+  echo.sentUs = now;
+  echo.sequence = sequence;
+  echo.tag = tag;
+  echo.used = true;
+  _outstanding++;
+  return true;
+}
+
+void IcmpEngine::receive(uint32_t now, IcmpEchoHandler handler, void* context) {
+  if (_fd < 0) return;
+  uint8_t buffer[128];
+  sockaddr_in from;
+  socklen_t fromLength = sizeof(from);
+  ssize_t received;
+  while ((received = recvfrom(_fd, buffer, sizeof(buffer), 0, (sockaddr*)&from, &fromLength)) > 0) {
+    fromLength = sizeof(from);
+    // O socket raw entrega o cabeçalho IP junto
+    size_t ipHeader = (buffer[0] & 0x0F) * 4;
+    if ((size_t)received < ipHeader + 8) continue;
+    const uint8_t* icmp = buffer + ipHeader;
+    // Echo Reply vem do alvo; Time Exceeded traz o cabeçalho IP e os 8 primeiros bytes do eco
+    const uint8_t* echoHeader = icmp;
+    uint32_t target = from.sin_addr.s_addr;
+    if (icmp[0] == 11) {
+      const uint8_t* inner = icmp + 8;
+      size_t innerHeader = (inner[0] & 0x0F) * 4;
+      if ((size_t)received < ipHeader + 8 + innerHeader + 8) continue;
+      memcpy(&target, inner + 16, 4);
+      echoHeader = inner + innerHeader;
+      if (echoHeader[0] != 8) continue;
+    } else if (icmp[0] != 0) {
+      continue;
+    }
+    uint16_t id = (uint16_t)(echoHeader[4] << 8 | echoHeader[5]);
+    uint16_t sequence = (uint16_t)(echoHeader[6] << 8 | echoHeader[7]);
+    if (id != _id) continue;
+
+    Echo& echo = _echoes[sequence % ICMP_MAX_OUTSTANDING];
+    // Resposta duplicada, atrasada além do expire() ou de um eco para outro endereço
+    if (!echo.used || echo.sequence != sequence || echo.ip != target) continue;
+    echo.used = false;
+    _outstanding--;
+    handler(context, echo.tag, from.sin_addr.s_addr, (int32_t)std::min<uint32_t>(now - echo.sentUs, INT32_MAX));
+  }
+}
+
+uint32_t IcmpEngine::expire(uint32_t now, uint32_t timeoutUs, IcmpEchoHandler handler, void* context) {
+  uint32_t next = timeoutUs;
+  for (size_t i = 0; i < ICMP_MAX_OUTSTANDING && _outstanding > 0; i++) {
+    Echo& echo = _echoes[i];
+    if (!echo.used) continue;
+    uint32_t age = now - echo.sentUs;
+    if (age < timeoutUs) {
+      next = std::min(next, timeoutUs - age);
+      continue;
+    }
+    echo.used = false;
+    _outstanding--;
+    handler(context, echo.tag, echo.ip, -1);
+  }
+  return next;
+}
+
+void IcmpEngine::_onSweepEcho(void* context, uint16_t tag, uint32_t, int32_t rttUs) {
+  IcmpEngine* engine = static_cast<IcmpEngine*>(context);
+  SweepTarget& target = engine->_sweepTargets[tag];
+  IcmpTargetResult& result = target.result;
+  if (rttUs >= 0) {
+    uint32_t rtt = (uint32_t)rttUs;
+    result.rttMinUs = result.received ? std::min(result.rttMinUs, rtt) : rtt;
+    result.rttMaxUs = std::max(result.rttMaxUs, rtt);
+    result.rttSumUs += rtt;
+    result.received++;
+  } else if (!engine->_sweepLastPass) {
+    return;  // A próxima passada tenta de novo
+  }
+  target.done = true;
+  engine->_sweepHandler(engine->_sweepContext, result);
+}
+
+bool IcmpEngine::sweep(const uint32_t* targets, size_t count, uint8_t passes, IcmpTargetHandler handler,
+                       void* context, uint16_t timeoutMs, uint8_t window) {
+  count = std::min<size_t>(count, ICMP_MAX_TARGETS);
+  window = (uint8_t)std::min<size_t>(std::max<uint8_t>(window, 1), ICMP_MAX_OUTSTANDING);
+  if (count == 0 || passes == 0 || !open()) return false;
+  _sweepTargets = (SweepTarget*)calloc(count, sizeof(SweepTarget));
+  if (_sweepTargets == nullptr) {
+    ESP_LOGE(TAG, "Sem memória para varrer %u alvos.", (unsigned)count);
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) _sweepTargets[i].result.ip = targets[i];
+  _sweepHandler = handler;
+  _sweepContext = context;
+
+  uint32_t timeoutUs = (uint32_t)timeoutMs * 1000;
+  for (uint8_t pass = 0; pass < passes; pass++) {
+    _sweepLastPass = pass + 1 == passes;
+    size_t next = 0;
+    while (true) {
+      uint32_t now = nowUs();
+      // Completa a janela com os próximos alvos que ainda não responderam
+      for (; next < count && _outstanding < window; next++) {
+        SweepTarget& target = _sweepTargets[next];
+        if (target.done) continue;
+        target.result.sent++;
+        // Erro de envio (fila do lwIP cheia, sem rota): conta como eco perdido
+        if (!send(targets[next], (uint16_t)next, now)) _onSweepEcho(this, (uint16_t)next, targets[next], -1);
+      }
+      uint32_t waitUs = expire(now, timeoutUs, _onSweepEcho, this);
+      if (_outstanding == 0) {
+        if (next >= count) break;
+        continue;
+      }
+
+      fd_set readable;
+      FD_ZERO(&readable);
+      FD_SET(_fd, &readable);
+      timeval timeout = { (long)(waitUs / 1000000), (long)(waitUs % 1000000) };
+      if (select(_fd + 1, &readable, nullptr, nullptr, &timeout) > 0) receive(nowUs(), _onSweepEcho, this);
+    }
+  }
+  free(_sweepTargets);
+  _sweepTargets = nullptr;
+  _sweepHandler = nullptr;
+  return true;
+}
@@ -0,0 +1,175 @@
+#include "InferenceRuntime.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <cstdlib>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "esp_heap_caps.h"
+#endif
+
+static const char* TAG = "InferenceRuntime";
+
+// Alinhamento da arena (o TFLM exige 16 bytes para os tensores)
+static const size_t ARENA_ALIGN = 16;
+
+InferenceRuntime inferenceRuntime;
+
+uint32_t InferenceProfiler::BeginEvent(const char* tag) {
+  uint32_t handle = _next++;
+  if (handle >= INFERENCE_MAX_OPS) return handle;
+  if (handle >= _opCount) {
+    _ops[handle].tag = tag;
+    _opCount = handle + 1;
+  }
+  _starts[handle] = esp_timer_get_time();
+  return handle;
+}
+
+void InferenceProfiler::EndEvent(uint32_t handle) {
+  if (handle >= INFERENCE_MAX_OPS) return;
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - _starts[handle]);
+  OpStats& op = _ops[handle];
+  op.count++;
+  op.totalUs += elapsed;
+  if (elapsed > op.maxUs) op.maxUs = elapsed;
+}
+
+InferenceRuntime::InferenceRuntime() {
+  for (Slot& slot : _slots) {
+    slot.model = nullptr;
+    slot.invocations = 0;
+    slot.totalUs = 0;
+    slot.maxUs = 0;
+  }
+}
+
+bool InferenceRuntime::registerModel(InferenceModel* model) {
+  if (_slotOf(model) >= 0) return true;
+  if (_count >= INFERENCE_MAX_MODELS) {
+    ESP_LOGE(TAG, "Modelo '%s' recusado: limite de %d modelos.", model->modelName(), INFERENCE_MAX_MODELS);
+    return false;
+  }
+  if (isStarted() && model->arenaBytes() > _arenaSize) {
+    ESP_LOGE(TAG, "Modelo '%s' recusado: precisa de %u B e a arena já foi planejada com %u B.", model->modelName(),
+             (unsigned)model->arenaBytes(), (unsigned)_arenaSize);
+    return false;
+  }
+  _slots[_count++].model = model;
+  return true;
+}
+
+size_t InferenceRuntime::separateArenaBytes() const {
+  size_t total = 0;
+  for (size_t i = 0; i < _count; i++) total += _slots[i].model->arenaBytes();
+  return total;
+}
+
+int InferenceRuntime::_slotOf(const InferenceModel* model) const {
+  for (size_t i = 0; i < _count; i++) {
+    if (_slots[i].model == model) return (int)i;
+  }
+  return -1;
+}
+
+InferenceRuntime::ModelStats InferenceRuntime::stats(size_t index) const {
+  const Slot& slot = _slots[index];
+  return { slot.model, slot.invocations, slot.totalUs, slot.maxUs, &slot.profiler };
+}
+
+bool InferenceRuntime::_execute(int slot, const float* in, float* out, int n) {
+  Slot& s = _slots[slot];
+  if (_owner != slot) {
+    if (!s.model->prepare(_arena, _arenaSize)) {
+      ESP_LOGE(TAG, "Falha ao preparar '%s' na arena.", s.model->modelName());
+      _owner = -1;
+      return false;
+    }
+    _owner = slot;
+  }
+  s.profiler.ClearEvents();
+  int64_t start = esp_timer_get_time();
+  bool ok = s.model->invoke(_arena, in, out, n, s.profiler);
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+  s.invocations++;
+  s.totalUs += elapsed;
+  if (elapsed > s.maxUs) s.maxUs = elapsed;
+  return ok;
+}
+
+#ifdef ARDUINO
+struct InferenceJob {
+  int slot;
+  const float* in;
+  float* out;
+  int n;
+  TaskHandle_t caller;
+  bool* ok;
+};
+
+bool InferenceRuntime::begin() {
+  if (isStarted()) return true;
+  size_t needed = 0;
+  for (size_t i = 0; i < _count; i++) {
+    if (_slots[i].model->arenaBytes() > needed) needed = _slots[i].model->arenaBytes();
+  }
+  needed = (needed + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+  uint8_t* raw = (uint8_t*)heap_caps_malloc(needed + ARENA_ALIGN, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  QueueHandle_t jobs = xQueueCreate(4, sizeof(InferenceJob));
+  if (raw == nullptr || jobs == nullptr) {
+    ESP_LOGE(TAG, "Sem memória para a arena de %u B.", (unsigned)needed);
+    return false;
+  }
+  _arena = (uint8_t*)(((uintptr_t)raw + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1));
+  _arenaSize = needed;
+  _jobs = jobs;
+  // Prioridade mínima: roda enquanto quem pediu a inferência espera
+  xTaskCreate(_task, "Inference Task", 6144, this, 1, NULL);
+
+  ESP_LOGI(TAG, "Arena compartilhada de %u B para %u modelos (arenas separadas somariam %u B):", (unsigned)_arenaSize,
+           (unsigned)_count, (unsigned)separateArenaBytes());
+  for (size_t i = 0; i < _count; i++) {
+    ESP_LOGI(TAG, "  %s: %u B", _slots[i].model->modelName(), (unsigned)_slots[i].model->arenaBytes());
+  }
+  return true;
+}
+
+void InferenceRuntime::_task(void* parameter) {
+  InferenceRuntime* runtime = static_cast<InferenceRuntime*>(parameter);
+  InferenceJob job;
+  for (;;) {
+    if (xQueueReceive((QueueHandle_t)runtime->_jobs, &job, portMAX_DELAY) != pdTRUE) continue;
+    *job.ok = runtime->_execute(job.slot, job.in, job.out, job.n);
+    xTaskNotifyGive(job.caller);
+  }
+}
+
+bool InferenceRuntime::run(InferenceModel* model, const float* in, float* out, int n) {
+  if (!isStarted() && !begin()) return false;
+  int slot = _slotOf(model);
+  if (slot < 0) return false;
+  bool ok = false;
+  InferenceJob job = { slot, in, out, n, xTaskGetCurrentTaskHandle(), &ok };
+  if (xQueueSend((QueueHandle_t)_jobs, &job, portMAX_DELAY) != pdTRUE) return false;
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  return ok;
+}
+#else
+bool InferenceRuntime::begin() {
+  if (isStarted()) return true;
+  size_t needed = ARENA_ALIGN;
+  for (size_t i = 0; i < _count; i++) {
+    if (_slots[i].model->arenaBytes() > needed) needed = _slots[i].model->arenaBytes();
+  }
+  needed = (needed + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+  _arena = static_cast<uint8_t*>(std::aligned_alloc(ARENA_ALIGN, needed));
+  _arenaSize = needed;
+  return _arena != nullptr;
+}
+
+bool InferenceRuntime::run(InferenceModel* model, const float* in, float* out, int n) {
+  if (!isStarted() && !begin()) return false;
+  int slot = _slotOf(model);
+  return slot >= 0 && _execute(slot, in, out, n);
+}
+#endif
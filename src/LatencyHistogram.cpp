@@ -0,0 +1,197 @@
+#include "LatencyHistogram.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "freertos/semphr.h"
+#endif
+
+static const char* TAG = "LatencyHistogram";
+
+static_assert(LATENCY_SUB_BUCKET_BITS >= 1 && LATENCY_SUB_BUCKET_BITS < LATENCY_RANGE_BITS, "baldes por oitava");
+static_assert(LATENCY_MAX_TARGETS < 256, "alvos indexados em um byte");
+
+#define SUB_BUCKETS (1u << LATENCY_SUB_BUCKET_BITS)
+
+static inline uint16_t addSaturated(uint16_t a, uint32_t b) {
+  return (uint16_t)std::min<uint32_t>(a + b, 0xFFFF);
+}
+
+static inline uint16_t tenthsOfMs(uint32_t us) {
+  return (uint16_t)std::min<uint32_t>((us + 50) / 100, 0xFFFF);
+}
+
+size_t LatencyHistogram::bucketOf(uint32_t us) {
+  if (us < SUB_BUCKETS) return us;
+  if (us >> LATENCY_RANGE_BITS) return LATENCY_BUCKETS - 1;
+  int exponent = 31 - __builtin_clz(us);
+  int shift = exponent - LATENCY_SUB_BUCKET_BITS;
+  return ((size_t)(shift + 1) << LATENCY_SUB_BUCKET_BITS) + ((us >> shift) - SUB_BUCKETS);
+}
+
+uint32_t LatencyHistogram::bucketLow(size_t bucket) {
+  if (bucket < SUB_BUCKETS) return (uint32_t)bucket;
+  size_t group = bucket >> LATENCY_SUB_BUCKET_BITS;
+  return (uint32_t)(SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << (group - 1);
+}
+
+uint32_t LatencyHistogram::bucketWidth(size_t bucket) {
+  if (bucket < SUB_BUCKETS) return 1;
+  return 1u << ((bucket >> LATENCY_SUB_BUCKET_BITS) - 1);
+}
+
+void LatencyHistogram::clear() {
+  memset(this, 0, sizeof(*this));
+}
+
+void LatencyHistogram::add(uint32_t rttUs) {
+  size_t bucket = bucketOf(rttUs);
+  counts[bucket] = addSaturated(counts[bucket], 1);
+  samples = addSaturated(samples, 1);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) counts[i] = addSaturated(counts[i], other.counts[i]);
+  samples = addSaturated(samples, other.samples);
+  lost = addSaturated(lost, other.lost);
+  jitterSumUs += other.jitterSumUs;
+  jitterCount = addSaturated(jitterCount, other.jitterCount);
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t pct) const {
+  if (samples == 0) return 0;
+  // Posto da resposta procurada (1..samples), arredondado para cima
+  uint32_t rank = std::max<uint32_t>(((uint32_t)samples * pct + 99) / 100, 1);
+  uint32_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += counts[i];
+    if (seen >= rank) return bucketLow(i) + bucketWidth(i) / 2;
+  }
+  return bucketLow(LATENCY_BUCKETS - 1);
+}
+
+uint8_t LatencyHistogram::lossPct() const {
+  uint32_t total = (uint32_t)samples + lost;
+  return total ? (uint8_t)(100 * lost / total) : 0;
+}
+
+LatencyStore::LatencyStore() {}
+
+void LatencyStore::setup() {
+#ifdef ARDUINO
+  _mutex = xSemaphoreCreateMutex();
+#endif
+  ESP_LOGI(TAG, "Histogramas de latência: até %u alvos, %u baldes (erro < %.2f%%), %u B por alvo.",
+           (unsigned)LATENCY_MAX_TARGETS, (unsigned)LATENCY_BUCKETS, 100.0 / (2 * SUB_BUCKETS),
+           (unsigned)sizeof(LatencyTarget));
+}
+
+void LatencyStore::_lock() const {
+#ifdef ARDUINO
+  if (_mutex) xSemaphoreTake((SemaphoreHandle_t)_mutex, portMAX_DELAY);
+#endif
+}
+
+void LatencyStore::_unlock() const {
+#ifdef ARDUINO
+  if (_mutex) xSemaphoreGive((SemaphoreHandle_t)_mutex);
+#endif
+}
+
+LatencySummary LatencyStore::summarize(const LatencyHistogram& histogram, uint32_t start, uint8_t flags) {
+  LatencySummary summary;
+  summary.start = start;
+  summary.p50 = tenthsOfMs(histogram.percentile(50));
+  summary.p90 = tenthsOfMs(histogram.percentile(90));
+  summary.p99 = tenthsOfMs(histogram.percentile(99));
+  summary.jitter = tenthsOfMs(histogram.jitterUs());
+  summary.samples = histogram.samples;
+  summary.lossPct = histogram.lossPct();
+  summary.flags = flags;
+  return summary;
+}
+
+// Fecha o minuto (e a hora) em que 'now' já não cabe; janela vazia não gera resumo
+void LatencyStore::_advance(LatencyTarget& target, uint32_t now) {
+  bool epoch = now > 1600000000;  // Relógio acertado pelo SNTP
+  uint8_t flags = epoch ? LATENCY_FLAG_EPOCH : 0;
+  // O relógio acertou no meio da janela: os inícios antigos não servem mais de referência
+  bool clockChanged = (target.flags & LATENCY_FLAG_EPOCH) != flags;
+
+  if (clockChanged || now / 60 != target.minuteStart / 60) {
+    if (target.minute.samples + target.minute.lost > 0) {
+      target.minutes[target.minuteTotal++ % LATENCY_MINUTES] =
+          summarize(target.minute, target.minuteStart, target.flags);
+      target.hour.merge(target.minute);
+    }
+    target.minute.clear();
+    target.minuteStart = now - now % 60;
+  }
+  if (clockChanged || now / 3600 != target.hourStart / 3600) {
+    if (target.hour.samples + target.hour.lost > 0) {
+      target.hours[target.hourTotal++ % LATENCY_HOURS] = summarize(target.hour, target.hourStart, target.flags);
+    }
+    target.hour.clear();
+    target.hourStart = now - now % 3600;
+  }
+  target.flags = flags;
+}
+
+LatencyTarget* LatencyStore::_find(uint8_t kind, uint32_t ip, uint32_t now) {
+  for (size_t i = 0; i < _count; i++) {
+    if (_targets[i].kind == kind && _targets[i].ip == ip) return &_targets[i];
+  }
+  LatencyTarget* target;
+  if (_count < LATENCY_MAX_TARGETS) {
+    target = &_targets[_count++];
+  } else {
+    target = &_targets[0];
+    for (size_t i = 1; i < _count; i++) {
+      if (_targets[i].lastSeen < target->lastSeen) target = &_targets[i];
+    }
+    ESP_LOGW(TAG, "Tabela de latência cheia: alvo %u/%08x substituído.", target->kind, (unsigned)target->ip);
+  }
+  memset(target, 0, sizeof(*target));
+  target->kind = kind;
+  target->ip = ip;
+  target->flags = now > 1600000000 ? LATENCY_FLAG_EPOCH : 0;
+  target->minuteStart = now - now % 60;
+  target->hourStart = now - now % 3600;
+  return target;
+}
+
+void LatencyStore::record(uint8_t kind, uint32_t ip, bool ok, uint32_t rttUs, uint32_t now) {
+  _lock();
+  LatencyTarget* target = _find(kind, ip, now);
+  _advance(*target, now);
+  target->lastSeen = ++_sequence;
+  LatencyHistogram& minute = target->minute;
+  if (ok) {
+    minute.add(rttUs);
+    if (target->lastRttUs != 0) {
+      minute.jitterSumUs += (uint32_t)std::abs((int32_t)(rttUs - target->lastRttUs));
+      minute.jitterCount = addSaturated(minute.jitterCount, 1);
+    }
+    target->lastRttUs = std::max<uint32_t>(rttUs, 1);
+  } else {
+    minute.lost = addSaturated(minute.lost, 1);
+    target->lastRttUs = 0;
+  }
+  _unlock();
+}
+
+void LatencyStore::advance(uint32_t now) {
+  _lock();
+  for (size_t i = 0; i < _count; i++) _advance(_targets[i], now);
+  _unlock();
+}
+
+bool LatencyStore::snapshot(size_t i, LatencyTarget* out) const {
+  _lock();
+  bool found = i < _count;
+  if (found) *out = _targets[i];
+  _unlock();
+  return found;
+}
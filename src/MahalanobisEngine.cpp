@@ -0,0 +1,148 @@
+#include "MahalanobisEngine.h"
+#include "esp_log.h"
+#include <cmath>
+#include <cstring>
+
+static const char* TAG = "MahalanobisEngine";
+
+// Frequência de gravação do estado no NVS
+static const uint32_t SAVE_EVERY_WINDOWS = 15;
+#ifdef ARDUINO
+#include <Preferences.h>
+#include "NvsState.h"
+static const char* STATE_NAMESPACE = "anomaly-maha";
+static const char* STATE_KEY = "state";
+#endif
+
+static const int F = MAHALANOBIS_FEATURES;
+
+MahalanobisEngine::MahalanobisEngine() {
+  reset();
+}
+
+void MahalanobisEngine::reset() {
+  memset(&_state, 0, sizeof(_state));
+  _state.version = MAHALANOBIS_STATE_VERSION;
+}
+
+bool MahalanobisEngine::begin() {
+  _load();
+  ESP_LOGI(TAG, "Engine Mahalanobis inicializada (%u bytes de estado, %u janelas aprendidas).",
+           (unsigned)sizeof(State), (unsigned)_state.windows);
+  return true;
+}
+
+float MahalanobisEngine::_distance2(const float* diff) const {
+  // Cholesky L·Lᵀ = cov + piso·I; depois L·y = diff e d² = |y|²
+  float l[F][F];
+  for (int i = 0; i < F; i++) {
+    for (int j = 0; j <= i; j++) {
+      float sum = _state.cov[i][j] + (i == j ? MAHALANOBIS_VARIANCE_FLOOR : 0.0f);
+      for (int k = 0; k < j; k++) sum -= l[i][k] * l[j][k];
+      if (i == j) {
+        l[i][i] = sqrtf(sum > MAHALANOBIS_VARIANCE_FLOOR ? sum : MAHALANOBIS_VARIANCE_FLOOR);
+      } else {
+        l[i][j] = sum / l[j][j];
+      }
+    }
+  }
+  float d2 = 0.0f;
+  float y[F];
+  for (int i = 0; i < F; i++) {
+    float sum = diff[i];
+    for (int k = 0; k < i; k++) sum -= l[i][k] * y[k];
+    y[i] = sum / l[i][i];
+    d2 += y[i] * y[i];
+  }
+  return d2;
+}
+
+bool MahalanobisEngine::evaluate(const FeatureVector& features, AnomalyScore* result) {
+  float x[F];
+  for (int i = 0; i < F; i++) x[i] = log1pf(features[i] > 0.0f ? features[i] : 0.0f);
+
+  bool wasWarm = isWarm();
+  float threshold = this->threshold();
+  float diff[F];
+  for (int i = 0; i < F; i++) diff[i] = x[i] - _state.mean[i];
+  float score = (_state.windows == 0) ? 0.0f : _distance2(diff) / F;
+  bool anomaly = wasWarm && score > threshold;
+
+  result->score = score;
+  result->threshold = threshold;
+  result->warm = wasWarm;
+  result->anomalous = anomaly;
+
+  _state.windows++;
+  // No aquecimento as médias são aritméticas; depois passam a exponenciais
+  float alpha = 1.0f / _state.windows;
+  if (alpha < MAHALANOBIS_ALPHA) alpha = MAHALANOBIS_ALPHA;
+  if (_state.windows == 1) {
+    memcpy(_state.mean, x, sizeof(x));
+  } else {
+    // Covariância exponencial na forma incremental de West
+    for (int i = 0; i < F; i++) {
+      _state.mean[i] += alpha * diff[i];
+      for (int j = 0; j < F; j++) {
+        _state.cov[i][j] = (1.0f - alpha) * (_state.cov[i][j] + alpha * diff[i] * diff[j]);
+      }
+    }
+    // O escore da segunda janela já usa uma covariância; a primeira não tem
+    if (!anomaly) {
+      float scoreAlpha = 1.0f / (_state.windows - 1);
+      if (scoreAlpha < MAHALANOBIS_SCORE_ALPHA) scoreAlpha = MAHALANOBIS_SCORE_ALPHA;
+      float delta = logf(score + MAHALANOBIS_LOG_EPSILON) - _state.logScoreMean;
+      _state.logScoreMean += scoreAlpha * delta;
+      _state.logScoreVar = (1.0f - scoreAlpha) * (_state.logScoreVar + scoreAlpha * delta * delta);
+    }
+  }
+
+  if (wasWarm) {
+    ESP_LOGI(TAG, "Análise Mahalanobis - Escore: %.3f (Limite: %.3f)", score, threshold);
+  } else {
+    ESP_LOGI(TAG, "Mahalanobis: janela %u de %u (escore %.3f), sem alertas até o fim do aquecimento.",
+             (unsigned)_state.windows, (unsigned)MAHALANOBIS_WARMUP_WINDOWS, score);
+  }
+  if ((isWarm() && !wasWarm) || _state.windows % SAVE_EVERY_WINDOWS == 0) _save();
+  return true;
+}
+
+float MahalanobisEngine::threshold() const {
+  return expf(_state.logScoreMean + MAHALANOBIS_THRESHOLD_SIGMAS * sqrtf(_state.logScoreVar)) - MAHALANOBIS_LOG_EPSILON;
+}
+
+bool MahalanobisEngine::restore(const State& state) {
+  if (state.version != MAHALANOBIS_STATE_VERSION) return false;
+  for (int i = 0; i < F; i++) {
+    if (!std::isfinite(state.mean[i]) || !(state.cov[i][i] >= 0.0f)) return false;
+    for (int j = 0; j < F; j++) {
+      if (!std::isfinite(state.cov[i][j])) return false;
+    }
+  }
+  if (!std::isfinite(state.logScoreMean) || !std::isfinite(state.logScoreVar) || state.logScoreVar < 0.0f) return false;
+  _state = state;
+  return true;
+}
+
+void MahalanobisEngine::_load() {
+#ifdef ARDUINO
+  Preferences preferences;
+  preferences.begin(STATE_NAMESPACE, true, NVS_STATE_PARTITION);
+  static State state;
+  size_t length = preferences.getBytes(STATE_KEY, &state, sizeof(state));
+  preferences.end();
+  if (length == sizeof(state) && restore(state)) return;
+#endif
+  reset();
+}
+
+void MahalanobisEngine::_save() {
+#ifdef ARDUINO
+  Preferences preferences;
+  preferences.begin(STATE_NAMESPACE, false, NVS_STATE_PARTITION);
+  if (preferences.putBytes(STATE_KEY, &_state, sizeof(_state)) != sizeof(_state)) {
+    ESP_LOGW(TAG, "Falha ao gravar o estado no NVS (partição %s cheia?).", NVS_STATE_PARTITION);
+  }
+  preferences.end();
+#endif
+}
@@ -0,0 +1,237 @@
+#include "ModelStore.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cstring>
+
+static const char* TAG = "ModelStore";
+
+ModelStore::ModelStore() {
+  memset(_partitions, 0, sizeof(_partitions));
+  memset(&_view, 0, sizeof(_view));
+  memset(&_expect, 0, sizeof(_expect));
+}
+
+void ModelStore::_failUpload(const char* error) {
+  _uploadError = error;
+  _uploadSlot = -1;
+  ESP_LOGW(TAG, "Upload de modelo recusado: %s", error);
+}
+
+#ifdef ARDUINO
+#include "esp_partition.h"
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION_MAJOR >= 5
+#define MODEL_MMAP_DATA ESP_PARTITION_MMAP_DATA
+#define modelMunmap esp_partition_munmap
+typedef esp_partition_mmap_handle_t ModelMapHandle;
+#else
+#include "esp_spi_flash.h"
+#define MODEL_MMAP_DATA SPI_FLASH_MMAP_DATA
+#define modelMunmap spi_flash_munmap
+typedef spi_flash_mmap_handle_t ModelMapHandle;
+#endif
+
+static const char* SLOT_LABELS[MODEL_STORE_SLOTS] = { "model0", "model1" };
+
+static inline const esp_partition_t* slotPartition(const void* partition) {
+  return static_cast<const esp_partition_t*>(partition);
+}
+
+bool ModelStore::begin(const AnomalyBlobExpect& expect) {
+  _expect = expect;
+  for (int s = 0; s < MODEL_STORE_SLOTS; s++) {
+    _partitions[s] = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SLOT_LABELS[s]);
+    if (_partitions[s] == nullptr) {
+      ESP_LOGW(TAG, "Partição '%s' ausente (ver partitions.csv): usando os pesos compilados.", SLOT_LABELS[s]);
+      return false;
+    }
+  }
+
+  // Primeiro pelo cabeçalho (barato); o CRC do payload é conferido ao mapear
+  bool valid[MODEL_STORE_SLOTS];
+  uint32_t sequence[MODEL_STORE_SLOTS];
+  for (int s = 0; s < MODEL_STORE_SLOTS; s++) {
+    AnomalyBlobHeader header;
+    valid[s] = esp_partition_read(slotPartition(_partitions[s]), 0, &header, sizeof(header)) == ESP_OK &&
+               anomalyBlobCheckHeader(header, expect, nullptr);
+    sequence[s] = valid[s] ? header.sequence : 0;
+  }
+  int order[MODEL_STORE_SLOTS] = { 0, 1 };
+  if (valid[1] && (!valid[0] || sequence[1] > sequence[0])) std::swap(order[0], order[1]);
+
+  for (int slot : order) {
+    if (!valid[slot]) continue;
+    const char* error = nullptr;
+    if (_map(slot, &_view, &_mapHandle, &error)) {
+      _active = slot;
+      ESP_LOGI(TAG, "Modelo do slot %s mapeado da flash (versão %u, sequência %u, limite %.6f).",
+               SLOT_LABELS[slot], (unsigned)_view.modelVersion, (unsigned)_view.sequence, _view.threshold);
+      return true;
+    }
+    ESP_LOGW(TAG, "Slot %s descartado: %s", SLOT_LABELS[slot], error);
+  }
+  ESP_LOGI(TAG, "Nenhum modelo válido nas partições: usando os pesos compilados.");
+  return true;
+}
+
+bool ModelStore::_map(int slot, AnomalyModelView* view, uint32_t* handle, const char** error) {
+  const esp_partition_t* partition = slotPartition(_partitions[slot]);
+  size_t size = anomalyBlobSize(_expect);
+  if (size > partition->size) {
+    *error = "modelo maior que a partição";
+    return false;
+  }
+  const void* data = nullptr;
+  ModelMapHandle mapHandle;
+  if (esp_partition_mmap(partition, 0, size, MODEL_MMAP_DATA, &data, &mapHandle) != ESP_OK) {
+    *error = "falha no esp_partition_mmap";
+    return false;
+  }
+  if (!anomalyBlobParse(static_cast<const uint8_t*>(data), size, _expect, view, error)) {
+    modelMunmap(mapHandle);
+    return false;
+  }
+  *handle = mapHandle;
+  return true;
+}
+
+bool ModelStore::beginUpload(size_t size) {
+  _uploadError = nullptr;
+  _uploadSlot = -1;
+  if (_partitions[0] == nullptr || _partitions[1] == nullptr) {
+    _failUpload("partições de modelo ausentes");
+    return false;
+  }
+  if (_swapPending) {
+    _failUpload("o modelo enviado antes ainda não entrou em uso");
+    return false;
+  }
+  if (size != anomalyBlobSize(_expect)) {
+    _failUpload("tamanho diferente do esperado pela arquitetura compilada");
+    return false;
+  }
+  int slot = (_active == 0) ? 1 : 0;
+  if (size > slotPartition(_partitions[slot])->size) {
+    _failUpload("modelo maior que a partição");
+    return false;
+  }
+  // Apaga já o setor do cabeçalho: o slot fica inválido antes de qualquer escrita
+  if (esp_partition_erase_range(slotPartition(_partitions[slot]), 0, MODEL_STORE_SECTOR) != ESP_OK) {
+    _failUpload("falha ao apagar a flash");
+    return false;
+  }
+  _uploadSlot = slot;
+  _uploadSize = size;
+  _received = 0;
+  _erasedUpTo = MODEL_STORE_SECTOR;
+  ESP_LOGI(TAG, "Recebendo modelo (%u bytes) no slot %s...", (unsigned)size, SLOT_LABELS[slot]);
+  return true;
+}
+
+bool ModelStore::writeUpload(const uint8_t* data, size_t length) {
+  if (_uploadSlot < 0) return false;
+  if (_received + length > _uploadSize) {
+    _failUpload("dados além do tamanho anunciado");
+    return false;
+  }
+  const esp_partition_t* partition = slotPartition(_partitions[_uploadSlot]);
+
+  // O cabeçalho fica na RAM e só vai para a flash no fim
+  size_t headerBytes = 0;
+  if (_received < sizeof(AnomalyBlobHeader)) {
+    headerBytes = std::min(length, sizeof(AnomalyBlobHeader) - _received);
+    memcpy(reinterpret_cast<uint8_t*>(&_uploadHeader) + _received, data, headerBytes);
+  }
+  size_t offset = _received + headerBytes;
+  size_t rest = length - headerBytes;
+  if (rest > 0) {
+    while (_erasedUpTo < offset + rest) {
+      if (esp_partition_erase_range(partition, _erasedUpTo, MODEL_STORE_SECTOR) != ESP_OK) {
+        _failUpload("falha ao apagar a flash");
+        return false;
+      }
+      _erasedUpTo += MODEL_STORE_SECTOR;
+    }
+    if (esp_partition_write(partition, offset, data + headerBytes, rest) != ESP_OK) {
+      _failUpload("falha ao gravar a flash");
+      return false;
+    }
+  }
+  _received += length;
+  return true;
+}
+
+bool ModelStore::finishUpload() {
+  if (_uploadSlot < 0) return false;
+  if (_received != _uploadSize) {
+    _failUpload("upload incompleto");
+    return false;
+  }
+  const char* error = nullptr;
+  if (!anomalyBlobCheckHeader(_uploadHeader, _expect, &error)) {
+    _failUpload(error);
+    return false;
+  }
+
+  // O firmware numera: o slot gravado passa a ser o mais recente
+  int slot = _uploadSlot;
+  const esp_partition_t* partition = slotPartition(_partitions[slot]);
+  _uploadHeader.sequence = (_active >= 0 ? _view.sequence : 0) + 1;
+  anomalyBlobSealHeader(&_uploadHeader);
+  if (esp_partition_write(partition, 0, &_uploadHeader, sizeof(_uploadHeader)) != ESP_OK) {
+    _failUpload("falha ao gravar o cabeçalho");
+    return false;
+  }
+
+  // Confere o que ficou na flash, inclusive o CRC do payload, pelo próprio mapeamento
+  if (!_map(slot, &_pendingView, &_pendingHandle, &error)) {
+    esp_partition_erase_range(partition, 0, MODEL_STORE_SECTOR);
+    _failUpload(error);
+    return false;
+  }
+  _uploadSlot = -1;
+  _pendingSlot = slot;
+  _swapPending = true;
+  ESP_LOGI(TAG, "Modelo gravado no slot %s (versão %u, sequência %u); troca na próxima janela.",
+           SLOT_LABELS[slot], (unsigned)_pendingView.modelVersion, (unsigned)_pendingView.sequence);
+  return true;
+}
+
+bool ModelStore::takeUploaded(AnomalyModelView* view) {
+  if (!_swapPending) return false;
+  if (_active >= 0) modelMunmap(_mapHandle);
+  _active = _pendingSlot;
+  _view = _pendingView;
+  _mapHandle = _pendingHandle;
+  _swapPending = false;
+  *view = _view;
+  return true;
+}
+#else
+// No PC não há partições: o detector usa sempre os pesos compilados
+bool ModelStore::begin(const AnomalyBlobExpect& expect) {
+  _expect = expect;
+  return false;
+}
+
+bool ModelStore::beginUpload(size_t) {
+  _failUpload("partições de modelo ausentes");
+  return false;
+}
+
+bool ModelStore::writeUpload(const uint8_t*, size_t) {
+  return false;
+}
+
+bool ModelStore::finishUpload() {
+  return false;
+}
+
+bool ModelStore::takeUploaded(AnomalyModelView*) {
+  return false;
+}
+
+bool ModelStore::_map(int, AnomalyModelView*, uint32_t*, const char**) {
+  return false;
+}
+#endif
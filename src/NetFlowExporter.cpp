@@ -0,0 +1,156 @@
+#include "NetFlowExporter.h"
+#include <WiFi.h>
+#include <time.h>
+#include "esp_log.h"
+
+static const char* TAG_NF = "NetFlowExporter";
+
+// Campos do template (tipo, tamanho) conforme RFC 3954, seção 8
+static const uint16_t TEMPLATE_FIELDS[][2] = {
+  {8, 4},   // IPV4_SRC_ADDR
+  {12, 4},  // IPV4_DST_ADDR
+  {7, 2},   // L4_SRC_PORT
+  {11, 2},  // L4_DST_PORT
+  {4, 1},   // PROTOCOL
+  {6, 1},   // TCP_FLAGS
+  {2, 4},   // IN_PKTS
+  {1, 4},   // IN_BYTES
+  {22, 4},  // FIRST_SWITCHED
+  {21, 4},  // LAST_SWITCHED
+};
+static const size_t TEMPLATE_FIELD_COUNT = sizeof(TEMPLATE_FIELDS) / sizeof(TEMPLATE_FIELDS[0]);
+static const size_t RECORD_LENGTH = 30;
+static const size_t HEADER_LENGTH = 20;
+static const size_t TEMPLATE_FLOWSET_LENGTH = 8 + TEMPLATE_FIELD_COUNT * 4;
+static const size_t MAX_DATAGRAM_LENGTH = HEADER_LENGTH + TEMPLATE_FLOWSET_LENGTH + 4 + NETFLOW_RECORDS_PER_DATAGRAM * RECORD_LENGTH + 3;
+
+static inline uint8_t* put16(uint8_t* p, uint16_t v) {
+  p[0] = v >> 8; p[1] = v;
+  return p + 2;
+}
+
+static inline uint8_t* put32(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+  return p + 4;
+}
+
+NetFlowExporter::NetFlowExporter() {
+  _port = 0;
+  _mutex = NULL;
+  _pendingHead = 0;
+  _pendingCount = 0;
+  _sequence = 0;
+  _dropped = 0;
+}
+
+void NetFlowExporter::setup() {
+  _mutex = xSemaphoreCreateMutex();
+}
+
+void NetFlowExporter::setCollector(const char* host, uint16_t port) {
+  _host = host;
+  _port = port;
+  if (isEnabled()) {
+    ESP_LOGI(TAG_NF, "Exportação NetFlow v9 para %s:%u (%d fluxos por datagrama).", _host.c_str(), _port, NETFLOW_RECORDS_PER_DATAGRAM);
+  } else {
+    ESP_LOGI(TAG_NF, "Exportação NetFlow desativada (nenhum coletor configurado).");
+  }
+}
+
+void NetFlowExporter::enqueue(const FlowRecord& record) {
+  if (!isEnabled() || _mutex == NULL) return;
+  if (xSemaphoreTake(_mutex, 0) != pdTRUE) {
+    _dropped++;
+    return;
+  }
+  if (_pendingCount < NETFLOW_MAX_PENDING) {
+    _pending[(_pendingHead + _pendingCount) % NETFLOW_MAX_PENDING] = record;
+    _pendingCount++;
+  } else {
+    _dropped++;
+  }
+  xSemaphoreGive(_mutex);
+}
+
+size_t NetFlowExporter::encodeDatagram(const FlowRecord* records, size_t count, uint32_t sysUptimeMs,
+                                       uint32_t unixSecs, uint32_t sequence, uint32_t sourceId,
+                                       uint8_t* out, size_t outSize) {
+  size_t dataLength = 4 + count * RECORD_LENGTH;
+  size_t padding = (4 - (dataLength % 4)) % 4;
+  size_t total = HEADER_LENGTH + TEMPLATE_FLOWSET_LENGTH + dataLength + padding;
+  if (total > outSize) return 0;
+
+  uint8_t* p = out;
+  // Cabeçalho: o 'count' do v9 é o número de registros (template + dados)
+  p = put16(p, 9);
+  p = put16(p, (uint16_t)(count + 1));
+  p = put32(p, sysUptimeMs);
+  p = put32(p, unixSecs);
+  p = put32(p, sequence);
+  p = put32(p, sourceId);
+
+  // O template vai em todo datagrama: coletores que reiniciam se recuperam sozinhos
+  p = put16(p, 0);
+  p = put16(p, (uint16_t)TEMPLATE_FLOWSET_LENGTH);
+  p = put16(p, NETFLOW_TEMPLATE_ID);
+  p = put16(p, (uint16_t)TEMPLATE_FIELD_COUNT);
+  for (size_t i = 0; i < TEMPLATE_FIELD_COUNT; i++) {
+    p = put16(p, TEMPLATE_FIELDS[i][0]);
+    p = put16(p, TEMPLATE_FIELDS[i][1]);
+  }
+
+  p = put16(p, NETFLOW_TEMPLATE_ID);
+  p = put16(p, (uint16_t)(dataLength + padding));
+  for (size_t i = 0; i < count; i++) {
+    const FlowRecord& r = records[i];
+    p = put32(p, r.key.srcIp);
+    p = put32(p, r.key.dstIp);
+    p = put16(p, r.key.srcPort);
+    p = put16(p, r.key.dstPort);
+    *p++ = r.key.proto;
+    *p++ = r.tcpFlags;
+    p = put32(p, r.packets);
+    p = put32(p, r.bytes);
+    p = put32(p, r.firstMs);
+    p = put32(p, r.lastMs);
+  }
+  for (size_t i = 0; i < padding; i++) *p++ = 0;
+  return (size_t)(p - out);
+}
+
+size_t NetFlowExporter::flush(bool partial) {
+  if (!isEnabled() || _mutex == NULL || WiFi.status() != WL_CONNECTED) return 0;
+
+  uint8_t datagram[MAX_DATAGRAM_LENGTH];
+  FlowRecord batch[NETFLOW_RECORDS_PER_DATAGRAM];
+  size_t sent = 0;
+
+  for (;;) {
+    size_t count = 0;
+    if (xSemaphoreTake(_mutex, pdMS_TO_TICKS(100)) != pdTRUE) break;
+    if (_pendingCount >= NETFLOW_RECORDS_PER_DATAGRAM || (partial && _pendingCount > 0)) {
+      count = (_pendingCount < NETFLOW_RECORDS_PER_DATAGRAM) ? _pendingCount : NETFLOW_RECORDS_PER_DATAGRAM;
+      for (size_t i = 0; i < count; i++) {
+        batch[i] = _pending[(_pendingHead + i) % NETFLOW_MAX_PENDING];
+      }
+      _pendingHead = (_pendingHead + count) % NETFLOW_MAX_PENDING;
+      _pendingCount -= count;
+    }
+    xSemaphoreGive(_mutex);
+    if (count == 0) break;
+
+    uint32_t sourceId = (uint32_t)WiFi.localIP();
+    size_t length = encodeDatagram(batch, count, millis(), (uint32_t)time(nullptr), _sequence++, sourceId, datagram, sizeof(datagram));
+    if (_udp.beginPacket(_host.c_str(), _port) && _udp.write(datagram, length) == length && _udp.endPacket()) {
+      sent++;
+    } else {
+      ESP_LOGW(TAG_NF, "Falha ao enviar datagrama NetFlow (%u fluxos descartados).", (unsigned)count);
+      _dropped += count;
+    }
+  }
+
+  if (sent > 0) {
+    ESP_LOGI(TAG_NF, "%u datagrama(s) NetFlow enviados para %s:%u.", (unsigned)sent, _host.c_str(), _port);
+  }
+  return sent;
+}
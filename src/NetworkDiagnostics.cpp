@@ -1,75 +1,313 @@
 #include "NetworkDiagnostics.h"
-#include <HTTPClient.h>
-#include <ESP32Ping.h>
 #include "esp_log.h"
 #include <WiFi.h>
+#include <time.h>
+#include <algorithm>
 
-// Inclui o header do NetworkDiscovery para que possamos usar o mutex compartilhado
-#include "NetworkDiscovery.h"
+extern "C"
+{
+#include "lwip/etharp.h"
+}
 
 static const char *TAG_ND = "NetworkDiagnostics";
 
-// Inicializa o ponteiro do módulo como nulo
+static const char* TEST_HOST = "clients3.google.com";
+static const char* TEST_PATH = "/generate_204";
+
+// Amostra do histórico: pings por verificação, espaçados para medir perda
+#define DIAG_PING_BURST 5
+#define DIAG_PING_SPACING_MS 100
+// Destinos públicos distintos que precisam responder para declarar a internet de pé
+#define DIAG_QUORUM 2
+// TTL que morre no primeiro roteador do provedor (o 1 morre no nosso)
+#define DIAG_ISP_HOP_TTL 2
+// Batida: um eco, com prazo menor que o da rodada (o RTT normal é de dezenas de ms)
+#define DIAG_HEARTBEAT_DEADLINE_MS 1000
+
 NetworkDiagnostics::NetworkDiagnostics() {
-  _discoveryModule = nullptr;
+  _historyMutex = nullptr;
+  _probeMutex = nullptr;
+  _ispHop = 0;
+  _probesSent = 0;
+  _online = false;
+  _checkedMs = 0;
+  _beats = 0;
+  _beatsAnswered = 0;
+  _beatRttMsSum = 0;
+  memset(&_lastFault, 0, sizeof(_lastFault));
 }
 
 void NetworkDiagnostics::setup() {
-  ESP_LOGI(TAG_ND, "Módulo de Diagnóstico de Rede inicializado com lógica multi-camada.");
+  _historyMutex = xSemaphoreCreateMutex();
+  _probeMutex = xSemaphoreCreateMutex();
+  _probes.setHost(TEST_HOST, TEST_PATH);
+  _latency.setup();
+  ESP_LOGI(TAG_ND, "Módulo de Diagnóstico de Rede inicializado com sondas paralelas (quorum %d, prazo %d ms).",
+           DIAG_QUORUM, PROBE_DEADLINE_MS);
 }
 
-// Esta função permite que o main.cpp nos "entregue" o mutex
-void NetworkDiagnostics::setDiscoveryModule(NetworkDiscovery* discovery) {
-  _discoveryModule = discovery;
+// Monta a rodada: DNS da rede e um público, HTTP no generate_204, TCP connect
+// em dois resolvedores e 'pings' ecos ICMP ao 8.8.8.8. Todos partem juntos
+// (os pings espaçados); retorna o índice da sonda do DNS da rede ou -1.
+int NetworkDiagnostics::_prepareProbes(uint8_t pings) {
+  _probes.clear();
+  uint32_t resolver = (uint32_t)WiFi.dnsIP();
+  int networkDns = resolver != 0 ? _probes.add(ProbeKind::Dns, resolver) : -1;
+  _probes.add(ProbeKind::Dns, ProbeEngine::ip(1, 1, 1, 1));
+  _probes.add(ProbeKind::Http, 0);
+  _probes.add(ProbeKind::TcpConnect, ProbeEngine::ip(9, 9, 9, 9), 443);
+  _probes.add(ProbeKind::TcpConnect, ProbeEngine::ip(208, 67, 222, 222), 443);
+  for (uint8_t i = 0; i < pings; i++) {
+    _probes.add(ProbeKind::Icmp, ProbeEngine::ip(8, 8, 8, 8), 0, i * DIAG_PING_SPACING_MS);
+  }
+  return networkDns;
 }
 
-bool NetworkDiagnostics::isInternetConnected() {
-  // --- ETAPA 1: Verificação primária com HTTP GET ---
-  HTTPClient http;
-  WiFiClient client;
-  const char* testUrl = "http://clients3.google.com/generate_204";
-  ESP_LOGI(TAG_ND, "Etapa 1: Verificando conectividade via HTTP GET para %s", testUrl);
-  http.begin(client, testUrl);
-  http.setConnectTimeout(5000); 
-  int httpCode = http.GET();
-  http.end();
-
-  if (httpCode == 204) {
-    ESP_LOGI(TAG_ND, "Resultado do HTTP GET: SUCESSO. Internet está ONLINE.");
-    return true; 
+// Alvos das batidas, em rodízio a cada falha: dois seguidos sem resposta são
+// dois destinos distintos, como o quorum das rodadas completas
+static const uint8_t HEARTBEAT_TARGETS[][4] = { { 8, 8, 8, 8 }, { 1, 1, 1, 1 }, { 9, 9, 9, 9 } };
+
+ProbeVerdict NetworkDiagnostics::_run(uint16_t deadlineMs, uint8_t quorum, bool stopAtQuorum, bool budgeted) {
+  if (budgeted) _probesSent += _probes.count();
+  return _probes.run(deadlineMs, quorum, stopAtQuorum);
+}
+
+// Toda sonda da rodada entra no histograma do seu alvo, inclusive as perdas
+void NetworkDiagnostics::_recordLatency() {
+  time_t epoch = time(nullptr);
+  uint32_t now = epoch > 1600000000 ? (uint32_t)epoch : millis() / 1000;
+  _latency.advance(now);
+  for (size_t i = 0; i < _probes.count(); i++) {
+    const ProbeResult& r = _probes.result(i);
+    if (r.kind == ProbeKind::Hop) continue;  // O RTT é do salto, não do alvo
+    // O IP do host HTTP muda a cada resolução: um alvo só para ele
+    _latency.record((uint8_t)r.kind, r.kind == ProbeKind::Http ? 0 : r.ip, r.ok, r.us, now);
+  }
+}
+
+bool NetworkDiagnostics::_measure(DiagnosticSample* sample) {
+  memset(sample, 0, sizeof(*sample));
+  time_t now = time(nullptr);
+  if (now > 1600000000) {  // Relógio já acertado pelo SNTP
+    sample->time = (uint32_t)now;
+    sample->flags |= DIAG_FLAG_EPOCH;
+  } else {
+    sample->time = millis() / 1000;
+  }
+  sample->httpMs = DIAG_FAILED;
+  sample->dnsMs = DIAG_FAILED;
+  sample->rttMs = DIAG_FAILED;
+  sample->lossPct = 100;
+  if (!_probeMutex || xSemaphoreTake(_probeMutex, portMAX_DELAY) != pdTRUE) return false;
+
+  // As batidas do último minuto já mediram RTT e perda, espalhadas no tempo:
+  // a rajada de pings só sai quando não houve nenhuma (orçamento de sondas)
+  uint16_t beats = _beats, beatsAnswered = _beatsAnswered;
+  uint32_t beatRttMsSum = _beatRttMsSum;
+  _beats = _beatsAnswered = 0;
+  _beatRttMsSum = 0;
+
+  // Sem parar no quorum: a amostra precisa do tempo de todas as sondas
+  int networkDns = _prepareProbes(beats > 0 ? 0 : DIAG_PING_BURST);
+  // Aprende o salto do provedor enquanto a rede está de pé, para o diagnose() de uma queda
+  int hop = _probes.addHop(ProbeEngine::ip(8, 8, 8, 8), DIAG_ISP_HOP_TTL);
+  ProbeVerdict verdict = _run(PROBE_DEADLINE_MS, DIAG_QUORUM, false);
+  if (hop >= 0 && _probes.result(hop).ok && _probes.result(hop).from != (uint32_t)WiFi.gatewayIP()) {
+    _ispHop = _probes.result(hop).from;
+  }
+
+  int pings = beats, received = beatsAnswered;
+  uint32_t rttSum = beatRttMsSum;
+  for (size_t i = 0; i < _probes.count(); i++) {
+    const ProbeResult& r = _probes.result(i);
+    uint16_t ms = r.ok ? (uint16_t)std::min<uint32_t>(r.us / 1000, DIAG_FAILED - 1) : DIAG_FAILED;
+    if (r.kind == ProbeKind::Http) sample->httpMs = ms;
+    if ((int)i == networkDns) sample->dnsMs = ms;
+    if (r.kind == ProbeKind::Icmp) {
+      pings++;
+      if (r.ok) {
+        received++;
+        rttSum += r.us / 1000;
+      }
+    }
+    ESP_LOGD(TAG_ND, "Sonda %s %s: %s (%u ms)", ProbeEngine::kindName(r.kind), IPAddress(r.ip).toString().c_str(),
+             r.ok ? "ok" : "falhou", r.us / 1000);
+  }
+  _recordLatency();
+  xSemaphoreGive(_probeMutex);
+
+  if (pings > 0) {
+    sample->lossPct = (uint8_t)(100 * (pings - received) / pings);
+    if (received > 0) sample->rttMs = (uint16_t)std::min<uint32_t>(rttSum / received, DIAG_FAILED - 1);
+  }
+  return verdict.online;
+}
+
+bool NetworkDiagnostics::checkInternet() {
+  DiagnosticSample sample;
+  bool online = _measure(&sample);
+  // Sem quorum: a rodada de diagnóstico confirma a queda e diz em que camada ela está
+  FaultReport report;
+  if (!online) {
+    online = diagnose(&report) == FaultVerdict::Healthy;
+  } else {
+    memset(&report, 0, sizeof(report));
+    report.verdict = FaultVerdict::Healthy;
+    _storeFault(report);
   }
-  
-  ESP_LOGW(TAG_ND, "Etapa 1 FALHOU (Código: %d). Partindo para a Etapa 2: Rajada de Pings.", httpCode);
-
-  // --- ETAPA 2: Verificação secundária com Rajada de Pings ---
-  const char* hostToPing = "8.8.8.8";
-  const int totalPings = 10;
-  
-  // Primeiro, verificamos se a conexão com o outro módulo foi feita.
-  if (!_discoveryModule || !_discoveryModule->pingMutex) {
-      ESP_LOGE(TAG_ND, "Mutex de Ping não está disponível! Abortando verificação de ping.");
-      return false;
+  if (online) sample.flags |= DIAG_FLAG_ONLINE;
+  _online = online;
+  _checkedMs = millis();
+
+  if (_historyMutex && xSemaphoreTake(_historyMutex, portMAX_DELAY) == pdTRUE) {
+    _history.push(sample);
+    xSemaphoreGive(_historyMutex);
   }
+  ESP_LOGI(TAG_ND, "Amostra: HTTP %u ms, DNS %u ms, RTT %u ms, perda %u%% -> %s", sample.httpMs, sample.dnsMs,
+           sample.rttMs, sample.lossPct, online ? "ONLINE" : "OFFLINE");
+  return online;
+}
 
-  for (int i = 0; i < totalPings; i++) {
-    ESP_LOGI(TAG_ND, "Etapa 2: Tentativa de Ping %d/%d...", i + 1, totalPings);
-    
-    bool success = false;
-    // Pega a "trava" do mutex compartilhado antes de fazer o ping.
-    if (xSemaphoreTake(_discoveryModule->pingMutex, portMAX_DELAY) == pdTRUE) {
-        success = Ping.ping(hostToPing, 1);
-        // Libera a "trava" para que outras tarefas possam usar o ping.
-        xSemaphoreGive(_discoveryModule->pingMutex);
+// O gateway ainda responde ARP? Só informativo: a entrada pode ter até alguns minutos
+static bool gatewayInArpCache(uint32_t gateway) {
+  ip4_addr_t address;
+  address.addr = gateway;
+  struct eth_addr* ethAddr = nullptr;
+  const ip4_addr_t* ipAddr = nullptr;
+  return etharp_find_addr(NULL, &address, &ethAddr, &ipAddr) >= 0 && ethAddr != nullptr;
+}
+
+FaultVerdict NetworkDiagnostics::diagnose(FaultReport* report) {
+  memset(report, 0, sizeof(*report));
+  report->wifi = WiFi.status() == WL_CONNECTED;
+  if (report->wifi && _probeMutex && xSemaphoreTake(_probeMutex, portMAX_DELAY) == pdTRUE) {
+    report->rssi = (int8_t)WiFi.RSSI();
+    uint32_t gateway = (uint32_t)WiFi.gatewayIP();
+    uint32_t resolver = (uint32_t)WiFi.dnsIP();
+    uint32_t ispHop = _ispHop;
+
+    // Uma rodada só, de baixo para cima: gateway, saltos do provedor, DNS, anycast e HTTP
+    _probes.clear();
+    _probes.add(ProbeKind::Icmp, gateway);
+    _probes.add(ProbeKind::TcpConnect, gateway, 80);
+    _probes.addHop(ProbeEngine::ip(8, 8, 8, 8), DIAG_ISP_HOP_TTL);
+    _probes.addHop(ProbeEngine::ip(8, 8, 8, 8), DIAG_ISP_HOP_TTL + 1);
+    int ispPing = ispHop != 0 ? _probes.add(ProbeKind::Icmp, ispHop) : -1;
+    int networkDns = resolver != 0 ? _probes.add(ProbeKind::Dns, resolver) : -1;
+    _probes.add(ProbeKind::Dns, ProbeEngine::ip(1, 1, 1, 1));
+    _probes.add(ProbeKind::Dns, ProbeEngine::ip(8, 8, 8, 8));
+    _probes.add(ProbeKind::Icmp, ProbeEngine::ip(1, 1, 1, 1));
+    _probes.add(ProbeKind::Icmp, ProbeEngine::ip(8, 8, 8, 8));
+    _probes.add(ProbeKind::Icmp, ProbeEngine::ip(9, 9, 9, 9));
+    _probes.add(ProbeKind::TcpConnect, ProbeEngine::ip(1, 1, 1, 1), 443);
+    _probes.add(ProbeKind::TcpConnect, ProbeEngine::ip(9, 9, 9, 9), 443);
+    _probes.add(ProbeKind::Http, 0);
+    ProbeVerdict verdict = _run(PROBE_DEADLINE_MS, DIAG_QUORUM, false);
+
+    for (size_t i = 0; i < _probes.count(); i++) {
+      const ProbeResult& r = _probes.result(i);
+      if (!r.ok) continue;
+      if ((int)i == ispPing) {
+        report->ispEdge = true;
+      } else if (r.ip == gateway && r.kind != ProbeKind::Dns) {
+        report->gateway = true;
+      } else if (r.kind == ProbeKind::Hop) {
+        if (r.from == gateway) continue;
+        report->ispEdge = true;
+        if (r.ttl == DIAG_ISP_HOP_TTL) _ispHop = r.from;
+      } else if (r.kind == ProbeKind::Dns) {
+        if ((int)i == networkDns) {
+          report->dnsNetwork = true;
+        } else {
+          report->dnsPublic = true;
+        }
+      } else if (r.kind == ProbeKind::Http) {
+        report->http = true;
+      } else {
+        report->publicIp = true;
+      }
     }
-    
-    if (success) {
-      ESP_LOGI(TAG_ND, "Resultado do Ping: SUCESSO na tentativa %d. Internet está ONLINE (instável).", i + 1);
-      return true;
+    xSemaphoreGive(_probeMutex);
+
+    report->gatewayArp = gatewayInArpCache(gateway);
+    report->dnsNetworkLocal = resolver != 0 && !ProbeEngine::isPublic(resolver);
+    report->ispHop = _ispHop;
+    report->elapsedMs = verdict.elapsedMs;
+  }
+  report->verdict = FaultLocator::classify(*report);
+
+  char line[192];
+  if (FaultLocator::describe(*report, line, sizeof(line)) > 0) ESP_LOGW(TAG_ND, "%s", line);
+  _storeFault(*report);
+  return report->verdict;
+}
+
+void NetworkDiagnostics::_storeFault(const FaultReport& report) {
+  if (_historyMutex && xSemaphoreTake(_historyMutex, portMAX_DELAY) == pdTRUE) {
+    _lastFault = report;
+    xSemaphoreGive(_historyMutex);
+  }
+}
+
+FaultReport NetworkDiagnostics::lastFault() {
+  FaultReport report;
+  memset(&report, 0, sizeof(report));
+  if (_historyMutex && xSemaphoreTake(_historyMutex, portMAX_DELAY) == pdTRUE) {
+    report = _lastFault;
+    xSemaphoreGive(_historyMutex);
+  }
+  return report;
+}
+
+size_t NetworkDiagnostics::readHistory(uint32_t* cursor, DiagnosticSample* out, size_t max) {
+  size_t copied = 0;
+  if (_historyMutex && xSemaphoreTake(_historyMutex, portMAX_DELAY) == pdTRUE) {
+    if (*cursor < _history.oldest()) *cursor = _history.oldest();
+    while (copied < max && _history.get(*cursor, &out[copied])) {
+      copied++;
+      (*cursor)++;
     }
-    
-    delay(500);
+    xSemaphoreGive(_historyMutex);
+  }
+  return copied;
+}
+
+bool NetworkDiagnostics::isInternetConnected() {
+  if (!_probeMutex || xSemaphoreTake(_probeMutex, portMAX_DELAY) != pdTRUE) return false;
+  _prepareProbes(1);
+  // Fora do orçamento: quem chama fora do agendador não pode atrasar as batidas
+  ProbeVerdict verdict = _run(PROBE_DEADLINE_MS, DIAG_QUORUM, true, false);
+  _recordLatency();
+  xSemaphoreGive(_probeMutex);
+
+  if (verdict.online) {
+    ESP_LOGI(TAG_ND, "Internet ONLINE: %u destinos responderam em %u ms.", verdict.answered, verdict.elapsedMs);
+  } else {
+    ESP_LOGE(TAG_ND, "Internet OFFLINE: %u de %u destinos no quorum, %u sondas sem resposta em %u ms.",
+             verdict.answered, DIAG_QUORUM, verdict.failed, verdict.elapsedMs);
+  }
+  return verdict.online;
+}
+
+bool NetworkDiagnostics::heartbeat(uint8_t attempt, uint32_t* rttUs) {
+  *rttUs = 0;
+  if (!_probeMutex || xSemaphoreTake(_probeMutex, portMAX_DELAY) != pdTRUE) return false;
+  const uint8_t* target = HEARTBEAT_TARGETS[attempt % (sizeof(HEARTBEAT_TARGETS) / sizeof(HEARTBEAT_TARGETS[0]))];
+  _probes.clear();
+  _probes.add(ProbeKind::Icmp, ProbeEngine::ip(target[0], target[1], target[2], target[3]));
+  _run(DIAG_HEARTBEAT_DEADLINE_MS, 1, true);
+  ProbeResult r = _probes.result(0);  // Cópia: o log sai depois de soltar a trava
+  bool ok = r.ok;
+  if (ok) *rttUs = r.us;
+  _beats++;
+  if (ok) {
+    _beatsAnswered++;
+    _beatRttMsSum += r.us / 1000;
   }
+  _recordLatency();
+  xSemaphoreGive(_probeMutex);
 
-  ESP_LOGE(TAG_ND, "Etapa 2 FALHOU. Todas as %d tentativas de ping falharam. Confirmando internet OFFLINE.", totalPings);
-  return false;
-}
\ No newline at end of file
+  ESP_LOGD(TAG_ND, "Batida %s: %s (%u ms)", IPAddress(r.ip).toString().c_str(), ok ? "ok" : "sem resposta",
+           *rttUs / 1000);
+  return ok;
+}
@@ -1,27 +1,40 @@
 #include "NetworkDiscovery.h"
 #include <WiFi.h>
-#include <ESP32Ping.h>
 #include "esp_log.h"
 
-static const char* TAG_ND = "NetworkDiscovery";
-
-// A função pingTask não será mais usada, mas a deixamos aqui para não dar erro de compilação.
-void pingTask(void *pvParameters) {
-  vTaskDelete(NULL);
+extern "C"
+{
+#include "lwip/etharp.h"
 }
 
+static const char* TAG_ND = "NetworkDiscovery";
+
 NetworkDiscovery::NetworkDiscovery() {
   deviceCount = 0;
   activeScanTasks = 0;
   listMutex = NULL;
-  pingMutex = NULL;
+  _fingerprinter = nullptr;
+}
+
+void NetworkDiscovery::setFingerprinter(const DeviceFingerprinter* fingerprinter) {
+  _fingerprinter = fingerprinter;
+}
+
+// O eco que acabou de responder deixou o MAC no cache ARP do lwIP
+bool NetworkDiscovery::_arpLookup(const IPAddress& ip, uint8_t* mac) {
+  ip4_addr_t address;
+  address.addr = static_cast<uint32_t>(ip);
+  struct eth_addr* ethAddr = nullptr;
+  const ip4_addr_t* ipAddr = nullptr;
+  if (etharp_find_addr(NULL, &address, &ethAddr, &ipAddr) < 0 || ethAddr == nullptr) return false;
+  memcpy(mac, ethAddr->addr, 6);
+  return true;
 }
 
 void NetworkDiscovery::setup() {
   listMutex = xSemaphoreCreateMutex();
-  pingMutex = xSemaphoreCreateMutex(); 
-  if (listMutex && pingMutex) {
-    ESP_LOGI(TAG_ND, "Módulo de Descoberta de Rede (MODO SEQUENCIAL).");
+  if (listMutex) {
+    ESP_LOGI(TAG_ND, "Módulo de Descoberta de Rede (varredura ICMP paralela).");
   } else {
     ESP_LOGE(TAG_ND, "Falha ao criar o Mutex do Scanner!");
   }
@@ -33,9 +46,35 @@ bool NetworkDiscovery::isScanning() {
   return activeScanTasks > 0;
 }
 
-// ===================================================================
-// VERSÃO FINAL DA FUNÇÃO beginScan (SEQUENCIAL E BLOQUEANTE)
-// ===================================================================
+void NetworkDiscovery::_onHost(const IPAddress& ip, uint32_t rttUs) {
+  uint8_t mac[6];
+  bool hasMac = _arpLookup(ip, mac);
+  char macStr[18] = "";
+  if (hasMac) {
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  }
+  DeviceFingerprint fingerprint;
+  bool classified = hasMac && _fingerprinter && _fingerprinter->fingerprint(mac, &fingerprint);
+  ESP_LOGI(TAG_ND, "Dispositivo encontrado em: %s %s (%s), RTT %.1f ms", ip.toString().c_str(), macStr,
+           classified ? DeviceFingerprinter::typeName(fingerprint.type) : "não classificado", rttUs / 1000.0f);
+  if (xSemaphoreTake(listMutex, (TickType_t)100) == pdTRUE) {
+    if (deviceCount < MAX_DEVICES) {
+      devices[deviceCount].ip = ip;
+      devices[deviceCount].macAddress = macStr;
+      devices[deviceCount].isOnline = true;
+      devices[deviceCount].type = classified ? fingerprint.type : DeviceType::Unknown;
+      devices[deviceCount].typeConfidence = classified ? fingerprint.confidence : 0;
+      deviceCount++;
+    }
+    xSemaphoreGive(listMutex);
+  }
+}
+
+// Chamado pelo IcmpEngine assim que o alvo termina: o MAC ainda está no cache ARP
+void NetworkDiscovery::_onSweepResult(void* context, const IcmpTargetResult& result) {
+  if (result.received > 0) static_cast<NetworkDiscovery*>(context)->_onHost(IPAddress(result.ip), result.rttAvgUs());
+}
+
 void NetworkDiscovery::beginScan() {
   if (isScanning()) {
     ESP_LOGW(TAG_ND, "Scan já em andamento.");
@@ -44,37 +83,24 @@ void NetworkDiscovery::beginScan() {
   
   activeScanTasks = 1; // Sinaliza que o scan está ativo
 
-  ESP_LOGI(TAG_ND, "--- Iniciando Scan Sequencial da Rede Local ---");
+  ESP_LOGI(TAG_ND, "--- Iniciando Varredura da Rede Local ---");
   deviceCount = 0;
 
-  // O loop agora acontece diretamente aqui, sem criar tarefas
+  // Até ICMP_SWEEP_WINDOW alvos em voo (cabem na tabela ARP) e uma segunda
+  // passada para quem não respondeu na primeira
+  uint32_t targets[254];
+  IPAddress host = WiFi.gatewayIP();
   for (int i = 1; i < 255; i++) {
-    IPAddress hostToPing = WiFi.gatewayIP();
-    hostToPing[3] = i;
-
-    // A chamada ao Ping é protegida pelo mutex, como boa prática
-    // para o caso do NetworkDiagnostics tentar usar ao mesmo tempo.
-    bool success = false;
-    if (xSemaphoreTake(pingMutex, portMAX_DELAY) == pdTRUE) {
-        success = Ping.ping(hostToPing, 1);
-        xSemaphoreGive(pingMutex);
-    }
-    
-    if (success) {
-      ESP_LOGI(TAG_ND, "Dispositivo encontrado em: %s", hostToPing.toString().c_str());
-      if (xSemaphoreTake(listMutex, (TickType_t)100) == pdTRUE) {
-        if (deviceCount < MAX_DEVICES) {
-          devices[deviceCount].ip = hostToPing;
-          devices[deviceCount].isOnline = true;
-          deviceCount++;
-        }
-        xSemaphoreGive(listMutex);
-      }
-    }
-    // Pequeno delay para a tarefa principal poder respirar e não bloquear o watchdog
-    vTaskDelay(pdMS_TO_TICKS(20)); 
+    host[3] = i;
+    targets[i - 1] = static_cast<uint32_t>(host);
   }
+  unsigned long start = millis();
+  if (!_icmp.sweep(targets, 254, ICMP_SWEEP_PASSES, _onSweepResult, this)) {
+    ESP_LOGE(TAG_ND, "Falha ao abrir o socket ICMP ou sem memória; varredura cancelada.");
+  }
+  // Socket fechado entre varreduras: não ocupa um dos poucos sockets do lwIP à toa
+  _icmp.close();
 
-  ESP_LOGI(TAG_ND, "--- Scan Sequencial Concluído ---");
+  ESP_LOGI(TAG_ND, "--- Varredura Concluída: %d dispositivos em %lu ms ---", deviceCount, millis() - start);
   activeScanTasks = 0; // Sinaliza que o scan terminou
-}
\ No newline at end of file
+}
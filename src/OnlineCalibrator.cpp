@@ -0,0 +1,75 @@
+#include "OnlineCalibrator.h"
+#include <cmath>
+#include <cstring>
+
+OnlineCalibrator::OnlineCalibrator() {
+  reset();
+}
+
+void OnlineCalibrator::reset() {
+  memset(&_state, 0, sizeof(_state));
+  _state.version = ONLINE_CAL_STATE_VERSION;
+}
+
+void OnlineCalibrator::normalize(const float* raw, float* out) const {
+  for (int i = 0; i < ONLINE_CAL_FEATURES; i++) {
+    float range = _state.featureMax[i] - _state.featureMin[i];
+    if (_state.windows == 0 || range <= 0.0f) {
+      out[i] = 0.0f;
+      continue;
+    }
+    float v = (raw[i] - _state.featureMin[i]) / range;
+    // Fora da faixa aprendida também é informação para o autoencoder, mas
+    // limitada para não saturar a sigmoide da saída
+    if (v < -1.0f) v = -1.0f;
+    if (v > 2.0f) v = 2.0f;
+    out[i] = v;
+  }
+}
+
+void OnlineCalibrator::update(const float* raw, float error, bool anomalous) {
+  bool learnError = !(anomalous && isWarm());
+  _state.windows++;
+  // No aquecimento a média é a aritmética; depois passa a exponencial
+  float alpha = 1.0f / _state.windows;
+  if (alpha < ONLINE_CAL_ERROR_ALPHA) alpha = ONLINE_CAL_ERROR_ALPHA;
+
+  for (int i = 0; i < ONLINE_CAL_FEATURES; i++) {
+    if (_state.windows == 1) {
+      _state.featureMean[i] = _state.featureMin[i] = _state.featureMax[i] = raw[i];
+      continue;
+    }
+    _state.featureMean[i] += alpha * (raw[i] - _state.featureMean[i]);
+    _state.featureMin[i] += ONLINE_CAL_RANGE_DECAY * (_state.featureMean[i] - _state.featureMin[i]);
+    _state.featureMax[i] -= ONLINE_CAL_RANGE_DECAY * (_state.featureMax[i] - _state.featureMean[i]);
+    if (raw[i] < _state.featureMin[i]) _state.featureMin[i] = raw[i];
+    if (raw[i] > _state.featureMax[i]) _state.featureMax[i] = raw[i];
+  }
+
+  if (!learnError) return;
+  // Média e variância exponenciais do log do erro (forma incremental de West)
+  float delta = logf(error + ONLINE_CAL_LOG_EPSILON) - _state.logErrorMean;
+  _state.logErrorMean += alpha * delta;
+  _state.logErrorVar = (1.0f - alpha) * (_state.logErrorVar + alpha * delta * delta);
+}
+
+float OnlineCalibrator::threshold() const {
+  return expf(_state.logErrorMean + ONLINE_CAL_THRESHOLD_SIGMAS * sqrtf(_state.logErrorVar)) - ONLINE_CAL_LOG_EPSILON;
+}
+
+float OnlineCalibrator::typicalError() const {
+  return expf(_state.logErrorMean) - ONLINE_CAL_LOG_EPSILON;
+}
+
+bool OnlineCalibrator::restore(const State& state) {
+  if (state.version != ONLINE_CAL_STATE_VERSION) return false;
+  for (int i = 0; i < ONLINE_CAL_FEATURES; i++) {
+    if (!std::isfinite(state.featureMin[i]) || !std::isfinite(state.featureMax[i]) ||
+        state.featureMin[i] > state.featureMax[i]) {
+      return false;
+    }
+  }
+  if (!std::isfinite(state.logErrorMean) || !std::isfinite(state.logErrorVar) || state.logErrorVar < 0.0f) return false;
+  _state = state;
+  return true;
+}
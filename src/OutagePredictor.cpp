@@ -0,0 +1,71 @@
+#include "OutagePredictor.h"
+#include "OutageModelWeights.h"
+#include "esp_log.h"
+#include <algorithm>
+
+static const char* TAG = "OutagePredictor";
+
+static_assert(OutageModel::inputs == OUTAGE_WINDOW * OUTAGE_CHANNELS && OutageModel::outputs == 1,
+              "OutageModelWeights.h não corresponde à janela do preditor");
+
+void OutagePredictor::setup() {
+  inferenceRuntime.registerModel(this);
+  ESP_LOGI(TAG, "Preditor de quedas: janela de %d verificações, horizonte de %d min, %d parâmetros (%u B).",
+           OUTAGE_WINDOW, OUTAGE_HORIZON_MIN, OutageModel::paramCount,
+           (unsigned)sizeof(outage_model_params));
+}
+
+size_t OutagePredictor::arenaBytes() const {
+  return 2 * sizeof(float) * OutageModel::hiddenWidth;
+}
+
+bool OutagePredictor::invoke(uint8_t* arena, const float* in, float* out, int n, InferenceProfiler& profiler) {
+  if (n != 1) return false;
+  float* scratchA = reinterpret_cast<float*>(arena);
+  OutageModel::forwardBatch(outage_model_params, in, out, 1, scratchA, scratchA + OutageModel::hiddenWidth, profiler);
+  return true;
+}
+
+int OutagePredictor::horizonMinutes() const {
+  return OUTAGE_HORIZON_MIN;
+}
+
+static float capped(uint16_t ms, float cap) {
+  if (ms == DIAG_FAILED) return 1.0f;
+  return std::min((float)ms, cap) / cap;
+}
+
+void OutagePredictor::normalize(const DiagnosticSample& sample, float* out) {
+  out[0] = capped(sample.httpMs, outage_http_cap_ms);
+  out[1] = capped(sample.rttMs, outage_rtt_cap_ms);
+  out[2] = sample.lossPct / 100.0f;
+  out[3] = capped(sample.dnsMs, outage_dns_cap_ms);
+}
+
+bool OutagePredictor::update(const DiagnosticsRing& history) {
+  DiagnosticSample window[OUTAGE_WINDOW];
+  if (history.latest(window, OUTAGE_WINDOW) < OUTAGE_WINDOW) return false;
+
+  float input[OUTAGE_WINDOW * OUTAGE_CHANNELS];
+  for (int i = 0; i < OUTAGE_WINDOW; i++) normalize(window[i], input + i * OUTAGE_CHANNELS);
+
+  float output;
+  if (!inferenceRuntime.run(this, input, &output)) return false;
+
+  _probability = output;
+  _hasPrediction = true;
+  if (_armed && _probability >= OUTAGE_ALERT_PROBABILITY) {
+    _armed = false;
+    _warningPending = true;
+  } else if (!_armed && _probability < OUTAGE_REARM_PROBABILITY) {
+    _armed = true;
+  }
+  ESP_LOGI(TAG, "P(queda em %d min) = %.2f", OUTAGE_HORIZON_MIN, _probability);
+  return true;
+}
+
+bool OutagePredictor::takeWarning() {
+  bool pending = _warningPending;
+  _warningPending = false;
+  return pending;
+}
@@ -0,0 +1,154 @@
+#include "PcapStream.h"
+#include <cstdlib>
+#include <cstring>
+
+static inline uint8_t* putLe16(uint8_t* p, uint16_t v) {
+  p[0] = v; p[1] = v >> 8;
+  return p + 2;
+}
+
+static inline uint8_t* putLe32(uint8_t* p, uint32_t v) {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+  return p + 4;
+}
+
+static uint16_t channelToMhz(uint8_t channel) {
+  if (channel == 14) return 2484;
+  return 2407 + 5 * channel;
+}
+
+PcapStream::PcapStream() : _head(0), _tail(0), _captured(0), _dropped(0) {
+  _ring = nullptr;
+  _capacity = 0;
+  _stagingLength = 0;
+  _stagingOffset = 0;
+  _startEpochUs = 0;
+  _firstFrameUs = 0;
+  _haveFirstFrame = false;
+}
+
+bool PcapStream::begin(size_t capacityBytes) {
+  if (_ring != nullptr) return true;
+  _ring = (uint8_t*)malloc(capacityBytes);
+  if (_ring == nullptr) return false;
+  _capacity = capacityBytes;
+  return true;
+}
+
+void PcapStream::start(uint64_t startEpochUs) {
+  _head.store(0);
+  _tail.store(0);
+  _captured.store(0);
+  _dropped.store(0);
+  _startEpochUs = startEpochUs;
+  _haveFirstFrame = false;
+
+  // Cabeçalho global do pcap clássico (little-endian, microssegundos)
+  uint8_t* p = _staging;
+  p = putLe32(p, 0xA1B2C3D4);
+  p = putLe16(p, 2);
+  p = putLe16(p, 4);
+  p = putLe32(p, 0);        // thiszone
+  p = putLe32(p, 0);        // sigfigs
+  p = putLe32(p, 65535);    // snaplen
+  p = putLe32(p, PCAP_LINKTYPE_RADIOTAP);
+  _stagingLength = (size_t)(p - _staging);
+  _stagingOffset = 0;
+}
+
+void PcapStream::_ringWrite(size_t position, const void* data, size_t length) {
+  size_t offset = position % _capacity;
+  size_t first = (length < _capacity - offset) ? length : _capacity - offset;
+  memcpy(_ring + offset, data, first);
+  memcpy(_ring, (const uint8_t*)data + first, length - first);
+}
+
+void PcapStream::_ringRead(size_t position, void* data, size_t length) const {
+  size_t offset = position % _capacity;
+  size_t first = (length < _capacity - offset) ? length : _capacity - offset;
+  memcpy(data, _ring + offset, first);
+  memcpy((uint8_t*)data + first, _ring, length - first);
+}
+
+bool PcapStream::push(const uint8_t* frame, uint16_t capturedLength, uint16_t originalLength,
+                      uint32_t timestampUs, int8_t rssi, uint8_t channel) {
+  if (_ring == nullptr) return false;
+  if (capturedLength > PCAP_MAX_FRAME) capturedLength = PCAP_MAX_FRAME;
+
+  size_t head = _head.load(std::memory_order_relaxed);
+  size_t tail = _tail.load(std::memory_order_acquire);
+  size_t needed = sizeof(RecordHeader) + capturedLength;
+  if (_capacity - (head - tail) < needed) {
+    // Contrapressão: o TCP não está drenando rápido o suficiente
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  RecordHeader header = {capturedLength, originalLength, timestampUs, rssi, channel};
+  _ringWrite(head, &header, sizeof(header));
+  _ringWrite(head + sizeof(header), frame, capturedLength);
+  _head.store(head + needed, std::memory_order_release);
+  _captured.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool PcapStream::_stageNextRecord() {
+  size_t tail = _tail.load(std::memory_order_relaxed);
+  if (tail == _head.load(std::memory_order_acquire)) return false;
+
+  RecordHeader header;
+  _ringRead(tail, &header, sizeof(header));
+
+  if (!_haveFirstFrame) {
+    _firstFrameUs = header.timestampUs;
+    _haveFirstFrame = true;
+  }
+  uint64_t epochUs = _startEpochUs + (uint32_t)(header.timestampUs - _firstFrameUs);
+  uint16_t recordLength = PCAP_RADIOTAP_LENGTH + header.capturedLength;
+
+  uint8_t* p = _staging;
+  p = putLe32(p, (uint32_t)(epochUs / 1000000));
+  p = putLe32(p, (uint32_t)(epochUs % 1000000));
+  p = putLe32(p, recordLength);
+  p = putLe32(p, PCAP_RADIOTAP_LENGTH + header.originalLength);
+
+  // Radiotap: Flags (FCS no fim), Channel e dBm Antenna Signal
+  p = putLe16(p, 0);                        // versão + pad
+  p = putLe16(p, PCAP_RADIOTAP_LENGTH);
+  p = putLe32(p, (1 << 1) | (1 << 3) | (1 << 5));
+  *p++ = 0x10;                              // Flags: quadro inclui FCS
+  *p++ = 0;                                 // Alinhamento do campo Channel
+  p = putLe16(p, channelToMhz(header.channel));
+  p = putLe16(p, 0x0080);                   // Canal de 2 GHz
+  *p++ = (uint8_t)header.rssi;
+
+  _ringRead(tail + sizeof(header), p, header.capturedLength);
+  p += header.capturedLength;
+  _tail.store(tail + sizeof(header) + header.capturedLength, std::memory_order_release);
+
+  _stagingLength = (size_t)(p - _staging);
+  _stagingOffset = 0;
+  return true;
+}
+
+size_t PcapStream::read(uint8_t* out, size_t maxLen) {
+  size_t written = 0;
+  while (written < maxLen) {
+    if (_stagingOffset == _stagingLength && !_stageNextRecord()) break;
+    size_t chunk = _stagingLength - _stagingOffset;
+    if (chunk > maxLen - written) chunk = maxLen - written;
+    memcpy(out + written, _staging + _stagingOffset, chunk);
+    _stagingOffset += chunk;
+    written += chunk;
+  }
+  return written;
+}
+
+bool PcapStream::hasPending() const {
+  return _stagingOffset < _stagingLength || _tail.load() != _head.load();
+}
+
+void PcapStream::discard() {
+  _stagingOffset = _stagingLength;
+  _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+}
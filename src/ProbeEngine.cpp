@@ -0,0 +1,379 @@
+#include "ProbeEngine.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "lwip/sockets.h"
+static uint16_t randomId() { return (uint16_t)esp_random(); }
+static void sleepMs(uint32_t ms) { delay(ms); }
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <random>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+static uint16_t randomId() { return (uint16_t)std::random_device()(); }
+static void sleepMs(uint32_t ms) { usleep(ms * 1000); }
+#endif
+
+static const char* TAG = "ProbeEngine";
+
+static inline uint32_t nowUs() {
+  return (uint32_t)esp_timer_get_time();
+}
+
+static bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static sockaddr_in socketAddress(uint32_t ip, uint16_t port) {
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = ip;
+  return address;
+}
+
+ProbeEngine::ProbeEngine() {
+  _host[0] = '\0';
+  _path[0] = '\0';
+}
+
+void ProbeEngine::setHost(const char* host, const char* path) {
+  if (strcmp(host, _host) != 0) _hostIp = 0;
+  strncpy(_host, host, sizeof(_host) - 1);
+  _host[sizeof(_host) - 1] = '\0';
+  strncpy(_path, path, sizeof(_path) - 1);
+  _path[sizeof(_path) - 1] = '\0';
+}
+
+void ProbeEngine::clear() {
+  _count = 0;
+}
+
+int ProbeEngine::add(ProbeKind kind, uint32_t ip, uint16_t port, uint16_t startMs) {
+  if (_count >= PROBE_MAX) return -1;
+  Probe& probe = _probes[_count];
+  memset(&probe, 0, sizeof(probe));
+  probe.result.kind = kind;
+  probe.result.ip = ip;
+  probe.result.port = port != 0 ? port : (kind == ProbeKind::Http ? 80 : kind == ProbeKind::Dns ? 53 : 0);
+  probe.result.startMs = startMs;
+  // O host HTTP é público por definição; resolver da rede local não prova que há internet
+  probe.result.votes = (kind == ProbeKind::Http && ip == 0) || isPublic(ip);
+  probe.fd = -1;
+  return (int)_count++;
+}
+
+int ProbeEngine::addHop(uint32_t ip, uint8_t ttl, uint16_t startMs) {
+  int index = add(ProbeKind::Hop, ip, 0, startMs);
+  if (index < 0) return -1;
+  _probes[index].result.ttl = ttl;
+  _probes[index].result.votes = false;  // O salto responder não prova que há internet
+  return index;
+}
+
+const char* ProbeEngine::kindName(ProbeKind kind) {
+  switch (kind) {
+    case ProbeKind::Http: return "http";
+    case ProbeKind::Dns: return "dns";
+    case ProbeKind::TcpConnect: return "tcp";
+    case ProbeKind::Icmp: return "icmp";
+    case ProbeKind::Hop: return "hop";
+  }
+  return "?";
+}
+
+uint32_t ProbeEngine::ip(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+  return htonl((uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)c << 8 | d);
+}
+
+bool ProbeEngine::isPublic(uint32_t ip) {
+  uint32_t host = ntohl(ip);
+  uint8_t a = host >> 24, b = (host >> 16) & 0xFF;
+  if (a == 0 || a == 10 || a == 127 || a >= 224) return false;
+  if (a == 172 && (b & 0xF0) == 16) return false;
+  if (a == 192 && b == 168) return false;
+  if (a == 169 && b == 254) return false;
+  if (a == 100 && (b & 0xC0) == 64) return false;  // CGNAT
+  return true;
+}
+
+size_t ProbeEngine::_buildDnsQuery(uint16_t id, uint8_t* out, size_t maxLen) const {
+  const uint8_t header[12] = { (uint8_t)(id >> 8), (uint8_t)id, 0x01, 0x00, 0x00, 0x01, 0, 0, 0, 0, 0, 0 };
+  if (maxLen < sizeof(header)) return 0;
+  memcpy(out, header, sizeof(header));
+  size_t length = sizeof(header);
+  for (const char* label = _host; *label;) {
+    const char* dot = strchr(label, '.');
+    size_t labelLength = dot ? (size_t)(dot - label) : strlen(label);
+    if (labelLength == 0 || labelLength > 63 || length + labelLength + 6 > maxLen) return 0;
+    out[length++] = (uint8_t)labelLength;
+    memcpy(out + length, label, labelLength);
+    length += labelLength;
+    label += labelLength + (dot ? 1 : 0);
+  }
+  const uint8_t question[5] = { 0x00, 0x00, 0x01, 0x00, 0x01 };  // Fim do nome, tipo A, classe IN
+  memcpy(out + length, question, sizeof(question));
+  return length + sizeof(question);
+}
+
+// Pula um nome (rótulos ou ponteiro de compressão); retorna a posição seguinte ou 0
+static size_t skipDnsName(const uint8_t* packet, size_t length, size_t pos) {
+  while (pos < length) {
+    uint8_t label = packet[pos];
+    if (label == 0) return pos + 1;
+    if ((label & 0xC0) == 0xC0) return pos + 2;
+    pos += 1 + label;
+  }
+  return 0;
+}
+
+// Primeiro registro A da resposta (ordem de rede), ou 0
+static uint32_t firstARecord(const uint8_t* packet, size_t length) {
+  uint16_t questions = (uint16_t)(packet[4] << 8 | packet[5]);
+  uint16_t answers = (uint16_t)(packet[6] << 8 | packet[7]);
+  size_t pos = 12;
+  for (int i = 0; i < questions && pos != 0; i++) {
+    pos = skipDnsName(packet, length, pos);
+    if (pos != 0) pos += 4;
+  }
+  for (int i = 0; i < answers && pos != 0; i++) {
+    pos = skipDnsName(packet, length, pos);
+    if (pos == 0 || pos + 10 > length) return 0;
+    uint16_t type = (uint16_t)(packet[pos] << 8 | packet[pos + 1]);
+    uint16_t dataLength = (uint16_t)(packet[pos + 8] << 8 | packet[pos + 9]);
+    pos += 10;
+    if (pos + dataLength > length) return 0;
+    if (type == 1 && dataLength == 4) {
+      uint32_t address;
+      memcpy(&address, packet + pos, 4);
+      return address;
+    }
+    pos += dataLength;
+  }
+  return 0;
+}
+
+void ProbeEngine::_finish(Probe& probe, bool ok, uint32_t now) {
+  if (probe.fd >= 0) close(probe.fd);
+  probe.fd = -1;
+  probe.state = State::Done;
+  probe.result.ok = ok;
+  if (ok) probe.result.us = now - probe.startUs;
+}
+
+void ProbeEngine::_start(Probe& probe, uint32_t now) {
+  ProbeResult& r = probe.result;
+  probe.startUs = now;
+  if (r.kind == ProbeKind::Http && r.ip == 0) {
+    if (_hostIp == 0) {
+      probe.state = State::WaitingAddress;
+      return;
+    }
+    r.ip = _hostIp;
+  }
+  sockaddr_in address = socketAddress(r.ip, r.port);
+
+  if (r.kind == ProbeKind::Icmp || r.kind == ProbeKind::Hop) {
+    probe.state = State::Sent;
+    if (!_icmp.send(r.ip, (uint16_t)(&probe - _probes), now, r.ttl)) _finish(probe, false, now);
+    return;
+  }
+
+  bool udp = r.kind == ProbeKind::Dns;
+  probe.fd = socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+  if (probe.fd < 0 || !setNonBlocking(probe.fd)) {
+    ESP_LOGW(TAG, "Sem socket para a sonda %s (errno %d).", kindName(r.kind), errno);
+    _finish(probe, false, now);
+    return;
+  }
+  int connected = connect(probe.fd, (sockaddr*)&address, sizeof(address));
+  if (connected < 0 && errno != EINPROGRESS) {
+    _finish(probe, false, now);
+    return;
+  }
+  if (!udp) {
+    probe.state = State::Connecting;
+    return;
+  }
+  uint8_t query[PROBE_HOST_MAX + 20];
+  probe.id = randomId();
+  size_t length = _buildDnsQuery(probe.id, query, sizeof(query));
+  probe.state = State::Sent;
+  if (length == 0 || send(probe.fd, query, length, 0) != (ssize_t)length) _finish(probe, false, now);
+}
+
+void ProbeEngine::_onWritable(Probe& probe, uint32_t now) {
+  int error = 0;
+  socklen_t errorLength = sizeof(error);
+  if (getsockopt(probe.fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) != 0) error = errno;
+  if (probe.result.kind == ProbeKind::TcpConnect) {
+    // RST também é resposta: o destino foi alcançado
+    _finish(probe, error == 0 || error == ECONNREFUSED, now);
+    return;
+  }
+  if (error != 0) {
+    _finish(probe, false, now);
+    return;
+  }
+  char request[2 * PROBE_HOST_MAX + 64];
+  int length = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", _path, _host);
+  probe.state = State::Sent;
+  if (send(probe.fd, request, length, 0) != length) _finish(probe, false, now);
+}
+
+void ProbeEngine::_onReadable(Probe& probe, uint32_t now) {
+  uint8_t buffer[512];
+  if (probe.result.kind == ProbeKind::Http) {
+    // "HTTP/1.1 204": consome o que chegou (um middlebox pode picotar a linha
+    // de status) e só decide com os 12 bytes; sem consumir, o select() giraria
+    ssize_t received = recv(probe.fd, probe.status + probe.statusLength,
+                            PROBE_HTTP_STATUS_LEN - probe.statusLength, 0);
+    if (received < 0 && errno == EWOULDBLOCK) return;
+    if (received <= 0) {
+      _finish(probe, false, now);
+      return;
+    }
+    probe.statusLength += (uint8_t)received;
+    if (probe.statusLength < PROBE_HTTP_STATUS_LEN) return;
+    _finish(probe, memcmp(probe.status, "HTTP/1.", 7) == 0 && memcmp(probe.status + 9, "204", 3) == 0, now);
+    return;
+  }
+  ssize_t received = recv(probe.fd, buffer, sizeof(buffer), 0);
+  if (received < 12) {
+    if (received < 0 && errno == EWOULDBLOCK) return;
+    _finish(probe, false, now);
+    return;
+  }
+  // Outro id é resposta atrasada de uma rodada anterior
+  if (buffer[0] != (uint8_t)(probe.id >> 8) || buffer[1] != (uint8_t)probe.id || !(buffer[2] & 0x80)) return;
+  uint32_t address = firstARecord(buffer, (size_t)received);
+  _finish(probe, (buffer[3] & 0x0F) == 0 && address != 0, now);
+  if (address != 0) _onAddress(address, now);
+}
+
+// Eco casado pelo IcmpEngine; a etiqueta é o índice da sonda
+void ProbeEngine::_onEcho(void* context, uint16_t tag, uint32_t from, int32_t rttUs) {
+  ProbeEngine* engine = static_cast<ProbeEngine*>(context);
+  Probe& probe = engine->_probes[tag];
+  if (probe.state != State::Sent || rttUs < 0) return;
+  probe.result.from = from;
+  // Time Exceeded só conta para a sonda de salto; para o ping, o alvo não foi alcançado
+  bool ok = probe.result.kind == ProbeKind::Hop || from == probe.result.ip;
+  engine->_finish(probe, ok, probe.startUs + (uint32_t)rttUs);
+}
+
+void ProbeEngine::_onAddress(uint32_t address, uint32_t now) {
+  _hostIp = address;
+  for (size_t i = 0; i < _count; i++) {
+    Probe& probe = _probes[i];
+    if (probe.state != State::WaitingAddress) continue;
+    // O tempo do HTTP conta a partir daqui: a resolução já foi medida pela sonda DNS
+    probe.result.ip = address;
+    _start(probe, now);
+  }
+}
+
+ProbeVerdict ProbeEngine::run(uint16_t deadlineMs, uint8_t quorum, bool stopAtQuorum) {
+  ProbeVerdict verdict;
+  memset(&verdict, 0, sizeof(verdict));
+  bool icmp = false;
+  for (size_t i = 0; i < _count; i++) {
+    Probe& probe = _probes[i];
+    probe.state = State::Idle;
+    probe.fd = -1;
+    probe.result.ok = false;
+    probe.result.us = 0;
+    probe.result.from = 0;
+    if (probe.result.kind == ProbeKind::Icmp || probe.result.kind == ProbeKind::Hop) icmp = true;
+  }
+  if (icmp && !_icmp.open()) ESP_LOGW(TAG, "Sondas de ping falham sem o socket ICMP.");
+
+  uint32_t start = nowUs();
+  uint32_t answeredIps[PROBE_MAX];
+  size_t answered = 0;
+  for (;;) {
+    uint32_t now = nowUs();
+    uint32_t elapsedMs = (now - start) / 1000;
+    bool pending = false;
+    uint32_t wakeMs = deadlineMs;
+    for (size_t i = 0; i < _count; i++) {
+      Probe& probe = _probes[i];
+      if (probe.state == State::Idle && probe.result.startMs <= elapsedMs) _start(probe, now);
+      if (probe.state == State::Idle) wakeMs = std::min<uint32_t>(wakeMs, probe.result.startMs);
+      if (probe.state != State::Done) pending = true;
+    }
+
+    // Destinos distintos que votam e já responderam
+    answered = 0;
+    for (size_t i = 0; i < _count; i++) {
+      const ProbeResult& r = _probes[i].result;
+      if (!r.ok || !r.votes || std::find(answeredIps, answeredIps + answered, r.ip) != answeredIps + answered) continue;
+      answeredIps[answered++] = r.ip;
+    }
+    if ((stopAtQuorum && answered >= quorum) || !pending || elapsedMs >= deadlineMs) break;
+
+    fd_set readable, writable;
+    FD_ZERO(&readable);
+    FD_ZERO(&writable);
+    int maxFd = -1;
+    bool icmpPending = false;
+    for (size_t i = 0; i < _count; i++) {
+      Probe& probe = _probes[i];
+      if (probe.state == State::Sent && probe.fd >= 0) FD_SET(probe.fd, &readable);
+      if (probe.state == State::Connecting) FD_SET(probe.fd, &writable);
+      if (probe.state == State::Sent && probe.fd < 0) icmpPending = true;
+      if ((probe.state == State::Sent || probe.state == State::Connecting) && probe.fd > maxFd) maxFd = probe.fd;
+    }
+    if (icmpPending && _icmp.isOpen()) {
+      FD_SET(_icmp.fd(), &readable);
+      maxFd = std::max(maxFd, _icmp.fd());
+    }
+    uint32_t waitMs = std::max<uint32_t>(wakeMs - std::min(wakeMs, elapsedMs), 1);
+    if (maxFd < 0) {
+      // Só sondas agendadas (ou HTTP esperando o DNS, que também tem prazo)
+      sleepMs(waitMs);
+      continue;
+    }
+    timeval timeout = { (long)(waitMs / 1000), (long)(waitMs % 1000) * 1000 };
+    if (select(maxFd + 1, &readable, &writable, nullptr, &timeout) <= 0) continue;
+
+    now = nowUs();
+    for (size_t i = 0; i < _count; i++) {
+      Probe& probe = _probes[i];
+      if (probe.fd < 0) continue;
+      if (probe.state == State::Connecting && FD_ISSET(probe.fd, &writable)) {
+        _onWritable(probe, now);
+      } else if (probe.state == State::Sent && FD_ISSET(probe.fd, &readable)) {
+        _onReadable(probe, now);
+      }
+    }
+    if (_icmp.isOpen() && FD_ISSET(_icmp.fd(), &readable)) _icmp.receive(now, _onEcho, this);
+  }
+
+  // Prazo esgotado: o que ficou sem resposta é falha
+  uint32_t end = nowUs();
+  for (size_t i = 0; i < _count; i++) {
+    Probe& probe = _probes[i];
+    if (probe.state != State::Done) _finish(probe, false, end);
+    if (probe.result.ok) {
+      verdict.succeeded++;
+    } else {
+      verdict.failed++;
+    }
+  }
+  _icmp.close();
+  verdict.answered = (uint8_t)answered;
+  verdict.online = answered >= quorum;
+  verdict.elapsedMs = (uint16_t)std::min<uint32_t>((end - start) / 1000, 0xFFFF);
+  return verdict;
+}
@@ -0,0 +1,122 @@
+#include "ProbeScheduler.h"
+#include "esp_log.h"
+#include <algorithm>
+
+static const char* TAG = "ProbeScheduler";
+
+static_assert(PROBE_MIN_INTERVAL_MS > 0 && PROBE_MIN_INTERVAL_MS <= PROBE_MAX_INTERVAL_MS, "limites do intervalo");
+static_assert(PROBE_BUDGET_PER_MIN > 0, "orçamento de sondas");
+
+ProbeScheduler::ProbeScheduler() {
+  start(0);
+}
+
+void ProbeScheduler::start(uint32_t nowMs) {
+  _health = LinkHealth::Healthy;
+  // Começa atento e relaxa conforme as batidas confirmam o link
+  _intervalMs = PROBE_MIN_INTERVAL_MS;
+  _streak = 0;
+  _failures = 0;
+  _srttUs = 0;
+  _rttvarUs = 0;
+  _creditMilli = PROBE_BUDGET_BURST * 1000;
+  _refillMs = nowMs;
+}
+
+const char* ProbeScheduler::healthName(LinkHealth health) {
+  static const char* const names[] = { "healthy", "degraded", "down" };
+  return names[(int)health];
+}
+
+void ProbeScheduler::_setHealth(LinkHealth health) {
+  if (health == _health) return;
+  ESP_LOGI(TAG, "Link %s -> %s (batida a cada %u ms, crédito %d sondas)", healthName(_health), healthName(health),
+           (unsigned)_intervalMs, (int)credit());
+  _health = health;
+}
+
+void ProbeScheduler::_tighten(uint32_t intervalMs) {
+  _intervalMs = std::max<uint32_t>(PROBE_MIN_INTERVAL_MS, std::min(_intervalMs, intervalMs));
+  _streak = 0;
+}
+
+void ProbeScheduler::_refill(uint32_t nowMs) {
+  uint32_t elapsed = nowMs - _refillMs;
+  // PROBE_BUDGET_PER_MIN sondas por 60000 ms = PROBE_BUDGET_PER_MIN / 60 milésimos por ms
+  int64_t credit = (int64_t)_creditMilli + (int64_t)elapsed * PROBE_BUDGET_PER_MIN / 60;
+  _creditMilli = (int32_t)std::min<int64_t>(credit, PROBE_BUDGET_BURST * 1000);
+  // Guarda o resto da divisão para não perder crédito com chamadas frequentes
+  _refillMs = nowMs - (uint32_t)((int64_t)elapsed * PROBE_BUDGET_PER_MIN % 60 / PROBE_BUDGET_PER_MIN);
+}
+
+void ProbeScheduler::charge(uint32_t probes, uint32_t nowMs) {
+  _refill(nowMs);
+  // A dívida para em uma rajada: nem uma rodada grande de diagnóstico adia a
+  // batida por mais que o tempo de recarregar PROBE_BUDGET_BURST sondas
+  _creditMilli = (int32_t)std::max<int64_t>((int64_t)_creditMilli - (int64_t)probes * 1000,
+                                            -(int64_t)PROBE_BUDGET_BURST * 1000);
+}
+
+bool ProbeScheduler::onHeartbeat(bool ok, uint32_t rttUs, uint32_t nowMs) {
+  (void)nowMs;
+  if (!ok) {
+    if (_failures < 0xFF) _failures++;
+    _tighten(PROBE_MIN_INTERVAL_MS);
+    if (_health == LinkHealth::Healthy) _setHealth(LinkHealth::Degraded);
+    return _failures >= PROBE_CONFIRM_FAILURES && _health != LinkHealth::Down;
+  }
+  bool answeredAgain = _failures > 0;
+  _failures = 0;
+  // Primeira resposta do alvo durante a queda: a verificação completa confirma
+  // a volta (se ele nunca parou de responder, a falha é outra e fica para o minuto)
+  if (_health == LinkHealth::Down) return answeredAgain;
+
+  bool slow = false;
+  if (_srttUs == 0) {
+    _srttUs = rttUs;
+    _rttvarUs = rttUs / 2;
+  } else {
+    // Compara com o limite antes de incluir a amostra, como o RTO
+    slow = rttUs > _srttUs + 4 * _rttvarUs + PROBE_RTT_SLACK_US;
+    uint32_t deviation = rttUs > _srttUs ? rttUs - _srttUs : _srttUs - rttUs;
+    _rttvarUs = _rttvarUs - _rttvarUs / 4 + deviation / 4;
+    _srttUs = _srttUs - _srttUs / 8 + rttUs / 8;
+  }
+
+  if (slow) {
+    _tighten(_intervalMs / 4);
+    _setHealth(LinkHealth::Degraded);
+  } else if (++_streak >= PROBE_HEALTHY_STREAK) {
+    _streak = 0;
+    _intervalMs = std::min<uint32_t>(_intervalMs * 2, PROBE_MAX_INTERVAL_MS);
+    if (_health == LinkHealth::Degraded) _setHealth(LinkHealth::Healthy);
+  }
+  return false;
+}
+
+void ProbeScheduler::onCheck(bool online, uint8_t lossPct) {
+  if (!online) {
+    _tighten(PROBE_MIN_INTERVAL_MS);
+    _setHealth(LinkHealth::Down);
+    return;
+  }
+  _failures = 0;
+  if (lossPct > 0) {
+    _tighten(_intervalMs / 4);
+    _setHealth(LinkHealth::Degraded);
+  } else if (_health == LinkHealth::Down) {
+    // Voltou: continua atento até as batidas confirmarem
+    _setHealth(LinkHealth::Degraded);
+  }
+}
+
+uint32_t ProbeScheduler::nextDelay(uint32_t nowMs) {
+  _refill(nowMs);
+  uint32_t delay = _intervalMs;
+  if (_creditMilli < 1000) {
+    // Espera a recarga pagar uma sonda
+    uint32_t missing = (uint32_t)(1000 - _creditMilli);
+    delay = std::max<uint32_t>(delay, (missing * 60 + PROBE_BUDGET_PER_MIN - 1) / PROBE_BUDGET_PER_MIN);
+  }
+  return delay;
+}
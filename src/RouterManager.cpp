@@ -15,6 +15,8 @@ const unsigned long TWO_HOURS = 2 * 60 * 60 * 1000;
 RouterManager::RouterManager(const int relayPin) {
     _currentState = NORMAL;
     _isInternetUp = true;
+    _fault = FaultVerdict::Healthy;
+    _announcedFault = FaultVerdict::Healthy;
     _lastStateChangeTime = 0;
     _relayPin = relayPin;
     _stateMutex = NULL;
@@ -43,8 +45,9 @@ void RouterManager::setNotificationManager(NotificationManager* nm) {
 }
 
 // Atualiza o status da internet (chamada pela logicTask)
-void RouterManager::updateInternetStatus(bool isUp) {
+void RouterManager::updateInternetStatus(bool isUp, FaultVerdict fault) {
     if (xSemaphoreTake(_stateMutex, (TickType_t)10) == pdTRUE) {
+        _fault = fault;
         // Lógica de transição de estado: só acontece quando o status MUDA
         if (isUp != _isInternetUp) {
             _isInternetUp = isUp;
@@ -55,6 +58,7 @@ void RouterManager::updateInternetStatus(bool isUp) {
                     _notificationManager->sendMessage("✅ *Internet Recuperada!* Sistema voltando ao estado normal.");
                 }
                 _currentState = NORMAL;
+                _announcedFault = FaultVerdict::Healthy;
             } else {
                 // Se a internet caiu
                 ESP_LOGW(TAG_RM, "[State Machine] Internet caiu! Iniciando contagem para o primeiro reboot.");
@@ -125,15 +129,31 @@ void RouterManager::loop() {
                 break;
         }
 
+        // Falha confirmada fora do roteador (provedor, DNS externo): o reboot só
+        // somaria minutos de queda. Pula esta tentativa, mas a escada segue, e
+        // o aviso sai uma vez por veredito.
+        bool postponed = shouldReboot && !FaultLocator::rebootHelps(_fault);
+        if (postponed) {
+            snprintf(notificationMessage, sizeof(notificationMessage),
+                     "⏸️ *Reboot adiado:* a falha está em %s, fora do roteador.", FaultLocator::verdictLabel(_fault));
+            ESP_LOGW(TAG_RM, "[State Machine] %s", notificationMessage);
+            if (_notificationManager && _fault != _announcedFault) {
+                _notificationManager->sendMessage(notificationMessage);
+            }
+            _announcedFault = _fault;
+        }
+
         // Se qualquer um dos 'cases' acima decidiu que é hora de rebootar...
         if (shouldReboot) {
-            ESP_LOGI(TAG_RM, "[State Machine] %s", notificationMessage);
-            if (_notificationManager) {
-                _notificationManager->sendMessage(notificationMessage);
+            if (!postponed) {
+                ESP_LOGI(TAG_RM, "[State Machine] %s", notificationMessage);
+                if (_notificationManager) {
+                    _notificationManager->sendMessage(notificationMessage);
+                }
+
+                performIntelligentReboot();
             }
             
-            performIntelligentReboot();
-            
             // Avança para o próximo estado
             if(_currentState == AWAITING_FIRST_REBOOT) _currentState = AWAITING_SECOND_REBOOT;
             else if(_currentState == AWAITING_SECOND_REBOOT) _currentState = AWAITING_30MIN_REBOOT_1;
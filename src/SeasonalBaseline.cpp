@@ -0,0 +1,95 @@
+#include "SeasonalBaseline.h"
+#include <cmath>
+#include <cstring>
+
+static const float MEAN_SCALE = 1024.0f;  // Q10: até ±32 em log1p
+static const float SD_SCALE = 2048.0f;    // Q11: até 32 em log1p
+
+static inline float logValue(float raw) {
+  return log1pf(raw > 0.0f ? raw : 0.0f);
+}
+
+SeasonalBaseline::SeasonalBaseline() {
+  reset();
+}
+
+void SeasonalBaseline::reset() {
+  memset(_buckets, 0, sizeof(_buckets));
+}
+
+int SeasonalBaseline::bucketFor(time_t now) {
+  if (now < SEASONAL_MIN_VALID_TIME) return -1;
+  struct tm local;
+  if (localtime_r(&now, &local) == nullptr) return -1;
+  return local.tm_wday * SEASONAL_BUCKETS_PER_DAY + local.tm_hour;
+}
+
+float SeasonalBaseline::score(int bucket, const float* raw, int* worstFeature) const {
+  const Bucket& b = _buckets[bucket];
+  float worst = 0.0f;
+  int worstIndex = 0;
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) {
+    float z = fabsf(logValue(raw[i]) - b.mean[i]) / (sqrtf(b.var[i]) + SEASONAL_SD_FLOOR);
+    if (z > worst) {
+      worst = z;
+      worstIndex = i;
+    }
+  }
+  if (worstFeature != nullptr) *worstFeature = worstIndex;
+  return worst;
+}
+
+void SeasonalBaseline::update(int bucket, const float* raw) {
+  Bucket& b = _buckets[bucket];
+  if (b.count < UINT16_MAX) b.count++;
+  // Aritmética nas primeiras janelas do balde, exponencial depois
+  float alpha = 1.0f / b.count;
+  if (alpha < SEASONAL_ALPHA_MIN) alpha = SEASONAL_ALPHA_MIN;
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) {
+    float delta = logValue(raw[i]) - b.mean[i];
+    b.mean[i] += alpha * delta;
+    b.var[i] = (1.0f - alpha) * (b.var[i] + alpha * delta * delta);
+  }
+}
+
+static int16_t quantizeMean(float v) {
+  float q = roundf(v * MEAN_SCALE);
+  if (q > INT16_MAX) q = INT16_MAX;
+  if (q < INT16_MIN) q = INT16_MIN;
+  return (int16_t)q;
+}
+
+static uint16_t quantizeSd(float var) {
+  float q = roundf(sqrtf(var) * SD_SCALE);
+  if (q > UINT16_MAX) q = UINT16_MAX;
+  return (uint16_t)q;
+}
+
+void SeasonalBaseline::exportDay(int day, StoredDay* out) const {
+  memset(out, 0, sizeof(*out));
+  out->version = SEASONAL_STATE_VERSION;
+  for (int h = 0; h < SEASONAL_BUCKETS_PER_DAY; h++) {
+    const Bucket& b = _buckets[day * SEASONAL_BUCKETS_PER_DAY + h];
+    StoredBucket& s = out->buckets[h];
+    s.count = b.count;
+    for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) {
+      s.mean[i] = quantizeMean(b.mean[i]);
+      s.sd[i] = quantizeSd(b.var[i]);
+    }
+  }
+}
+
+bool SeasonalBaseline::importDay(int day, const StoredDay& in) {
+  if (in.version != SEASONAL_STATE_VERSION || day < 0 || day >= SEASONAL_BUCKETS / SEASONAL_BUCKETS_PER_DAY) return false;
+  for (int h = 0; h < SEASONAL_BUCKETS_PER_DAY; h++) {
+    const StoredBucket& s = in.buckets[h];
+    Bucket& b = _buckets[day * SEASONAL_BUCKETS_PER_DAY + h];
+    b.count = s.count;
+    for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) {
+      b.mean[i] = s.mean[i] / MEAN_SCALE;
+      float sd = s.sd[i] / SD_SCALE;
+      b.var[i] = sd * sd;
+    }
+  }
+  return true;
+}
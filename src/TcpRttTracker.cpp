@@ -0,0 +1,246 @@
+#include "TcpRttTracker.h"
+#include <algorithm>
+#include <cstring>
+
+// Timeouts da tabela de fluxos (microssegundos)
+static const uint32_t HANDSHAKE_TIMEOUT_US = 5 * 1000 * 1000;
+static const uint32_t IDLE_TIMEOUT_US = 30 * 1000 * 1000;
+// Quantos slots vizinhos são examinados a partir do hash
+static const int FLOW_PROBE_WINDOW = 8;
+
+static inline bool isPrivateIp(uint32_t ip) {
+  return (ip >> 24) == 10 || (ip >> 20) == 0xAC1 || (ip >> 16) == 0xC0A8;
+}
+
+// Comparação de números de sequência com wrap-around (RFC 1982)
+static inline bool seqLessOrEqual(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) <= 0;
+}
+
+static uint32_t percentile(const uint32_t* ring, uint16_t count, int pct) {
+  uint32_t sorted[TCP_RTT_SAMPLES_PER_PREFIX];
+  memcpy(sorted, ring, count * sizeof(uint32_t));
+  std::sort(sorted, sorted + count);
+  int rank = (count * pct + 99) / 100; // Nearest-rank
+  if (rank < 1) rank = 1;
+  return sorted[rank - 1];
+}
+
+TcpRttTracker::TcpRttTracker() {
+  reset();
+}
+
+void TcpRttTracker::reset() {
+  memset(_flows, 0, sizeof(_flows));
+  memset(_prefixes, 0, sizeof(_prefixes));
+  _totalRetransmissions = 0;
+}
+
+uint32_t TcpRttTracker::_hash(uint32_t ipA, uint16_t portA, uint32_t ipB, uint16_t portB) {
+  // Simétrico: os dois sentidos do fluxo caem no mesmo slot
+  uint32_t a = ipA ^ ((uint32_t)portA << 16 | portA);
+  uint32_t b = ipB ^ ((uint32_t)portB << 16 | portB);
+  uint32_t h = (a ^ b) * 0x9E3779B1u;
+  return h ^ (h >> 15);
+}
+
+TcpRttTracker::FlowEntry* TcpRttTracker::_findFlow(uint32_t ipA, uint16_t portA, uint32_t ipB, uint16_t portB, int& direction) {
+  uint32_t start = _hash(ipA, portA, ipB, portB);
+  for (int i = 0; i < FLOW_PROBE_WINDOW; i++) {
+    FlowEntry& flow = _flows[(start + i) & (TCP_RTT_MAX_FLOWS - 1)];
+    if (flow.state == FLOW_FREE) continue;
+    if (flow.clientIp == ipA && flow.clientPort == portA && flow.serverIp == ipB && flow.serverPort == portB) {
+      direction = 0;
+      return &flow;
+    }
+    if (flow.clientIp == ipB && flow.clientPort == portB && flow.serverIp == ipA && flow.serverPort == portA) {
+      direction = 1;
+      return &flow;
+    }
+  }
+  return nullptr;
+}
+
+TcpRttTracker::FlowEntry* TcpRttTracker::_allocateFlow(uint32_t clientIp, uint16_t clientPort, uint32_t serverIp, uint16_t serverPort, uint32_t nowUs) {
+  uint32_t start = _hash(clientIp, clientPort, serverIp, serverPort);
+  FlowEntry* victim = nullptr;
+  for (int i = 0; i < FLOW_PROBE_WINDOW; i++) {
+    FlowEntry& flow = _flows[(start + i) & (TCP_RTT_MAX_FLOWS - 1)];
+    if (flow.state == FLOW_FREE) {
+      victim = &flow;
+      break;
+    }
+    // Sem slot livre, reaproveita o fluxo mais antigo da janela de busca
+    if (victim == nullptr || (nowUs - flow.lastSeenUs) > (nowUs - victim->lastSeenUs)) {
+      victim = &flow;
+    }
+  }
+  memset(victim, 0, sizeof(FlowEntry));
+  victim->clientIp = clientIp;
+  victim->clientPort = clientPort;
+  victim->serverIp = serverIp;
+  victim->serverPort = serverPort;
+  victim->lastSeenUs = nowUs;
+  return victim;
+}
+
+TcpRttTracker::PrefixStats* TcpRttTracker::_prefixFor(uint32_t ip, uint32_t nowUs) {
+  uint32_t prefix = ip & (0xFFFFFFFFu << (32 - TCP_RTT_PREFIX_LEN));
+  PrefixStats* victim = nullptr;
+  for (int i = 0; i < TCP_RTT_MAX_PREFIXES; i++) {
+    PrefixStats& stats = _prefixes[i];
+    if (stats.inUse && stats.prefix == prefix) {
+      stats.lastUpdateUs = nowUs;
+      return &stats;
+    }
+    if (!stats.inUse) {
+      if (victim == nullptr || victim->inUse) victim = &stats;
+    } else if (victim == nullptr || (victim->inUse && (nowUs - stats.lastUpdateUs) > (nowUs - victim->lastUpdateUs))) {
+      victim = &stats;
+    }
+  }
+  memset(victim, 0, sizeof(PrefixStats));
+  victim->inUse = true;
+  victim->prefix = prefix;
+  victim->lastUpdateUs = nowUs;
+  return victim;
+}
+
+void TcpRttTracker::_trackSequence(FlowEntry& flow, int direction, const ParsedFrame& frame) {
+  // Retries da camada MAC repetem o mesmo quadro e não são retransmissões TCP
+  if (frame.l4PayloadLength == 0 || frame.isRetry()) return;
+
+  uint32_t end = frame.tcpSeq + frame.l4PayloadLength;
+  if (flow.seqKnown[direction] && seqLessOrEqual(end, flow.nextSeq[direction])) {
+    _totalRetransmissions++;
+    _prefixFor(flow.serverIp, frame.timestampUs)->retransmissions++;
+    return;
+  }
+  flow.nextSeq[direction] = end;
+  flow.seqKnown[direction] = true;
+}
+
+void TcpRttTracker::onFrame(const ParsedFrame& frame) {
+  if (!frame.hasIpv4 || frame.ipProto != IP_PROTO_TCP || frame.l4Payload == nullptr) return;
+
+  uint32_t now = frame.timestampUs;
+  uint8_t flags = frame.tcpFlags;
+  int direction = 0;
+  FlowEntry* flow = _findFlow(frame.srcIp, frame.srcPort, frame.dstIp, frame.dstPort, direction);
+
+  if ((flags & TCP_FLAG_SYN) && !(flags & TCP_FLAG_ACK)) {
+    if (flow && flow->state == FLOW_SYN_SENT && direction == 0 && flow->clientIsn == frame.tcpSeq) {
+      // SYN repetido: conta como retransmissão e invalida a amostra de RTT
+      flow->synRetransmitted = true;
+      flow->lastSeenUs = now;
+      _totalRetransmissions++;
+      _prefixFor(flow->serverIp, now)->retransmissions++;
+      return;
+    }
+    if (!flow) flow = _allocateFlow(frame.srcIp, frame.srcPort, frame.dstIp, frame.dstPort, now);
+    flow->state = FLOW_SYN_SENT;
+    flow->clientIsn = frame.tcpSeq;
+    flow->synUs = now;
+    flow->lastSeenUs = now;
+    flow->nextSeq[0] = frame.tcpSeq + 1;
+    flow->seqKnown[0] = true;
+    return;
+  }
+
+  if ((flags & TCP_FLAG_SYN) && (flags & TCP_FLAG_ACK)) {
+    if (!flow || direction != 1 || frame.tcpAck != flow->clientIsn + 1) return;
+    flow->lastSeenUs = now;
+    if (flow->state == FLOW_SYN_ACKED && flow->serverIsn == frame.tcpSeq) {
+      flow->synRetransmitted = true;
+      _totalRetransmissions++;
+      _prefixFor(flow->serverIp, now)->retransmissions++;
+      return;
+    }
+    if (flow->state != FLOW_SYN_SENT) return;
+    flow->state = FLOW_SYN_ACKED;
+    flow->serverIsn = frame.tcpSeq;
+    flow->synAckUs = now;
+    flow->nextSeq[1] = frame.tcpSeq + 1;
+    flow->seqKnown[1] = true;
+    if (!flow->synRetransmitted) {
+      PrefixStats* stats = _prefixFor(flow->serverIp, now);
+      stats->wan[stats->wanHead] = now - flow->synUs;
+      stats->wanHead = (stats->wanHead + 1) % TCP_RTT_SAMPLES_PER_PREFIX;
+      if (stats->wanCount < TCP_RTT_SAMPLES_PER_PREFIX) stats->wanCount++;
+    }
+    return;
+  }
+
+  if (!flow) {
+    // Fluxo já estabelecido antes da captura: acompanha só as retransmissões,
+    // sem expulsar fluxos cujo handshake ainda está em andamento.
+    if (frame.l4PayloadLength == 0) return;
+    bool srcIsLocal = isPrivateIp(frame.srcIp) || !isPrivateIp(frame.dstIp);
+    uint32_t clientIp = srcIsLocal ? frame.srcIp : frame.dstIp;
+    uint16_t clientPort = srcIsLocal ? frame.srcPort : frame.dstPort;
+    uint32_t serverIp = srcIsLocal ? frame.dstIp : frame.srcIp;
+    uint16_t serverPort = srcIsLocal ? frame.dstPort : frame.srcPort;
+    uint32_t start = _hash(clientIp, clientPort, serverIp, serverPort);
+    for (int i = 0; i < FLOW_PROBE_WINDOW && !flow; i++) {
+      if (_flows[(start + i) & (TCP_RTT_MAX_FLOWS - 1)].state == FLOW_FREE) {
+        flow = _allocateFlow(clientIp, clientPort, serverIp, serverPort, now);
+      }
+    }
+    if (!flow) return;
+    flow->state = FLOW_ESTABLISHED;
+    direction = srcIsLocal ? 0 : 1;
+  }
+
+  flow->lastSeenUs = now;
+  if (flow->state == FLOW_SYN_ACKED && direction == 0 && (flags & TCP_FLAG_ACK) && frame.tcpAck == flow->serverIsn + 1) {
+    flow->state = FLOW_ESTABLISHED;
+    PrefixStats* stats = _prefixFor(flow->serverIp, now);
+    stats->handshakes++;
+    if (!flow->synRetransmitted) {
+      stats->lan[stats->lanHead] = now - flow->synAckUs;
+      stats->lanHead = (stats->lanHead + 1) % TCP_RTT_SAMPLES_PER_PREFIX;
+      if (stats->lanCount < TCP_RTT_SAMPLES_PER_PREFIX) stats->lanCount++;
+    }
+  }
+
+  _trackSequence(*flow, direction, frame);
+
+  if (flags & (TCP_FLAG_FIN | TCP_FLAG_RST)) {
+    flow->state = FLOW_FREE;
+  }
+}
+
+void TcpRttTracker::expire(uint32_t nowUs) {
+  for (int i = 0; i < TCP_RTT_MAX_FLOWS; i++) {
+    FlowEntry& flow = _flows[i];
+    if (flow.state == FLOW_FREE) continue;
+    uint32_t idle = nowUs - flow.lastSeenUs;
+    uint32_t limit = (flow.state == FLOW_ESTABLISHED) ? IDLE_TIMEOUT_US : HANDSHAKE_TIMEOUT_US;
+    if (idle > limit) flow.state = FLOW_FREE;
+  }
+}
+
+size_t TcpRttTracker::summarize(TcpRttPrefixSummary* out, size_t maxOut) const {
+  size_t written = 0;
+  for (int i = 0; i < TCP_RTT_MAX_PREFIXES && written < maxOut; i++) {
+    const PrefixStats& stats = _prefixes[i];
+    if (!stats.inUse) continue;
+    TcpRttPrefixSummary& summary = out[written++];
+    memset(&summary, 0, sizeof(summary));
+    summary.prefix = stats.prefix;
+    summary.prefixLen = TCP_RTT_PREFIX_LEN;
+    summary.lanSamples = stats.lanCount;
+    summary.wanSamples = stats.wanCount;
+    summary.handshakes = stats.handshakes;
+    summary.retransmissions = stats.retransmissions;
+    if (stats.lanCount > 0) {
+      summary.lanMedianUs = percentile(stats.lan, stats.lanCount, 50);
+      summary.lanP99Us = percentile(stats.lan, stats.lanCount, 99);
+    }
+    if (stats.wanCount > 0) {
+      summary.wanMedianUs = percentile(stats.wan, stats.wanCount, 50);
+      summary.wanP99Us = percentile(stats.wan, stats.wanCount, 99);
+    }
+  }
+  return written;
+}
@@ -0,0 +1,82 @@
+#include "TimerWheel.h"
+#include <cstring>
+
+static_assert((TIMER_WHEEL_SLOTS & (TIMER_WHEEL_SLOTS - 1)) == 0, "casas da roda em potência de 2");
+static_assert(TIMER_WHEEL_MAX_TIMERS <= 32 && TIMER_WHEEL_MAX_TIMERS < TIMER_WHEEL_NONE, "timers cabem na máscara");
+
+TimerWheel::TimerWheel() {
+  start(0);
+}
+
+void TimerWheel::start(uint32_t nowMs) {
+  memset(_timers, 0, sizeof(_timers));
+  memset(_slots, TIMER_WHEEL_NONE, sizeof(_slots));
+  _tick = 0;
+  _tickMs = nowMs;
+}
+
+void TimerWheel::_unlink(uint8_t id) {
+  Timer& timer = _timers[id];
+  if (timer.prev != TIMER_WHEEL_NONE) {
+    _timers[timer.prev].next = timer.next;
+  } else {
+    _slots[timer.due & (TIMER_WHEEL_SLOTS - 1)] = timer.next;
+  }
+  if (timer.next != TIMER_WHEEL_NONE) _timers[timer.next].prev = timer.prev;
+  timer.armed = false;
+}
+
+void TimerWheel::schedule(uint8_t id, uint32_t delayMs) {
+  if (id >= TIMER_WHEEL_MAX_TIMERS) return;
+  if (_timers[id].armed) _unlink(id);
+  // Arredonda para cima e vence no mínimo no próximo tick
+  uint32_t ticks = (delayMs + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+  Timer& timer = _timers[id];
+  timer.due = _tick + (ticks > 0 ? ticks : 1);
+  uint8_t& head = _slots[timer.due & (TIMER_WHEEL_SLOTS - 1)];
+  timer.prev = TIMER_WHEEL_NONE;
+  timer.next = head;
+  if (head != TIMER_WHEEL_NONE) _timers[head].prev = id;
+  head = id;
+  timer.armed = true;
+}
+
+void TimerWheel::cancel(uint8_t id) {
+  if (armed(id)) _unlink(id);
+}
+
+uint32_t TimerWheel::advance(uint32_t nowMs) {
+  uint32_t ticks = (nowMs - _tickMs) / TIMER_WHEEL_TICK_MS;
+  uint32_t target = _tick + ticks;
+  uint32_t fired = 0;
+  _tickMs += ticks * TIMER_WHEEL_TICK_MS;
+  // Depois de uma pausa longa basta uma volta: as casas se repetem
+  if (ticks > TIMER_WHEEL_SLOTS) _tick = target - TIMER_WHEEL_SLOTS;
+  while ((int32_t)(target - _tick) > 0) {
+    _tick++;
+    uint8_t id = _slots[_tick & (TIMER_WHEEL_SLOTS - 1)];
+    while (id != TIMER_WHEEL_NONE) {
+      uint8_t next = _timers[id].next;
+      // Os outros da casa ainda têm voltas pela frente
+      if ((int32_t)(_timers[id].due - target) <= 0) {
+        _unlink(id);
+        fired |= TIMER_BIT(id);
+      }
+      id = next;
+    }
+  }
+  return fired;
+}
+
+uint32_t TimerWheel::untilNext(uint32_t nowMs) const {
+  uint32_t best = UINT32_MAX;
+  for (uint8_t id = 0; id < TIMER_WHEEL_MAX_TIMERS; id++) {
+    if (!_timers[id].armed) continue;
+    int32_t ticks = (int32_t)(_timers[id].due - _tick);
+    uint32_t dueMs = _tickMs + (uint32_t)(ticks > 0 ? ticks : 0) * TIMER_WHEEL_TICK_MS;
+    int32_t remaining = (int32_t)(dueMs - nowMs);
+    uint32_t wait = remaining > 0 ? (uint32_t)remaining : 0;
+    if (wait < best) best = wait;
+  }
+  return best;
+}
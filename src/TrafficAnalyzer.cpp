@@ -1,35 +1,34 @@
 #include "TrafficAnalyzer.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
-#include <map>
+#include "AnalyzerPipeline.h"
+#include "AnalyzerStages.h"
+#include "PcapStream.h"
+#include <atomic>
+#include <sys/time.h>
+#include <time.h>
 #include <WiFi.h>
 
 static const char* TAG_TA = "TrafficAnalyzer";
 static QueueHandle_t packetQueue_s = NULL;
+static volatile bool snifferActive_s = false;
+static volatile bool captureActive_s = false;
+// Captura pcap em curso e resposta HTTP dona do fluxo (0 = nenhuma). O
+// servidor web e a operationalTask mexem nelas, daí os atômicos.
+static std::atomic<uint32_t> captureId_s(0);
+static std::atomic<uint32_t> streamOwner_s(0);
+static uint32_t nextCaptureId_s = 0;
+static uint8_t ownMac_s[6];
+static PcapStream pcapStream;
 
-// Estrutura para estatísticas por dispositivo
-struct DeviceStats {
-  uint64_t packetCount = 0;
-  uint64_t totalBytes = 0;
-};
-static std::map<String, DeviceStats> statsMap;
-
-// Função para extrair a query de um pacote DNS
-String parseDnsQuery(uint8_t* data, int len) {
-    if (len < 13) return "";
-    char* query = (char*)(data + 12);
-    char* q_end = (char*)(data + len);
-    String qname = "";
-    while (query < q_end && *query != 0) {
-        uint8_t label_len = *query++;
-        if (label_len == 0 || query + label_len > q_end) break;
-        for (int i = 0; i < label_len; i++) {
-            qname += (char)query[i];
-        }
-        query += label_len;
-        if (*query != 0) qname += ".";
-    }
-    return qname;
+// Pipeline de análise do sniffer: estágios compostos em tempo de compilação.
+// Para um novo analisador basta escrever o estágio e acrescentá-lo aqui.
+typedef Pipeline<StatsStage, DnsStage, FlowStage, RttStage, FeatureStage, FingerprintStage, AppClassStage> SnifferPipeline;
+static SnifferPipeline pipeline;
+
+// Fluxos que saem do cache vão para a fila de exportação NetFlow
+static void onFlowExpired(const FlowRecord& record, FlowExpiryReason reason, void* context) {
+  ((NetFlowExporter*)context)->enqueue(record);
 }
 
 // Callback do sniffer: apenas captura o pacote e envia para a fila
@@ -38,8 +37,20 @@ void TrafficAnalyzer::snifferCallback(void* buf, wifi_promiscuous_pkt_type_t typ
   
   wifi_promiscuous_pkt_t* packet = (wifi_promiscuous_pkt_t*)buf;
   wifi_pkt_rx_ctrl_t& ctrl = (wifi_pkt_rx_ctrl_t&)packet->rx_ctrl;
+
+  // Captura pcap: ignora os quadros do próprio ESP32 (inclusive o download do pcap)
+  if (captureActive_s && ctrl.sig_len >= 16 &&
+      memcmp(packet->payload + 4, ownMac_s, 6) != 0 && memcmp(packet->payload + 10, ownMac_s, 6) != 0) {
+    uint16_t captured = (ctrl.sig_len < PCAP_MAX_FRAME) ? ctrl.sig_len : PCAP_MAX_FRAME;
+    pcapStream.push(packet->payload, captured, ctrl.sig_len, ctrl.timestamp, ctrl.rssi, ctrl.channel);
+  }
+  if (!snifferActive_s) return;
+
   CapturedPacketInfo info;
   info.length = ctrl.sig_len;
+  info.timestamp = ctrl.timestamp;
+  info.rssi = ctrl.rssi;
+  info.channel = ctrl.channel;
   int len_to_copy = (info.length < sizeof(info.payload)) ? info.length : sizeof(info.payload);
   memcpy(info.payload, packet->payload, len_to_copy);
   xQueueSendToBack(packetQueue_s, &info, (TickType_t)0);
@@ -54,54 +65,29 @@ void snifferTask(void* pvParameters) {
   while (!analyzer->_stopSniffer) {
     CapturedPacketInfo receivedPacket;
     if (xQueueReceive(analyzer->_packetQueue, &receivedPacket, pdMS_TO_TICKS(1000))) {
-      // Coleta estatísticas de todos os pacotes recebidos
-      char macStr[18];
-      uint8_t* mac_source_ptr = receivedPacket.payload + 10;
-      sprintf(macStr, "%02X:%02X:%02X:%02X:%02X:%02X",
-              mac_source_ptr[0], mac_source_ptr[1], mac_source_ptr[2],
-              mac_source_ptr[3], mac_source_ptr[4], mac_source_ptr[5]);
-      statsMap[String(macStr)].packetCount++;
-      statsMap[String(macStr)].totalBytes += receivedPacket.length;
-
-      // Análise focada em pacotes DNS
-      const int IP_HEADER_OFFSET = 32;
-      if (receivedPacket.length > IP_HEADER_OFFSET && receivedPacket.payload[IP_HEADER_OFFSET - 2] == 0x08 && receivedPacket.payload[IP_HEADER_OFFSET - 1] == 0x00) {
-          uint8_t ip_protocol = receivedPacket.payload[IP_HEADER_OFFSET + 9];
-          if (ip_protocol == 17) { // UDP
-              const int UDP_HEADER_OFFSET = IP_HEADER_OFFSET + 20;
-              if (receivedPacket.length > UDP_HEADER_OFFSET + 2) {
-                  uint16_t dest_port = (receivedPacket.payload[UDP_HEADER_OFFSET] << 8) | receivedPacket.payload[UDP_HEADER_OFFSET + 1];
-                  if (dest_port == 53) { // DNS
-                      const int DNS_PAYLOAD_OFFSET = UDP_HEADER_OFFSET + 8;
-                      String dns_query = parseDnsQuery(receivedPacket.payload + DNS_PAYLOAD_OFFSET, receivedPacket.length - DNS_PAYLOAD_OFFSET);
-                      if (dns_query.length() > 0) {
-                          ESP_LOGW(TAG_TA, "DNS Query from MAC %s -> %s", macStr, dns_query.c_str());
-                      }
-                  }
-              }
-          }
+      // Decodifica o quadro uma única vez e o entrega a todos os estágios
+      ParsedFrame frame;
+      frame.timestampUs = receivedPacket.timestamp;
+      frame.uptimeMs = millis();
+      frame.rssi = receivedPacket.rssi;
+      frame.channel = receivedPacket.channel;
+      int captured = (receivedPacket.length < (int)sizeof(receivedPacket.payload)) ? receivedPacket.length : sizeof(receivedPacket.payload);
+      if (parseWifiFrame(receivedPacket.payload, captured, receivedPacket.length, frame)) {
+        pipeline.onFrame(frame);
       }
     }
 
     // A cada 30 segundos, imprime as estatísticas e calcula os totais para a IA
     if (millis() - lastStatsPrint > 30000) {
       lastStatsPrint = millis();
-      ESP_LOGI(TAG_TA, "--- Estatísticas de Tráfego (últimos 30s) ---");
-      
-      uint32_t current_total_packets = 0;
-      uint64_t current_total_bytes = 0;
-
-      for(auto const& [mac, stats] : statsMap) {
-        ESP_LOGD(TAG_TA, "MAC: %s - Pacotes: %llu, Bytes: %llu", mac.c_str(), stats.packetCount, stats.totalBytes);
-        current_total_packets += stats.packetCount;
-        current_total_bytes += stats.totalBytes;
-      }
+      pipeline.onWindowEnd();
 
       // Guarda os totais para serem usados pelo AnomalyDetector
-      analyzer->_total_packets_in_window += current_total_packets;
-      analyzer->_total_bytes_in_window += current_total_bytes;
-      
-      statsMap.clear();
+      StatsStage& stats = pipeline.get<StatsStage>();
+      analyzer->_total_packets_in_window += stats.windowPackets();
+      analyzer->_total_bytes_in_window += stats.windowBytes();
+      analyzer->_publishRttSummary();
+      analyzer->_publishActivities();
     }
   }
 
@@ -118,10 +104,19 @@ TrafficAnalyzer::TrafficAnalyzer() {
   _stopSniffer = false;
   _total_packets_in_window = 0;
   _total_bytes_in_window = 0;
+  _summaryMutex = NULL;
+  _rttSummaryCount = 0;
+  _activityCount = 0;
+  _captureDeadline = 0;
 }
 
 // Setup
 void TrafficAnalyzer::setup() {
+  _summaryMutex = xSemaphoreCreateMutex();
+  _flowExporter.setup();
+  pipeline.get<FlowStage>().table().setExpiredCallback(onFlowExpired, &_flowExporter);
+  pipeline.get<FingerprintStage>().fingerprinter().setup();
+  pipeline.get<StatsStage>().profiles().setup();
   _packetQueue = xQueueCreate(100, sizeof(CapturedPacketInfo));
   packetQueue_s = _packetQueue;
   ESP_LOGI(TAG_TA, "Módulo de Análise de Tráfego inicializado.");
@@ -134,11 +129,20 @@ void TrafficAnalyzer::start() {
     return;
   }
   if (_snifferTaskHandle != NULL) return;
+  if (isCapturing()) {
+    ESP_LOGW(TAG_TA, "Captura pcap em andamento. Modo sniffer adiado.");
+    return;
+  }
   
   _stopSniffer = false;
+  snifferActive_s = true;
   // Zera os contadores no início de cada ciclo
   _total_packets_in_window = 0;
   _total_bytes_in_window = 0;
+  pipeline.get<RttStage>().tracker().reset();
+  pipeline.get<FeatureStage>().reset();
+  pipeline.get<AppClassStage>().classifier().reset();
+  pipeline.get<StatsStage>().profiles().beginCycle();
 
   ESP_LOGI(TAG_TA, "Preparando para modo promíscuo...");
   _target_channel = WiFi.channel();
@@ -170,6 +174,184 @@ void TrafficAnalyzer::stop() {
     vTaskDelay(pdMS_TO_TICKS(1100)); 
   }
   esp_wifi_set_promiscuous(false);
-  statsMap.clear(); // Garante que o mapa seja limpo
+  snifferActive_s = false;
+  // Fecha a última janela (atualiza os perfis) e zera os contadores
+  pipeline.get<StatsStage>().onWindowEnd();
+  pipeline.get<StatsStage>().reset();
+  _windowFeatures = pipeline.get<FeatureStage>().features();
+  _deviceFeatureCount = pipeline.get<FeatureStage>().deviceFeatures(_deviceFeatures, FEATURE_MAX_STATIONS);
+  pipeline.get<FingerprintStage>().fingerprinter().endCycle(time(nullptr));
+  pipeline.get<AppClassStage>().classifier().endCycle();
+  pipeline.get<FlowStage>().table().flushAll(); // Fim da captura: todos os fluxos abertos são exportados
+  _publishRttSummary();
+  _publishActivities();
   ESP_LOGI(TAG_TA, "Modo promíscuo parado.");
+}
+
+DeviceProfileStore& TrafficAnalyzer::profiles() {
+  return pipeline.get<StatsStage>().profiles();
+}
+
+DeviceFingerprinter& TrafficAnalyzer::fingerprinter() {
+  return pipeline.get<FingerprintStage>().fingerprinter();
+}
+
+// Calcula mediana/p99 por prefixo e publica o resumo para a API web
+void TrafficAnalyzer::_publishRttSummary() {
+  TcpRttPrefixSummary summary[TCP_RTT_MAX_PREFIXES];
+  size_t count = pipeline.get<RttStage>().tracker().summarize(summary, TCP_RTT_MAX_PREFIXES);
+
+  for (size_t i = 0; i < count; i++) {
+    const TcpRttPrefixSummary& s = summary[i];
+    ESP_LOGI(TAG_TA, "RTT %u.%u.%u.0/%u - WAN p50/p99: %u/%u us (%u), LAN p50/p99: %u/%u us (%u), retransmissões: %u",
+             (unsigned)(s.prefix >> 24), (unsigned)((s.prefix >> 16) & 0xFF), (unsigned)((s.prefix >> 8) & 0xFF), s.prefixLen,
+             s.wanMedianUs, s.wanP99Us, s.wanSamples, s.lanMedianUs, s.lanP99Us, s.lanSamples, s.retransmissions);
+  }
+
+  if (_summaryMutex && xSemaphoreTake(_summaryMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    memcpy(_rttSummary, summary, count * sizeof(TcpRttPrefixSummary));
+    _rttSummaryCount = count;
+    xSemaphoreGive(_summaryMutex);
+  }
+}
+
+size_t TrafficAnalyzer::getRttSummary(TcpRttPrefixSummary* out, size_t maxOut) {
+  size_t count = 0;
+  if (_summaryMutex && xSemaphoreTake(_summaryMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    count = (_rttSummaryCount < maxOut) ? _rttSummaryCount : maxOut;
+    memcpy(out, _rttSummary, count * sizeof(TcpRttPrefixSummary));
+    xSemaphoreGive(_summaryMutex);
+  }
+  return count;
+}
+
+// Publica a atividade de cada estação no ciclo para a API web e os alertas
+void TrafficAnalyzer::_publishActivities() {
+  StationActivity activities[APP_MAX_STATIONS];
+  size_t count = pipeline.get<AppClassStage>().classifier().summarize(activities, APP_MAX_STATIONS);
+
+  for (size_t i = 0; i < count && activities[i].activity != AppActivity::Idle; i++) {
+    const uint8_t* m = activities[i].mac;
+    ESP_LOGI(TAG_TA, "Atividade %02X:%02X:%02X:%02X:%02X:%02X: %s (%u%% dos bytes), %u/%u kbit/s", m[0], m[1], m[2],
+             m[3], m[4], m[5], AppClassifier::activityName(activities[i].activity), activities[i].share,
+             activities[i].downKbps, activities[i].upKbps);
+  }
+
+  if (_summaryMutex && xSemaphoreTake(_summaryMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    memcpy(_activities, activities, count * sizeof(StationActivity));
+    _activityCount = count;
+    xSemaphoreGive(_summaryMutex);
+  }
+}
+
+size_t TrafficAnalyzer::getActivities(StationActivity* out, size_t maxOut) {
+  size_t count = 0;
+  if (_summaryMutex && xSemaphoreTake(_summaryMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    count = (_activityCount < maxOut) ? _activityCount : maxOut;
+    memcpy(out, _activities, count * sizeof(StationActivity));
+    xSemaphoreGive(_summaryMutex);
+  }
+  return count;
+}
+
+bool TrafficAnalyzer::activityOf(const uint8_t* mac, StationActivity* out) {
+  bool found = false;
+  if (_summaryMutex && xSemaphoreTake(_summaryMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    for (size_t i = 0; i < _activityCount && !found; i++) {
+      if (memcmp(_activities[i].mac, mac, 6) == 0) {
+        *out = _activities[i];
+        found = true;
+      }
+    }
+    xSemaphoreGive(_summaryMutex);
+  }
+  return found;
+}
+
+void TrafficAnalyzer::setFlowCollector(const char* host, uint16_t port) {
+  _flowExporter.setCollector(host, port);
+}
+
+size_t TrafficAnalyzer::exportFlows() {
+  if (_flowExporter.droppedRecords() > 0) {
+    ESP_LOGW(TAG_TA, "NetFlow: %u registros descartados até agora (buffer cheio).", _flowExporter.droppedRecords());
+  }
+  return _flowExporter.flush(true);
+}
+
+// Inicia a captura pcap mantendo a associação com o AP, para que o cliente
+// HTTP continue recebendo o fluxo enquanto os quadros são capturados.
+uint32_t TrafficAnalyzer::startCapture(uint32_t seconds) {
+  if (_snifferTaskHandle != NULL || captureActive_s) return 0;
+  if (WiFi.status() != WL_CONNECTED) return 0;
+  // O anel ainda é de outra resposta: reiniciá-lo cortaria o fluxo dela
+  if (streamOwner_s.load() != 0 || pcapStream.hasPending()) return 0;
+  if (!pcapStream.begin(PCAP_RING_BYTES)) {
+    ESP_LOGE(TAG_TA, "Sem memória para o anel de captura pcap.");
+    return 0;
+  }
+  uint32_t id = ++nextCaptureId_s;
+  if (id == 0) id = ++nextCaptureId_s;
+  uint32_t none = 0;
+  if (!streamOwner_s.compare_exchange_strong(none, id)) return 0;
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  pcapStream.start((uint64_t)now.tv_sec * 1000000ULL + now.tv_usec);
+  WiFi.macAddress(ownMac_s);
+  _captureDeadline = millis() + seconds * 1000UL;
+  captureId_s.store(id);
+  captureActive_s = true;
+
+  wifi_promiscuous_filter_t filter = {.filter_mask = WIFI_PROMIS_FILTER_MASK_DATA};
+  esp_wifi_set_promiscuous_filter(&filter);
+  esp_wifi_set_promiscuous_rx_cb(&snifferCallback);
+  esp_wifi_set_promiscuous(true);
+  ESP_LOGI(TAG_TA, "Captura pcap %u iniciada por %u s no canal %d.", (unsigned)id, (unsigned)seconds, WiFi.channel());
+  return id;
+}
+
+void TrafficAnalyzer::stopCapture(uint32_t captureId) {
+  // Só a captura com esse id, e uma vez só: o servidor e a operationalTask podem chegar juntos
+  if (captureId == 0 || !captureId_s.compare_exchange_strong(captureId, 0)) return;
+  captureActive_s = false;
+  esp_wifi_set_promiscuous(false);
+  ESP_LOGI(TAG_TA, "Captura pcap encerrada: %u quadros, %u descartados por contrapressão.",
+           pcapStream.capturedFrames(), pcapStream.droppedFrames());
+}
+
+void TrafficAnalyzer::expireCapture() {
+  uint32_t id = captureId_s.load();
+  if (id != 0 && (long)(millis() - _captureDeadline) >= 0) stopCapture(id);
+}
+
+bool TrafficAnalyzer::isCapturing() const {
+  return captureActive_s || streamOwner_s.load() != 0;
+}
+
+size_t TrafficAnalyzer::readCapture(uint32_t captureId, uint8_t* buffer, size_t maxLen) {
+  if (streamOwner_s.load() != captureId) return 0;
+  expireCapture();
+  return pcapStream.read(buffer, maxLen);
+}
+
+bool TrafficAnalyzer::isCaptureFinished(uint32_t captureId) const {
+  if (streamOwner_s.load() != captureId) return true;
+  return captureId_s.load() != captureId && !captureActive_s && !pcapStream.hasPending();
+}
+
+void TrafficAnalyzer::releaseCapture(uint32_t captureId) {
+  stopCapture(captureId);
+  uint32_t owner = captureId;
+  if (captureId == 0 || !streamOwner_s.compare_exchange_strong(owner, 0)) return;
+  // Roda na task do AsyncTCP, a mesma do leitor: sem ele, o resto do anel não tem destino
+  pcapStream.discard();
+}
+
+uint32_t TrafficAnalyzer::capturedFrames() const {
+  return pcapStream.capturedFrames();
+}
+
+uint32_t TrafficAnalyzer::droppedCaptureFrames() const {
+  return pcapStream.droppedFrames();
 }
\ No newline at end of file
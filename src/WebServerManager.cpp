@@ -8,16 +8,35 @@
 #include "NetworkDiagnostics.h"
 #include "NetworkDiscovery.h"
 #include "TrafficAnalyzer.h"
+#include "AnomalyDetector.h"
+#include "OutagePredictor.h"
+#include "InferenceRuntime.h"
+#include "FeatureRecorder.h"
+#include "ProbeScheduler.h"
 
 extern RouterManager routerManager;
 extern NetworkDiagnostics networkDiagnostics;
 extern NetworkDiscovery networkDiscovery;
 extern TrafficAnalyzer trafficAnalyzer;
+extern AnomalyDetector anomalyDetector;
+extern OutagePredictor outagePredictor;
+extern FeatureRecorder featureRecorder;
+extern ProbeScheduler probeScheduler;
 
 static const char *TAG_WS = "WebServer";
 const byte DNS_PORT = 53;
 const char *ap_ssid = "Super-Monitor-Setup";
 
+// Uma janela de /latency_json; 'epoch' diz se 'start' é epoch ou segundos desde o boot
+static void printLatencySummary(AsyncResponseStream *response, const LatencySummary &summary)
+{
+    response->printf("{\"start\":%lu,\"epoch\":%s,\"samples\":%u,\"p50_ms\":%.1f,\"p90_ms\":%.1f,"
+                     "\"p99_ms\":%.1f,\"jitter_ms\":%.1f,\"loss_pct\":%u}",
+                     (unsigned long)summary.start, (summary.flags & LATENCY_FLAG_EPOCH) ? "true" : "false",
+                     summary.samples, summary.p50 / 10.0, summary.p90 / 10.0, summary.p99 / 10.0,
+                     summary.jitter / 10.0, summary.lossPct);
+}
+
 void rebootCallback(TimerHandle_t xTimer)
 {
     ESP_LOGI(TAG_WS, "Temporizador de reboot acionado. Reiniciando agora...");
@@ -74,6 +93,11 @@ void WebServerManager::_handleRoot(AsyncWebServerRequest *request)
   <h3>Telegram (Opcional)</h3>
   <input type="text" name="tg_token" placeholder="Token do Bot">
   <input type="text" name="tg_chat_id" placeholder="Seu Chat ID numerico">
+  <h3>NetFlow v9 (Opcional)</h3>
+  <input type="text" name="nf_host" placeholder="IP do Coletor (ex: nfcapd)">
+  <input type="text" name="nf_port" placeholder="Porta UDP (padrao 2055)">
+  <h3>Detector de Anomalias</h3>
+  <select name="anom_engine" style="width:100%;padding:12px;margin:8px 0;"><option value="autoencoder">Autoencoder (treinado no PC)</option><option value="mahalanobis">Mahalanobis (aprende na rede, sem treino)</option></select>
   <input type="submit" value="Salvar e Reiniciar"></form></div></body></html>
   )rawliteral";
     request->send(200, "text/html", html);
@@ -98,6 +122,12 @@ void WebServerManager::_handleSaveConfig(AsyncWebServerRequest *request)
         preferences.putString("tg_token", request->getParam("tg_token", true)->value());
     if (request->hasParam("tg_chat_id", true))
         preferences.putString("tg_chat_id", request->getParam("tg_chat_id", true)->value());
+    if (request->hasParam("nf_host", true))
+        preferences.putString("nf_host", request->getParam("nf_host", true)->value());
+    if (request->hasParam("nf_port", true) && request->getParam("nf_port", true)->value().toInt() > 0)
+        preferences.putUShort("nf_port", request->getParam("nf_port", true)->value().toInt());
+    if (request->hasParam("anom_engine", true))
+        preferences.putString("anom_engine", request->getParam("anom_engine", true)->value());
     preferences.end();
 
     String html = "<html><body><h1>Configuracoes salvas!</h1><h2>O dispositivo ira reiniciar...</h2></body></html>";
@@ -127,7 +157,7 @@ void WebServerManager::startDashboardServer()
     <p id="status">Carregando...</p><button onclick="forceReboot()">Forcar Reboot do Roteador</button></div>
     <div class="card"><h2>Dispositivos na Rede</h2><pre id="devices">Carregando...</pre></div></div>
     <script>
-      function updateData(){fetch('/status_json').then(response=>response.json()).then(data=>{const statusEl=document.getElementById('status');statusEl.innerText=data.isOnline?'ONLINE':'OFFLINE';statusEl.className=data.isOnline?'online':'offline';let deviceText='Total: '+data.deviceCount+'\\n\\n';data.devices.forEach(device=>{deviceText+=device.ip+'\\n';});document.getElementById('devices').innerText=deviceText;});}
+      function updateData(){fetch('/status_json').then(response=>response.json()).then(data=>{const statusEl=document.getElementById('status');statusEl.innerText=data.isOnline?'ONLINE':'OFFLINE';statusEl.className=data.isOnline?'online':'offline';let deviceText='Total: '+data.deviceCount+'\\n\\n';data.devices.forEach(device=>{deviceText+=device.ip+(device.type?' ('+device.type+')':'')+'\\n';});document.getElementById('devices').innerText=deviceText;});}
       function forceReboot(){if(confirm('Tem certeza que deseja forcar o reboot do roteador?')){fetch('/reboot').then(response=>response.text()).then(text=>alert(text));}}
       setInterval(updateData,5000);window.onload=updateData;
     </script></body></html>
@@ -137,12 +167,314 @@ void WebServerManager::startDashboardServer()
     _server.on("/status_json", HTTP_GET, [](AsyncWebServerRequest *request)
                {
     JsonDocument json;
-    json["isOnline"] = networkDiagnostics.isInternetConnected();
+    // Veredito guardado pela task de operação: sondar aqui travaria todas as conexões
+    json["isOnline"] = networkDiagnostics.lastOnline();
+    if (networkDiagnostics.lastCheckMs() != 0) json["checkedAgoS"] = (millis() - networkDiagnostics.lastCheckMs()) / 1000;
+    json["fault"] = FaultLocator::verdictName(networkDiagnostics.lastFault().verdict);
+    json["link"] = ProbeScheduler::healthName(probeScheduler.health());
+    json["probeIntervalMs"] = probeScheduler.intervalMs();
+    json["probeCredit"] = probeScheduler.credit();
     json["deviceCount"] = networkDiscovery.deviceCount;
     JsonArray devices = json["devices"].to<JsonArray>();
     for (int i = 0; i < networkDiscovery.deviceCount; i++) {
       JsonObject device = devices.add<JsonObject>();
       device["ip"] = networkDiscovery.devices[i].ip.toString();
+      if (networkDiscovery.devices[i].macAddress.length() > 0) device["mac"] = networkDiscovery.devices[i].macAddress;
+      if (networkDiscovery.devices[i].typeConfidence > 0) {
+        device["type"] = DeviceFingerprinter::typeName(networkDiscovery.devices[i].type);
+        device["typeConfidence"] = networkDiscovery.devices[i].typeConfidence;
+      }
+    }
+    if (outagePredictor.hasPrediction()) {
+      json["outageProbability"] = outagePredictor.probability();
+      json["outageHorizonMin"] = outagePredictor.horizonMinutes();
+    }
+    String response;
+    serializeJson(json, response);
+    request->send(200, "application/json", response); });
+
+    _server.on("/tcp_rtt_json", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    TcpRttPrefixSummary summary[TCP_RTT_MAX_PREFIXES];
+    size_t count = trafficAnalyzer.getRttSummary(summary, TCP_RTT_MAX_PREFIXES);
+    JsonDocument json;
+    JsonArray prefixes = json["prefixes"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+      JsonObject entry = prefixes.add<JsonObject>();
+      char prefixStr[20];
+      sprintf(prefixStr, "%u.%u.%u.%u/%u", (unsigned)(summary[i].prefix >> 24), (unsigned)((summary[i].prefix >> 16) & 0xFF),
+              (unsigned)((summary[i].prefix >> 8) & 0xFF), (unsigned)(summary[i].prefix & 0xFF), summary[i].prefixLen);
+      entry["prefix"] = prefixStr;
+      entry["handshakes"] = summary[i].handshakes;
+      entry["retransmissions"] = summary[i].retransmissions;
+      entry["wan_samples"] = summary[i].wanSamples;
+      entry["wan_p50_us"] = summary[i].wanMedianUs;
+      entry["wan_p99_us"] = summary[i].wanP99Us;
+      entry["lan_samples"] = summary[i].lanSamples;
+      entry["lan_p50_us"] = summary[i].lanMedianUs;
+      entry["lan_p99_us"] = summary[i].lanP99Us;
+    }
+    String response;
+    serializeJson(json, response);
+    request->send(200, "application/json", response); });
+
+    // Atividade de cada estação no ciclo sniffer (Módulo 12)
+    _server.on("/activity_json", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    static StationActivity activities[APP_MAX_STATIONS];
+    size_t count = trafficAnalyzer.getActivities(activities, APP_MAX_STATIONS);
+    JsonDocument json;
+    JsonArray stations = json["stations"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+      const StationActivity &a = activities[i];
+      JsonObject entry = stations.add<JsonObject>();
+      char mac[18];
+      snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X", a.mac[0], a.mac[1], a.mac[2], a.mac[3], a.mac[4], a.mac[5]);
+      entry["mac"] = mac;
+      entry["activity"] = AppClassifier::activityName(a.activity);
+      entry["share_pct"] = a.share;
+      entry["votes"] = a.votes;
+      entry["trees"] = APP_FOREST_TREES;
+      entry["windows"] = a.windows;
+      entry["down_kbps"] = a.downKbps;
+      entry["up_kbps"] = a.upKbps;
+    }
+    String response;
+    serializeJson(json, response);
+    request->send(200, "application/json", response); });
+
+    // Perfil de comportamento de cada dispositivo (médias em log2 convertidas)
+    _server.on("/profiles_json", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    static DeviceProfile profiles[PROFILE_MAX_DEVICES];
+    size_t count = trafficAnalyzer.profiles().snapshot(profiles, PROFILE_MAX_DEVICES);
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"k_sigma\":%u,\"spilled\":%u,\"profiles\":[", trafficAnalyzer.profiles().kSigma(),
+                     (unsigned)trafficAnalyzer.profiles().spilledCount());
+    for (size_t i = 0; i < count; i++) {
+      const DeviceProfile &p = profiles[i];
+      response->printf("%s{\"mac\":\"%02X:%02X:%02X:%02X:%02X:%02X\",\"windows\":%u,\"bytes_per_min\":%.0f,"
+                       "\"bytes_sigma_factor\":%.2f,\"packets_per_min\":%.1f,\"packets_sigma_factor\":%.2f,"
+                       "\"active_hours\":%lu,\"days\":%lu,\"flags\":%u}",
+                       i ? "," : "", p.mac[0], p.mac[1], p.mac[2], p.mac[3], p.mac[4], p.mac[5], p.windows,
+                       DeviceProfileStore::typicalValue(p.bytesMean), DeviceProfileStore::sigmaFactor(p.bytesVar),
+                       DeviceProfileStore::typicalValue(p.packetsMean), DeviceProfileStore::sigmaFactor(p.packetsVar),
+                       (unsigned long)(p.activeHours & 0xFFFFFF), (unsigned long)(p.activeHours >> 24), p.flags);
+    }
+    response->print("]}");
+    request->send(response); });
+
+    // Percentis de RTT, jitter e perda por alvo de sonda; ?history=1 inclui os anéis de minutos e horas
+    _server.on("/latency_json", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    static LatencyTarget target;
+    bool history = request->hasParam("history") && request->getParam("history")->value() == "1";
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"bucket_error_pct\":%.2f,\"targets\":[", 100.0 / (2 << LATENCY_SUB_BUCKET_BITS));
+    for (size_t i = 0; networkDiagnostics.latency().snapshot(i, &target); i++) {
+      response->printf("%s{\"kind\":\"%s\"", i ? "," : "", ProbeEngine::kindName((ProbeKind)target.kind));
+      if (target.ip != 0) response->printf(",\"ip\":\"%s\"", IPAddress(target.ip).toString().c_str());
+      response->print(",\"minute\":");
+      printLatencySummary(response, LatencyStore::summarize(target.minute, target.minuteStart, target.flags));
+      response->print(",\"hour\":");
+      printLatencySummary(response, LatencyStore::summarize(target.hour, target.hourStart, target.flags));
+      if (history) {
+        response->print(",\"minutes\":[");
+        for (size_t m = 0; m < target.minuteCount(); m++) {
+          if (m) response->print(",");
+          printLatencySummary(response, target.minuteAt(m));
+        }
+        response->print("],\"hours\":[");
+        for (size_t h = 0; h < target.hourCount(); h++) {
+          if (h) response->print(",");
+          printLatencySummary(response, target.hourAt(h));
+        }
+        response->print("]");
+      }
+      response->print("}");
+    }
+    response->print("]}");
+    request->send(response); });
+
+    // Captura ao vivo em pcap: curl http://<ip>/capture.pcap?secs=30 > x.pcap
+    _server.on("/capture.pcap", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    long secs = 30;
+    if (request->hasParam("secs")) secs = request->getParam("secs")->value().toInt();
+    if (secs < 1) secs = 1;
+    if (secs > 300) secs = 300;
+    uint32_t captureId = trafficAnalyzer.startCapture(secs);
+    if (captureId == 0) {
+      request->send(409, "text/plain", "Captura indisponivel (outra captura sendo entregue ou modo sniffer em andamento).");
+      return;
+    }
+    // O AsyncTCP só chama o callback quando há espaço na janela TCP; enquanto
+    // isso o anel enche e o excedente é descartado (contado em /capture_stats).
+    // O id amarra a resposta à captura: um cliente antigo não mexe na seguinte.
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/vnd.tcpdump.pcap",
+      [captureId](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        size_t written = trafficAnalyzer.readCapture(captureId, buffer, maxLen);
+        if (written > 0) return written;
+        if (!trafficAnalyzer.isCaptureFinished(captureId)) return RESPONSE_TRY_AGAIN;
+        trafficAnalyzer.releaseCapture(captureId);
+        return 0;
+      });
+    response->addHeader("Content-Disposition", "attachment; filename=capture.pcap");
+    request->onDisconnect([captureId]() { trafficAnalyzer.releaseCapture(captureId); });
+    request->send(response); });
+
+    _server.on("/capture_stats", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    JsonDocument json;
+    json["capturing"] = trafficAnalyzer.isCapturing();
+    json["frames"] = trafficAnalyzer.capturedFrames();
+    json["dropped"] = trafficAnalyzer.droppedCaptureFrames();
+    String response;
+    serializeJson(json, response);
+    request->send(200, "application/json", response); });
+
+    // Histórico das verificações de internet, para treinar o preditor de quedas:
+    // curl http://<ip>/diagnostics.csv > ring.csv (ver scripts/TinyML_Module_10)
+    _server.on("/diagnostics.csv", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    uint32_t cursor = 0;
+    bool headerSent = false;
+    AsyncWebServerResponse *response = request->beginChunkedResponse("text/csv",
+      [cursor, headerSent](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+        size_t written = 0;
+        if (!headerSent) {
+          written = snprintf((char *)buffer, maxLen, "index,time,epoch,online,http_ms,dns_ms,rtt_ms,loss_pct\n");
+          headerSent = true;
+        }
+        // Uma linha tem no máximo ~60 caracteres; falha = -1
+        DiagnosticSample sample;
+        while (maxLen - written >= 64 && networkDiagnostics.readHistory(&cursor, &sample, 1) == 1) {
+          auto ms = [](uint16_t v) { return v == DIAG_FAILED ? -1 : (int)v; };
+          written += snprintf((char *)buffer + written, maxLen - written, "%u,%u,%d,%d,%d,%d,%d,%u\n",
+                              (unsigned)(cursor - 1), (unsigned)sample.time, (sample.flags & DIAG_FLAG_EPOCH) ? 1 : 0,
+                              (sample.flags & DIAG_FLAG_ONLINE) ? 1 : 0, ms(sample.httpMs), ms(sample.dnsMs),
+                              ms(sample.rttMs), sample.lossPct);
+        }
+        return written;
+      });
+    response->addHeader("Content-Disposition", "attachment; filename=diagnostics.csv");
+    request->send(response); });
+
+    // Vetor de características de cada ciclo sniffer, gravado na flash, nas
+    // colunas de network_metrics_dataset.csv (Módulo 9):
+    // curl http://<ip>/features.csv > features.csv && python train_and_convert.py features.csv
+    _server.on("/features.csv", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    if (!featureRecorder.isReady()) {
+      request->send(503, "text/plain", "Particao 'features' ausente (ver partitions.csv).");
+      return;
+    }
+    uint32_t cursor = 0;
+    uint32_t end = featureRecorder.next();  // Só o que já estava gravado quando o download começou
+    bool headerSent = false;
+    AsyncWebServerResponse *response = request->beginChunkedResponse("text/csv",
+      [cursor, end, headerSent](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+        size_t written = 0;
+        if (!headerSent) {
+          written = FeatureRecorder::csvHeader((char *)buffer, maxLen);
+          if (written == 0) return 0;
+          headerSent = true;
+        }
+        // Uma linha tem no máximo ~150 caracteres
+        FeatureRecord record;
+        while (maxLen - written >= 192 && cursor < end && featureRecorder.read(&cursor, &record) &&
+               record.sequence < end) {
+          written += FeatureRecorder::csvLine(record, (char *)buffer + written, maxLen - written);
+        }
+        return written;
+      });
+    response->addHeader("Content-Disposition", "attachment; filename=features.csv");
+    request->send(response); });
+
+    // Impressões digitais dos dispositivos (Módulo 11). Preencha a coluna
+    // 'label' e treine com scripts/TinyML_Module_11/train_fingerprint_model.py
+    _server.on("/fingerprints.csv", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    static DeviceFingerprint table[FINGERPRINT_MAX_DEVICES];
+    size_t count = trafficAnalyzer.fingerprinter().snapshot(table, FINGERPRINT_MAX_DEVICES);
+    AsyncResponseStream *response = request->beginResponseStream("text/csv");
+    response->print("mac,vendor,maker,type,confidence");
+    for (int i = 0; i < FINGERPRINT_FEATURES; i++) response->printf(",%s", device_class_features[i]);
+    response->print(",label\n");
+    for (size_t i = 0; i < count; i++) {
+      const DeviceFingerprint &fp = table[i];
+      const char *maker = nullptr;
+      DeviceFingerprinter::lookupVendor(fp.mac, &maker);
+      response->printf("%02X:%02X:%02X:%02X:%02X:%02X,%s,%s,%s,%u", fp.mac[0], fp.mac[1], fp.mac[2], fp.mac[3],
+                       fp.mac[4], fp.mac[5], DeviceFingerprinter::vendorName(fp.vendor), maker ? maker : "",
+                       DeviceFingerprinter::typeName(fp.type), fp.confidence);
+      for (int k = 0; k < FINGERPRINT_FEATURES; k++) response->printf(",%u", fp.features[k]);
+      response->print(",\n");
+    }
+    response->addHeader("Content-Disposition", "attachment; filename=fingerprints.csv");
+    request->send(response); });
+
+    // Modelo do autoencoder sem regravar o firmware:
+    // curl --data-binary @anomaly_model.bin http://<ip>/model
+    // O corpo vai direto para o slot inativo, em pedaços; a resposta sai depois do último.
+    _server.on("/model", HTTP_POST, [](AsyncWebServerRequest *request)
+               {
+    ModelStore &models = anomalyDetector.modelStore();
+    if (models.uploadError() != nullptr) {
+      request->send(400, "text/plain", String("Modelo recusado: ") + models.uploadError());
+      return;
+    }
+    if (!models.isSwapPending()) {
+      request->send(400, "text/plain", "Corpo vazio ou incompleto.");
+      return;
+    }
+    request->send(200, "text/plain", "Modelo gravado; o detector troca na proxima janela."); },
+               nullptr,
+               [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+               {
+    ModelStore &models = anomalyDetector.modelStore();
+    if (index == 0 && !models.beginUpload(total)) return;
+    if (!models.writeUpload(data, len)) return;
+    if (index + len == total) models.finishUpload(); });
+
+    _server.on("/model_json", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    const ModelStore &models = anomalyDetector.modelStore();
+    JsonDocument json;
+    json["source"] = models.hasModel() ? "flash" : "firmware";
+    json["slot"] = models.activeSlot();
+    json["version"] = anomalyDetector.modelVersion();
+    json["sequence"] = models.hasModel() ? models.model().sequence : 0;
+    json["threshold"] = anomalyDetector.threshold();
+    json["swap_pending"] = models.isSwapPending();
+    String response;
+    serializeJson(json, response);
+    request->send(200, "application/json", response); });
+
+    // Arena compartilhada dos modelos e tempo por invocação e por op
+    _server.on("/inference_json", HTTP_GET, [](AsyncWebServerRequest *request)
+               {
+    JsonDocument json;
+    json["arena_bytes"] = inferenceRuntime.arenaSize();
+    json["separate_arena_bytes"] = inferenceRuntime.separateArenaBytes();
+    JsonArray models = json["models"].to<JsonArray>();
+    for (size_t i = 0; i < inferenceRuntime.modelCount(); i++) {
+      InferenceRuntime::ModelStats stats = inferenceRuntime.stats(i);
+      JsonObject model = models.add<JsonObject>();
+      model["name"] = stats.model->modelName();
+      model["arena_bytes"] = stats.model->arenaBytes();
+      model["arena_used_bytes"] = stats.model->arenaUsedBytes();
+      model["invocations"] = stats.invocations;
+      model["mean_us"] = stats.invocations ? (uint32_t)(stats.totalUs / stats.invocations) : 0;
+      model["max_us"] = stats.maxUs;
+      JsonArray ops = model["ops"].to<JsonArray>();
+      for (size_t j = 0; j < stats.profiler->opCount(); j++) {
+        const InferenceProfiler::OpStats &op = stats.profiler->op(j);
+        JsonObject entry = ops.add<JsonObject>();
+        entry["tag"] = op.tag;
+        entry["mean_us"] = op.count ? (uint32_t)(op.totalUs / op.count) : 0;
+        entry["max_us"] = op.maxUs;
+      }
     }
     String response;
     serializeJson(json, response);
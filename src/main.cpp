@@ -12,6 +12,12 @@
 #include <Preferences.h>
 #include "TinyUPnP.h"
 #include "AnomalyDetector.h" 
+#include "OutagePredictor.h"
+#include "FeatureRecorder.h"
+#include "InferenceRuntime.h"
+#include "ProbeScheduler.h"
+#include "TimerWheel.h"
+#include <algorithm>
 
 extern "C"
 {
@@ -35,6 +41,20 @@ enum OperationalMode
   MODE_SNIFFER
 };
 
+// Tarefas periódicas da operationalTask, cada uma um timer da roda
+enum OperationalTimer : uint8_t
+{
+  TIMER_HEARTBEAT, // Batida de conectividade (intervalo do ProbeScheduler)
+  TIMER_CHECK,     // Verificação completa e amostra do histórico
+  TIMER_ROUTER,    // Máquina de estados do RouterManager
+  TIMER_DISCOVERY,
+  TIMER_UPNP,
+  TIMER_MODE       // Troca entre monitor e sniffer
+};
+// Só rodam no modo monitor com Wi-Fi: vencidas fora dele, esperam a volta
+const uint32_t MONITOR_TIMERS =
+    TIMER_BIT(TIMER_HEARTBEAT) | TIMER_BIT(TIMER_CHECK) | TIMER_BIT(TIMER_DISCOVERY) | TIMER_BIT(TIMER_UPNP);
+
 // --- Configurações e Instâncias de Módulos ---
 const int ROUTER_RELAY_PIN = 18;
 #define LED_PIN 48
@@ -44,6 +64,10 @@ Adafruit_NeoPixel pixels(NUM_LEDS, LED_PIN, NEO_GRB + NEO_KHZ800);
 #define COLOR_RED pixels.Color(255, 0, 0)
 #define COLOR_GREEN pixels.Color(0, 255, 0)
 #define COLOR_PURPLE pixels.Color(128, 0, 128)
+// Fuso horário (POSIX TZ) do baseline sazonal do detector: horário de Brasília
+#define LOCAL_TIMEZONE "<-03>3"
+#define NTP_SERVER_1 "a.st1.ntp.br"
+#define NTP_SERVER_2 "pool.ntp.org"
 
 String saved_ssid;
 String saved_pass;
@@ -57,6 +81,9 @@ WebServerManager webServerManager;
 Preferences preferences;
 TinyUPnP upnp(5000); 
 AnomalyDetector anomalyDetector;
+OutagePredictor outagePredictor;
+ProbeScheduler probeScheduler;
+FeatureRecorder featureRecorder;
 
 // ===================================================================
 // --- MUDANÇA 1: NOVA LÓGICA DE CONTROLE DO LED ---
@@ -102,21 +129,33 @@ void operationalTask(void *pvParameters)
   const long monitorDuration = 3 * 60 * 1000; // 3 minutos
   const long snifferDuration = 1 * 60 * 1000;   // 1 minuto
 
-  unsigned long lastInternetCheck = 0;
-  unsigned long lastDiscoveryScan = millis();
+  FaultVerdict lastFaultVerdict = FaultVerdict::Healthy;
 
-  const long internetCheckInterval = 60 * 1000;     // 1 minuto
+  const long internetCheckInterval = 60 * 1000;     // 1 minuto (uma amostra do histórico)
   const long discoveryScanInterval = 4 * 60 * 1000; // 5 minutos
-
-  // --- diciona um timer para a descoberta UPnP ---
-  unsigned long lastUpnpDiscovery = 0;
   const long upnpDiscoveryInterval = 10 * 60 * 1000; // A cada 10 minutos
+  const long routerLoopInterval = 5000;              // Os prazos da máquina de estados são de minutos
+
+  // Sem polling: cada tarefa periódica é um timer e a task dorme até o próximo
+  TimerWheel timers;
+  timers.start(millis());
+  timers.schedule(TIMER_CHECK, 0);
+  timers.schedule(TIMER_ROUTER, 0);
+  timers.schedule(TIMER_DISCOVERY, discoveryScanInterval);
+  timers.schedule(TIMER_UPNP, 0);
+  timers.schedule(TIMER_MODE, monitorDuration);
+  uint32_t deferred = 0; // Tarefas de monitor que venceram no sniffer ou sem Wi-Fi
+  probeScheduler.start(millis());
+  uint32_t probesCharged = networkDiagnostics.probesSent();
 
   notificationManager.sendMessage("✅ *Super Monitor* iniciou operação normal.");
 
   for (;;)
   {
     unsigned long currentTime = millis();
+    uint32_t due = timers.advance(currentTime);
+    // O prazo da captura pcap vale mesmo se o cliente parar de ler
+    trafficAnalyzer.expireCapture();
     bool isConnected = (WiFi.status() == WL_CONNECTED);
 
     // --- LÓGICA DE EXECUÇÃO E TRANSIÇÃO DE MODO ---
@@ -125,27 +164,86 @@ void operationalTask(void *pvParameters)
         // --- Bloco de ações do Modo Monitor ---
         if (isConnected)
         {
-            // 1. Verifica a internet periodicamente
-            if (currentTime - lastInternetCheck >= internetCheckInterval)
+            due |= deferred;
+            deferred = 0;
+
+            // 1. Batida de conectividade: um eco, de 15 s em 15 s com o link
+            // saudável e a cada 2 s quando RTT, perda ou falhas pioram
+            if (due & TIMER_BIT(TIMER_HEARTBEAT))
             {
-                bool internetOK = networkDiagnostics.isInternetConnected();
+                uint32_t rttUs;
+                bool beatOK = networkDiagnostics.heartbeat(probeScheduler.failures(), &rttUs);
+                // Quorum perdido (ou a primeira resposta depois da queda): verifica já, sem esperar o minuto
+                if (probeScheduler.onHeartbeat(beatOK, rttUs, millis()))
+                    due |= TIMER_BIT(TIMER_CHECK);
+            }
+
+            // 2. Verifica a internet a cada minuto, ou antes quando as batidas pedem
+            if (due & TIMER_BIT(TIMER_CHECK))
+            {
+                bool internetOK = networkDiagnostics.checkInternet();
                 updateLedColor(MODE_MONITOR, internetOK); // --- MUDANÇA AQUI ---
-                routerManager.updateInternetStatus(internetOK);
-                lastInternetCheck = currentTime;
+                // Onde está a falha: avisa quando muda e só deixa reiniciar se for o roteador
+                FaultReport fault = networkDiagnostics.lastFault();
+                if (!internetOK && fault.verdict != lastFaultVerdict)
+                {
+                    char message[192];
+                    if (FaultLocator::describe(fault, message, sizeof(message)) > 0)
+                        notificationManager.sendMessage(message);
+                }
+                lastFaultVerdict = fault.verdict;
+                routerManager.updateInternetStatus(internetOK, fault.verdict);
+
+                // Módulo 10: aviso antecipado, enquanto ainda dá para agir com a rede de pé
+                bool outageWarning = outagePredictor.update(networkDiagnostics.history()) && outagePredictor.takeWarning();
+                if (outageWarning && internetOK)
+                {
+                    char message[192];
+                    snprintf(message, sizeof(message),
+                             "⚠️ *PREVISÃO:* %.0f%% de chance de queda da internet nos próximos %d minutos. "
+                             "Se for o caso, reinicie o roteador agora (/reboot).",
+                             outagePredictor.probability() * 100.0f, outagePredictor.horizonMinutes());
+                    notificationManager.sendMessage(message);
+                }
+                DiagnosticSample sample;
+                uint8_t lossPct = networkDiagnostics.history().latest(&sample, 1) == 1 ? sample.lossPct : 0;
+                probeScheduler.onCheck(internetOK, lossPct);
+                timers.schedule(TIMER_CHECK, internetCheckInterval);
             }
 
-            // 2. Controla o roteador
-            routerManager.loop();
+            // As rodadas das batidas e da verificação saem do orçamento de
+            // sondas antes de agendar a próxima batida
+            if (due & (TIMER_BIT(TIMER_HEARTBEAT) | TIMER_BIT(TIMER_CHECK)))
+            {
+                uint32_t probesSent = networkDiagnostics.probesSent();
+                probeScheduler.charge(probesSent - probesCharged, millis());
+                probesCharged = probesSent;
+                timers.schedule(TIMER_HEARTBEAT, probeScheduler.nextDelay(millis()));
+            }
+
+            // 3. Controla o roteador
+            if (due & TIMER_BIT(TIMER_ROUTER))
+            {
+                routerManager.loop();
+                timers.schedule(TIMER_ROUTER, routerLoopInterval);
+            }
 
-            // 3. Roda o scan de descoberta periodicamente
-            if (!networkDiscovery.isScanning() && (currentTime - lastDiscoveryScan >= discoveryScanInterval))
+            // 4. Roda o scan de descoberta periodicamente (depois que o anterior terminar)
+            if (due & TIMER_BIT(TIMER_DISCOVERY))
             {
-                networkDiscovery.beginScan();
-                lastDiscoveryScan = currentTime;
+                if (networkDiscovery.isScanning())
+                {
+                    timers.schedule(TIMER_DISCOVERY, 1000);
+                }
+                else
+                {
+                    networkDiscovery.beginScan();
+                    timers.schedule(TIMER_DISCOVERY, discoveryScanInterval);
+                }
             }
 
             // --- Adiciona a lógica de descoberta UPnP periódica ---
-            if (currentTime - lastUpnpDiscovery >= upnpDiscoveryInterval) {
+            if (due & TIMER_BIT(TIMER_UPNP)) {
                 ESP_LOGI(TAG, "Iniciando descoberta de dispositivos UPnP...");
                 
                 // Esta é a chamada correta: ela bloqueia e retorna a lista
@@ -166,25 +264,36 @@ void operationalTask(void *pvParameters)
                     curr = next;
                 }
 
-                lastUpnpDiscovery = currentTime;
+                timers.schedule(TIMER_UPNP, upnpDiscoveryInterval);
             }
         }
         else
         {
-            ESP_LOGW(TAG, "Wi-Fi desconectado em modo Monitor. Tentando reconectar...");
-            updateLedColor(MODE_MONITOR, false); // --- MUDANÇA AQUI ---
-            routerManager.updateInternetStatus(false);
-            vTaskDelay(pdMS_TO_TICKS(5000));
+            // As sondas esperam a reconexão; o timer do roteador vira o da nova tentativa
+            deferred |= due & MONITOR_TIMERS;
+            if (due & TIMER_BIT(TIMER_ROUTER))
+            {
+                ESP_LOGW(TAG, "Wi-Fi desconectado em modo Monitor. Tentando reconectar...");
+                updateLedColor(MODE_MONITOR, false); // --- MUDANÇA AQUI ---
+                routerManager.updateInternetStatus(false, FaultVerdict::WifiLink);
+                timers.schedule(TIMER_ROUTER, 5000);
+            }
         }
 
-        // 4. Verifica se é hora de mudar para o modo Sniffer
-        if (currentTime - lastModeChange >= monitorDuration)
+        // 5. Verifica se é hora de mudar para o modo Sniffer
+        // (adiado enquanto uma captura pcap via HTTP estiver em andamento)
+        if ((due & TIMER_BIT(TIMER_MODE)) && trafficAnalyzer.isCapturing())
+        {
+            timers.schedule(TIMER_MODE, 1000);
+        }
+        else if (due & TIMER_BIT(TIMER_MODE))
         {
             ESP_LOGI(TAG, "MUDANDO PARA MODO SNIFFER.");
             notificationManager.sendMessage("🔬 Entrando em modo de análise de tráfego por 1 minuto...");
             trafficAnalyzer.start();
             currentMode = MODE_SNIFFER;
             lastModeChange = currentTime;
+            timers.schedule(TIMER_MODE, snifferDuration);
             updateLedColor(MODE_SNIFFER, false); // --- MUDANÇA AQUI ---
         }
     }
@@ -193,19 +302,102 @@ void operationalTask(void *pvParameters)
         // --- Bloco de ações do Modo Sniffer ---
         // A tarefa snifferTask está rodando em background.
         
+        // O rádio está em modo promíscuo: as tarefas de monitor esperam a volta
+        deferred |= due & MONITOR_TIMERS;
+
         // Verifica se é hora de voltar ao modo Monitor
-        if (currentTime - lastModeChange >= snifferDuration)
+        if (due & TIMER_BIT(TIMER_MODE))
         {
             ESP_LOGI(TAG, "MUDANDO PARA MODO MONITOR.");
             trafficAnalyzer.stop();
             // --- ADICIONADO: Lógica de Detecção de Anomalia ---
             ESP_LOGI(TAG, "Executando análise de tráfego com TinyML...");
-            bool isAnomaly = anomalyDetector.detect(
-                trafficAnalyzer._total_packets_in_window, 
-                trafficAnalyzer._total_bytes_in_window
-            );
+            bool isAnomaly = anomalyDetector.detect(trafficAnalyzer.windowFeatures());
+            // Dataset de treino com a visão do próprio ESP32 (/features.csv)
+            featureRecorder.record(trafficAnalyzer.windowFeatures(), (currentTime - lastModeChange) / 1000, isAnomaly,
+                                   time(nullptr));
             if (isAnomaly) {
-                notificationManager.sendMessage("🚨 *ALERTA:* Anomalia de tráfego de rede detectada!");
+                // Módulo 12: diz o que está ocupando o link, não só que há algo estranho
+                StationActivity top;
+                char alert[192] = "🚨 *ALERTA:* Anomalia de tráfego de rede detectada!";
+                if (trafficAnalyzer.getActivities(&top, 1) == 1 && top.activity != AppActivity::Idle) {
+                    snprintf(alert + strlen(alert), sizeof(alert) - strlen(alert),
+                             "\nMaior consumo: `%02X:%02X:%02X:%02X:%02X:%02X`, %s (%.1f Mbit/s)", top.mac[0],
+                             top.mac[1], top.mac[2], top.mac[3], top.mac[4], top.mac[5],
+                             AppClassifier::activityLabel(top.activity), (top.downKbps + top.upKbps) / 1000.0f);
+                }
+                notificationManager.sendMessage(alert);
+            }
+
+            // Cada dispositivo contra o próprio histórico: aponta quem causou o desvio
+            DeviceScore topDevices[3];
+            size_t ranked = anomalyDetector.scoreDevices(trafficAnalyzer.deviceFeatures(),
+                                                         trafficAnalyzer.deviceFeatureCount(), topDevices, 3);
+            String offenders;
+            for (size_t i = 0; i < ranked && topDevices[i].anomalous; i++) {
+                char line[128];
+                const uint8_t* m = topDevices[i].mac;
+                int length = snprintf(line, sizeof(line), "\n`%02X:%02X:%02X:%02X:%02X:%02X` (erro %.1fx o limite",
+                                      m[0], m[1], m[2], m[3], m[4], m[5], topDevices[i].error / topDevices[i].threshold);
+                StationActivity activity;
+                if (trafficAnalyzer.activityOf(m, &activity) && activity.activity != AppActivity::Idle) {
+                    snprintf(line + length, sizeof(line) - length, ", %s a %.1f Mbit/s)",
+                             AppClassifier::activityLabel(activity.activity),
+                             (activity.downKbps + activity.upKbps) / 1000.0f);
+                } else {
+                    snprintf(line + length, sizeof(line) - length, ")");
+                }
+                offenders += line;
+            }
+            if (offenders.length() > 0) {
+                notificationManager.sendMessage(("🚨 *ALERTA:* Dispositivos com tráfego fora do padrão:" + offenders).c_str());
+            }
+
+            // Perfis por dispositivo: quem saiu de k sigmas do próprio normal neste ciclo
+            DeviceProfile deviating[4];
+            size_t deviations = trafficAnalyzer.profiles().deviations(deviating, 4);
+            String outliers;
+            for (size_t i = 0; i < deviations; i++) {
+                const DeviceProfile& p = deviating[i];
+                char line[160];
+                int length = snprintf(line, sizeof(line), "\n`%02X:%02X:%02X:%02X:%02X:%02X`:", p.mac[0], p.mac[1],
+                                      p.mac[2], p.mac[3], p.mac[4], p.mac[5]);
+                if (p.flags & PROFILE_FLAG_BYTES) {
+                    length += snprintf(line + length, sizeof(line) - length, " bytes %+.1fσ (normal ~%.0f KB/min)",
+                                       p.bytesZ / 10.0f, DeviceProfileStore::typicalValue(p.bytesMean) / 1024.0f);
+                }
+                if (p.flags & PROFILE_FLAG_PACKETS) {
+                    length += snprintf(line + length, sizeof(line) - length, " pacotes %+.1fσ", p.packetsZ / 10.0f);
+                }
+                if (p.flags & PROFILE_FLAG_HOUR) {
+                    length += snprintf(line + length, sizeof(line) - length, " horário incomum");
+                }
+                if (p.flags & PROFILE_FLAG_PEERS) {
+                    snprintf(line + length, sizeof(line) - length, " destinos novos");
+                }
+                outliers += line;
+            }
+            if (outliers.length() > 0) {
+                notificationManager.sendMessage(("📊 *FORA DO PERFIL:* Dispositivos longe do próprio normal:" + outliers).c_str());
+            }
+
+            // Módulo 11: dispositivos que acabaram de ganhar uma impressão digital são novos na rede
+            DeviceFingerprint newDevices[8];
+            size_t classified = trafficAnalyzer.fingerprinter().classify(newDevices, 8);
+            String newcomers;
+            for (size_t i = 0; i < classified; i++) {
+                char line[112];
+                const uint8_t* m = newDevices[i].mac;
+                const char* maker = nullptr;
+                DeviceFingerprinter::lookupVendor(m, &maker);
+                snprintf(line, sizeof(line), "\n%s `%02X:%02X:%02X:%02X:%02X:%02X` %s (%u%%%s%s)",
+                         newDevices[i].type == DeviceType::Unknown ? "❓" : "•", m[0], m[1], m[2], m[3], m[4], m[5],
+                         DeviceFingerprinter::typeLabel(newDevices[i].type), newDevices[i].confidence,
+                         maker ? ", " : "", maker ? maker : "");
+                newcomers += line;
+            }
+            if (newcomers.length() > 0) {
+                notificationManager.sendMessage(("🆕 *NOVOS DISPOSITIVOS* na rede:" + newcomers).c_str());
             }
             // -----------------------------------------------------------
 
@@ -215,15 +407,23 @@ void operationalTask(void *pvParameters)
             WiFi.begin(saved_ssid.c_str(), saved_pass.c_str());
             
             vTaskDelay(pdMS_TO_TICKS(10000)); // Espera para estabilizar
+
+            // Com a rede de volta, envia os fluxos acumulados durante a captura
+            trafficAnalyzer.exportFlows();
             
             currentMode = MODE_MONITOR;
             lastModeChange = currentTime;
-            lastInternetCheck = 0; // Força uma checagem de internet imediata
+            timers.schedule(TIMER_MODE, monitorDuration);
+            timers.schedule(TIMER_CHECK, 0); // Força uma checagem de internet imediata
+            timers.schedule(TIMER_ROUTER, 0);
             updateLedColor(MODE_MONITOR, (WiFi.status() == WL_CONNECTED)); // --- MUDANÇA AQUI ---
         }
     }
 
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    // Dorme até o próximo timer (sempre há um: o da troca de modo)
+    uint32_t sleepMs = std::min<uint32_t>(timers.untilNext(millis()), internetCheckInterval);
+    if (trafficAnalyzer.isCapturing()) sleepMs = std::min<uint32_t>(sleepMs, 1000);
+    vTaskDelay(pdMS_TO_TICKS(std::max<uint32_t>(sleepMs, 10)));
   }
 }
 
@@ -293,6 +493,9 @@ void setup()
     String router_user = preferences.getString("router_user", ROUTER_USER);
     String router_pass = preferences.getString("router_pass", ROUTER_PASS);
     String tg_token = preferences.getString("tg_token", TELEGRAM_BOT_TOKEN);
+    String nf_host = preferences.getString("nf_host", "");
+    uint16_t nf_port = preferences.getUShort("nf_port", NETFLOW_DEFAULT_PORT);
+    String anom_engine = preferences.getString("anom_engine", "autoencoder");
     long long tg_chat_id_ll = atoll(preferences.getString("tg_chat_id", "0").c_str());
     if (tg_chat_id_ll == 0)
       tg_chat_id_ll = TELEGRAM_CHAT_ID;
@@ -306,12 +509,24 @@ void setup()
     routerManager.setNotificationManager(&notificationManager);
     networkDiscovery.setup();
     trafficAnalyzer.setup();
+    featureRecorder.begin();
+    trafficAnalyzer.setFlowCollector(nf_host.c_str(), nf_port);
+    networkDiscovery.setFingerprinter(&trafficAnalyzer.fingerprinter());
     webServerManager.setup();
-    networkDiagnostics.setDiscoveryModule(&networkDiscovery);
+    anomalyDetector.setEngine(anom_engine == "mahalanobis" ? AnomalyEngineType::Mahalanobis : AnomalyEngineType::Autoencoder);
     anomalyDetector.setup();
+    // Normalização e limite aprendidos nesta rede (persistidos no NVS)
+    anomalyDetector.setOnlineCalibration(true);
+    // Filtro por hora da semana; ativo assim que o SNTP acertar o relógio
+    anomalyDetector.setSeasonalBaseline(true);
+    outagePredictor.setup();
+    // Com todos os modelos registrados: planeja a arena compartilhada e sobe a task de inferência
+    inferenceRuntime.begin();
 
     WiFi.setAutoReconnect(true);
     WiFi.begin(saved_ssid.c_str(), saved_pass.c_str()); 
+    // O SNTP tenta de novo sozinho até a rede subir; o RTC mantém a hora no modo sniffer
+    configTzTime(LOCAL_TIMEZONE, NTP_SERVER_1, NTP_SERVER_2);
 
     int retryCount = 0;
     while (WiFi.status() != WL_CONNECTED && retryCount < 60)
@@ -340,6 +555,9 @@ void setup()
 
       primaryDnsAddr.u_addr.ip4.addr = static_cast<uint32_t>(primaryDNS);
       secondaryDnsAddr.u_addr.ip4.addr = static_cast<uint32_t>(secondaryDNS);
+
+      // Dashboard e APIs (status, RTT TCP passivo, etc.)
+      webServerManager.startDashboardServer();
     }
     else
     {
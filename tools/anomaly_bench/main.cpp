@@ -0,0 +1,193 @@
+// Roda o AnomalyDetector do firmware sobre cada linha do dataset de treino (no PC).
+//
+//   pio run -e native_anomaly_bench
+//   .pio/build/native_anomaly_bench/program [dataset.csv] [erros.csv] [rodadas] [modo]
+//
+// Usa as mesmas constantes de normalização e limite do firmware (o próprio
+// AnomalyDetector.cpp e as engines são compilados aqui). Relata a RAM da
+// engine, percentis de latência por chamada a detect(), a distribuição do
+// escore e as linhas sinalizadas. Se erros.csv for informado, grava o erro de cada linha para
+// scripts/TinyML_Module_9/compare_anomaly_bench.py comparar com o modelo Python.
+// Com "online", usa a calibração contínua (OnlineCalibrator) numa única passada
+// sobre o dataset, como se cada linha fosse uma janela do sniffer. O modo
+// combina, separadas por '+':
+//   online       calibração contínua do autoencoder (OnlineCalibrator)
+//   mahalanobis  engine MahalanobisEngine em vez do autoencoder
+//   sazonal      filtro por hora da semana, com o timestamp de cada linha como hora local
+//   injetar      a cada BENCH_INJECT_EVERY linhas após o aquecimento, multiplica ou
+//                divide pacotes e bytes por BENCH_INJECT_FACTOR; relata recall nessas
+//                linhas e a taxa de sinalização nas demais
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "esp_log.h"
+#include "AnomalyDetector.h"
+
+struct Row {
+  std::string timestamp;
+  time_t time = 0;
+  FeatureVector features;
+};
+
+// Lê o CSV mapeando as colunas pelo nome (AnomalyFeatures.def); colunas
+// ausentes ficam em zero e as desconhecidas são ignoradas
+static bool loadDataset(const char* path, std::vector<Row>& rows) {
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) return false;
+  char line[512];
+  std::vector<int> columnFeature;
+  int timestampColumn = -1;
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    line[strcspn(line, "\r\n")] = '\0';
+    std::vector<char*> fields;
+    for (char* p = line; p != nullptr; ) {
+      fields.push_back(p);
+      p = strchr(p, ',');
+      if (p != nullptr) *p++ = '\0';
+    }
+    if (columnFeature.empty()) {
+      for (size_t i = 0; i < fields.size(); i++) {
+        columnFeature.push_back(anomalyFeatureIndex(fields[i]));
+        if (strcmp(fields[i], "timestamp") == 0) timestampColumn = (int)i;
+      }
+      continue;
+    }
+    Row row;
+    for (size_t i = 0; i < fields.size() && i < columnFeature.size(); i++) {
+      if (columnFeature[i] >= 0) row.features[columnFeature[i]] = strtof(fields[i], nullptr);
+    }
+    if (timestampColumn >= 0 && timestampColumn < (int)fields.size()) {
+      row.timestamp = fields[timestampColumn];
+      struct tm local = {};
+      if (strptime(fields[timestampColumn], "%Y-%m-%d %H:%M:%S", &local) != nullptr) {
+        local.tm_isdst = -1;
+        row.time = mktime(&local);
+      }
+    }
+    rows.push_back(row);
+  }
+  fclose(f);
+  return true;
+}
+
+static const size_t BENCH_INJECT_START = 600;  // Depois do aquecimento das engines online
+static const size_t BENCH_INJECT_EVERY = 50;
+static const float BENCH_INJECT_FACTOR = 5.0f;
+
+template <typename T>
+static T percentile(const std::vector<T>& sorted, double p) {
+  size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+int main(int argc, char** argv) {
+  const char* datasetPath = (argc > 1 && argv[1][0] != '\0') ? argv[1] : "scripts/TinyML_Module_9/network_metrics_dataset.csv";
+  const char* errorsPath = (argc > 2 && argv[2][0] != '\0') ? argv[2] : nullptr;
+  int rounds = (argc > 3) ? atoi(argv[3]) : 20;
+  const char* mode = (argc > 4) ? argv[4] : "";
+  bool online = strstr(mode, "online") != nullptr;
+  bool seasonal = strstr(mode, "sazonal") != nullptr;
+  bool mahalanobis = strstr(mode, "mahalanobis") != nullptr;
+  bool inject = strstr(mode, "injetar") != nullptr;
+  if (online || seasonal || mahalanobis) rounds = 1; // Engines com estado: uma passada só
+  esp_log_host_level = ESP_LOG_NONE;
+  // Os timestamps do dataset já são hora local
+  setenv("TZ", "UTC0", 1);
+  tzset();
+
+  std::vector<Row> rows;
+  if (!loadDataset(datasetPath, rows) || rows.empty()) {
+    fprintf(stderr, "Não foi possível ler '%s'\n", datasetPath);
+    return 1;
+  }
+
+  std::vector<bool> injected(rows.size(), false);
+  if (inject) {
+    for (size_t i = BENCH_INJECT_START; i < rows.size(); i += BENCH_INJECT_EVERY) {
+      float factor = (i / BENCH_INJECT_EVERY) % 2 ? BENCH_INJECT_FACTOR : 1.0f / BENCH_INJECT_FACTOR;
+      rows[i].features[FEATURE_PACKET_COUNT] *= factor;
+      rows[i].features[FEATURE_TOTAL_BYTES] *= factor;
+      injected[i] = true;
+    }
+  }
+
+  AnomalyDetector detector;
+  detector.setEngine(mahalanobis ? AnomalyEngineType::Mahalanobis : AnomalyEngineType::Autoencoder);
+  detector.setup();
+  detector.setOnlineCalibration(online);
+  detector.setSeasonalBaseline(seasonal);
+
+  std::vector<float> errors(rows.size());
+  std::vector<bool> flags(rows.size());
+  std::vector<double> latencies;
+  latencies.reserve(rows.size() * rounds);
+  for (int r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < rows.size(); i++) {
+      auto start = std::chrono::steady_clock::now();
+      bool anomaly = detector.detect(rows[i].features, rows[i].time);
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      latencies.push_back(std::chrono::duration<double, std::nano>(elapsed).count());
+      errors[i] = detector.lastError();
+      flags[i] = anomaly;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  printf("Dataset: %zu linhas, %d rodadas, engine %s, limite %.6f (%s%s)\n", rows.size(), rounds,
+         detector.engine().name(), detector.threshold(),
+         (online || mahalanobis) ? "aprendido online, valor final" : "constantes do treino",
+         seasonal ? ", filtro sazonal" : "");
+  printf("RAM da engine: %zu bytes\n\n", detector.engine().memoryBytes());
+  printf("Latência de detect() (ns): p50 %.0f  p90 %.0f  p99 %.0f  máx %.0f\n",
+         percentile(latencies, 50), percentile(latencies, 90), percentile(latencies, 99), latencies.back());
+
+  std::vector<float> sortedErrors(errors);
+  std::sort(sortedErrors.begin(), sortedErrors.end());
+  double sum = 0;
+  for (float e : errors) sum += e;
+  printf("Escore: mín %.6f  média %.6f  p50 %.6f  p95 %.6f  p99 %.6f  máx %.6f\n",
+         sortedErrors.front(), sum / errors.size(), percentile(sortedErrors, 50),
+         percentile(sortedErrors, 95), percentile(sortedErrors, 99), sortedErrors.back());
+
+  size_t flagged = std::count(flags.begin(), flags.end(), true);
+  printf("\nLinhas sinalizadas: %zu (%.2f%%)\n", flagged, 100.0 * flagged / rows.size());
+  if (inject) {
+    size_t injectedCount = 0, caught = 0, falseFlags = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+      if (injected[i]) {
+        injectedCount++;
+        if (flags[i]) caught++;
+      } else if (flags[i]) {
+        falseFlags++;
+      }
+    }
+    printf("Injetadas: %zu, detectadas %zu (recall %.1f%%); sinalizadas sem injeção: %zu (%.2f%%)\n",
+           injectedCount, caught, 100.0 * caught / injectedCount, falseFlags,
+           100.0 * falseFlags / (rows.size() - injectedCount));
+  }
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (!flags[i]) continue;
+    printf("  linha %5zu  %s  pacotes %8.0f  bytes %12.0f  erro %.6f\n", i, rows[i].timestamp.c_str(),
+           rows[i].features[FEATURE_PACKET_COUNT], rows[i].features[FEATURE_TOTAL_BYTES], errors[i]);
+  }
+
+  if (errorsPath != nullptr) {
+    FILE* out = fopen(errorsPath, "w");
+    if (out == nullptr) {
+      fprintf(stderr, "Não foi possível criar '%s'\n", errorsPath);
+      return 1;
+    }
+    fprintf(out, "row,error,anomaly\n");
+    for (size_t i = 0; i < rows.size(); i++) fprintf(out, "%zu,%.9g,%d\n", i, errors[i], flags[i] ? 1 : 0);
+    fclose(out);
+    printf("\nErros por linha gravados em '%s'\n", errorsPath);
+  }
+  return 0;
+}
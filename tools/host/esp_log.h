@@ -0,0 +1,28 @@
+#ifndef HOST_ESP_LOG_H
+#define HOST_ESP_LOG_H
+
+// Substituto mínimo do esp_log.h para as ferramentas que rodam no PC.
+// O nível pode ser ajustado em tempo de execução (ex.: benchmarks usam 0).
+
+#include <cstdio>
+
+#define ESP_LOG_NONE 0
+#define ESP_LOG_ERROR 1
+#define ESP_LOG_WARN 2
+#define ESP_LOG_INFO 3
+#define ESP_LOG_DEBUG 4
+
+inline int esp_log_host_level = ESP_LOG_INFO;
+
+#define ESP_HOST_LOG(level, letter, tag, format, ...)                          \
+  do {                                                                         \
+    if (esp_log_host_level >= level)                                           \
+      fprintf(stderr, letter " (%s) " format "\n", tag, ##__VA_ARGS__);        \
+  } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_HOST_LOG(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_HOST_LOG(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_HOST_LOG(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_HOST_LOG(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+
+#endif
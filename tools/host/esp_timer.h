@@ -0,0 +1,15 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+// Substituto do esp_timer.h para as ferramentas que rodam no PC:
+// microssegundos de um relógio monotônico.
+
+#include <chrono>
+#include <cstdint>
+
+inline int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
@@ -0,0 +1,259 @@
+// Confere a engine TinyMlp contra os vetores de referência gerados junto com os
+// pesos (autoencoder, preditor de quedas e classificador de dispositivos) e mede o tempo por inferência (roda no PC).
+//
+//   pio run -e native_mlp_check && .pio/build/native_mlp_check/program [iteracoes] [modelo.bin]
+//
+// Com modelo.bin (gerado por generate_mlp_header.py), também valida o blob como
+// o ModelStore do firmware faria e confere se os pesos dele reproduzem os
+// vetores de referência. Sai com código 1 se alguma saída divergir além da
+// tolerância ou se o blob for rejeitado.
+//
+// Com -DANOMALY_MODEL_INT8 também confere o modelo int8 (AnomalyModelInt8.h),
+// que tem de reproduzir exatamente as saídas emuladas pelo quantize_mlp_header.py.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AnomalyModelBlob.h"
+#include "AnomalyModelWeights.h"
+#include "DeviceClassModelWeights.h"
+#include "OutageModelWeights.h"
+#ifdef ANOMALY_MODEL_INT8
+#include "AnomalyModelInt8.h"
+#endif
+
+static const float kTolerance = 1e-5f;
+
+// Preditor de quedas (Conv1D + Dense): devolve o número de saídas divergentes
+static int checkOutageModel(long iterations) {
+  int failures = 0;
+  float maxDiff = 0.0f;
+  for (int i = 0; i < outage_model_reference_count; i++) {
+    float out;
+    OutageModel::forward(outage_model_params, outage_model_reference_inputs[i], &out);
+    float diff = fabsf(out - outage_model_reference_outputs[i]);
+    if (diff > maxDiff) maxDiff = diff;
+    if (diff > kTolerance) {
+      printf("Preditor de quedas: divergência na janela %d: %.9g (esperado %.9g)\n", i, out,
+             outage_model_reference_outputs[i]);
+      failures++;
+    }
+  }
+
+  volatile float sink = 0.0f;
+  float in[OutageModel::inputs];
+  memcpy(in, outage_model_reference_inputs[0], sizeof(in));
+  long runs = iterations / 10 + 1;
+  auto start = std::chrono::steady_clock::now();
+  for (long n = 0; n < runs; n++) {
+    float out;
+    in[n % OutageModel::inputs] = (float)(n & 1023) * (1.0f / 1024.0f);
+    OutageModel::forward(outage_model_params, in, &out);
+    sink = sink + out;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  printf("Preditor de quedas: %d janelas de referência, maior diferença %.3g; %.1f ns por inferência "
+         "(%d parâmetros, %zu B)\n", outage_model_reference_count, maxDiff,
+         std::chrono::duration<double, std::nano>(elapsed).count() / runs, OutageModel::paramCount,
+         sizeof(outage_model_params));
+  return failures;
+}
+
+// Classificador de tipo de dispositivo (Módulo 11): logits por classe
+static int checkDeviceClassModel() {
+  int failures = 0;
+  float maxDiff = 0.0f;
+  for (int i = 0; i < device_class_reference_count; i++) {
+    float out[FINGERPRINT_CLASSES];
+    DeviceClassModel::forward(device_class_params, device_class_reference_inputs[i], out);
+    for (int k = 0; k < FINGERPRINT_CLASSES; k++) {
+      float diff = fabsf(out[k] - device_class_reference_outputs[i][k]);
+      if (diff > maxDiff) maxDiff = diff;
+      if (diff > kTolerance) {
+        printf("Classificador de dispositivos: divergência no vetor %d, classe %s: %.9g (esperado %.9g)\n", i,
+               device_class_names[k], out[k], device_class_reference_outputs[i][k]);
+        failures++;
+      }
+    }
+  }
+  printf("Classificador de dispositivos: %d vetores de referência, maior diferença %.3g (%d parâmetros, %zu B)\n",
+         device_class_reference_count, maxDiff, DeviceClassModel::paramCount, sizeof(device_class_params));
+  return failures;
+}
+
+#ifdef ANOMALY_MODEL_INT8
+static int8_t quantizeInput(float x) {
+  long q = lroundf(x / anomaly_mlp_int8_input_scale) + anomaly_mlp_int8_input_zero_point;
+  return (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+}
+
+// Autoencoder int8: saídas exatas e tempo por inferência em lotes de 16
+static int checkInt8Model(long iterations) {
+  static_assert(anomaly_mlp_int8_reference_count == anomaly_mlp_reference_count, "vetores de referência do int8");
+  tinymlp::NoProfiler none;
+  int failures = 0;
+  float maxDiff = 0.0f;
+  for (int i = 0; i < anomaly_mlp_int8_reference_count; i++) {
+    int8_t in[AnomalyMlp::inputs], out[AnomalyMlp::outputs];
+    int8_t a[AnomalyMlp::hiddenWidth], b[AnomalyMlp::hiddenWidth];
+    for (int k = 0; k < AnomalyMlp::inputs; k++) in[k] = quantizeInput(anomaly_mlp_reference_inputs[i][k]);
+    AnomalyMlp::forwardBatchInt8(anomaly_mlp_int8_layers, in, out, 1, a, b, none);
+    for (int k = 0; k < AnomalyMlp::outputs; k++) {
+      if (out[k] != anomaly_mlp_int8_reference_outputs[i][k]) {
+        printf("Int8: divergência no vetor %d, saída %d: %d (esperado %d)\n", i, k, out[k],
+               anomaly_mlp_int8_reference_outputs[i][k]);
+        failures++;
+      }
+      float dequantized = (out[k] - anomaly_mlp_int8_output_zero_point) * anomaly_mlp_int8_output_scale;
+      float diff = fabsf(dequantized - anomaly_mlp_reference_outputs[i][k]);
+      if (diff > maxDiff) maxDiff = diff;
+    }
+  }
+
+  const int kBatch = 16;
+  int8_t batchIn[kBatch][AnomalyMlp::inputs];
+  int8_t batchRes[kBatch][AnomalyMlp::outputs];
+  int8_t a[kBatch * AnomalyMlp::hiddenWidth], b[kBatch * AnomalyMlp::hiddenWidth];
+  volatile int sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long n = 0; n < iterations; n += kBatch) {
+    for (int k = 0; k < kBatch; k++) {
+      batchIn[k][0] = (int8_t)(((n + k) & 255) - 128);
+      batchIn[k][1] = (int8_t)(-1 - batchIn[k][0]);
+    }
+    AnomalyMlp::forwardBatchInt8(anomaly_mlp_int8_layers, &batchIn[0][0], &batchRes[0][0], kBatch, a, b, none);
+    sink = sink + batchRes[0][0];
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  printf("Int8: %d vetores de referência, %d saídas divergentes, maior diferença para o float32 %.3g; "
+         "em lotes de %d: %.1f ns por inferência (%u B)\n", anomaly_mlp_int8_reference_count, failures, maxDiff,
+         kBatch, std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+         (unsigned)anomaly_mlp_int8_flash_bytes);
+  return failures;
+}
+#endif
+
+// Carrega e valida o blob; devolve o número de falhas
+static int checkBlob(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) {
+    printf("Não foi possível abrir '%s'\n", path);
+    return 1;
+  }
+  std::vector<uint8_t> blob;
+  uint8_t chunk[512];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) blob.insert(blob.end(), chunk, chunk + n);
+  fclose(f);
+
+  const AnomalyBlobExpect expect = { anomaly_mlp_layout_hash, AnomalyMlp::shapeHash(), AnomalyMlp::inputs,
+                                     (uint32_t)AnomalyMlp::paramCount };
+  AnomalyModelView view;
+  const char* error = nullptr;
+  if (!anomalyBlobParse(blob.data(), blob.size(), expect, &view, &error)) {
+    printf("Blob '%s' rejeitado: %s\n", path, error);
+    return 1;
+  }
+  int failures = 0;
+  for (int i = 0; i < anomaly_mlp_reference_count; i++) {
+    float out[AnomalyMlp::outputs];
+    AnomalyMlp::forward(view.params, anomaly_mlp_reference_inputs[i], out);
+    for (int k = 0; k < AnomalyMlp::outputs; k++) {
+      if (fabsf(out[k] - anomaly_mlp_reference_outputs[i][k]) > kTolerance) failures++;
+    }
+  }
+  printf("Blob '%s': %zu B, versão %u, limite %.6f; %d saídas divergentes dos vetores de referência\n", path,
+         blob.size(), (unsigned)view.modelVersion, view.threshold, failures);
+
+  // Um byte corrompido no payload tem de ser recusado pelo CRC
+  blob[sizeof(AnomalyBlobHeader) + 5] ^= 0x40;
+  if (anomalyBlobParse(blob.data(), blob.size(), expect, &view, &error)) {
+    printf("Blob corrompido foi aceito!\n");
+    failures++;
+  }
+  return failures;
+}
+
+int main(int argc, char** argv) {
+  long iterations = (argc > 1) ? strtol(argv[1], nullptr, 10) : 1000000;
+
+  float maxDiff = 0.0f;
+  int failures = (argc > 2) ? checkBlob(argv[2]) : 0;
+  for (int i = 0; i < anomaly_mlp_reference_count; i++) {
+    float out[AnomalyMlp::outputs];
+    AnomalyMlp::forward(anomaly_mlp_params, anomaly_mlp_reference_inputs[i], out);
+    for (int k = 0; k < AnomalyMlp::outputs; k++) {
+      float diff = fabsf(out[k] - anomaly_mlp_reference_outputs[i][k]);
+      if (diff > maxDiff) maxDiff = diff;
+      if (diff > kTolerance) {
+        printf("Divergência no vetor %d, saída %d: %.9g (esperado %.9g)\n",
+               i, k, out[k], anomaly_mlp_reference_outputs[i][k]);
+        failures++;
+      }
+    }
+  }
+  printf("%d vetores de referência, maior diferença: %.3g (tolerância %.3g)\n",
+         anomaly_mlp_reference_count, maxDiff, kTolerance);
+
+  // O caminho em lote tem de dar exatamente o mesmo resultado que o vetor a vetor
+  static float batchOut[anomaly_mlp_reference_count][AnomalyMlp::outputs];
+  static float scratchA[anomaly_mlp_reference_count * AnomalyMlp::hiddenWidth];
+  static float scratchB[anomaly_mlp_reference_count * AnomalyMlp::hiddenWidth];
+  AnomalyMlp::forwardBatch(anomaly_mlp_params, &anomaly_mlp_reference_inputs[0][0], &batchOut[0][0],
+                           anomaly_mlp_reference_count, scratchA, scratchB);
+  int batchMismatches = 0;
+  for (int i = 0; i < anomaly_mlp_reference_count; i++) {
+    float out[AnomalyMlp::outputs];
+    AnomalyMlp::forward(anomaly_mlp_params, anomaly_mlp_reference_inputs[i], out);
+    for (int k = 0; k < AnomalyMlp::outputs; k++) {
+      if (out[k] != batchOut[i][k]) batchMismatches++;
+    }
+  }
+  printf("Lote de %d vetores: %d saídas diferentes do caminho vetor a vetor\n",
+         anomaly_mlp_reference_count, batchMismatches);
+  failures += batchMismatches;
+
+  // Tempo por inferência; a entrada muda a cada iteração para não ser constante-propagada
+  volatile float sink = 0.0f;
+  float in[AnomalyMlp::inputs] = {0.0f};
+  auto start = std::chrono::steady_clock::now();
+  for (long n = 0; n < iterations; n++) {
+    float out[AnomalyMlp::outputs];
+    in[0] = (float)(n & 1023) * (1.0f / 1024.0f);
+    in[1] = 1.0f - in[0];
+    AnomalyMlp::forward(anomaly_mlp_params, in, out);
+    sink = sink + out[0];
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  printf("%ld inferências, %.1f ns por inferência (%d parâmetros, %zu B)\n", iterations,
+         std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+         AnomalyMlp::paramCount, sizeof(anomaly_mlp_params));
+
+  // Mesmo número de inferências em lotes de 16 (o tamanho usado por dispositivo no firmware)
+  const int kBatch = 16;
+  float batchIn[kBatch][AnomalyMlp::inputs] = {};
+  float batchRes[kBatch][AnomalyMlp::outputs];
+  float a[kBatch * AnomalyMlp::hiddenWidth], b[kBatch * AnomalyMlp::hiddenWidth];
+  start = std::chrono::steady_clock::now();
+  for (long n = 0; n < iterations; n += kBatch) {
+    for (int k = 0; k < kBatch; k++) {
+      batchIn[k][0] = (float)((n + k) & 1023) * (1.0f / 1024.0f);
+      batchIn[k][1] = 1.0f - batchIn[k][0];
+    }
+    AnomalyMlp::forwardBatch(anomaly_mlp_params, &batchIn[0][0], &batchRes[0][0], kBatch, a, b);
+    sink = sink + batchRes[0][0];
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  printf("Em lotes de %d: %.1f ns por inferência\n", kBatch,
+         std::chrono::duration<double, std::nano>(elapsed).count() / iterations);
+  failures += checkOutageModel(iterations);
+  failures += checkDeviceClassModel();
+#ifdef ANOMALY_MODEL_INT8
+  failures += checkInt8Model(iterations);
+#endif
+  return failures == 0 ? 0 : 1;
+}
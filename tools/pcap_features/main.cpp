@@ -0,0 +1,464 @@
+// Gera o dataset de treino do detector de anomalias direto de capturas
+// pcap/pcapng (roda no PC), no lugar do process_logs.py com pyshark.
+//
+//   pio run -e native_pcap_features
+//   .pio/build/native_pcap_features/program [opções] saida.csv captura.pcap[ng]...
+//
+// Opções:
+//   -w segundos     tamanho da janela (padrão 60, o ciclo do sniffer)
+//   -j threads      arquivos processados em paralelo (padrão: núcleos do PC)
+//   -d disp.csv     também grava um vetor por transmissor em cada janela
+//                   (FeatureStage::deviceFeatures, o que o detector pontua por dispositivo)
+//   -c              trata os quadros como cifrados (WPA2): como no ar, só a
+//                   camada 2 é legível e DNS/peers ficam de fora
+//
+// Cada arquivo é mapeado na memória (mmap) e decodificado por uma thread. Os
+// quadros passam pelo parseWifiFrame() e pelo FeatureStage do próprio
+// firmware, um acumulador por janela, então as colunas (AnomalyFeatures.def)
+// têm exatamente a definição que o AnomalyDetector recebe. Janelas partidas
+// entre arquivos são somadas no fim (FeatureStage::merge). O timestamp de cada
+// linha é o início da janela em hora local (variável TZ), como em
+// network_metrics_dataset.csv.
+//
+// Tipos de enlace: 802.11 (105), 802.11 com radiotap (127, o /capture.pcap do
+// firmware), Ethernet (1) e Linux cooked (113). Quadros Ethernet viram quadros
+// de dados 802.11 do transmissor de origem, com o tamanho que teriam no ar.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "AnalyzerStages.h"
+
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_IEEE802_11 105
+#define LINKTYPE_LINUX_SLL 113
+#define LINKTYPE_RADIOTAP 127
+
+#define WIFI_DATA_HEADER 24  // Cabeçalho de dados 802.11 sem QoS
+#define WIFI_LLC_SNAP 8
+#define WIFI_FCS 4
+#define WIFI_QOS_CCMP_EXTRA 18  // Campo QoS (2) + cabeçalho CCMP (8) + MIC (8)
+
+struct Options {
+  unsigned windowSeconds = 60;
+  unsigned threads = 0;
+  const char* devicesPath = nullptr;
+  bool encrypted = false;
+  const char* outputPath = nullptr;
+  std::vector<const char*> inputs;
+};
+
+typedef std::map<int64_t, std::unique_ptr<FeatureStage>> WindowMap;
+
+struct FileResult {
+  WindowMap windows;
+  uint64_t bytes = 0;
+  uint64_t records = 0;
+  uint64_t frames = 0;  // Quadros de dados entregues ao FeatureStage
+  std::string error;
+};
+
+static uint16_t le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint16_t be16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+static uint32_t rd32(const uint8_t* p, bool swap) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return swap ? __builtin_bswap32(v) : v;
+}
+static uint16_t rd16(const uint8_t* p, bool swap) {
+  uint16_t v;
+  memcpy(&v, p, 2);
+  return swap ? __builtin_bswap16(v) : v;
+}
+
+// Acumula os quadros de um arquivo, uma janela por vez (as capturas vêm em ordem)
+class FileAggregator {
+public:
+  FileAggregator(const Options& options, FileResult& result) : _options(options), _result(result) {
+    _scratch.resize(65536 + WIFI_DATA_HEADER + WIFI_LLC_SNAP);
+  }
+
+  void frame(int linkType, const uint8_t* data, uint32_t captured, uint32_t length, uint64_t timestampUs) {
+    _result.records++;
+    const uint8_t* wifi = nullptr;
+    uint32_t wifiCaptured = 0, wifiLength = 0;
+    switch (linkType) {
+      case LINKTYPE_IEEE802_11:
+        wifi = data;
+        wifiCaptured = captured;
+        wifiLength = length + WIFI_FCS;  // sig_len do ESP32 inclui o FCS
+        break;
+      case LINKTYPE_RADIOTAP:
+        if (!_radiotap(data, captured, length, &wifi, &wifiCaptured, &wifiLength)) return;
+        break;
+      case LINKTYPE_ETHERNET:
+        if (captured < 14) return;
+        wifi = _ethernet(data + 12, data + 6, data, data + 14, captured - 14, length - 14, &wifiCaptured, &wifiLength);
+        break;
+      case LINKTYPE_LINUX_SLL:
+        if (captured < 16) return;
+        wifi = _ethernet(data + 14, be16(data + 4) == 6 ? data + 6 : nullptr, nullptr, data + 16, captured - 16,
+                         length - 16, &wifiCaptured, &wifiLength);
+        break;
+      default:
+        return;
+    }
+    if (wifi == nullptr || wifiCaptured < 2) return;
+    // O filtro do hardware do sniffer só entrega quadros de dados
+    if (((wifi[0] >> 2) & 0x03) != 2) return;
+    if (_options.encrypted) _scratchProtect(wifi, wifiCaptured);
+
+    int64_t windowUs = (int64_t)_options.windowSeconds * 1000000;
+    int64_t start = (int64_t)(timestampUs / windowUs) * _options.windowSeconds;
+    if (_current == nullptr || start != _currentStart) {
+      std::unique_ptr<FeatureStage>& stage = _result.windows[start];
+      if (!stage) stage.reset(new FeatureStage());
+      _current = stage.get();
+      _currentStart = start;
+    }
+    ParsedFrame parsed;
+    parsed.timestampUs = (uint32_t)timestampUs;
+    parsed.uptimeMs = (uint32_t)((timestampUs - (uint64_t)start * 1000000) / 1000);
+    parsed.rssi = 0;
+    parsed.channel = 0;
+    if (!parseWifiFrame(wifi, (uint16_t)std::min<uint32_t>(wifiCaptured, 65535),
+                        (uint16_t)std::min<uint32_t>(wifiLength, 65535), parsed)) {
+      return;
+    }
+    _current->onFrame(parsed);
+    _result.frames++;
+  }
+
+private:
+  const Options& _options;
+  FileResult& _result;
+  std::vector<uint8_t> _scratch;
+  FeatureStage* _current = nullptr;
+  int64_t _currentStart = 0;
+
+  // Quadro cifrado no ar: parseWifiFrame não lê nada além da camada 2
+  void _scratchProtect(const uint8_t*& wifi, uint32_t captured) {
+    if (wifi != _scratch.data()) {
+      memcpy(_scratch.data(), wifi, std::min<size_t>(captured, _scratch.size()));
+      wifi = _scratch.data();
+    }
+    _scratch[1] |= WIFI_FC_PROTECTED;
+  }
+
+  bool _radiotap(const uint8_t* data, uint32_t captured, uint32_t length, const uint8_t** wifi,
+                 uint32_t* wifiCaptured, uint32_t* wifiLength) {
+    if (captured < 8) return false;
+    uint16_t headerLength = le16(data + 2);
+    if (headerLength < 8 || headerLength > captured) return false;
+    // Campo Flags (bit 1), depois do TSFT (bit 0, 8 bytes alinhados em 8)
+    uint32_t present = rd32(data + 4, false);
+    size_t offset = 8;
+    for (uint32_t word = present; (word & 0x80000000u) && offset + 4 <= headerLength; offset += 4) {
+      word = rd32(data + offset, false);
+    }
+    bool fcsIncluded = false;
+    if (present & 0x01) offset = ((offset + 7) & ~(size_t)7) + 8;
+    if ((present & 0x02) && offset < headerLength) {
+      uint8_t flags = data[offset];
+      if (flags & 0x40) return false;  // FCS inválido: o ESP32 descartaria
+      fcsIncluded = flags & 0x10;
+    }
+    *wifi = data + headerLength;
+    *wifiCaptured = captured - headerLength;
+    *wifiLength = length - headerLength + (fcsIncluded ? 0 : WIFI_FCS);
+    return true;
+  }
+
+  // Quadro Ethernet (ou Linux cooked) reescrito como um quadro de dados 802.11
+  // To-DS do transmissor 'src', com LLC/SNAP; o tamanho é o que ele teria no ar
+  const uint8_t* _ethernet(const uint8_t* etherType, const uint8_t* src, const uint8_t* dst, const uint8_t* payload,
+                           uint32_t captured, uint32_t length, uint32_t* wifiCaptured, uint32_t* wifiLength) {
+    static const uint8_t zeros[6] = { 0 };
+    uint16_t type = be16(etherType);
+    while ((type == 0x8100 || type == 0x88A8) && captured >= 4) {  // VLAN
+      type = be16(payload + 2);
+      payload += 4;
+      captured -= 4;
+      length -= 4;
+    }
+    uint8_t* f = _scratch.data();
+    captured = std::min<uint32_t>(captured, (uint32_t)_scratch.size() - WIFI_DATA_HEADER - WIFI_LLC_SNAP);
+    memset(f, 0, WIFI_DATA_HEADER);
+    f[0] = 0x08;  // Dados, sem QoS
+    f[1] = WIFI_FC_TO_DS;
+    memcpy(f + 4, dst ? dst : zeros, 6);
+    memcpy(f + 10, src ? src : zeros, 6);
+    memcpy(f + 16, dst ? dst : zeros, 6);
+    uint8_t* llc = f + WIFI_DATA_HEADER;
+    llc[0] = 0xAA;
+    llc[1] = 0xAA;
+    llc[2] = 0x03;
+    llc[3] = llc[4] = llc[5] = 0;
+    llc[6] = type >> 8;
+    llc[7] = type & 0xFF;
+    memcpy(llc + WIFI_LLC_SNAP, payload, captured);
+    *wifiCaptured = WIFI_DATA_HEADER + WIFI_LLC_SNAP + captured;
+    *wifiLength = WIFI_DATA_HEADER + WIFI_LLC_SNAP + length + WIFI_FCS + (_options.encrypted ? WIFI_QOS_CCMP_EXTRA : 0);
+    return f;
+  }
+};
+
+static bool readPcap(const uint8_t* base, size_t size, FileAggregator& aggregator, std::string& error) {
+  uint32_t magic;
+  memcpy(&magic, base, 4);
+  bool swap = magic == 0xD4C3B2A1u || magic == 0x4D3CB2A1u;
+  bool nano = magic == 0xA1B23C4Du || magic == 0x4D3CB2A1u;
+  int linkType = (int)(rd32(base + 20, swap) & 0xFFFF);
+  size_t offset = 24;
+  while (offset + 16 <= size) {
+    const uint8_t* record = base + offset;
+    uint64_t seconds = rd32(record, swap);
+    uint32_t fraction = rd32(record + 4, swap);
+    uint32_t captured = rd32(record + 8, swap);
+    uint32_t length = rd32(record + 12, swap);
+    if (captured > size - offset - 16) {
+      error = "registro truncado no fim do arquivo";
+      return true;  // Captura interrompida: o que veio antes vale
+    }
+    uint64_t timestampUs = seconds * 1000000 + (nano ? fraction / 1000 : fraction);
+    aggregator.frame(linkType, record + 16, captured, std::max(length, captured), timestampUs);
+    offset += 16 + captured;
+  }
+  return true;
+}
+
+static bool readPcapng(const uint8_t* base, size_t size, FileAggregator& aggregator, std::string& error) {
+  struct Interface {
+    int linkType;
+    uint64_t unitsPerSecond;
+  };
+  std::vector<Interface> interfaces;
+  bool swap = false;
+  size_t offset = 0;
+  while (offset + 12 <= size) {
+    const uint8_t* block = base + offset;
+    uint32_t type;
+    memcpy(&type, block, 4);
+    if (type == 0x0A0D0D0Au) {  // Section Header: define a ordem dos bytes
+      uint32_t byteOrder;
+      memcpy(&byteOrder, block + 8, 4);
+      swap = byteOrder == 0x4D3C2B1Au;
+      interfaces.clear();
+    } else if (swap) {
+      type = __builtin_bswap32(type);
+    }
+    uint32_t blockLength = rd32(block + 4, swap);
+    if (blockLength < 12 || blockLength > size - offset) {
+      error = "bloco truncado no fim do arquivo";
+      return true;
+    }
+
+    if (type == 1 && blockLength >= 20) {  // Interface Description
+      Interface interface = { rd16(block + 8, swap), 1000000 };
+      for (size_t o = 16; o + 4 <= blockLength - 4;) {
+        uint16_t code = rd16(block + o, swap);
+        uint16_t optionLength = rd16(block + o + 2, swap);
+        if (code == 0) break;
+        if (code == 9 && optionLength >= 1) {  // if_tsresol
+          uint8_t resolution = block[o + 4];
+          uint64_t units = 1;
+          for (int i = 0; i < (resolution & 0x7F); i++) units *= (resolution & 0x80) ? 2 : 10;
+          interface.unitsPerSecond = units;
+        }
+        o += 4 + ((optionLength + 3) & ~3u);
+      }
+      interfaces.push_back(interface);
+    } else if ((type == 6 || type == 2) && blockLength >= 32) {  // Enhanced Packet / Packet (obsoleto)
+      uint32_t id = (type == 6) ? rd32(block + 8, swap) : rd16(block + 8, swap);
+      uint64_t timestamp = ((uint64_t)rd32(block + 12, swap) << 32) | rd32(block + 16, swap);
+      uint32_t captured = rd32(block + 20, swap);
+      uint32_t length = rd32(block + 24, swap);
+      if (id < interfaces.size() && captured <= blockLength - 32) {
+        const Interface& interface = interfaces[id];
+        uint64_t timestampUs = (interface.unitsPerSecond == 1000000)
+                                   ? timestamp
+                                   : (uint64_t)((unsigned __int128)timestamp * 1000000 / interface.unitsPerSecond);
+        aggregator.frame(interface.linkType, block + 28, captured, std::max(length, captured), timestampUs);
+      }
+    }
+    // Simple Packet (3) não tem timestamp e os demais blocos não têm quadros
+    offset += blockLength;
+  }
+  return true;
+}
+
+static void processFile(const char* path, const Options& options, FileResult& result) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    result.error = "não abriu";
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < 24) {
+    close(fd);
+    result.error = "vazio ou ilegível";
+    return;
+  }
+  size_t size = (size_t)st.st_size;
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    result.error = "falha no mmap";
+    return;
+  }
+  madvise(mapped, size, MADV_SEQUENTIAL);
+  const uint8_t* base = static_cast<const uint8_t*>(mapped);
+  result.bytes = size;
+
+  FileAggregator aggregator(options, result);
+  uint32_t magic;
+  memcpy(&magic, base, 4);
+  if (magic == 0x0A0D0D0Au) {
+    readPcapng(base, size, aggregator, result.error);
+  } else if (magic == 0xA1B2C3D4u || magic == 0xD4C3B2A1u || magic == 0xA1B23C4Du || magic == 0x4D3CB2A1u) {
+    readPcap(base, size, aggregator, result.error);
+  } else {
+    result.error = "não é pcap nem pcapng";
+  }
+  munmap(mapped, size);
+}
+
+static void formatTimestamp(int64_t seconds, char* out, size_t size) {
+  time_t t = (time_t)seconds;
+  struct tm local;
+  localtime_r(&t, &local);
+  strftime(out, size, "%Y-%m-%d %H:%M:%S", &local);
+}
+
+static void writeHeader(FILE* f, bool withMac) {
+  fprintf(f, "timestamp");
+  if (withMac) fprintf(f, ",mac");
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) fprintf(f, ",%s", ANOMALY_FEATURE_COLUMNS[i]);
+  fprintf(f, "\n");
+}
+
+static void writeValues(FILE* f, const FeatureVector& v) {
+  for (int i = 0; i < ANOMALY_FEATURE_COUNT; i++) fprintf(f, ",%.9g", (double)v[i]);
+  fprintf(f, "\n");
+}
+
+static void usage() {
+  fprintf(stderr, "uso: program [-w segundos] [-j threads] [-d dispositivos.csv] [-c] saida.csv captura.pcap[ng]...\n");
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (strcmp(arg, "-w") == 0 && i + 1 < argc) {
+      options.windowSeconds = (unsigned)atoi(argv[++i]);
+    } else if (strcmp(arg, "-j") == 0 && i + 1 < argc) {
+      options.threads = (unsigned)atoi(argv[++i]);
+    } else if (strcmp(arg, "-d") == 0 && i + 1 < argc) {
+      options.devicesPath = argv[++i];
+    } else if (strcmp(arg, "-c") == 0) {
+      options.encrypted = true;
+    } else if (arg[0] == '-') {
+      usage();
+    } else if (options.outputPath == nullptr) {
+      options.outputPath = arg;
+    } else {
+      options.inputs.push_back(arg);
+    }
+  }
+  if (options.outputPath == nullptr || options.inputs.empty() || options.windowSeconds == 0) usage();
+  if (options.threads == 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+  options.threads = std::min<unsigned>(options.threads, (unsigned)options.inputs.size());
+
+  auto started = std::chrono::steady_clock::now();
+  std::vector<FileResult> results(options.inputs.size());
+  std::atomic<size_t> nextFile(0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < options.threads; t++) {
+    workers.emplace_back([&]() {
+      for (size_t i = nextFile++; i < options.inputs.size(); i = nextFile++) {
+        processFile(options.inputs[i], options, results[i]);
+      }
+    });
+  }
+  for (std::thread& worker : workers) worker.join();
+
+  // Janelas de todos os arquivos, somando as que aparecem em mais de um
+  WindowMap windows;
+  uint64_t bytes = 0, records = 0, frames = 0;
+  for (size_t i = 0; i < results.size(); i++) {
+    FileResult& result = results[i];
+    if (!result.error.empty()) fprintf(stderr, "%s: %s\n", options.inputs[i], result.error.c_str());
+    bytes += result.bytes;
+    records += result.records;
+    frames += result.frames;
+    for (auto& entry : result.windows) {
+      std::unique_ptr<FeatureStage>& stage = windows[entry.first];
+      if (!stage) {
+        stage = std::move(entry.second);
+      } else {
+        stage->merge(*entry.second);
+      }
+    }
+    result.windows.clear();
+  }
+
+  FILE* out = fopen(options.outputPath, "w");
+  if (out == nullptr) {
+    fprintf(stderr, "não foi possível criar %s\n", options.outputPath);
+    return 1;
+  }
+  FILE* devicesOut = nullptr;
+  if (options.devicesPath != nullptr && (devicesOut = fopen(options.devicesPath, "w")) == nullptr) {
+    fprintf(stderr, "não foi possível criar %s\n", options.devicesPath);
+    return 1;
+  }
+  writeHeader(out, false);
+  if (devicesOut) writeHeader(devicesOut, true);
+  static DeviceFeatures devices[FEATURE_MAX_STATIONS];
+  size_t deviceRows = 0;
+  for (const auto& entry : windows) {
+    char timestamp[32];
+    formatTimestamp(entry.first, timestamp, sizeof(timestamp));
+    fprintf(out, "%s", timestamp);
+    writeValues(out, entry.second->features());
+    if (devicesOut == nullptr) continue;
+    size_t count = entry.second->deviceFeatures(devices, FEATURE_MAX_STATIONS);
+    for (size_t d = 0; d < count; d++) {
+      const uint8_t* m = devices[d].mac;
+      fprintf(devicesOut, "%s,%02x:%02x:%02x:%02x:%02x:%02x", timestamp, m[0], m[1], m[2], m[3], m[4], m[5]);
+      writeValues(devicesOut, devices[d].features);
+    }
+    deviceRows += count;
+  }
+  fclose(out);
+  if (devicesOut) fclose(devicesOut);
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  fprintf(stderr,
+          "%zu arquivo(s), %.1f MB, %llu registros (%llu quadros de dados) em %.2f s (%.0f MB/s, %u threads)\n"
+          "%zu janelas de %u s -> %s",
+          options.inputs.size(), bytes / 1e6, (unsigned long long)records, (unsigned long long)frames, seconds,
+          bytes / 1e6 / std::max(seconds, 1e-9), options.threads, windows.size(), options.windowSeconds,
+          options.outputPath);
+  if (devicesOut) fprintf(stderr, "; %zu linhas por dispositivo -> %s", deviceRows, options.devicesPath);
+  fprintf(stderr, "\n");
+  return 0;
+}
@@ -0,0 +1,157 @@
+// Benchmark do pipeline de análise do sniffer (roda no PC).
+//
+//   pio run -e native_pipeline_bench && .pio/build/native_pipeline_bench/program [frames] [rodadas]
+//
+// Mede o custo por quadro de cada estágio isolado e das composições
+// acumuladas. Como o despacho é resolvido em tempo de compilação, o custo de
+// Pipeline<A, B> deve ficar próximo de custo(A) + custo(B) - custo(vazio).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "esp_log.h"
+#include "AnalyzerPipeline.h"
+#include "AnalyzerStages.h"
+
+struct Corpus {
+  std::vector<std::vector<uint8_t>> buffers;
+  std::vector<ParsedFrame> frames;
+};
+
+static void put16(uint8_t* p, uint16_t v) { p[0] = v >> 8; p[1] = v; }
+static void put32(uint8_t* p, uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; }
+
+// Monta um quadro de dados 802.11 QoS com LLC/SNAP + IPv4 + TCP/UDP
+static std::vector<uint8_t> buildFrame(std::mt19937& rng, int kind) {
+  static const char dnsName[] = "\x03www\x07" "example\x03" "com";
+  bool uplink = rng() & 1;
+  int payload = (kind == 0) ? 200 + (int)(rng() % 1200) : 0;
+  int l4Header = (kind == 2) ? 8 : 20;
+  int dnsLength = (kind == 2) ? 12 + (int)sizeof(dnsName) + 4 : 0;
+  std::vector<uint8_t> f(26 + 8 + 20 + l4Header + payload + dnsLength + 4, 0);
+
+  f[0] = 0x88;
+  f[1] = uplink ? 0x01 : 0x02;
+  if (kind == 3) f[1] |= 0x40; // Quadro protegido: só L2 é legível
+  // 16 estações falando com o mesmo AP
+  uint8_t station = (uint8_t)(rng() % 16);
+  const uint8_t ap[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01};
+  const uint8_t sta[6] = {0x3C, 0x22, 0xFB, 0x10, 0x00, station};
+  memcpy(&f[4], uplink ? ap : sta, 6);
+  memcpy(&f[10], uplink ? sta : ap, 6);
+  uint8_t* llc = &f[26];
+  llc[0] = 0xAA; llc[1] = 0xAA; llc[2] = 0x03; llc[6] = 0x08;
+
+  uint8_t* ip = llc + 8;
+  ip[0] = 0x45;
+  put16(ip + 2, (uint16_t)(20 + l4Header + payload + dnsLength));
+  ip[9] = (kind == 2) ? 17 : 6;
+  uint32_t local = 0xC0A80100 | (rng() % 16);
+  uint32_t remote = 0x5DB8D800 | (rng() % 64);
+  put32(ip + 12, uplink ? local : remote);
+  put32(ip + 16, uplink ? remote : local);
+
+  uint8_t* l4 = ip + 20;
+  uint16_t localPort = 40000 + rng() % 32;
+  uint16_t remotePort = (kind == 2) ? 53 : 443;
+  put16(l4, uplink ? localPort : remotePort);
+  put16(l4 + 2, uplink ? remotePort : localPort);
+  if (kind == 2) {
+    put16(l4 + 4, (uint16_t)(8 + dnsLength));
+    memcpy(l4 + 8 + 12, dnsName, sizeof(dnsName));
+  } else {
+    put32(l4 + 4, rng());
+    put32(l4 + 8, rng());
+    l4[12] = 0x50;
+    l4[13] = (kind == 1) ? ((rng() & 1) ? 0x02 : 0x12) : 0x10;
+  }
+  return f;
+}
+
+static Corpus buildCorpus(size_t count) {
+  std::mt19937 rng(42);
+  Corpus corpus;
+  corpus.buffers.reserve(count);
+  corpus.frames.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    // 70% dados TCP, 10% handshakes, 5% DNS, 15% protegidos
+    uint32_t r = rng() % 100;
+    int kind = (r < 70) ? 0 : (r < 80) ? 1 : (r < 85) ? 2 : 3;
+    corpus.buffers.push_back(buildFrame(rng, kind));
+    ParsedFrame& frame = corpus.frames[i];
+    frame.timestampUs = (uint32_t)(i * 250);
+    frame.uptimeMs = (uint32_t)(i / 4);
+    frame.rssi = -50;
+    frame.channel = 6;
+    const std::vector<uint8_t>& b = corpus.buffers.back();
+    parseWifiFrame(b.data(), (uint16_t)b.size(), (uint16_t)b.size(), frame);
+  }
+  return corpus;
+}
+
+// Melhor de 3 execuções, para reduzir o ruído do escalonador do PC
+template <typename P>
+static double nsPerFrame(const Corpus& corpus, int rounds) {
+  double best = 0;
+  for (int trial = 0; trial < 3; trial++) {
+    P* pipeline = new P();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+      for (const ParsedFrame& frame : corpus.frames) pipeline->onFrame(frame);
+      pipeline->onWindowEnd();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    delete pipeline;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / ((double)corpus.frames.size() * rounds);
+    if (trial == 0 || ns < best) best = ns;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  size_t frames = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+  int rounds = (argc > 2) ? atoi(argv[2]) : 5;
+  esp_log_host_level = ESP_LOG_NONE;
+
+  Corpus corpus = buildCorpus(frames);
+  printf("Corpus: %zu quadros, %d rodadas\n\n", frames, rounds);
+
+  double empty = nsPerFrame<Pipeline<>>(corpus, rounds);
+  double stats = nsPerFrame<Pipeline<StatsStage>>(corpus, rounds);
+  double dns = nsPerFrame<Pipeline<DnsStage>>(corpus, rounds);
+  double flow = nsPerFrame<Pipeline<FlowStage>>(corpus, rounds);
+  double rtt = nsPerFrame<Pipeline<RttStage>>(corpus, rounds);
+  double feature = nsPerFrame<Pipeline<FeatureStage>>(corpus, rounds);
+  double app = nsPerFrame<Pipeline<AppClassStage>>(corpus, rounds);
+
+  printf("%-36s %10s\n", "Estagio isolado", "ns/quadro");
+  printf("%-36s %10.1f\n", "Pipeline<> (vazio)", empty);
+  printf("%-36s %10.1f\n", "Stats", stats);
+  printf("%-36s %10.1f\n", "Dns", dns);
+  printf("%-36s %10.1f\n", "Flow", flow);
+  printf("%-36s %10.1f\n", "Rtt", rtt);
+  printf("%-36s %10.1f\n", "Feature", feature);
+  printf("%-36s %10.1f\n\n", "AppClass", app);
+
+  struct Row { const char* name; double measured; double expected; };
+  Row rows[] = {
+    {"Stats, Dns", nsPerFrame<Pipeline<StatsStage, DnsStage>>(corpus, rounds), stats + dns - empty},
+    {"Stats, Dns, Flow", nsPerFrame<Pipeline<StatsStage, DnsStage, FlowStage>>(corpus, rounds), stats + dns + flow - 2 * empty},
+    {"Stats, Dns, Flow, Rtt", nsPerFrame<Pipeline<StatsStage, DnsStage, FlowStage, RttStage>>(corpus, rounds), stats + dns + flow + rtt - 3 * empty},
+    {"Stats, Dns, Flow, Rtt, Feature", nsPerFrame<Pipeline<StatsStage, DnsStage, FlowStage, RttStage, FeatureStage>>(corpus, rounds),
+     stats + dns + flow + rtt + feature - 4 * empty},
+    {"Stats, Dns, Flow, Rtt, Feature, App",
+     nsPerFrame<Pipeline<StatsStage, DnsStage, FlowStage, RttStage, FeatureStage, AppClassStage>>(corpus, rounds),
+     stats + dns + flow + rtt + feature + app - 5 * empty},
+  };
+  printf("%-36s %10s %10s %8s\n", "Composicao", "medido", "soma", "desvio");
+  for (const Row& row : rows) {
+    printf("%-36s %10.1f %10.1f %7.1f%%\n", row.name, row.measured, row.expected,
+           100.0 * (row.measured - row.expected) / row.expected);
+  }
+  return 0;
+}